@@ -23,6 +23,7 @@
 #include "itkBSplineKernelFunction.h"
 #include "itkArray.h"
 #include "itkArray2D.h"
+#include "itkMatrix.h"
 
 namespace itk
 {
@@ -95,6 +96,20 @@ public:
   virtual void
   Evaluate(const ContinuousIndexType & index, WeightsType & weights, IndexType & startIndex) const;
 
+  /** Weights of each dimension, whose products are the weights over the
+   * support region. */
+  using OneDWeightsType = Matrix<double, VSpaceDimension, VSplineOrder + 1>;
+
+  /** Evaluate the weights of each dimension at specified ContinuousIndex
+   * position. The weight of the offset (i_0, ..., i_n) of the support region
+   * is the product of the weights1D[j][i_j], in the order of the dimensions
+   * j, the offsets of the first dimension being the fastest varying ones in
+   * the weights returned by Evaluate(). On return, startIndex contains the
+   * start index of the support region over which the weights are defined.
+   */
+  void
+  EvaluateOneDWeights(const ContinuousIndexType & index, OneDWeightsType & weights1D, IndexType & startIndex) const;
+
   /** Get support region size. */
   itkGetConstMacro(SupportSize, SizeType);
 
@@ -84,12 +84,12 @@ BSplineInterpolationWeightFunction<TCoordRep, VSpaceDimension, VSplineOrder>::Ev
   return weights;
 }
 
-/** Compute weights for interpolation at continuous index position */
+/** Compute the weights of each dimension at continuous index position */
 template <typename TCoordRep, unsigned int VSpaceDimension, unsigned int VSplineOrder>
 void
-BSplineInterpolationWeightFunction<TCoordRep, VSpaceDimension, VSplineOrder>::Evaluate(
+BSplineInterpolationWeightFunction<TCoordRep, VSpaceDimension, VSplineOrder>::EvaluateOneDWeights(
   const ContinuousIndexType & index,
-  WeightsType &               weights,
+  OneDWeightsType &           weights1D,
   IndexType &                 startIndex) const
 {
   unsigned int j, k;
@@ -104,7 +104,6 @@ BSplineInterpolationWeightFunction<TCoordRep, VSpaceDimension, VSplineOrder>::Ev
   }
 
   // Compute the weights
-  Matrix<double, SpaceDimension, SplineOrder + 1> weights1D;
   for (j = 0; j < SpaceDimension; j++)
   {
     double x = index[j] - static_cast<double>(startIndex[j]);
@@ -115,12 +114,24 @@ BSplineInterpolationWeightFunction<TCoordRep, VSpaceDimension, VSplineOrder>::Ev
       x -= 1.0;
     }
   }
+}
+
+/** Compute weights for interpolation at continuous index position */
+template <typename TCoordRep, unsigned int VSpaceDimension, unsigned int VSplineOrder>
+void
+BSplineInterpolationWeightFunction<TCoordRep, VSpaceDimension, VSplineOrder>::Evaluate(
+  const ContinuousIndexType & index,
+  WeightsType &               weights,
+  IndexType &                 startIndex) const
+{
+  OneDWeightsType weights1D;
+  this->EvaluateOneDWeights(index, weights1D, startIndex);
 
-  for (k = 0; k < m_NumberOfWeights; k++)
+  for (unsigned int k = 0; k < m_NumberOfWeights; k++)
   {
     weights[k] = 1.0;
 
-    for (j = 0; j < SpaceDimension; j++)
+    for (unsigned int j = 0; j < SpaceDimension; j++)
     {
       weights[k] *= weights1D[j][m_OffsetToIndexTable[k][j]];
     }
@@ -0,0 +1,126 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferAllocation_h
+#define itkImageBufferAllocation_h
+
+#include "itkMacro.h" // for ITKCommon_EXPORT
+#include "itkSingletonMacro.h"
+#include <cstddef>
+
+namespace itk
+{
+/**\class ImageBufferAllocationEnums
+ * \brief Contains all enum classes used by ImageBufferAllocation class.
+ * \ingroup ITKCommon
+ */
+class ImageBufferAllocationEnums
+{
+public:
+  /**\class Policy
+   * \ingroup ITKCommon
+   * Defines how the pixel buffer of an image is allocated. */
+  enum class Policy : uint8_t
+  {
+    /** operator new[], with no alignment guarantee beyond the one of the element type. */
+    NewArray,
+    /** Aligned on a cache line (64 bytes). */
+    CacheLineAligned,
+    /** Aligned on a 2 MiB boundary. On Linux, the buffer is also advised to be
+     * backed by transparent huge pages, which reduces the TLB misses when
+     * traversing large images. */
+    HugePageAligned
+  };
+};
+// Define how to print enumeration
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const ImageBufferAllocationEnums::Policy value);
+
+/** \class ImageBufferAllocation
+ *  \brief Global settings and helpers for the allocation of image buffers.
+ *
+ * Holds the default allocation policy of the pixel buffers of the images,
+ * which is used by every ImportImageContainer created afterwards, and
+ * whether these buffers are touched for the first time by several threads.
+ * On NUMA systems, a memory page is placed on the node of the thread that
+ * touches it first, so the parallel first touch spreads the pages of large
+ * images over the nodes of the threads that later process them.
+ *
+ * The policy of a single image can be changed through its pixel container,
+ * before the image is allocated:
+ * \code
+ * image->GetPixelContainer()->SetAllocationPolicy(ImageBufferAllocationEnums::Policy::HugePageAligned);
+ * image->Allocate();
+ * \endcode
+ *
+ * \sa ImportImageContainer
+ * \ingroup ITKCommon
+ */
+
+struct ImageBufferAllocationGlobals;
+
+class ITKCommon_EXPORT ImageBufferAllocation
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferAllocation);
+  ImageBufferAllocation() = default;
+  virtual ~ImageBufferAllocation() = default;
+
+  using PolicyEnum = ImageBufferAllocationEnums::Policy;
+
+  /** Size of a cache line, used by the CacheLineAligned policy. */
+  static constexpr std::size_t CacheLineSize = 64;
+
+  /** Size of a huge page, used by the HugePageAligned policy. */
+  static constexpr std::size_t HugePageSize = std::size_t{ 2 } * 1024 * 1024;
+
+  /** Set/Get the policy used by default to allocate the image buffers. The
+   * default is NewArray. */
+  static void
+  SetGlobalDefaultPolicy(PolicyEnum policy);
+  static PolicyEnum
+  GetGlobalDefaultPolicy();
+
+  /** Set/Get whether the image buffers are touched for the first time by
+   * several threads by default. The default is false. */
+  static void
+  SetGlobalDefaultParallelFirstTouch(bool parallelFirstTouch);
+  static bool
+  GetGlobalDefaultParallelFirstTouch();
+
+  /** Returns the alignment of the buffers allocated with the given policy,
+   * or 0 for NewArray. */
+  static std::size_t
+  GetAlignment(PolicyEnum policy);
+
+  /** Allocates uninitialized memory with the alignment of the given policy,
+   * which must not be NewArray. Throws a MemoryAllocationError on failure.
+   * The memory must be released with DeallocateAligned. */
+  static void *
+  AllocateAligned(std::size_t numberOfBytes, PolicyEnum policy);
+
+  /** Releases the memory allocated by AllocateAligned. */
+  static void
+  DeallocateAligned(void * pointer);
+
+private:
+  itkGetGlobalDeclarationMacro(ImageBufferAllocationGlobals, PimplGlobals);
+  static ImageBufferAllocationGlobals * m_PimplGlobals;
+};
+} // namespace itk
+
+#endif
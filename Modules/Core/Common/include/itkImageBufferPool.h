@@ -0,0 +1,129 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferPool_h
+#define itkImageBufferPool_h
+
+#include "itkImageBufferAllocation.h"
+#include "itkIntTypes.h"
+#include <typeinfo>
+
+namespace itk
+{
+/** \class ImageBufferPool
+ *  \brief Global pool of image buffers, which are reused instead of being
+ *  released and allocated again.
+ *
+ * When the pool is enabled, the buffer of an ImportImageContainer is given
+ * to the pool when the container releases it, and a container which needs a
+ * buffer of the same element type, number of elements and allocation policy
+ * takes it back from the pool instead of allocating a new one. Since image
+ * sources allocate their outputs through their pixel containers, a pipeline
+ * which is updated again and again on images of the same size then stops
+ * allocating and releasing memory after its first update.
+ *
+ * Only the buffers of elements which are trivially destructible are pooled.
+ * The pool keeps at most MaximumNumberOfPooledBytes. When a buffer given to
+ * a full pool does not fit, the buffers given to the pool the longest ago
+ * are released to make room for it, so that the pool follows the sizes of
+ * the images currently processed.
+ *
+ * The pool is disabled by default:
+ * \code
+ * ImageBufferPool::SetEnabled(true);
+ * \endcode
+ *
+ * \sa ImportImageContainer
+ * \ingroup ITKCommon
+ */
+
+struct ImageBufferPoolGlobals;
+
+class ITKCommon_EXPORT ImageBufferPool
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferPool);
+  ImageBufferPool() = default;
+  virtual ~ImageBufferPool() = default;
+
+  using PolicyEnum = ImageBufferAllocationEnums::Policy;
+
+  /** Function releasing a buffer which is not kept by the pool. */
+  using DeleterType = void (*)(void *);
+
+  /** Set/Get whether the image buffers are pooled. Disabling the pool
+   * releases the buffers which it holds. */
+  static void
+  SetEnabled(bool enabled);
+  static bool
+  GetEnabled();
+
+  /** Set/Get the maximum number of bytes of the buffers kept by the pool.
+   * The default is 1 GiB. Lowering it releases the buffers given to the pool
+   * the longest ago, until the others fit. */
+  static void
+  SetMaximumNumberOfPooledBytes(SizeValueType numberOfBytes);
+  static SizeValueType
+  GetMaximumNumberOfPooledBytes();
+
+  /** Returns the number of bytes of the buffers currently kept by the pool. */
+  static SizeValueType
+  GetNumberOfPooledBytes();
+
+  /** Returns the number of requests which have been satisfied by a pooled
+   * buffer, and the number of the other ones. */
+  static SizeValueType
+  GetNumberOfHits();
+  static SizeValueType
+  GetNumberOfMisses();
+
+  /** Returns the number of buffers which have been released to make room
+   * for others. */
+  static SizeValueType
+  GetNumberOfEvictions();
+
+  /** Resets the numbers of hits, misses and evictions. */
+  static void
+  ResetStatistics();
+
+  /** Releases all the buffers kept by the pool. */
+  static void
+  Clear();
+
+  /** Takes a buffer out of the pool, or returns nullptr if there is no
+   * buffer for these element type, number of elements and policy, or if the
+   * pool is disabled. */
+  static void *
+  Acquire(const std::type_info & elementType, SizeValueType numberOfElements, PolicyEnum policy);
+
+  /** Gives a buffer to the pool. Returns false if the pool does not keep
+   * it, in which case the caller still has to release it. */
+  static bool
+  Release(void *                 buffer,
+          const std::type_info & elementType,
+          SizeValueType          numberOfElements,
+          SizeValueType          numberOfBytes,
+          PolicyEnum             policy,
+          DeleterType            deleter);
+
+private:
+  itkGetGlobalDeclarationMacro(ImageBufferPoolGlobals, PimplGlobals);
+  static ImageBufferPoolGlobals * m_PimplGlobals;
+};
+} // namespace itk
+
+#endif
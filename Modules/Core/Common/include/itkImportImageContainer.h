@@ -20,6 +20,8 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocation.h"
+#include "itkImageBufferPool.h"
 #include <utility>
 
 namespace itk
@@ -36,6 +38,19 @@ namespace itk
  *
  * \tparam TElement The element type stored in the container.
  *
+ * The memory allocated by the container follows its AllocationPolicy,
+ * which is initialized from ImageBufferAllocation::GetGlobalDefaultPolicy().
+ * With the default NewArray policy, the buffer is allocated with
+ * operator new[]; the other policies return a buffer aligned on a cache
+ * line or on a huge page. When ParallelFirstTouch is on, the elements of
+ * a newly allocated buffer are initialized by several threads, each of them
+ * initializing a contiguous part of the buffer, as the default image region
+ * splitter does.
+ *
+ * When the ImageBufferPool is enabled, the buffers of trivially
+ * destructible elements are taken from the pool and given back to it,
+ * instead of being allocated and released.
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITKCommon
@@ -57,6 +72,8 @@ public:
   using ElementIdentifier = TElementIdentifier;
   using Element = TElement;
 
+  using AllocationPolicyEnum = ImageBufferAllocationEnums::Policy;
+
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
@@ -146,11 +163,26 @@ public:
    *  is intended to be used by external applications.
    *  Note that the normal logic of this class set the value of the boolean
    *  flag. This may override your setting if you call this methods prematurely.
-   *  \warning Improper use of these methods will result in memory leaks */
+   *  \warning Improper use of these methods will result in memory leaks.
+   *  Only a buffer allocated with the NewArray policy can be released with
+   *  delete[] by the application. */
   itkSetMacro(ContainerManageMemory, bool);
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get the policy used to allocate the memory of the container. It
+   * only applies to the buffers allocated afterwards. */
+  itkSetEnumMacro(AllocationPolicy, AllocationPolicyEnum);
+  itkGetEnumMacro(AllocationPolicy, AllocationPolicyEnum);
+
+  /** Set/Get whether the elements of a newly allocated buffer are
+   * initialized by several threads, so that the memory pages are placed
+   * on the NUMA nodes of the threads which process them. The elements are
+   * then initialized to zero (or with their default constructor). */
+  itkSetMacro(ParallelFirstTouch, bool);
+  itkGetConstMacro(ParallelFirstTouch, bool);
+  itkBooleanMacro(ParallelFirstTouch);
+
 protected:
   ImportImageContainer();
   ~ImportImageContainer() override;
@@ -172,6 +204,27 @@ protected:
   virtual void
   DeallocateManagedMemory();
 
+  /** Calls initializeElements(begin, end) concurrently on contiguous parts
+   * of a buffer of the given size. */
+  template <typename TFunction>
+  static void
+  InitializeElementsInParallel(ElementIdentifier size, TFunction initializeElements);
+
+private:
+  /** Release a buffer allocated with the NewArray policy, or with another
+   * one, for the buffers of trivially destructible elements released by the
+   * ImageBufferPool. */
+  static void
+  DeleteNewArray(void * buffer)
+  {
+    delete[] static_cast<TElement *>(buffer);
+  }
+  static void
+  DeleteAligned(void * buffer)
+  {
+    ImageBufferAllocation::DeallocateAligned(buffer);
+  }
+
   /* Set the m_Size member that represents the number of elements
    * currently stored in the container. Use this function with great
    * care since it only changes the m_Size member and not the actual size
@@ -203,6 +256,12 @@ private:
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  AllocationPolicyEnum m_AllocationPolicy;
+  bool                 m_ParallelFirstTouch;
+
+  /** The policy with which the current buffer has been allocated. */
+  AllocationPolicyEnum m_BufferAllocationPolicy{ AllocationPolicyEnum::NewArray };
 };
 } // end namespace itk
 
@@ -29,7 +29,11 @@
 #define itkImportImageContainer_hxx
 
 #include "itkImportImageContainer.h"
+#include "itkMultiThreaderBase.h"
 #include <algorithm> // For copy_n.
+#include <new>
+#include <typeinfo>
+#include <type_traits>
 
 namespace itk
 {
@@ -40,6 +44,8 @@ ImportImageContainer<TElementIdentifier, TElement>::ImportImageContainer()
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_AllocationPolicy = ImageBufferAllocation::GetGlobalDefaultPolicy();
+  m_ParallelFirstTouch = ImageBufferAllocation::GetGlobalDefaultParallelFirstTouch();
 }
 
 template <typename TElementIdentifier, typename TElement>
@@ -70,6 +76,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_BufferAllocationPolicy = m_AllocationPolicy;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -84,6 +91,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   else
   {
     m_ImportPointer = this->AllocateElements(size, UseDefaultConstructor);
+    m_BufferAllocationPolicy = m_AllocationPolicy;
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -110,6 +118,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Squeeze()
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_BufferAllocationPolicy = m_AllocationPolicy;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -153,6 +162,7 @@ ImportImageContainer<TElementIdentifier, TElement>::SetImportPointer(TElement *
 {
   DeallocateManagedMemory();
   m_ImportPointer = ptr;
+  m_BufferAllocationPolicy = AllocationPolicyEnum::NewArray;
   m_ContainerManageMemory = LetContainerManageMemory;
   m_Capacity = num;
   m_Size = num;
@@ -170,38 +180,142 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
   // does not do this by default.
   TElement * data;
 
-  try
+  if (std::is_trivially_destructible<TElement>::value)
   {
-    if (UseDefaultConstructor)
+    data = static_cast<TElement *>(ImageBufferPool::Acquire(typeid(TElement), size, m_AllocationPolicy));
+    if (data)
     {
-      data = new TElement[size](); // POD types initialized to 0, others use default constructor.
+      // a recycled buffer holds the pixels of a previous image
+      if (UseDefaultConstructor)
+      {
+        std::fill_n(data, size, TElement());
+      }
+      return data;
     }
-    else
+  }
+
+  if (m_AllocationPolicy == AllocationPolicyEnum::NewArray)
+  {
+    try
+    {
+      if (UseDefaultConstructor && !m_ParallelFirstTouch)
+      {
+        data = new TElement[size](); // POD types initialized to 0, others use default constructor.
+      }
+      else
+      {
+        data = new TElement[size]; // Faster but uninitialized
+      }
+    }
+    catch (...)
+    {
+      data = nullptr;
+    }
+    if (!data)
     {
-      data = new TElement[size]; // Faster but uninitialized
+      // We cannot construct an error string here because we may be out
+      // of memory.  Do not use the exception macro.
+      throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
     }
+    if (m_ParallelFirstTouch)
+    {
+      Self::InitializeElementsInParallel(size, [data](ElementIdentifier begin, ElementIdentifier end) {
+        std::fill(data + begin, data + end, TElement());
+      });
+    }
+    return data;
+  }
+
+  data = static_cast<TElement *>(ImageBufferAllocation::AllocateAligned(size * sizeof(TElement), m_AllocationPolicy));
+
+  if (m_ParallelFirstTouch)
+  {
+    // The pages are only placed by a write, so the elements are initialized.
+    Self::InitializeElementsInParallel(size, [data](ElementIdentifier begin, ElementIdentifier end) {
+      for (ElementIdentifier i = begin; i < end; ++i)
+      {
+        new (data + i) TElement();
+      }
+    });
   }
-  catch (...)
+  else if (UseDefaultConstructor)
   {
-    data = nullptr;
+    for (ElementIdentifier i = 0; i < size; ++i)
+    {
+      new (data + i) TElement();
+    }
   }
-  if (!data)
+  else if (!std::is_trivially_default_constructible<TElement>::value)
   {
-    // We cannot construct an error string here because we may be out
-    // of memory.  Do not use the exception macro.
-    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+    for (ElementIdentifier i = 0; i < size; ++i)
+    {
+      new (data + i) TElement;
+    }
   }
   return data;
 }
 
+template <typename TElementIdentifier, typename TElement>
+template <typename TFunction>
+void
+ImportImageContainer<TElementIdentifier, TElement>::InitializeElementsInParallel(ElementIdentifier size,
+                                                                                 TFunction         initializeElements)
+{
+  // The buffer is split into as many contiguous parts as there are work
+  // units, just like the default region splitter splits an image along its
+  // slowest dimension.
+  const MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  const ElementIdentifier          numberOfParts =
+    std::min(static_cast<ElementIdentifier>(multiThreader->GetNumberOfWorkUnits()), size);
+
+  if (numberOfParts <= 1)
+  {
+    initializeElements(0, size);
+    return;
+  }
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfParts,
+    [size, numberOfParts, &initializeElements](SizeValueType part) {
+      const auto index = static_cast<ElementIdentifier>(part);
+      initializeElements(size * index / numberOfParts, size * (index + 1) / numberOfParts);
+    },
+    nullptr);
+}
+
 template <typename TElementIdentifier, typename TElement>
 void
 ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
 {
   // Encapsulate all image memory deallocation here
-  if (m_ContainerManageMemory)
+  if (m_ContainerManageMemory && std::is_trivially_destructible<TElement>::value &&
+      ImageBufferPool::Release(m_ImportPointer,
+                               typeid(TElement),
+                               m_Capacity,
+                               m_Capacity * sizeof(TElement),
+                               m_BufferAllocationPolicy,
+                               m_BufferAllocationPolicy == AllocationPolicyEnum::NewArray ? &Self::DeleteNewArray
+                                                                                          : &Self::DeleteAligned))
+  {
+    // the buffer is kept by the pool
+  }
+  else if (m_ContainerManageMemory)
   {
-    delete[] m_ImportPointer;
+    if (m_BufferAllocationPolicy == AllocationPolicyEnum::NewArray)
+    {
+      delete[] m_ImportPointer;
+    }
+    else if (m_ImportPointer)
+    {
+      if (!std::is_trivially_destructible<TElement>::value)
+      {
+        for (TElementIdentifier i = 0; i < m_Capacity; ++i)
+        {
+          m_ImportPointer[i].~TElement();
+        }
+      }
+      ImageBufferAllocation::DeallocateAligned(m_ImportPointer);
+    }
   }
   m_ImportPointer = nullptr;
   m_Capacity = 0;
@@ -218,6 +332,8 @@ ImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os,
   os << indent << "Container manages memory: " << (m_ContainerManageMemory ? "true" : "false") << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "AllocationPolicy: " << m_AllocationPolicy << std::endl;
+  os << indent << "ParallelFirstTouch: " << (m_ParallelFirstTouch ? "On" : "Off") << std::endl;
 }
 } // end namespace itk
 
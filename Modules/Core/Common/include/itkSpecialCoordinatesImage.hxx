@@ -65,8 +65,15 @@ SpecialCoordinatesImage<TPixel, VImageDimension>::Initialize()
 
   // Replace the handle to the buffer. This is the safest thing to do,
   // since the same container can be shared by multiple images (e.g.
-  // Grafted outputs and in place filters).
-  m_Buffer = PixelContainer::New();
+  // Grafted outputs and in place filters). The new buffer keeps the
+  // allocation settings of the previous one, if any.
+  const PixelContainerPointer buffer = PixelContainer::New();
+  if (m_Buffer)
+  {
+    buffer->SetAllocationPolicy(m_Buffer->GetAllocationPolicy());
+    buffer->SetParallelFirstTouch(m_Buffer->GetParallelFirstTouch());
+  }
+  m_Buffer = buffer;
 }
 
 template <typename TPixel, unsigned int VImageDimension>
@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocation.h"
+#include "itkSingleton.h"
+
+#include <cstdlib>
+#if defined(_WIN32)
+#  include <malloc.h>
+#else
+#  include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+struct ImageBufferAllocationGlobals
+{
+  ImageBufferAllocationGlobals() = default;
+  ImageBufferAllocation::PolicyEnum m_Policy{ ImageBufferAllocation::PolicyEnum::NewArray };
+  bool                              m_ParallelFirstTouch{ false };
+};
+
+itkGetGlobalSimpleMacro(ImageBufferAllocation, ImageBufferAllocationGlobals, PimplGlobals);
+
+ImageBufferAllocationGlobals * ImageBufferAllocation::m_PimplGlobals;
+
+void
+ImageBufferAllocation::SetGlobalDefaultPolicy(PolicyEnum policy)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->m_Policy = policy;
+}
+
+ImageBufferAllocation::PolicyEnum
+ImageBufferAllocation::GetGlobalDefaultPolicy()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->m_Policy;
+}
+
+void
+ImageBufferAllocation::SetGlobalDefaultParallelFirstTouch(bool parallelFirstTouch)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->m_ParallelFirstTouch = parallelFirstTouch;
+}
+
+bool
+ImageBufferAllocation::GetGlobalDefaultParallelFirstTouch()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->m_ParallelFirstTouch;
+}
+
+std::size_t
+ImageBufferAllocation::GetAlignment(PolicyEnum policy)
+{
+  switch (policy)
+  {
+    case PolicyEnum::CacheLineAligned:
+      return CacheLineSize;
+    case PolicyEnum::HugePageAligned:
+      return HugePageSize;
+    default:
+      return 0;
+  }
+}
+
+void *
+ImageBufferAllocation::AllocateAligned(std::size_t numberOfBytes, PolicyEnum policy)
+{
+  const std::size_t alignment = GetAlignment(policy);
+  void *            pointer = nullptr;
+  if (alignment != 0)
+  {
+    // Allocate at least one byte, so that a valid pointer is returned for
+    // empty buffers.
+    const std::size_t size = numberOfBytes > 0 ? numberOfBytes : 1;
+#if defined(_WIN32)
+    pointer = _aligned_malloc(size, alignment);
+#else
+    if (posix_memalign(&pointer, alignment, size) != 0)
+    {
+      pointer = nullptr;
+    }
+#endif
+  }
+  if (!pointer)
+  {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+  }
+#if defined(MADV_HUGEPAGE)
+  if (policy == PolicyEnum::HugePageAligned && numberOfBytes >= HugePageSize)
+  {
+    // Only a hint: the buffer is still valid if transparent huge pages are
+    // not available.
+    madvise(pointer, numberOfBytes, MADV_HUGEPAGE);
+  }
+#endif
+  return pointer;
+}
+
+void
+ImageBufferAllocation::DeallocateAligned(void * pointer)
+{
+#if defined(_WIN32)
+  _aligned_free(pointer);
+#else
+  free(pointer);
+#endif
+}
+
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const ImageBufferAllocationEnums::Policy value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case ImageBufferAllocationEnums::Policy::NewArray:
+        return "itk::ImageBufferAllocationEnums::Policy::NewArray";
+      case ImageBufferAllocationEnums::Policy::CacheLineAligned:
+        return "itk::ImageBufferAllocationEnums::Policy::CacheLineAligned";
+      case ImageBufferAllocationEnums::Policy::HugePageAligned:
+        return "itk::ImageBufferAllocationEnums::Policy::HugePageAligned";
+      default:
+        return "INVALID VALUE FOR itk::ImageBufferAllocationEnums::Policy";
+    }
+  }();
+}
+} // namespace itk
@@ -0,0 +1,284 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+#include "itkSingleton.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+#include <vector>
+
+namespace itk
+{
+
+struct ImageBufferPoolGlobals
+{
+  using KeyType = std::tuple<std::type_index, SizeValueType, ImageBufferPool::PolicyEnum>;
+
+  struct BufferType
+  {
+    void *                       m_Buffer;
+    SizeValueType                m_NumberOfBytes;
+    ImageBufferPool::DeleterType m_Deleter;
+    SizeValueType                m_ReleaseTime;
+  };
+
+  using BuffersType = std::multimap<KeyType, BufferType>;
+  using BufferListType = std::vector<BufferType>;
+
+  ImageBufferPoolGlobals() = default;
+  ~ImageBufferPoolGlobals() { Delete(this->TakeAll()); }
+
+  // Releases the buffers taken out of the pool. The mutex must not be
+  // locked, so that the other threads do not wait for the deleters.
+  static void
+  Delete(const BufferListType & buffers)
+  {
+    for (const BufferType & buffer : buffers)
+    {
+      buffer.m_Deleter(buffer.m_Buffer);
+    }
+  }
+
+  // Takes all the buffers out of the pool, to be released by Delete(). The
+  // mutex must be locked.
+  BufferListType
+  TakeAll()
+  {
+    BufferListType buffers;
+    buffers.reserve(m_Buffers.size());
+    for (const auto & keyAndBuffer : m_Buffers)
+    {
+      buffers.push_back(keyAndBuffer.second);
+    }
+    m_Buffers.clear();
+    m_BuffersByReleaseTime.clear();
+    m_NumberOfPooledBytes = 0;
+    return buffers;
+  }
+
+  // Takes the buffer out of the pool, without releasing it. The mutex must
+  // be locked.
+  void
+  Erase(BuffersType::iterator buffer)
+  {
+    m_NumberOfPooledBytes -= buffer->second.m_NumberOfBytes;
+    m_BuffersByReleaseTime.erase(buffer->second.m_ReleaseTime);
+    m_Buffers.erase(buffer);
+  }
+
+  // Takes the buffers given to the pool the longest ago out of it, until the
+  // pooled buffers hold at most the number of bytes. The evicted buffers are
+  // to be released by Delete(). The mutex must be locked.
+  BufferListType
+  EvictUntil(SizeValueType numberOfBytes)
+  {
+    BufferListType buffers;
+    while (m_NumberOfPooledBytes > numberOfBytes)
+    {
+      const BuffersType::iterator buffer = m_BuffersByReleaseTime.begin()->second;
+      buffers.push_back(buffer->second);
+      this->Erase(buffer);
+      ++m_NumberOfEvictions;
+    }
+    return buffers;
+  }
+
+  std::mutex                                     m_Mutex;
+  BuffersType                                    m_Buffers;
+  std::map<SizeValueType, BuffersType::iterator> m_BuffersByReleaseTime;
+  SizeValueType                                  m_ReleaseTime{ 0 };
+  std::atomic<bool>                              m_Enabled{ false };
+  SizeValueType                                  m_MaximumNumberOfPooledBytes{ SizeValueType{ 1 } << 30 };
+  SizeValueType                                  m_NumberOfPooledBytes{ 0 };
+  SizeValueType                                  m_NumberOfHits{ 0 };
+  SizeValueType                                  m_NumberOfMisses{ 0 };
+  SizeValueType                                  m_NumberOfEvictions{ 0 };
+};
+
+itkGetGlobalSimpleMacro(ImageBufferPool, ImageBufferPoolGlobals, PimplGlobals);
+
+ImageBufferPoolGlobals * ImageBufferPool::m_PimplGlobals;
+
+void
+ImageBufferPool::SetEnabled(bool enabled)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  ImageBufferPoolGlobals::BufferListType buffers;
+  {
+    const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+    m_PimplGlobals->m_Enabled = enabled;
+    if (!enabled)
+    {
+      buffers = m_PimplGlobals->TakeAll();
+    }
+  }
+  ImageBufferPoolGlobals::Delete(buffers);
+}
+
+bool
+ImageBufferPool::GetEnabled()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->m_Enabled;
+}
+
+void
+ImageBufferPool::SetMaximumNumberOfPooledBytes(SizeValueType numberOfBytes)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  ImageBufferPoolGlobals::BufferListType buffers;
+  {
+    const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+    m_PimplGlobals->m_MaximumNumberOfPooledBytes = numberOfBytes;
+    buffers = m_PimplGlobals->EvictUntil(numberOfBytes);
+  }
+  ImageBufferPoolGlobals::Delete(buffers);
+}
+
+SizeValueType
+ImageBufferPool::GetMaximumNumberOfPooledBytes()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_MaximumNumberOfPooledBytes;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfPooledBytes()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_NumberOfPooledBytes;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfHits()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_NumberOfHits;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfMisses()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_NumberOfMisses;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfEvictions()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_NumberOfEvictions;
+}
+
+void
+ImageBufferPool::ResetStatistics()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_NumberOfHits = 0;
+  m_PimplGlobals->m_NumberOfMisses = 0;
+  m_PimplGlobals->m_NumberOfEvictions = 0;
+}
+
+void
+ImageBufferPool::Clear()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  ImageBufferPoolGlobals::BufferListType buffers;
+  {
+    const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+    buffers = m_PimplGlobals->TakeAll();
+  }
+  ImageBufferPoolGlobals::Delete(buffers);
+}
+
+void *
+ImageBufferPool::Acquire(const std::type_info & elementType, SizeValueType numberOfElements, PolicyEnum policy)
+{
+  // The pool is disabled by default: the allocations of the images are then
+  // not serialized by the mutex.
+  itkInitGlobalsMacro(PimplGlobals);
+  if (!m_PimplGlobals->m_Enabled)
+  {
+    return nullptr;
+  }
+
+  const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+  if (!m_PimplGlobals->m_Enabled)
+  {
+    return nullptr;
+  }
+
+  const auto found =
+    m_PimplGlobals->m_Buffers.find(std::make_tuple(std::type_index(elementType), numberOfElements, policy));
+  if (found == m_PimplGlobals->m_Buffers.end())
+  {
+    ++m_PimplGlobals->m_NumberOfMisses;
+    return nullptr;
+  }
+  ++m_PimplGlobals->m_NumberOfHits;
+  void * buffer = found->second.m_Buffer;
+  m_PimplGlobals->Erase(found);
+  return buffer;
+}
+
+bool
+ImageBufferPool::Release(void *                 buffer,
+                         const std::type_info & elementType,
+                         SizeValueType          numberOfElements,
+                         SizeValueType          numberOfBytes,
+                         PolicyEnum             policy,
+                         DeleterType            deleter)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  if (!m_PimplGlobals->m_Enabled || buffer == nullptr)
+  {
+    return false;
+  }
+
+  ImageBufferPoolGlobals::BufferListType evictedBuffers;
+  {
+    const std::lock_guard<std::mutex> lock(m_PimplGlobals->m_Mutex);
+    if (!m_PimplGlobals->m_Enabled || numberOfBytes > m_PimplGlobals->m_MaximumNumberOfPooledBytes)
+    {
+      return false;
+    }
+
+    // Make room for the buffer, by evicting the least recently used ones, so
+    // that the pool follows the sizes of the images currently processed.
+    evictedBuffers = m_PimplGlobals->EvictUntil(m_PimplGlobals->m_MaximumNumberOfPooledBytes - numberOfBytes);
+
+    const SizeValueType                      releaseTime = ++m_PimplGlobals->m_ReleaseTime;
+    const ImageBufferPoolGlobals::BufferType pooledBuffer{ buffer, numberOfBytes, deleter, releaseTime };
+    const auto                               pooledBufferIt = m_PimplGlobals->m_Buffers.emplace(
+      std::make_tuple(std::type_index(elementType), numberOfElements, policy), pooledBuffer);
+    m_PimplGlobals->m_BuffersByReleaseTime.emplace(releaseTime, pooledBufferIt);
+    m_PimplGlobals->m_NumberOfPooledBytes += numberOfBytes;
+  }
+  ImageBufferPoolGlobals::Delete(evictedBuffers);
+  return true;
+}
+} // namespace itk
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImageBufferPool.h"
+#include "itkImage.h"
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+// Enables the pool for the lifetime of an object, and restores its default
+// state afterwards.
+class PoolEnabler
+{
+public:
+  PoolEnabler()
+  {
+    itk::ImageBufferPool::SetEnabled(true);
+    itk::ImageBufferPool::ResetStatistics();
+  }
+  ~PoolEnabler()
+  {
+    itk::ImageBufferPool::SetEnabled(false);
+    itk::ImageBufferPool::SetMaximumNumberOfPooledBytes(itk::SizeValueType{ 1 } << 30);
+    itk::ImageBufferPool::ResetStatistics();
+  }
+};
+
+template <typename TPixel>
+typename itk::Image<TPixel, 2>::Pointer
+CreateImage(const itk::SizeValueType sizeX, const bool initializePixels = false)
+{
+  const auto image = itk::Image<TPixel, 2>::New();
+  image->SetRegions(itk::Size<2>{ { sizeX, 16 } });
+  image->Allocate(initializePixels);
+  return image;
+}
+} // namespace
+
+
+// Tests that the pool is disabled by default.
+TEST(ImageBufferPool, IsDisabledByDefault)
+{
+  EXPECT_FALSE(itk::ImageBufferPool::GetEnabled());
+
+  CreateImage<float>(16);
+  CreateImage<float>(16);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfHits(), 0u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfMisses(), 0u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 0u);
+}
+
+
+// Tests that a buffer is reused for an image with the same pixel type and
+// number of pixels only.
+TEST(ImageBufferPool, ReusesBuffersOfSameTypeAndSize)
+{
+  const PoolEnabler poolEnabler;
+
+  const float * buffer = CreateImage<float>(16)->GetBufferPointer();
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfMisses(), 1u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 16 * 16 * sizeof(float));
+
+  EXPECT_EQ(CreateImage<float>(16)->GetBufferPointer(), buffer);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfHits(), 1u);
+
+  CreateImage<float>(17);
+  CreateImage<int>(16);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfHits(), 1u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfMisses(), 3u);
+
+  // a recycled buffer is initialized when requested
+  const auto image = CreateImage<float>(16);
+  image->FillBuffer(1.0f);
+  image->Initialize();
+  EXPECT_EQ(CreateImage<float>(16, true)->GetPixel({ { 15, 15 } }), 0.0f);
+
+  itk::ImageBufferPool::Clear();
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 0u);
+}
+
+
+// Tests that the pool does not keep more than its maximum number of bytes.
+TEST(ImageBufferPool, KeepsAtMostMaximumNumberOfPooledBytes)
+{
+  const PoolEnabler poolEnabler;
+
+  itk::ImageBufferPool::SetMaximumNumberOfPooledBytes(16 * 16 * sizeof(double));
+  {
+    const auto image1 = CreateImage<double>(16);
+    const auto image2 = CreateImage<double>(16);
+  }
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 16 * 16 * sizeof(double));
+
+  itk::ImageBufferPool::SetEnabled(false);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 0u);
+}
+
+
+// Tests that a full pool releases the buffers given to it the longest ago to
+// keep the ones of the images which are currently processed, when their size
+// changes.
+TEST(ImageBufferPool, EvictsLeastRecentlyReleasedBuffers)
+{
+  const PoolEnabler poolEnabler;
+
+  const itk::SizeValueType oldNumberOfBytes = 16 * 16 * sizeof(float);
+  const itk::SizeValueType newNumberOfBytes = 17 * 16 * sizeof(float);
+  itk::ImageBufferPool::SetMaximumNumberOfPooledBytes(2 * newNumberOfBytes);
+  {
+    const auto image1 = CreateImage<float>(16);
+    const auto image2 = CreateImage<float>(16);
+  }
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 2 * oldNumberOfBytes);
+
+  // the two buffers of the old size make room for the ones of the new size
+  {
+    const auto image1 = CreateImage<float>(17);
+    const auto image2 = CreateImage<float>(17);
+  }
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfEvictions(), 2u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 2 * newNumberOfBytes);
+
+  // which are then reused
+  {
+    const auto image1 = CreateImage<float>(17);
+    const auto image2 = CreateImage<float>(17);
+  }
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfHits(), 2u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfMisses(), 4u);
+
+  // a buffer larger than the pool does not evict the others
+  CreateImage<float>(64);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfEvictions(), 2u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), 2 * newNumberOfBytes);
+
+  // lowering the maximum evicts buffers until the others fit
+  itk::ImageBufferPool::SetMaximumNumberOfPooledBytes(newNumberOfBytes);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfEvictions(), 3u);
+  EXPECT_EQ(itk::ImageBufferPool::GetNumberOfPooledBytes(), newNumberOfBytes);
+}
@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImportImageContainer.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+// Test template instantiations for various TElement template arguments:
+template class itk::ImportImageContainer<itk::SizeValueType, double>;
+template class itk::ImportImageContainer<itk::SizeValueType, std::string>;
+
+
+namespace
+{
+using PolicyEnum = itk::ImageBufferAllocationEnums::Policy;
+
+constexpr PolicyEnum policies[] = { PolicyEnum::NewArray, PolicyEnum::CacheLineAligned, PolicyEnum::HugePageAligned };
+
+
+template <typename TElement>
+void
+Expect_Reserve_and_Squeeze_preserve_elements(const PolicyEnum policy, const bool parallelFirstTouch)
+{
+  const auto container = itk::ImportImageContainer<itk::SizeValueType, TElement>::New();
+  container->SetAllocationPolicy(policy);
+  container->SetParallelFirstTouch(parallelFirstTouch);
+
+  constexpr itk::SizeValueType size = 1000;
+  container->Reserve(size, true);
+  ASSERT_EQ(container->Size(), size);
+
+  const auto alignment = itk::ImageBufferAllocation::GetAlignment(policy);
+  if (alignment > 0)
+  {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(container->GetBufferPointer()) % alignment, 0u);
+  }
+
+  for (itk::SizeValueType i = 0; i < size; ++i)
+  {
+    EXPECT_EQ((*container)[i], TElement());
+    (*container)[i] = static_cast<TElement>(i);
+  }
+
+  container->Reserve(2 * size);
+  container->Reserve(size);
+  container->Squeeze();
+  ASSERT_EQ(container->Capacity(), size);
+
+  for (itk::SizeValueType i = 0; i < size; ++i)
+  {
+    EXPECT_EQ((*container)[i], static_cast<TElement>(i));
+  }
+  container->Initialize();
+  EXPECT_EQ(container->GetBufferPointer(), nullptr);
+}
+} // namespace
+
+
+// Tests the allocation policies, with and without parallel first touch.
+TEST(ImportImageContainer, ReserveAndSqueezePreserveElements)
+{
+  for (const auto policy : policies)
+  {
+    for (const bool parallelFirstTouch : { false, true })
+    {
+      Expect_Reserve_and_Squeeze_preserve_elements<unsigned char>(policy, parallelFirstTouch);
+      Expect_Reserve_and_Squeeze_preserve_elements<double>(policy, parallelFirstTouch);
+    }
+  }
+}
+
+
+// Tests that the elements are constructed and destructed, when the pixel
+// type is not trivial.
+TEST(ImportImageContainer, ConstructsNonTrivialElements)
+{
+  for (const auto policy : policies)
+  {
+    for (const bool parallelFirstTouch : { false, true })
+    {
+      const auto container = itk::ImportImageContainer<itk::SizeValueType, std::string>::New();
+      container->SetAllocationPolicy(policy);
+      container->SetParallelFirstTouch(parallelFirstTouch);
+      container->Reserve(100);
+      EXPECT_TRUE((*container)[99].empty());
+      (*container)[99] = "A string which is too long for the small string optimization";
+      container->Reserve(200);
+      EXPECT_EQ((*container)[99], "A string which is too long for the small string optimization");
+    }
+  }
+}
+
+
+// Tests that the global defaults are used by the new containers, and that
+// an image keeps the policy of its buffer when it is initialized again.
+TEST(ImportImageContainer, UsesGlobalDefaultPolicy)
+{
+  EXPECT_EQ(itk::ImageBufferAllocation::GetGlobalDefaultPolicy(), PolicyEnum::NewArray);
+  EXPECT_FALSE(itk::ImageBufferAllocation::GetGlobalDefaultParallelFirstTouch());
+
+  itk::ImageBufferAllocation::SetGlobalDefaultPolicy(PolicyEnum::CacheLineAligned);
+  itk::ImageBufferAllocation::SetGlobalDefaultParallelFirstTouch(true);
+
+  const auto image = itk::Image<float, 3>::New();
+  EXPECT_EQ(image->GetPixelContainer()->GetAllocationPolicy(), PolicyEnum::CacheLineAligned);
+  EXPECT_TRUE(image->GetPixelContainer()->GetParallelFirstTouch());
+
+  itk::ImageBufferAllocation::SetGlobalDefaultPolicy(PolicyEnum::NewArray);
+  itk::ImageBufferAllocation::SetGlobalDefaultParallelFirstTouch(false);
+
+  image->GetPixelContainer()->SetAllocationPolicy(PolicyEnum::HugePageAligned);
+  image->Initialize();
+  image->SetRegions(itk::Size<3>{ { 64, 64, 64 } });
+  image->Allocate(true);
+  EXPECT_EQ(image->GetPixelContainer()->GetAllocationPolicy(), PolicyEnum::HugePageAligned);
+  EXPECT_TRUE(image->GetPixelContainer()->GetParallelFirstTouch());
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(image->GetBufferPointer()) % itk::ImageBufferAllocation::HugePageSize,
+            0u);
+  EXPECT_EQ(image->GetPixel({ { 63, 63, 63 } }), 0.0f);
+}
+
+
+// Tests that an image without a pixel container can be initialized again,
+// with a container of the global default policy.
+TEST(ImportImageContainer, InitializesImageWithoutPixelContainer)
+{
+  const auto image = itk::Image<float, 2>::New();
+  image->SetPixelContainer(nullptr);
+  image->Initialize();
+  ASSERT_NE(image->GetPixelContainer(), nullptr);
+  EXPECT_EQ(image->GetPixelContainer()->GetAllocationPolicy(), itk::ImageBufferAllocation::GetGlobalDefaultPolicy());
+  image->SetPixelContainer(nullptr);
+  image->ReleaseData();
+  EXPECT_NE(image->GetPixelContainer(), nullptr);
+
+  const auto vectorImage = itk::VectorImage<float, 2>::New();
+  vectorImage->SetPixelContainer(nullptr);
+  vectorImage->Initialize();
+  EXPECT_NE(vectorImage->GetPixelContainer(), nullptr);
+}
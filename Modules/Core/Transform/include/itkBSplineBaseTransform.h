@@ -252,6 +252,27 @@ public:
                  ParameterIndexArrayType & indices,
                  bool &                    inside) const = 0;
 
+  using WeightsValueType = typename WeightsType::ValueType;
+  using ParameterIndexValueType = typename ParameterIndexArrayType::ValueType;
+
+  /**
+   * Transform a block of points by a BSpline deformable transformation, as
+   * the TransformPoint() above does for each of them, the weights and
+   * indices of the i-th point being stored from i * GetNumberOfWeights() in
+   * the weights and indices arrays. Together, they are the non-zero values
+   * of the Jacobians with respect to the parameters, which are left unset
+   * for the points that are not inside the grid.
+   * This default implementation calls TransformPoint() for each point;
+   * derived classes can share the work done for the points of the block.
+   */
+  virtual void
+  TransformPoints(const InputPointType *    inputPoints,
+                  SizeValueType             numberOfPoints,
+                  OutputPointType *         outputPoints,
+                  WeightsValueType *        weights,
+                  ParameterIndexValueType * indices,
+                  bool *                    inside) const;
+
   /** Get number of weights. */
   unsigned long
   GetNumberOfWeights() const
@@ -325,5 +325,29 @@ BSplineBaseTransform<TParametersValueType, NDimensions, VSplineOrder>::Transform
   return outputPoint;
 }
 
+// Transform a block of points
+template <typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineBaseTransform<TParametersValueType, NDimensions, VSplineOrder>::TransformPoints(
+  const InputPointType *    inputPoints,
+  SizeValueType             numberOfPoints,
+  OutputPointType *         outputPoints,
+  WeightsValueType *        weights,
+  ParameterIndexValueType * indices,
+  bool *                    inside) const
+{
+  const SizeValueType     numberOfWeights = this->m_WeightsFunction->GetNumberOfWeights();
+  WeightsType             pointWeights;
+  ParameterIndexArrayType pointIndices;
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    // The arrays of the point refer to the block ones
+    pointWeights.SetData(weights + i * numberOfWeights, numberOfWeights, false);
+    pointIndices.SetData(indices + i * numberOfWeights, numberOfWeights, false);
+    this->TransformPoint(inputPoints[i], outputPoints[i], pointWeights, pointIndices, inside[i]);
+  }
+}
+
 } // namespace itk
 #endif
@@ -239,6 +239,24 @@ public:
                  ParameterIndexArrayType & indices,
                  bool &                    inside) const override;
 
+  using WeightsValueType = typename Superclass::WeightsValueType;
+  using ParameterIndexValueType = typename Superclass::ParameterIndexValueType;
+
+  /**
+   * Transform a block of points, as TransformPoint() does for each of them.
+   * The offsets of the support region in the coefficient buffers are
+   * computed once for the block, and the weights of each point are the
+   * products of the weights of each dimension, which are then correlated
+   * with the coefficients by contiguous loops, instead of image iterators.
+   */
+  void
+  TransformPoints(const InputPointType *    inputPoints,
+                  SizeValueType             numberOfPoints,
+                  OutputPointType *         outputPoints,
+                  WeightsValueType *        weights,
+                  ParameterIndexValueType * indices,
+                  bool *                    inside) const override;
+
   /** Compute the Jacobian in one position. */
   void
   ComputeJacobianWithRespectToParameters(const InputPointType &, JacobianType &) const override;
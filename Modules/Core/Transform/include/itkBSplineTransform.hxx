@@ -597,6 +597,114 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::TransformPoin
   }
 }
 
+template <typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::TransformPoints(
+  const InputPointType *    inputPoints,
+  SizeValueType             numberOfPoints,
+  OutputPointType *         outputPoints,
+  WeightsValueType *        weights,
+  ParameterIndexValueType * indices,
+  bool *                    inside) const
+{
+  const ImageType * coefficientImage = this->m_CoefficientImages[0];
+  if (!coefficientImage->GetBufferPointer())
+  {
+    Superclass::TransformPoints(inputPoints, numberOfPoints, outputPoints, weights, indices, inside);
+    return;
+  }
+
+  constexpr unsigned int SupportSize = SplineOrder + 1;
+  const SizeValueType    numberOfWeights = this->m_WeightsFunction->GetNumberOfWeights();
+
+  // Offsets of the support region from its start index, the first dimension
+  // varying fastest, as the weights do
+  const OffsetValueType *      offsetTable = coefficientImage->GetOffsetTable();
+  std::vector<OffsetValueType> supportOffsets(numberOfWeights);
+  for (SizeValueType k = 0; k < numberOfWeights; ++k)
+  {
+    SizeValueType remainder = k;
+    supportOffsets[k] = 0;
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      supportOffsets[k] += static_cast<OffsetValueType>(remainder % SupportSize) * offsetTable[j];
+      remainder /= SupportSize;
+    }
+  }
+
+  const IndexType             bufferStart = coefficientImage->GetBufferedRegion().GetIndex();
+  const ParametersValueType * coefficients[SpaceDimension];
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    coefficients[j] = this->m_CoefficientImages[j]->GetBufferPointer();
+  }
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    const InputPointType & point = inputPoints[i];
+    OutputPointType &      outputPoint = outputPoints[i];
+
+    ContinuousIndexType index;
+    coefficientImage->TransformPhysicalPointToContinuousIndex(point, index);
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    inside[i] = this->InsideValidRegion(index);
+    if (!inside[i])
+    {
+      outputPoint = point;
+      continue;
+    }
+
+    typename WeightsFunctionType::OneDWeightsType weights1D;
+    IndexType                                     supportIndex;
+    this->m_WeightsFunction->EvaluateOneDWeights(index, weights1D, supportIndex);
+
+    // The weights of the first dimensions are multiplied by the weights of
+    // the next one, in place, which gives the products in the order of the
+    // dimensions, as BSplineInterpolationWeightFunction::Evaluate() does.
+    WeightsValueType * pointWeights = weights + i * numberOfWeights;
+    pointWeights[0] = 1.0;
+    SizeValueType numberOfProducts = 1;
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      for (unsigned int m = SupportSize; m-- > 0;)
+      {
+        const WeightsValueType weight = weights1D[j][m];
+        WeightsValueType *     products = pointWeights + m * numberOfProducts;
+        for (SizeValueType k = 0; k < numberOfProducts; ++k)
+        {
+          products[k] = pointWeights[k] * weight;
+        }
+      }
+      numberOfProducts *= SupportSize;
+    }
+
+    OffsetValueType supportStart = 0;
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      supportStart += (supportIndex[j] - bufferStart[j]) * offsetTable[j];
+    }
+    ParameterIndexValueType * pointIndices = indices + i * numberOfWeights;
+    for (SizeValueType k = 0; k < numberOfWeights; ++k)
+    {
+      pointIndices[k] = static_cast<ParameterIndexValueType>(supportStart + supportOffsets[k]);
+    }
+
+    // For each dimension, correlate coefficient with weights
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      const ParametersValueType * supportCoefficients = coefficients[j] + supportStart;
+      ScalarType                  displacement = NumericTraits<ScalarType>::ZeroValue();
+      for (SizeValueType k = 0; k < numberOfWeights; ++k)
+      {
+        displacement += static_cast<ScalarType>(pointWeights[k] * supportCoefficients[supportOffsets[k]]);
+      }
+      outputPoint[j] = displacement + point[j];
+    }
+  }
+}
+
 template <typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
 void
 BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::ComputeJacobianWithRespectToParameters(
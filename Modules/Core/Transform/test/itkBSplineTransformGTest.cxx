@@ -21,6 +21,8 @@
 
 #include "itkImageRegionConstIterator.h"
 
+#include <memory>
+
 namespace
 {
 
@@ -178,3 +180,149 @@ TEST(ITKBSplineTransform, Copying_Clone)
   bspline2 = bspline1->Clone();
   bspline_eq(bspline1.GetPointer(), bspline2.GetPointer(), "Clone");
 }
+
+namespace
+{
+
+// Checks that TransformPoints() gives the points, and the non-zero values of
+// the Jacobians, of TransformPoint() and ComputeJacobianWithRespectToParameters().
+template <typename TBSpline>
+void
+check_transform_points(const TBSpline * bspline, const std::vector<typename TBSpline::InputPointType> & points)
+{
+  using BaseType = typename TBSpline::Superclass;
+
+  const double        tolerance = std::numeric_limits<typename TBSpline::ScalarType>::epsilon();
+  const unsigned long numberOfWeights = bspline->GetNumberOfWeights();
+  const unsigned long numberOfParametersPerDimension = bspline->GetNumberOfParametersPerDimension();
+
+  std::vector<typename TBSpline::OutputPointType>         outputPoints(points.size());
+  std::vector<typename TBSpline::WeightsValueType>        weights(points.size() * numberOfWeights);
+  std::vector<typename TBSpline::ParameterIndexValueType> indices(points.size() * numberOfWeights);
+  std::unique_ptr<bool[]>                                 inside(new bool[points.size()]);
+
+  // the points of the default implementation, which are transformed one by one
+  std::vector<typename TBSpline::OutputPointType> basePoints(points.size());
+  std::vector<typename TBSpline::WeightsValueType> baseWeights(points.size() * numberOfWeights);
+  std::vector<typename TBSpline::ParameterIndexValueType> baseIndices(points.size() * numberOfWeights);
+  std::unique_ptr<bool[]>                                 baseInside(new bool[points.size()]);
+
+  bspline->TransformPoints(
+    points.data(), points.size(), outputPoints.data(), weights.data(), indices.data(), inside.get());
+  bspline->BaseType::TransformPoints(
+    points.data(), points.size(), basePoints.data(), baseWeights.data(), baseIndices.data(), baseInside.get());
+
+  typename TBSpline::JacobianType jacobian;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    ITK_EXPECT_VECTOR_NEAR(outputPoints[i], bspline->TransformPoint(points[i]), 1e-12) << "Point " << points[i];
+    ITK_EXPECT_VECTOR_NEAR(outputPoints[i], basePoints[i], 1e-12) << "Point " << points[i];
+    EXPECT_EQ(inside[i], baseInside[i]) << "Point " << points[i];
+
+    bspline->ComputeJacobianWithRespectToParameters(points[i], jacobian);
+    if (!inside[i])
+    {
+      EXPECT_EQ(jacobian.absolute_value_max(), 0.0) << "Point " << points[i];
+      continue;
+    }
+    double sumOfWeights = 0.0;
+    for (unsigned long k = i * numberOfWeights; k < (i + 1) * numberOfWeights; ++k)
+    {
+      EXPECT_NEAR(weights[k], baseWeights[k], 1e-15) << "Point " << points[i];
+      EXPECT_EQ(indices[k], baseIndices[k]) << "Point " << points[i];
+      for (unsigned int d = 0; d < TBSpline::SpaceDimension; ++d)
+      {
+        EXPECT_NEAR(jacobian(d, indices[k] + d * numberOfParametersPerDimension), weights[k], tolerance)
+          << "Point " << points[i];
+      }
+      sumOfWeights += weights[k];
+    }
+    EXPECT_NEAR(sumOfWeights, 1.0, 1e-12) << "Point " << points[i];
+  }
+}
+
+} // namespace
+
+TEST(ITKBSplineTransform, TransformPoints)
+{
+  using BSplineType = itk::BSplineTransform<double, 3, 3>;
+
+  BSplineType::MeshSizeType meshSize;
+  meshSize[0] = 4;
+  meshSize[1] = 5;
+  meshSize[2] = 3;
+  BSplineType::PhysicalDimensionsType dimensions;
+  dimensions[0] = 40.0;
+  dimensions[1] = 25.0;
+  dimensions[2] = 30.0;
+  BSplineType::OriginType origin;
+  origin[0] = -10.0;
+  origin[1] = 5.0;
+  origin[2] = 0.0;
+
+  BSplineType::Pointer bspline = BSplineType::New();
+  bspline->SetTransformDomainOrigin(origin);
+  bspline->SetTransformDomainPhysicalDimensions(dimensions);
+  bspline->SetTransformDomainMeshSize(meshSize);
+
+  BSplineType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int p = 0; p < parameters.Size(); ++p)
+  {
+    parameters[p] = std::sin(0.37 * p) * 2.0;
+  }
+  bspline->SetParameters(parameters);
+
+  // points spread over the domain, and beyond it
+  std::vector<BSplineType::InputPointType> points;
+  for (double x = -12.0; x <= 32.0; x += 3.3)
+  {
+    for (double y = 4.0; y <= 31.0; y += 4.1)
+    {
+      for (double z = -1.0; z <= 31.0; z += 5.7)
+      {
+        BSplineType::InputPointType point;
+        point[0] = x;
+        point[1] = y;
+        point[2] = z;
+        points.push_back(point);
+      }
+    }
+  }
+  check_transform_points(bspline.GetPointer(), points);
+
+  // the last corner of the domain, which is moved inside it
+  BSplineType::InputPointType corner;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    corner[d] = origin[d] + dimensions[d];
+  }
+  check_transform_points(bspline.GetPointer(), std::vector<BSplineType::InputPointType>(1, corner));
+
+  // a block without points
+  check_transform_points(bspline.GetPointer(), std::vector<BSplineType::InputPointType>());
+
+  // and a transform of another order, in another dimension
+  using BSpline2DType = itk::BSplineTransform<float, 2, 2>;
+  BSpline2DType::Pointer bspline2D = BSpline2DType::New();
+  BSpline2DType::MeshSizeType meshSize2D;
+  meshSize2D.Fill(6);
+  bspline2D->SetTransformDomainMeshSize(meshSize2D);
+  BSpline2DType::ParametersType parameters2D(bspline2D->GetNumberOfParameters());
+  for (unsigned int p = 0; p < parameters2D.Size(); ++p)
+  {
+    parameters2D[p] = 0.01f * std::cos(1.3f * p);
+  }
+  bspline2D->SetParameters(parameters2D);
+  std::vector<BSpline2DType::InputPointType> points2D;
+  for (float x = -0.1f; x <= 1.1f; x += 0.07f)
+  {
+    for (float y = -0.1f; y <= 1.1f; y += 0.09f)
+    {
+      BSpline2DType::InputPointType point;
+      point[0] = x;
+      point[1] = y;
+      points2D.push_back(point);
+    }
+  }
+  check_transform_points(bspline2D.GetPointer(), points2D);
+}
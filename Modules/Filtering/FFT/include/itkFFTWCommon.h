@@ -34,6 +34,7 @@
 #endif
 
 #include <mutex>
+#include <vector>
 
 namespace itk
 {
@@ -149,6 +150,14 @@ public:
       roflags = flags | FFTW_WISDOM_ONLY;
     }
     PlanType plan = fftwf_plan_dft_c2r(rank, n, in, out, roflags);
+#  ifndef ITK_USE_CUFFTW
+    if (plan == nullptr && FFTWGlobalConfiguration::GetShareWisdomCache())
+    {
+      // another process may have generated that wisdom since it was read
+      FFTWGlobalConfiguration::ImportDefaultWisdomFileFloat();
+      plan = fftwf_plan_dft_c2r(rank, n, in, out, roflags);
+    }
+#  endif
     if (plan == nullptr)
     {
       // no wisdom available for that plan
@@ -173,6 +182,10 @@ public:
       }
 #  ifndef ITK_USE_CUFFTW
       FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+      if (FFTWGlobalConfiguration::GetShareWisdomCache() && FFTWGlobalConfiguration::GetWriteWisdomCache())
+      {
+        FFTWGlobalConfiguration::MergeDefaultWisdomFileFloat();
+      }
 #  endif
     }
     itkAssertOrThrowMacro(plan != nullptr, "PLAN_CREATION_FAILED ");
@@ -251,6 +264,14 @@ public:
       roflags = flags | FFTW_WISDOM_ONLY;
     }
     PlanType plan = fftwf_plan_dft_r2c(rank, n, in, out, roflags);
+#  ifndef ITK_USE_CUFFTW
+    if (plan == nullptr && FFTWGlobalConfiguration::GetShareWisdomCache())
+    {
+      // another process may have generated that wisdom since it was read
+      FFTWGlobalConfiguration::ImportDefaultWisdomFileFloat();
+      plan = fftwf_plan_dft_r2c(rank, n, in, out, roflags);
+    }
+#  endif
     if (plan == nullptr)
     {
       // no wisdom available for that plan
@@ -275,6 +296,10 @@ public:
       }
 #  ifndef ITK_USE_CUFFTW
       FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+      if (FFTWGlobalConfiguration::GetShareWisdomCache() && FFTWGlobalConfiguration::GetWriteWisdomCache())
+      {
+        FFTWGlobalConfiguration::MergeDefaultWisdomFileFloat();
+      }
 #  endif
     }
     itkAssertOrThrowMacro(plan != nullptr, "PLAN_CREATION_FAILED ");
@@ -355,6 +380,14 @@ public:
       roflags = flags | FFTW_WISDOM_ONLY;
     }
     PlanType plan = fftwf_plan_dft(rank, n, in, out, sign, roflags);
+#  ifndef ITK_USE_CUFFTW
+    if (plan == nullptr && FFTWGlobalConfiguration::GetShareWisdomCache())
+    {
+      // another process may have generated that wisdom since it was read
+      FFTWGlobalConfiguration::ImportDefaultWisdomFileFloat();
+      plan = fftwf_plan_dft(rank, n, in, out, sign, roflags);
+    }
+#  endif
     if (plan == nullptr)
     {
       // no wisdom available for that plan
@@ -379,6 +412,10 @@ public:
       }
 #  ifndef ITK_USE_CUFFTW
       FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+      if (FFTWGlobalConfiguration::GetShareWisdomCache() && FFTWGlobalConfiguration::GetWriteWisdomCache())
+      {
+        FFTWGlobalConfiguration::MergeDefaultWisdomFileFloat();
+      }
 #  endif
     }
     itkAssertOrThrowMacro(plan != nullptr, "PLAN_CREATION_FAILED ");
@@ -386,6 +423,103 @@ public:
   }
 
 
+  /** Execute the transform of in into out with the plan of the plan cache of
+   * FFTWGlobalConfiguration if the plan cache is used, or with a new plan
+   * otherwise. */
+  static void
+  Execute_dft_c2r(int           rank,
+                  const int *   n,
+                  ComplexType * in,
+                  PixelType *   out,
+                  unsigned      flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    if (FFTWGlobalConfiguration::GetUsePlanCache())
+    {
+      const FFTWGlobalConfiguration::PlanKey key{ FFTWGlobalConfiguration::PlanKey::TransformEnum::ComplexToReal,
+                                                  std::vector<int>(n, n + rank),
+                                                  FFTW_BACKWARD,
+                                                  flags,
+                                                  threads,
+                                                  static_cast<void *>(in) == static_cast<void *>(out),
+                                                  fftwf_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                                  fftwf_alignment_of(out) };
+      const PlanType plan = FFTWGlobalConfiguration::GetCachedPlanFloat(
+        key, [=]() { return Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput); });
+      fftwf_execute_dft_c2r(plan, in, out);
+      return;
+    }
+#  endif
+    const PlanType plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+  }
+
+  static void
+  Execute_dft_r2c(int           rank,
+                  const int *   n,
+                  PixelType *   in,
+                  ComplexType * out,
+                  unsigned      flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    if (FFTWGlobalConfiguration::GetUsePlanCache())
+    {
+      const FFTWGlobalConfiguration::PlanKey key{ FFTWGlobalConfiguration::PlanKey::TransformEnum::RealToComplex,
+                                                  std::vector<int>(n, n + rank),
+                                                  FFTW_FORWARD,
+                                                  flags,
+                                                  threads,
+                                                  static_cast<void *>(in) == static_cast<void *>(out),
+                                                  fftwf_alignment_of(in),
+                                                  fftwf_alignment_of(reinterpret_cast<PixelType *>(out)) };
+      const PlanType plan = FFTWGlobalConfiguration::GetCachedPlanFloat(
+        key, [=]() { return Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput); });
+      fftwf_execute_dft_r2c(plan, in, out);
+      return;
+    }
+#  endif
+    const PlanType plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+  }
+
+  static void
+  Execute_dft(int           rank,
+              const int *   n,
+              ComplexType * in,
+              ComplexType * out,
+              int           sign,
+              unsigned      flags,
+              int           threads = 1,
+              bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    if (FFTWGlobalConfiguration::GetUsePlanCache())
+    {
+      const FFTWGlobalConfiguration::PlanKey key{ FFTWGlobalConfiguration::PlanKey::TransformEnum::ComplexToComplex,
+                                                  std::vector<int>(n, n + rank),
+                                                  sign,
+                                                  flags,
+                                                  threads,
+                                                  in == out,
+                                                  fftwf_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                                  fftwf_alignment_of(reinterpret_cast<PixelType *>(out)) };
+      const PlanType plan = FFTWGlobalConfiguration::GetCachedPlanFloat(
+        key, [=]() { return Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput); });
+      fftwf_execute_dft(plan, in, out);
+      return;
+    }
+#  endif
+    const PlanType plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+  }
+
   static void
   Execute(PlanType p)
   {
@@ -491,6 +625,14 @@ public:
       roflags = flags | FFTW_WISDOM_ONLY;
     }
     PlanType plan = fftw_plan_dft_c2r(rank, n, in, out, roflags);
+#  ifndef ITK_USE_CUFFTW
+    if (plan == nullptr && FFTWGlobalConfiguration::GetShareWisdomCache())
+    {
+      // another process may have generated that wisdom since it was read
+      FFTWGlobalConfiguration::ImportDefaultWisdomFileDouble();
+      plan = fftw_plan_dft_c2r(rank, n, in, out, roflags);
+    }
+#  endif
     if (plan == nullptr)
     {
       // no wisdom available for that plan
@@ -515,6 +657,10 @@ public:
       }
 #  ifndef ITK_USE_CUFFTW
       FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+      if (FFTWGlobalConfiguration::GetShareWisdomCache() && FFTWGlobalConfiguration::GetWriteWisdomCache())
+      {
+        FFTWGlobalConfiguration::MergeDefaultWisdomFileDouble();
+      }
 #  endif
     }
     itkAssertOrThrowMacro(plan != nullptr, "PLAN_CREATION_FAILED ");
@@ -592,6 +738,14 @@ public:
       roflags = flags | FFTW_WISDOM_ONLY;
     }
     PlanType plan = fftw_plan_dft_r2c(rank, n, in, out, roflags);
+#  ifndef ITK_USE_CUFFTW
+    if (plan == nullptr && FFTWGlobalConfiguration::GetShareWisdomCache())
+    {
+      // another process may have generated that wisdom since it was read
+      FFTWGlobalConfiguration::ImportDefaultWisdomFileDouble();
+      plan = fftw_plan_dft_r2c(rank, n, in, out, roflags);
+    }
+#  endif
     if (plan == nullptr)
     {
       // no wisdom available for that plan
@@ -616,6 +770,10 @@ public:
       }
 #  ifndef ITK_USE_CUFFTW
       FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+      if (FFTWGlobalConfiguration::GetShareWisdomCache() && FFTWGlobalConfiguration::GetWriteWisdomCache())
+      {
+        FFTWGlobalConfiguration::MergeDefaultWisdomFileDouble();
+      }
 #  endif
     }
     itkAssertOrThrowMacro(plan != nullptr, "PLAN_CREATION_FAILED ");
@@ -696,6 +854,14 @@ public:
       roflags = flags | FFTW_WISDOM_ONLY;
     }
     PlanType plan = fftw_plan_dft(rank, n, in, out, sign, roflags);
+#  ifndef ITK_USE_CUFFTW
+    if (plan == nullptr && FFTWGlobalConfiguration::GetShareWisdomCache())
+    {
+      // another process may have generated that wisdom since it was read
+      FFTWGlobalConfiguration::ImportDefaultWisdomFileDouble();
+      plan = fftw_plan_dft(rank, n, in, out, sign, roflags);
+    }
+#  endif
     if (plan == nullptr)
     {
       // no wisdom available for that plan
@@ -720,6 +886,10 @@ public:
       }
 #  ifndef ITK_USE_CUFFTW
       FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+      if (FFTWGlobalConfiguration::GetShareWisdomCache() && FFTWGlobalConfiguration::GetWriteWisdomCache())
+      {
+        FFTWGlobalConfiguration::MergeDefaultWisdomFileDouble();
+      }
 #  endif
     }
     itkAssertOrThrowMacro(plan != nullptr, "PLAN_CREATION_FAILED ");
@@ -727,6 +897,103 @@ public:
   }
 
 
+  /** Execute the transform of in into out with the plan of the plan cache of
+   * FFTWGlobalConfiguration if the plan cache is used, or with a new plan
+   * otherwise. */
+  static void
+  Execute_dft_c2r(int           rank,
+                  const int *   n,
+                  ComplexType * in,
+                  PixelType *   out,
+                  unsigned      flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    if (FFTWGlobalConfiguration::GetUsePlanCache())
+    {
+      const FFTWGlobalConfiguration::PlanKey key{ FFTWGlobalConfiguration::PlanKey::TransformEnum::ComplexToReal,
+                                                  std::vector<int>(n, n + rank),
+                                                  FFTW_BACKWARD,
+                                                  flags,
+                                                  threads,
+                                                  static_cast<void *>(in) == static_cast<void *>(out),
+                                                  fftw_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                                  fftw_alignment_of(out) };
+      const PlanType plan = FFTWGlobalConfiguration::GetCachedPlanDouble(
+        key, [=]() { return Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput); });
+      fftw_execute_dft_c2r(plan, in, out);
+      return;
+    }
+#  endif
+    const PlanType plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+  }
+
+  static void
+  Execute_dft_r2c(int           rank,
+                  const int *   n,
+                  PixelType *   in,
+                  ComplexType * out,
+                  unsigned      flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    if (FFTWGlobalConfiguration::GetUsePlanCache())
+    {
+      const FFTWGlobalConfiguration::PlanKey key{ FFTWGlobalConfiguration::PlanKey::TransformEnum::RealToComplex,
+                                                  std::vector<int>(n, n + rank),
+                                                  FFTW_FORWARD,
+                                                  flags,
+                                                  threads,
+                                                  static_cast<void *>(in) == static_cast<void *>(out),
+                                                  fftw_alignment_of(in),
+                                                  fftw_alignment_of(reinterpret_cast<PixelType *>(out)) };
+      const PlanType plan = FFTWGlobalConfiguration::GetCachedPlanDouble(
+        key, [=]() { return Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput); });
+      fftw_execute_dft_r2c(plan, in, out);
+      return;
+    }
+#  endif
+    const PlanType plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+  }
+
+  static void
+  Execute_dft(int           rank,
+              const int *   n,
+              ComplexType * in,
+              ComplexType * out,
+              int           sign,
+              unsigned      flags,
+              int           threads = 1,
+              bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    if (FFTWGlobalConfiguration::GetUsePlanCache())
+    {
+      const FFTWGlobalConfiguration::PlanKey key{ FFTWGlobalConfiguration::PlanKey::TransformEnum::ComplexToComplex,
+                                                  std::vector<int>(n, n + rank),
+                                                  sign,
+                                                  flags,
+                                                  threads,
+                                                  in == out,
+                                                  fftw_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                                  fftw_alignment_of(reinterpret_cast<PixelType *>(out)) };
+      const PlanType plan = FFTWGlobalConfiguration::GetCachedPlanDouble(
+        key, [=]() { return Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput); });
+      fftw_execute_dft(plan, in, out);
+      return;
+    }
+#  endif
+    const PlanType plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+  }
+
   static void
   Execute(PlanType p)
   {
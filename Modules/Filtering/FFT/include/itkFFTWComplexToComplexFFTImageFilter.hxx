@@ -77,10 +77,9 @@ FFTWComplexToComplexFFTImageFilter<TImage>::BeforeThreadedGenerateData()
     transformDirection = -1;
   }
 
-  typename FFTWProxyType::PlanType plan;
-  auto *                           in = (typename FFTWProxyType::ComplexType *)input->GetBufferPointer();
-  auto *                           out = (typename FFTWProxyType::ComplexType *)output->GetBufferPointer();
-  int                              flags = m_PlanRigor;
+  auto * in = (typename FFTWProxyType::ComplexType *)input->GetBufferPointer();
+  auto * out = (typename FFTWProxyType::ComplexType *)output->GetBufferPointer();
+  int    flags = m_PlanRigor;
   if (!m_CanUseDestructiveAlgorithm)
   {
     // if the input is about to be destroyed, there is no need to force fftw
@@ -95,11 +94,7 @@ FFTWComplexToComplexFFTImageFilter<TImage>::BeforeThreadedGenerateData()
     sizes[(ImageDimension - 1) - i] = inputSize[i];
   }
 
-  plan =
-    FFTWProxyType::Plan_dft(ImageDimension, sizes, in, out, transformDirection, flags, this->GetNumberOfWorkUnits());
-
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  FFTWProxyType::Execute_dft(ImageDimension, sizes, in, out, transformDirection, flags, this->GetNumberOfWorkUnits());
 }
 
 
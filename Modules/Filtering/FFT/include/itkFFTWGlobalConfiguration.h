@@ -35,6 +35,9 @@
 #  endif
 #  include <algorithm>
 #  include <cctype>
+#  include <functional>
+#  include <map>
+#  include <vector>
 
 struct FFTWGlobalConfigurationGlobals;
 
@@ -56,6 +59,12 @@ struct FFTWGlobalConfigurationGlobals;
 //                             file to be generated.  If this is
 //                             set, then ITK_FFTW_WISDOM_CACHE_BASE
 //                             is ignored.
+// ITK_FFTW_SHARE_WISDOM_CACHE - Defines if the wisdom file cache is
+//                              shared with other processes while they
+//                              run (it is "Off" by default)
+// ITK_FFTW_PLAN_CACHE - Defines if the plans are kept in a cache and
+//                      reused by the next transforms of the same
+//                      type and size (it is "Off" by default)
 //
 // The above behaviors can also be controlled by the application.
 //
@@ -192,6 +201,18 @@ private:
  * before calling FFTW unsafe functions. It also handle
  * cleanly the initialization and cleanup of FFTW.
  *
+ * The plans created by the FFTW filters may be kept in a plan cache,
+ * so that the next transforms of the same type, size and number of
+ * threads skip the planning and only execute the cached plan on their
+ * own buffers. The cached plans are shared by all the pipelines of the
+ * process, which may execute them concurrently.
+ *
+ * The wisdom cache file may also be shared by several processes while
+ * they run: the wisdom is then read again from the file when a plan is
+ * not found in the wisdom of the process, and the new wisdom is merged
+ * into the file as soon as it is generated. The file is locked while it
+ * is read or written.
+ *
  * This implementation was taken from the Insight Journal paper:
  * https://hdl.handle.net/10380/3154
  * or http://insight-journal.com/browse/publication/717
@@ -277,6 +298,83 @@ public:
   static bool
   GetWriteWisdomCache();
 
+  /**
+   * \brief Set/Get whether the wisdom file cache is shared with the
+   * other processes while they run
+   *
+   * If true, the wisdom file cache is read again before creating a plan
+   * which is not in the wisdom of the process, and, if WriteWisdomCache is
+   * true, the new wisdom is merged into the wisdom file cache as soon as it
+   * is generated, instead of at the end of the process. This avoids planning
+   * again the transforms that another process has already planned.
+   * If the environmental variable "ITK_FFTW_SHARE_WISDOM_CACHE", is set,
+   * then the environmental setting overrides default settings.
+   */
+  static void
+  SetShareWisdomCache(const bool & v);
+  static bool
+  GetShareWisdomCache();
+
+  /**
+   * \brief Set/Get whether the plans are kept in the plan cache
+   *
+   * If true, the FFTW filters get their plans from the plan cache, and
+   * only create a plan when there is no cached plan for the same type of
+   * transform, size, direction, planner flags, number of threads and
+   * alignment of the buffers.
+   * If the environmental variable "ITK_FFTW_PLAN_CACHE", is set,
+   * then the environmental setting overrides default settings.
+   */
+  static void
+  SetUsePlanCache(const bool & v);
+  static bool
+  GetUsePlanCache();
+
+  /** Destroy all the cached plans. This must not be called while an FFTW
+   * filter is running. */
+  static void
+  ClearPlanCache();
+
+#  if !defined(ITK_WRAPPING_PARSER)
+  /** \class PlanKey
+   * Identify a plan in the plan cache.
+   * \ingroup ITKFFT */
+  struct PlanKey
+  {
+    enum class TransformEnum : uint8_t
+    {
+      RealToComplex,
+      ComplexToReal,
+      ComplexToComplex
+    };
+
+    TransformEnum    Transform;
+    std::vector<int> Sizes;
+    int              Sign;
+    unsigned         Flags;
+    int              Threads;
+    bool             InPlace;
+    int              InputAlignment;
+    int              OutputAlignment;
+
+    bool
+    operator<(const PlanKey & other) const;
+  };
+
+#    if defined(ITK_USE_FFTWF)
+  /** Get the cached plan identified by key, or create it with createPlan
+   * and add it to the plan cache if there is none. The returned plan is owned
+   * by the plan cache and must only be executed with the new-array execute
+   * functions. */
+  static fftwf_plan
+  GetCachedPlanFloat(const PlanKey & key, const std::function<fftwf_plan()> & createPlan);
+#    endif
+#    if defined(ITK_USE_FFTWD)
+  static fftw_plan
+  GetCachedPlanDouble(const PlanKey & key, const std::function<fftw_plan()> & createPlan);
+#    endif
+#  endif
+
   /**
    * \brief Define the directory where
    * the wisdom cache will be placed.
@@ -331,6 +429,14 @@ public:
   static bool
   ExportWisdomFileFloat(const std::string & fname);
 
+  /** Merge the wisdom for the type double/float with the wisdom already
+   * stored in a file. The file is locked while it is read and written, so
+   * that the wisdom written by another process is not lost. */
+  static bool
+  MergeWisdomFileDouble(const std::string & fname);
+  static bool
+  MergeWisdomFileFloat(const std::string & fname);
+
   /** Import or export some wisdom for the type double to/from the default file */
   static bool
   ImportDefaultWisdomFileDouble();
@@ -343,6 +449,12 @@ public:
   static bool
   ExportDefaultWisdomFileFloat();
 
+  /** Merge the wisdom for the type double/float with the wisdom of the default file */
+  static bool
+  MergeDefaultWisdomFileDouble();
+  static bool
+  MergeDefaultWisdomFileFloat();
+
   /** Convenience functions to Import/Export both double and float default wisdom files */
   static bool
   ImportDefaultWisdomFile();
@@ -373,7 +485,21 @@ private:
   int         m_PlanRigor{ 0 };
   bool        m_WriteWisdomCache{ false };
   bool        m_ReadWisdomCache{ true };
+  bool        m_ShareWisdomCache{ false };
+  bool        m_UsePlanCache{ false };
   std::string m_WisdomCacheBase;
+
+  // m_PlanCacheLock protects the plan caches, but not the creation
+  // of the plans, which is protected by m_Lock.
+  std::mutex m_PlanCacheLock;
+#  if !defined(ITK_WRAPPING_PARSER)
+#    if defined(ITK_USE_FFTWF)
+  std::map<PlanKey, fftwf_plan> m_FloatPlanCache;
+#    endif
+#    if defined(ITK_USE_FFTWD)
+  std::map<PlanKey, fftw_plan> m_DoublePlanCache;
+#    endif
+#  endif
   // m_WriteWisdomCache Controls the behavior of default
   // wisdom file creation policies.
   WisdomFilenameGeneratorBase * m_WisdomFilenameGenerator;
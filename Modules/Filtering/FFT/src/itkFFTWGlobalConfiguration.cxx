@@ -33,9 +33,11 @@
 #    include <share.h>
 #  else
 #    include <sys/file.h>
+#    include <unistd.h>
 
 #    include <utility>
 #  endif
+#  include <tuple>
 
 #  include "itkObjectFactory.h"
 
@@ -138,6 +140,68 @@ isDeclineString(std::string response)
   return false;
 }
 
+#  ifndef _WIN32
+// Write the wisdom exported by exportWisdom to a file, after importing with
+// importWisdom the wisdom already stored in the file if merge is true. The
+// file is locked for exclusive access before it is read and truncated, so
+// that the other processes never read a partially written wisdom.
+template <typename TImportWisdom, typename TExportWisdom>
+static bool
+WriteLockedWisdomFile(const std::string & path,
+                      const bool          merge,
+                      TImportWisdom       importWisdom,
+                      TExportWisdom       exportWisdom)
+{
+  FILE * f = fopen(path.c_str(), "a+");
+  if (f == nullptr)
+  {
+    return false;
+  }
+  flock(fileno(f), LOCK_EX);
+  if (merge)
+  {
+    rewind(f);
+    importWisdom(f);
+  }
+  bool ret = (ftruncate(fileno(f), 0) == 0);
+  rewind(f);
+  exportWisdom(f);
+  ret = (fflush(f) == 0) && ret;
+  flock(fileno(f), LOCK_UN);
+  return (fclose(f) == 0) && ret;
+}
+#  endif
+
+// Get the plan identified by key from the cache, or create it and add it to
+// the cache. The plan is created without holding the lock of the cache, so
+// that the other pipelines can still get their cached plans in the meantime.
+template <typename TPlan, typename TDestroyPlan>
+static TPlan
+GetCachedPlan(std::mutex &                                         cacheLock,
+              std::map<FFTWGlobalConfiguration::PlanKey, TPlan> & cache,
+              const FFTWGlobalConfiguration::PlanKey &             key,
+              const std::function<TPlan()> &                       createPlan,
+              TDestroyPlan                                         destroyPlan)
+{
+  {
+    std::lock_guard<std::mutex> lock(cacheLock);
+    const auto                  it = cache.find(key);
+    if (it != cache.end())
+    {
+      return it->second;
+    }
+  }
+  TPlan                       plan = createPlan();
+  std::lock_guard<std::mutex> lock(cacheLock);
+  const auto                  inserted = cache.emplace(key, plan);
+  if (!inserted.second)
+  {
+    // Another thread has cached the same plan in the meantime.
+    destroyPlan(plan);
+  }
+  return inserted.first->second;
+}
+
 itkGetGlobalSimpleMacro(FFTWGlobalConfiguration, FFTWGlobalConfigurationGlobals, PimplGlobals);
 
 FFTWGlobalConfigurationGlobals * FFTWGlobalConfiguration::m_PimplGlobals;
@@ -475,6 +539,21 @@ FFTWGlobalConfiguration ::FFTWGlobalConfiguration()
     }
   }
 
+  {
+    // The wisdom file cache is only shared with the other processes
+    // while they run on request
+    std::string share_env;
+    const bool  envITK_FFTW_SHARE_WISDOM_CACHEfound =
+      itksys::SystemTools::GetEnv("ITK_FFTW_SHARE_WISDOM_CACHE", share_env);
+    this->m_ShareWisdomCache = envITK_FFTW_SHARE_WISDOM_CACHEfound && !isDeclineString(share_env);
+  }
+  {
+    // The plans are only cached on request
+    std::string plan_cache_env;
+    const bool  envITK_FFTW_PLAN_CACHEfound = itksys::SystemTools::GetEnv("ITK_FFTW_PLAN_CACHE", plan_cache_env);
+    this->m_UsePlanCache = envITK_FFTW_PLAN_CACHEfound && !isDeclineString(plan_cache_env);
+  }
+
   if (this->m_ReadWisdomCache)
   {
     std::string cachePath = m_WisdomFilenameGenerator->GenerateWisdomFilename(m_WisdomCacheBase);
@@ -494,21 +573,29 @@ FFTWGlobalConfiguration ::~FFTWGlobalConfiguration()
   if (this->m_WriteWisdomCache && this->m_NewWisdomAvailable)
   {
     std::string cachePath = m_WisdomFilenameGenerator->GenerateWisdomFilename(m_WisdomCacheBase);
+    // merge with the wisdom files to be sure to not erase the wisdom saved in another process
 #  if defined(ITK_USE_FFTWF)
-    {
-      // import the wisdom files again to be sure to not erase the wisdom saved in another process
-      ImportWisdomFileFloat(cachePath + "f");
-      ExportWisdomFileFloat(cachePath + "f");
-    }
+    MergeWisdomFileFloat(cachePath + "f");
 #  endif
 #  if defined(ITK_USE_FFTWD)
-    {
-      // import the wisdom files again to be sure to not erase the wisdom saved in another process
-      ImportWisdomFileDouble(cachePath);
-      ExportWisdomFileDouble(cachePath);
-    }
+    MergeWisdomFileDouble(cachePath);
+#  endif
+  }
+  // The cached plans must be destroyed before the cleanup of fftw
+#  if defined(ITK_USE_FFTWF)
+  for (const auto & cachedPlan : this->m_FloatPlanCache)
+  {
+    fftwf_destroy_plan(cachedPlan.second);
+  }
+  this->m_FloatPlanCache.clear();
 #  endif
+#  if defined(ITK_USE_FFTWD)
+  for (const auto & cachedPlan : this->m_DoublePlanCache)
+  {
+    fftw_destroy_plan(cachedPlan.second);
   }
+  this->m_DoublePlanCache.clear();
+#  endif
 #  if defined(ITK_USE_FFTWF)
 #    if !defined(_WIN32) || defined(ITK_STATIC)
   // Cannot be called with shared libs on Windows because FFTW does not check
@@ -592,6 +679,18 @@ FFTWGlobalConfiguration ::ExportDefaultWisdomFileDouble()
   return ExportWisdomFileDouble(GetWisdomFileDefaultBaseName());
 }
 
+bool
+FFTWGlobalConfiguration ::MergeDefaultWisdomFileFloat()
+{
+  return MergeWisdomFileFloat(GetWisdomFileDefaultBaseName() + "f");
+}
+
+bool
+FFTWGlobalConfiguration ::MergeDefaultWisdomFileDouble()
+{
+  return MergeWisdomFileDouble(GetWisdomFileDefaultBaseName());
+}
+
 bool
 FFTWGlobalConfiguration ::ImportWisdomFileFloat(const std::string &
 #  if defined(ITK_USE_FFTWF) // Only define if ITK_USE_FFTWF, to avoid compiler warning
@@ -689,14 +788,7 @@ FFTWGlobalConfiguration ::ExportWisdomFileFloat(const std::string &
   }
 #    else
   std::cout << "Trying to write : " << path << std::endl;
-  FILE * f = fopen(path.c_str(), "w");
-  if (f)
-  {
-    flock(fileno(f), LOCK_EX);
-    fftwf_export_wisdom_to_file(f);
-    flock(fileno(f), LOCK_UN);
-    ret = (fclose(f) != 0);
-  }
+  ret = WriteLockedWisdomFile(path, false, fftwf_import_wisdom_from_file, fftwf_export_wisdom_to_file);
 #    endif
 #  endif
   return ret;
@@ -724,19 +816,123 @@ FFTWGlobalConfiguration ::ExportWisdomFileDouble(const std::string &
   }
 #    else
   std::cout << "Trying to write : " << path << std::endl;
-  FILE * f = fopen(path.c_str(), "w");
-  if (f)
+  ret = WriteLockedWisdomFile(path, false, fftw_import_wisdom_from_file, fftw_export_wisdom_to_file);
+#    endif
+#  endif
+  return ret;
+}
+
+bool
+FFTWGlobalConfiguration ::MergeWisdomFileFloat(const std::string &
+#  if defined(ITK_USE_FFTWF) // Only define if ITK_USE_FFTWF, to avoid compiler warning
+                                                 path
+#  endif
+)
+{
+  bool ret = false;
+#  if defined(ITK_USE_FFTWF)
   {
-    flock(fileno(f), LOCK_EX);
-    fftw_export_wisdom_to_file(f);
-    flock(fileno(f), LOCK_UN);
-    ret = (fclose(f) != 0);
+    // If necessary, make a directory for writing the file.
+    const std::string directoryName = itksys::SystemTools::GetParentDirectory(path.c_str());
+    itksys::SystemTools::MakeDirectory(directoryName.c_str());
   }
+#    ifdef _WIN32
+  ImportWisdomFileFloat(path);
+  ret = ExportWisdomFileFloat(path);
+#    else
+  ret = WriteLockedWisdomFile(path, true, fftwf_import_wisdom_from_file, fftwf_export_wisdom_to_file);
 #    endif
 #  endif
   return ret;
 }
 
+bool
+FFTWGlobalConfiguration ::MergeWisdomFileDouble(const std::string &
+#  if defined(ITK_USE_FFTWD) // Only define if ITK_USE_FFTWD, to avoid compiler warning
+                                                  path
+#  endif
+)
+{
+  bool ret = false;
+#  if defined(ITK_USE_FFTWD)
+  {
+    // If necessary, make a directory for writing the file.
+    const std::string directoryName = itksys::SystemTools::GetParentDirectory(path.c_str());
+    itksys::SystemTools::MakeDirectory(directoryName.c_str());
+  }
+#    ifdef _WIN32
+  ImportWisdomFileDouble(path);
+  ret = ExportWisdomFileDouble(path);
+#    else
+  ret = WriteLockedWisdomFile(path, true, fftw_import_wisdom_from_file, fftw_export_wisdom_to_file);
+#    endif
+#  endif
+  return ret;
+}
+
+bool
+FFTWGlobalConfiguration::PlanKey::operator<(const PlanKey & other) const
+{
+  return std::tie(Transform, Sizes, Sign, Flags, Threads, InPlace, InputAlignment, OutputAlignment) <
+         std::tie(other.Transform,
+                  other.Sizes,
+                  other.Sign,
+                  other.Flags,
+                  other.Threads,
+                  other.InPlace,
+                  other.InputAlignment,
+                  other.OutputAlignment);
+}
+
+#  if defined(ITK_USE_FFTWF)
+fftwf_plan
+FFTWGlobalConfiguration ::GetCachedPlanFloat(const PlanKey & key, const std::function<fftwf_plan()> & createPlan)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  Pointer instance = GetInstance();
+  return GetCachedPlan(instance->m_PlanCacheLock, instance->m_FloatPlanCache, key, createPlan, [](fftwf_plan plan) {
+    std::lock_guard<MutexType> lock(GetLockMutex());
+    fftwf_destroy_plan(plan);
+  });
+}
+#  endif
+
+#  if defined(ITK_USE_FFTWD)
+fftw_plan
+FFTWGlobalConfiguration ::GetCachedPlanDouble(const PlanKey & key, const std::function<fftw_plan()> & createPlan)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  Pointer instance = GetInstance();
+  return GetCachedPlan(instance->m_PlanCacheLock, instance->m_DoublePlanCache, key, createPlan, [](fftw_plan plan) {
+    std::lock_guard<MutexType> lock(GetLockMutex());
+    fftw_destroy_plan(plan);
+  });
+}
+#  endif
+
+void
+FFTWGlobalConfiguration ::ClearPlanCache()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  Pointer                     instance = GetInstance();
+  std::lock_guard<std::mutex> cacheLock(instance->m_PlanCacheLock);
+  std::lock_guard<MutexType>  lock(instance->m_Lock);
+#  if defined(ITK_USE_FFTWF)
+  for (const auto & cachedPlan : instance->m_FloatPlanCache)
+  {
+    fftwf_destroy_plan(cachedPlan.second);
+  }
+  instance->m_FloatPlanCache.clear();
+#  endif
+#  if defined(ITK_USE_FFTWD)
+  for (const auto & cachedPlan : instance->m_DoublePlanCache)
+  {
+    fftw_destroy_plan(cachedPlan.second);
+  }
+  instance->m_DoublePlanCache.clear();
+#  endif
+}
+
 std::mutex &
 FFTWGlobalConfiguration ::GetLockMutex()
 {
@@ -812,6 +1008,34 @@ FFTWGlobalConfiguration ::GetWriteWisdomCache()
   return GetInstance()->m_WriteWisdomCache;
 }
 
+void
+FFTWGlobalConfiguration ::SetShareWisdomCache(const bool & v)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  GetInstance()->m_ShareWisdomCache = v;
+}
+
+bool
+FFTWGlobalConfiguration ::GetShareWisdomCache()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return GetInstance()->m_ShareWisdomCache;
+}
+
+void
+FFTWGlobalConfiguration ::SetUsePlanCache(const bool & v)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  GetInstance()->m_UsePlanCache = v;
+}
+
+bool
+FFTWGlobalConfiguration ::GetUsePlanCache()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return GetInstance()->m_UsePlanCache;
+}
+
 
 void
 FFTWGlobalConfiguration ::SetWisdomCacheBase(const std::string & v)
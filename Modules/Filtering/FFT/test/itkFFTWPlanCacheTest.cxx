@@ -0,0 +1,212 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTWForwardFFTImageFilter.h"
+#include "itkFFTWInverseFFTImageFilter.h"
+#include "itkFFTWRealToHalfHermitianForwardFFTImageFilter.h"
+#include "itkFFTWHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkFFTWComplexToComplexFFTImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+#if defined(ITK_USE_FFTWD)
+using PixelType = double;
+#else
+using PixelType = float;
+#endif
+constexpr unsigned int Dimension = 3;
+using RealImageType = itk::Image<PixelType, Dimension>;
+using ComplexImageType = itk::Image<std::complex<PixelType>, Dimension>;
+
+RealImageType::Pointer
+CreateRandomImage(const RealImageType::SizeType & size, unsigned int seed)
+{
+  auto image = RealImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  std::mt19937                              randomNumberEngine(seed);
+  std::uniform_real_distribution<PixelType> distribution(-1.0, 1.0);
+  for (itk::ImageRegionIterator<RealImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(distribution(randomNumberEngine));
+  }
+  return image;
+}
+
+// Runs all the FFTW filters on the image, and accumulates the real part of
+// their outputs in a single image, so that a single comparison checks all of
+// them.
+RealImageType::Pointer
+RunFFTWFilters(const RealImageType * image)
+{
+  auto forward = itk::FFTWForwardFFTImageFilter<RealImageType>::New();
+  forward->SetInput(image);
+
+  auto inverse = itk::FFTWInverseFFTImageFilter<ComplexImageType>::New();
+  inverse->SetInput(forward->GetOutput());
+
+  auto complexToComplex = itk::FFTWComplexToComplexFFTImageFilter<ComplexImageType>::New();
+  complexToComplex->SetInput(forward->GetOutput());
+
+  auto halfForward = itk::FFTWRealToHalfHermitianForwardFFTImageFilter<RealImageType>::New();
+  halfForward->SetInput(image);
+
+  auto halfInverse = itk::FFTWHalfHermitianToRealInverseFFTImageFilter<ComplexImageType>::New();
+  halfInverse->SetInput(halfForward->GetOutput());
+  halfInverse->SetActualXDimensionIsOdd(image->GetLargestPossibleRegion().GetSize(0) % 2 != 0);
+
+  inverse->Update();
+  complexToComplex->Update();
+  halfInverse->Update();
+
+  auto output = RealImageType::New();
+  output->SetRegions(image->GetLargestPossibleRegion());
+  output->Allocate();
+
+  itk::ImageRegionConstIterator<RealImageType>    inverseIt(inverse->GetOutput(), image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ComplexImageType> complexIt(complexToComplex->GetOutput(),
+                                                            image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<RealImageType>    halfInverseIt(halfInverse->GetOutput(),
+                                                             image->GetLargestPossibleRegion());
+  for (itk::ImageRegionIterator<RealImageType> it(output, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it, ++inverseIt, ++complexIt, ++halfInverseIt)
+  {
+    it.Set(inverseIt.Get() + complexIt.Get().real() + halfInverseIt.Get());
+  }
+  return output;
+}
+
+bool
+CompareImages(const RealImageType * expected, const RealImageType * actual)
+{
+  itk::ImageRegionConstIterator<RealImageType> expectedIt(expected, expected->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<RealImageType> actualIt(actual, actual->GetLargestPossibleRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (itk::Math::abs(expectedIt.Get() - actualIt.Get()) > 1e-4 * std::max(1.0, itk::Math::abs(expectedIt.Get())))
+    {
+      std::cerr << "Expected " << expectedIt.Get() << ", actual " << actualIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkFFTWPlanCacheTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+#ifndef ITK_USE_CUFFTW
+  itk::FFTWGlobalConfiguration::SetUsePlanCache(true);
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::GetUsePlanCache());
+  itk::FFTWGlobalConfiguration::SetUsePlanCache(false);
+  ITK_TEST_EXPECT_TRUE(!itk::FFTWGlobalConfiguration::GetUsePlanCache());
+
+  itk::FFTWGlobalConfiguration::SetShareWisdomCache(true);
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::GetShareWisdomCache());
+  itk::FFTWGlobalConfiguration::SetShareWisdomCache(false);
+  ITK_TEST_EXPECT_TRUE(!itk::FFTWGlobalConfiguration::GetShareWisdomCache());
+
+  const RealImageType::SizeType sizes[] = { { { 16, 9, 5 } }, { { 7, 12, 6 } } };
+
+  // The outputs computed with a new plan for each transform are the reference
+  std::vector<RealImageType::Pointer> images;
+  std::vector<RealImageType::Pointer> expectedOutputs;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    images.push_back(CreateRandomImage(sizes[i % 2], i));
+    expectedOutputs.push_back(RunFFTWFilters(images.back()));
+  }
+
+  bool passed = true;
+
+  // The cached plans are reused for the images of the same size
+  itk::FFTWGlobalConfiguration::SetUsePlanCache(true);
+  for (unsigned int i = 0; i < images.size(); ++i)
+  {
+    if (!CompareImages(expectedOutputs[i], RunFFTWFilters(images[i])))
+    {
+      std::cerr << "Test failed with the plan cache for the image " << i << std::endl;
+      passed = false;
+    }
+  }
+
+  // The cached plans are executed concurrently by several pipelines
+  std::vector<RealImageType::Pointer> concurrentOutputs(images.size());
+  std::vector<std::thread>            threads;
+  for (unsigned int i = 0; i < images.size(); ++i)
+  {
+    threads.emplace_back([&, i]() { concurrentOutputs[i] = RunFFTWFilters(images[i]); });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+  for (unsigned int i = 0; i < images.size(); ++i)
+  {
+    if (!CompareImages(expectedOutputs[i], concurrentOutputs[i]))
+    {
+      std::cerr << "Test failed with concurrent pipelines for the image " << i << std::endl;
+      passed = false;
+    }
+  }
+
+  itk::FFTWGlobalConfiguration::ClearPlanCache();
+  if (!CompareImages(expectedOutputs[0], RunFFTWFilters(images[0])))
+  {
+    std::cerr << "Test failed after clearing the plan cache" << std::endl;
+    passed = false;
+  }
+  itk::FFTWGlobalConfiguration::SetUsePlanCache(false);
+
+  // The wisdom merged into a file can be read back
+  const std::string wisdomFile = std::string(argv[1]) + "/itkFFTWPlanCacheTest.wisdom";
+#  if defined(ITK_USE_FFTWD)
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::ExportWisdomFileDouble(wisdomFile));
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::MergeWisdomFileDouble(wisdomFile));
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::ImportWisdomFileDouble(wisdomFile));
+#  else
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::ExportWisdomFileFloat(wisdomFile));
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::MergeWisdomFileFloat(wisdomFile));
+  ITK_TEST_EXPECT_TRUE(itk::FFTWGlobalConfiguration::ImportWisdomFileFloat(wisdomFile));
+#  endif
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+#endif
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
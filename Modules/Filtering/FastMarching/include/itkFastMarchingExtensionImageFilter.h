@@ -145,6 +145,14 @@ protected:
   double
   UpdateValue(const IndexType & index, const SpeedImageType * speed, LevelSetImageType * output) override;
 
+  /** The auxiliary values are extended by UpdateValue(), which the parallel
+   * solver does not call. */
+  bool
+  CanUseParallelSolver() const override
+  {
+    return false;
+  }
+
   /** Generate the output image meta information */
   void
   GenerateOutputInformation() override;
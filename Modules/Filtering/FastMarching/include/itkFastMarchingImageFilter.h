@@ -115,6 +115,29 @@ extern ITKFastMarching_EXPORT std::ostream &
  *
  * For an alternative implementation, see itk::FastMarchingImageFilter.
  *
+ * Parallel solver:
+ * When UseParallelSolver is on, the arrival times are not computed by the
+ * sequential heap-based loop, but by a block-based fast iterative method
+ * (Jeong and Whitaker, "A Fast Iterative Method for Eikonal Equations",
+ * SIAM J. Sci. Comput. 30(5), 2008). The image is divided into blocks of
+ * ParallelSolverBlockSize pixels along each dimension. The active blocks
+ * are repeatedly relaxed by the same upwind update that fast marching uses,
+ * until their values no longer decrease, after which their neighboring
+ * blocks are activated. Blocks are processed concurrently by the filter's
+ * multi-threader, in two passes of a checkerboard ordering, so that no two
+ * adjacent blocks are ever updated at the same time. Both solvers converge
+ * to the solution of the same discrete upwind scheme; the arrival times
+ * only differ by floating point round-off (a relative difference of the
+ * order of the epsilon of the level set pixel type), for all pixels whose
+ * arrival time does not exceed the stopping value. Pixels beyond the
+ * stopping value are labeled as TrialPoint or FarPoint, but their values
+ * are not guaranteed to match those of the sequential solver. The parallel
+ * solver processes its points in no particular order, so the collected
+ * processed points are sorted by arrival time afterwards.
+ * Subclasses that customize the processing of individual points (like
+ * FastMarchingExtensionImageFilter and FastMarchingUpwindGradientImageFilter)
+ * do not support the parallel solver, and always use the sequential one.
+ *
  * Possible Improvements:
  * In the current implementation, std::priority_queue only allows
  * taking nodes out from the front and putting nodes in from the back.
@@ -375,6 +398,19 @@ public:
   itkGetConstReferenceMacro(OverrideOutputInformation, bool);
   itkBooleanMacro(OverrideOutputInformation);
 
+  /** Set/Get whether the arrival times are computed by the multithreaded
+   * block-based fast iterative solver, instead of the sequential fast
+   * marching loop. Off by default. Ignored by subclasses for which
+   * CanUseParallelSolver() returns false. */
+  itkSetMacro(UseParallelSolver, bool);
+  itkGetConstReferenceMacro(UseParallelSolver, bool);
+  itkBooleanMacro(UseParallelSolver);
+
+  /** Set/Get the number of pixels along each dimension of the blocks that
+   * the parallel solver processes concurrently. Defaults to 8. */
+  itkSetClampMacro(ParallelSolverBlockSize, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(ParallelSolverBlockSize, unsigned int);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<SetDimension, SpeedImageDimension>));
@@ -408,6 +444,20 @@ protected:
   void
   GenerateData() override;
 
+  /** Tells whether the parallel solver may be used instead of the sequential
+   * loop. Subclasses that override UpdateValue() or UpdateNeighbors() to do
+   * additional work per point should return false. */
+  virtual bool
+  CanUseParallelSolver() const
+  {
+    return true;
+  }
+
+  /** Computes the arrival times of all far points of the output, after
+   * Initialize(), by the block-based fast iterative method. */
+  void
+  GenerateDataInParallel(const SpeedImageType * speedImage, LevelSetImageType * output);
+
   /** Generate the output image meta information. */
   void
   GenerateOutputInformation() override;
@@ -462,6 +512,9 @@ private:
   HeapType m_TrialHeap;
 
   double m_NormalizationFactor;
+
+  bool         m_UseParallelSolver{ false };
+  unsigned int m_ParallelSolverBlockSize{ 8 };
 };
 } // namespace itk
 
@@ -20,9 +20,12 @@
 
 #include "itkFastMarchingImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkIndexRange.h"
 #include "itkNumericTraits.h"
 #include "itkMath.h"
 #include <algorithm>
+#include <utility>
+#include <vector>
 #include "itkMath.h"
 
 namespace itk
@@ -81,6 +84,8 @@ FastMarchingImageFilter<TLevelSet, TSpeedImage>::PrintSelf(std::ostream & os, In
   os << indent << "OutputOrigin:  " << m_OutputOrigin << std::endl;
   os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
   os << indent << "OutputDirection: " << m_OutputDirection << std::endl;
+  os << indent << "UseParallelSolver: " << m_UseParallelSolver << std::endl;
+  os << indent << "ParallelSolverBlockSize: " << m_ParallelSolverBlockSize << std::endl;
 }
 
 template <typename TLevelSet, typename TSpeedImage>
@@ -290,6 +295,13 @@ FastMarchingImageFilter<TLevelSet, TSpeedImage>::GenerateData()
 
   this->UpdateProgress(0.0); // Send first progress event
 
+  if (m_UseParallelSolver && this->CanUseParallelSolver())
+  {
+    this->GenerateDataInParallel(speedImage, output);
+    this->UpdateProgress(1.0);
+    return;
+  }
+
   // CACHE
   while (!m_TrialHeap.empty())
   {
@@ -504,6 +516,319 @@ FastMarchingImageFilter<TLevelSet, TSpeedImage>::UpdateValue(const IndexType &
 
   return solution;
 }
+
+template <typename TLevelSet, typename TSpeedImage>
+void
+FastMarchingImageFilter<TLevelSet, TSpeedImage>::GenerateDataInParallel(const SpeedImageType * speedImage,
+                                                                        LevelSetImageType *    output)
+{
+  // The trial points were pushed onto the heap by Initialize(), but the
+  // parallel solver does not use it.
+  while (!m_TrialHeap.empty())
+  {
+    m_TrialHeap.pop();
+  }
+
+  PixelType * const             outputBuffer = output->GetBufferPointer();
+  LabelEnum * const             labelBuffer = m_LabelImage->GetBufferPointer();
+  const OffsetValueType * const offsetTable = output->GetOffsetTable();
+  const OutputSpacingType       spacing = output->GetSpacing();
+  const auto                    largeValue = static_cast<double>(m_LargeValue);
+
+  double spaceFactors[SetDimension];
+  for (unsigned int j = 0; j < SetDimension; ++j)
+  {
+    spaceFactors[j] = itk::Math::sqr(1.0 / spacing[j]);
+  }
+
+  // The upwind update of UpdateValue(), except that it uses the current
+  // values of all neighbors (other than outside points), and that it is
+  // thread-safe: it only reads the output buffer.
+  const auto solve = [&](const IndexType & index, const OffsetValueType offset) -> double {
+    std::pair<double, unsigned int> neighbors[SetDimension];
+
+    for (unsigned int j = 0; j < SetDimension; ++j)
+    {
+      double minimum = largeValue;
+
+      if (index[j] > m_StartIndex[j])
+      {
+        const OffsetValueType neighborOffset = offset - offsetTable[j];
+        if (labelBuffer[neighborOffset] != LabelEnum::OutsidePoint)
+        {
+          minimum = std::min(minimum, static_cast<double>(outputBuffer[neighborOffset]));
+        }
+      }
+      if (index[j] < m_LastIndex[j])
+      {
+        const OffsetValueType neighborOffset = offset + offsetTable[j];
+        if (labelBuffer[neighborOffset] != LabelEnum::OutsidePoint)
+        {
+          minimum = std::min(minimum, static_cast<double>(outputBuffer[neighborOffset]));
+        }
+      }
+      neighbors[j] = std::make_pair(minimum, j);
+    }
+
+    std::sort(neighbors, neighbors + SetDimension);
+
+    double solution = largeValue;
+    double aa(0.0);
+    double bb(0.0);
+    double cc(m_InverseSpeed);
+
+    if (speedImage)
+    {
+      cc = static_cast<double>(speedImage->GetPixel(index)) / m_NormalizationFactor;
+      cc = -1.0 * itk::Math::sqr(1.0 / cc);
+    }
+
+    for (unsigned int j = 0; j < SetDimension; ++j)
+    {
+      const double value = neighbors[j].first;
+
+      if (solution < value)
+      {
+        break;
+      }
+      const double spaceFactor = spaceFactors[neighbors[j].second];
+      aa += spaceFactor;
+      bb += value * spaceFactor;
+      cc += itk::Math::sqr(value) * spaceFactor;
+
+      const double discrim = itk::Math::sqr(bb) - aa * cc;
+      if (discrim < 0.0)
+      {
+        // Discriminant of quadratic eqn. is negative
+        ExceptionObject err(__FILE__, __LINE__);
+        err.SetLocation(ITK_LOCATION);
+        err.SetDescription("Discriminant of quadratic equation is negative");
+        throw err;
+      }
+
+      solution = (std::sqrt(discrim) + bb) / aa;
+    }
+    return solution;
+  };
+
+  // Divide the buffered region into blocks.
+  const OutputSizeType & bufferedSize = m_BufferedRegion.GetSize();
+  Size<SetDimension>     numberOfBlocks;
+  SizeValueType          blockStrides[SetDimension];
+  SizeValueType          totalNumberOfBlocks = 1;
+  for (unsigned int j = 0; j < SetDimension; ++j)
+  {
+    numberOfBlocks[j] = (bufferedSize[j] + m_ParallelSolverBlockSize - 1) / m_ParallelSolverBlockSize;
+    blockStrides[j] = totalNumberOfBlocks;
+    totalNumberOfBlocks *= numberOfBlocks[j];
+  }
+
+  const auto getBlockIndex = [&numberOfBlocks, &blockStrides](const SizeValueType blockId) {
+    Index<SetDimension> blockIndex;
+    for (unsigned int j = 0; j < SetDimension; ++j)
+    {
+      blockIndex[j] = static_cast<IndexValueType>((blockId / blockStrides[j]) % numberOfBlocks[j]);
+    }
+    return blockIndex;
+  };
+
+  // Relaxes all far points of a block until none of their values decreases
+  // anymore. Returns whether any value below the stopping value decreased.
+  const auto processBlock = [&](const SizeValueType blockId) -> bool {
+    const Index<SetDimension> blockIndex = getBlockIndex(blockId);
+    OutputRegionType          blockRegion;
+    for (unsigned int j = 0; j < SetDimension; ++j)
+    {
+      const auto blockStart = static_cast<SizeValueType>(blockIndex[j]) * m_ParallelSolverBlockSize;
+      blockRegion.SetIndex(j, m_StartIndex[j] + static_cast<IndexValueType>(blockStart));
+      blockRegion.SetSize(j, std::min<SizeValueType>(m_ParallelSolverBlockSize, bufferedSize[j] - blockStart));
+    }
+
+    bool blockChanged = false;
+    bool sweepChanged;
+    do
+    {
+      sweepChanged = false;
+      for (const auto & index : ImageRegionIndexRange<SetDimension>(blockRegion))
+      {
+        const OffsetValueType offset = output->ComputeOffset(index);
+        if (labelBuffer[offset] != LabelEnum::FarPoint)
+        {
+          continue;
+        }
+        const auto newValue = static_cast<PixelType>(solve(index, offset));
+        if (newValue < outputBuffer[offset])
+        {
+          outputBuffer[offset] = newValue;
+          if (static_cast<double>(newValue) <= m_StoppingValue)
+          {
+            sweepChanged = true;
+          }
+        }
+      }
+      blockChanged = blockChanged || sweepChanged;
+    } while (sweepChanged);
+
+    return blockChanged;
+  };
+
+  std::vector<unsigned char> isActive(totalNumberOfBlocks, 0);
+  std::vector<unsigned char> hasChanged(totalNumberOfBlocks, 0);
+  std::vector<SizeValueType> activeBlocks;
+
+  // Activates the specified block and its face-connected neighbors.
+  const auto activateNeighborhood = [&](const SizeValueType blockId) {
+    const Index<SetDimension> blockIndex = getBlockIndex(blockId);
+    const auto                activate = [&isActive, &activeBlocks](const SizeValueType id) {
+      if (!isActive[id])
+      {
+        isActive[id] = 1;
+        activeBlocks.push_back(id);
+      }
+    };
+    activate(blockId);
+    for (unsigned int j = 0; j < SetDimension; ++j)
+    {
+      if (blockIndex[j] > 0)
+      {
+        activate(blockId - blockStrides[j]);
+      }
+      if (static_cast<SizeValueType>(blockIndex[j]) + 1 < numberOfBlocks[j])
+      {
+        activate(blockId + blockStrides[j]);
+      }
+    }
+  };
+
+  const auto getBlockId = [this, &blockStrides](const NodeIndexType & index) {
+    SizeValueType blockId = 0;
+    for (unsigned int j = 0; j < SetDimension; ++j)
+    {
+      blockId += static_cast<SizeValueType>(index[j] - m_StartIndex[j]) / m_ParallelSolverBlockSize * blockStrides[j];
+    }
+    return blockId;
+  };
+
+  // The front starts at the blocks around the alive and the trial points.
+  for (const NodeContainer * const points : { m_AlivePoints.GetPointer(), m_TrialPoints.GetPointer() })
+  {
+    if (points)
+    {
+      for (typename NodeContainer::ConstIterator pointsIter = points->Begin(); pointsIter != points->End();
+           ++pointsIter)
+      {
+        const NodeIndexType & idx = pointsIter.Value().GetIndex();
+        if (m_BufferedRegion.IsInside(idx))
+        {
+          activateNeighborhood(getBlockId(idx));
+        }
+      }
+    }
+  }
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  std::vector<SizeValueType> blocksToProcess;
+  while (!activeBlocks.empty())
+  {
+    // Blocks whose block indices have the same parity are not adjacent, so
+    // they can be processed concurrently.
+    for (unsigned int parity = 0; parity < 2; ++parity)
+    {
+      blocksToProcess.clear();
+      for (const SizeValueType blockId : activeBlocks)
+      {
+        const Index<SetDimension> blockIndex = getBlockIndex(blockId);
+        IndexValueType            sum = 0;
+        for (unsigned int j = 0; j < SetDimension; ++j)
+        {
+          sum += blockIndex[j];
+        }
+        if (static_cast<unsigned int>(sum % 2) == parity)
+        {
+          blocksToProcess.push_back(blockId);
+        }
+      }
+      multiThreader->ParallelizeArray(
+        0,
+        blocksToProcess.size(),
+        [&blocksToProcess, &hasChanged, &processBlock](SizeValueType i) {
+          const SizeValueType blockId = blocksToProcess[i];
+          hasChanged[blockId] = processBlock(blockId);
+        },
+        nullptr);
+    }
+
+    // The neighbors of the blocks that have changed must be processed again.
+    const std::vector<SizeValueType> processedBlocks = std::move(activeBlocks);
+    activeBlocks.clear();
+    for (const SizeValueType blockId : processedBlocks)
+    {
+      isActive[blockId] = 0;
+    }
+    for (const SizeValueType blockId : processedBlocks)
+    {
+      if (hasChanged[blockId])
+      {
+        hasChanged[blockId] = 0;
+        activateNeighborhood(blockId);
+      }
+    }
+
+    if (this->GetAbortGenerateData())
+    {
+      this->InvokeEvent(AbortEvent());
+      this->ResetPipeline();
+      ProcessAborted e(__FILE__, __LINE__);
+      e.SetDescription("Process aborted.");
+      e.SetLocation(ITK_LOCATION);
+      throw e;
+    }
+  }
+
+  // Label the points the same way as the sequential loop does: all points up
+  // to the stopping value become alive, those beyond it are trial points.
+  std::vector<AxisNodeType> processedNodes;
+  SizeValueType             offset = 0;
+  for (const auto & index : ImageRegionIndexRange<SetDimension>(m_BufferedRegion))
+  {
+    const LabelEnum label = labelBuffer[offset];
+    const PixelType value = outputBuffer[offset];
+
+    if ((label == LabelEnum::FarPoint && value < m_LargeValue) || label == LabelEnum::InitialTrialPoint)
+    {
+      if (static_cast<double>(value) <= m_StoppingValue)
+      {
+        labelBuffer[offset] = LabelEnum::AlivePoint;
+        if (m_CollectPoints)
+        {
+          AxisNodeType node;
+          node.SetValue(value);
+          node.SetIndex(index);
+          processedNodes.push_back(node);
+        }
+      }
+      else if (label == LabelEnum::FarPoint)
+      {
+        labelBuffer[offset] = LabelEnum::TrialPoint;
+      }
+    }
+    ++offset;
+  }
+
+  if (m_CollectPoints)
+  {
+    std::stable_sort(
+      processedNodes.begin(), processedNodes.end(), [](const AxisNodeType & lhs, const AxisNodeType & rhs) {
+        return lhs.GetValue() < rhs.GetValue();
+      });
+    for (const AxisNodeType & node : processedNodes)
+    {
+      m_ProcessedPoints->InsertElement(m_ProcessedPoints->Size(), node);
+    }
+  }
+}
 } // namespace itk
 
 #endif
@@ -221,6 +221,14 @@ protected:
   void
   UpdateNeighbors(const IndexType & index, const SpeedImageType *, LevelSetImageType *) override;
 
+  /** The gradient and the reached targets are computed by UpdateNeighbors(),
+   * which the parallel solver does not call. */
+  bool
+  CanUseParallelSolver() const override
+  {
+    return false;
+  }
+
   virtual void
   ComputeGradient(const IndexType &         index,
                   const LevelSetImageType * output,
@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastMarchingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = float;
+constexpr unsigned int Dimension = 3;
+using FloatImageType = itk::Image<PixelType, Dimension>;
+using FastMarchingType = itk::FastMarchingImageFilter<FloatImageType, FloatImageType>;
+
+// Runs the fast marching filter on a speed image that varies along all axes,
+// with two seeds and a block of outside points in between.
+FastMarchingType::Pointer
+RunFastMarching(bool useParallelSolver, unsigned int blockSize, double stoppingValue)
+{
+  const FloatImageType::SizeType size = { { 37, 30, 23 } };
+
+  auto speedImage = FloatImageType::New();
+  speedImage->SetRegions(size);
+  speedImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<FloatImageType> speedIter(speedImage, speedImage->GetBufferedRegion());
+  for (; !speedIter.IsAtEnd(); ++speedIter)
+  {
+    const FloatImageType::IndexType index = speedIter.GetIndex();
+    speedIter.Set(1.0f + 0.5f * std::sin(0.3f * index[0]) * std::cos(0.2f * index[1]) + 0.01f * index[2]);
+  }
+
+  using NodeType = FastMarchingType::NodeType;
+  using NodeContainer = FastMarchingType::NodeContainer;
+
+  auto     alivePoints = NodeContainer::New();
+  auto     trialPoints = NodeContainer::New();
+  auto     outsidePoints = NodeContainer::New();
+  NodeType node;
+
+  const FloatImageType::IndexType seeds[] = { { { 5, 6, 7 } }, { { 30, 22, 15 } } };
+  for (const auto & seed : seeds)
+  {
+    node.SetValue(0.0);
+    node.SetIndex(seed);
+    alivePoints->InsertElement(alivePoints->Size(), node);
+
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      for (int s = -1; s < 2; s += 2)
+      {
+        FloatImageType::IndexType index = seed;
+        index[j] += s;
+        node.SetValue(1.0 / speedImage->GetPixel(index));
+        node.SetIndex(index);
+        trialPoints->InsertElement(trialPoints->Size(), node);
+      }
+    }
+  }
+
+  node.SetValue(0.0);
+  for (itk::IndexValueType y = 0; y < 20; ++y)
+  {
+    for (itk::IndexValueType z = 5; z < 23; ++z)
+    {
+      node.SetIndex({ { 18, y, z } });
+      outsidePoints->InsertElement(outsidePoints->Size(), node);
+    }
+  }
+
+  auto marcher = FastMarchingType::New();
+  marcher->SetInput(speedImage);
+  marcher->SetAlivePoints(alivePoints);
+  marcher->SetTrialPoints(trialPoints);
+  marcher->SetOutsidePoints(outsidePoints);
+  marcher->SetStoppingValue(stoppingValue);
+  marcher->CollectPointsOn();
+  marcher->SetUseParallelSolver(useParallelSolver);
+  marcher->SetParallelSolverBlockSize(blockSize);
+  marcher->Update();
+  return marcher;
+}
+
+bool
+CompareWithSequentialSolver(unsigned int blockSize, double stoppingValue)
+{
+  const auto sequential = RunFastMarching(false, 0, stoppingValue);
+  const auto parallel = RunFastMarching(true, blockSize, stoppingValue);
+
+  const FloatImageType *                  sequentialOutput = sequential->GetOutput();
+  const FastMarchingType::LabelImageType * sequentialLabels = sequential->GetLabelImage();
+  const FastMarchingType::LabelImageType * parallelLabels = parallel->GetLabelImage();
+
+  // Relative tolerance on the arrival times, of the order of the epsilon of
+  // the pixel type, times the number of accumulated updates.
+  constexpr double tolerance = 1e-5;
+
+  bool               passed = true;
+  itk::SizeValueType numberOfAlivePoints = 0;
+
+  itk::ImageRegionConstIteratorWithIndex<FloatImageType> it(parallel->GetOutput(),
+                                                           parallel->GetOutput()->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const FloatImageType::IndexType index = it.GetIndex();
+    const auto                      label = sequentialLabels->GetPixel(index);
+    if (parallelLabels->GetPixel(index) == FastMarchingType::LabelEnum::AlivePoint)
+    {
+      ++numberOfAlivePoints;
+    }
+    if (label != FastMarchingType::LabelEnum::AlivePoint)
+    {
+      continue;
+    }
+    const double expected = sequentialOutput->GetPixel(index);
+    const double actual = it.Get();
+    if (parallelLabels->GetPixel(index) != label ||
+        itk::Math::abs(actual - expected) > tolerance * std::max(1.0, itk::Math::abs(expected)))
+    {
+      std::cerr << "Mismatch at " << index << " (block size " << blockSize << "): expected " << expected
+                << ", actual " << actual << std::endl;
+      passed = false;
+    }
+  }
+
+  if (numberOfAlivePoints != sequential->GetProcessedPoints()->Size() + 2 ||
+      parallel->GetProcessedPoints()->Size() != sequential->GetProcessedPoints()->Size())
+  {
+    std::cerr << "The number of processed points differs (block size " << blockSize << "): expected "
+              << sequential->GetProcessedPoints()->Size() << ", actual " << parallel->GetProcessedPoints()->Size()
+              << std::endl;
+    passed = false;
+  }
+  return passed;
+}
+} // namespace
+
+int
+itkFastMarchingImageFilterParallelTest(int, char *[])
+{
+  auto marcher = FastMarchingType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(marcher, FastMarchingImageFilter, ImageToImageFilter);
+
+  ITK_TEST_SET_GET_BOOLEAN(marcher, UseParallelSolver, true);
+  ITK_TEST_SET_GET_BOOLEAN(marcher, UseParallelSolver, false);
+
+  marcher->SetParallelSolverBlockSize(5);
+  ITK_TEST_SET_GET_VALUE(5, marcher->GetParallelSolverBlockSize());
+
+  bool passed = true;
+  for (const unsigned int blockSize : { 1, 4, 8, 64 })
+  {
+    passed = CompareWithSequentialSolver(blockSize, 1.0e6) && passed;
+    passed = CompareWithSequentialSolver(blockSize, 12.0) && passed;
+  }
+
+  if (!passed)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
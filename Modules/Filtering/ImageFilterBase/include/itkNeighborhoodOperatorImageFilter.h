@@ -22,6 +22,7 @@
 #include "itkNeighborhoodOperator.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkTotalProgressReporter.h"
 
 namespace itk
 {
@@ -35,6 +36,13 @@ namespace itk
  * with the image region.  Apply the mirror()'d operator for
  * non-symmetric NeighborhoodOperators.
  *
+ * When the input is an itk::Image and the operator extends along a single
+ * direction, like the operators of DiscreteGaussianImageFilter and
+ * DerivativeImageFilter, the pixels away from the image boundaries are
+ * computed directly from the input buffer, with a loop that is unrolled at
+ * compile time for radii 1 and 2. The output is the same as the one of the
+ * NeighborhoodInnerProduct.
+ *
  * \ingroup ImageFilters
  *
  * \sa Image
@@ -184,6 +192,35 @@ protected:
   }
 
 private:
+  /** Computes the output for the specified region, which must be free of
+   * boundary conditions, directly from the input buffer, when the operator
+   * extends along at most one direction. Returns false, without computing
+   * anything, otherwise. */
+  template <typename TImage>
+  bool
+  GenerateDataAlongOneDirection(const TImage &, const OutputImageRegionType &, TotalProgressReporter &)
+  {
+    return false;
+  }
+
+  template <typename TPixel>
+  bool
+  GenerateDataAlongOneDirection(const Image<TPixel, InputImageDimension> & input,
+                                const OutputImageRegionType &              region,
+                                TotalProgressReporter &                    progress);
+
+  /** Convolves the lines of the specified region with the coefficients, at
+   * the given stride in the input buffer. VRadius is the radius of the
+   * operator, or zero, when it is only known at run time. */
+  template <unsigned int VRadius, typename TPixel, typename TCoefficient>
+  void
+  ConvolveAlongOneDirection(const Image<TPixel, InputImageDimension> & input,
+                            const OutputImageRegionType &              region,
+                            const TCoefficient *                       coefficients,
+                            unsigned int                               radius,
+                            OffsetValueType                            stride,
+                            TotalProgressReporter &                    progress);
+
   /** Internal operator used to filter the image. */
   OutputNeighborhoodType m_Operator;
 
@@ -24,8 +24,11 @@
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkTotalProgressReporter.h"
 
+#include <vector>
+
 namespace itk
 {
 template <typename TInputImage, typename TOutputImage, typename TOperatorValueType>
@@ -107,6 +110,10 @@ NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::
   ConstNeighborhoodIterator<InputImageType> bit;
   for (fit = faceList.begin(); fit != faceList.end(); ++fit)
   {
+    if (fit == faceList.begin() && this->GenerateDataAlongOneDirection(*input, *fit, progress))
+    {
+      continue;
+    }
     bit = ConstNeighborhoodIterator<InputImageType>(m_Operator.GetRadius(), input, *fit);
     bit.OverrideBoundaryCondition(m_BoundsCondition);
     it = ImageRegionIterator<OutputImageType>(output, *fit);
@@ -120,6 +127,101 @@ NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage, typename TOperatorValueType>
+template <typename TPixel>
+bool
+NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::GenerateDataAlongOneDirection(
+  const Image<TPixel, InputImageDimension> & input,
+  const OutputImageRegionType &              region,
+  TotalProgressReporter &                    progress)
+{
+  const typename OutputNeighborhoodType::RadiusType & radius = m_Operator.GetRadius();
+
+  unsigned int direction = 0;
+  unsigned int numberOfDirections = 0;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    if (radius[i] > 0)
+    {
+      direction = i;
+      ++numberOfDirections;
+    }
+  }
+  if (numberOfDirections > 1)
+  {
+    return false;
+  }
+  if (region.GetNumberOfPixels() == 0)
+  {
+    return true;
+  }
+
+  // The coefficients, converted as by NeighborhoodInnerProduct
+  using CoefficientType = typename NumericTraits<ComputingPixelType>::ValueType;
+  std::vector<CoefficientType> coefficients;
+  coefficients.reserve(m_Operator.Size());
+  for (auto it = m_Operator.Begin(); it != m_Operator.End(); ++it)
+  {
+    coefficients.push_back(static_cast<CoefficientType>(*it));
+  }
+
+  const auto            operatorRadius = static_cast<unsigned int>(radius[direction]);
+  const OffsetValueType stride = input.GetOffsetTable()[direction];
+
+  switch (operatorRadius)
+  {
+    case 1:
+      this->template ConvolveAlongOneDirection<1>(input, region, coefficients.data(), operatorRadius, stride, progress);
+      break;
+    case 2:
+      this->template ConvolveAlongOneDirection<2>(input, region, coefficients.data(), operatorRadius, stride, progress);
+      break;
+    default:
+      this->template ConvolveAlongOneDirection<0>(input, region, coefficients.data(), operatorRadius, stride, progress);
+  }
+  return true;
+}
+
+template <typename TInputImage, typename TOutputImage, typename TOperatorValueType>
+template <unsigned int VRadius, typename TPixel, typename TCoefficient>
+void
+NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::ConvolveAlongOneDirection(
+  const Image<TPixel, InputImageDimension> & input,
+  const OutputImageRegionType &              region,
+  const TCoefficient *                       coefficients,
+  unsigned int                               radius,
+  OffsetValueType                            stride,
+  TotalProgressReporter &                    progress)
+{
+  using InputPixelRealType = typename NumericTraits<TPixel>::RealType;
+  using AccumulateRealType = typename NumericTraits<InputPixelRealType>::AccumulateType;
+
+  // A compile time constant, unless VRadius is zero
+  const unsigned int numberOfCoefficients = 2 * (VRadius > 0 ? VRadius : radius) + 1;
+  const TPixel *     inputBuffer = input.GetBufferPointer();
+
+  ImageScanlineIterator<OutputImageType> it(this->GetOutput(), region);
+  while (!it.IsAtEnd())
+  {
+    const TPixel * inputPixel = inputBuffer + input.ComputeOffset(it.GetIndex()) - stride * radius;
+    while (!it.IsAtEndOfLine())
+    {
+      // Same sum as NeighborhoodInnerProduct, in the same order
+      AccumulateRealType sum = NumericTraits<AccumulateRealType>::ZeroValue();
+      for (unsigned int i = 0; i < numberOfCoefficients; ++i)
+      {
+        sum +=
+          static_cast<AccumulateRealType>(coefficients[i] * static_cast<InputPixelRealType>(inputPixel[i * stride]));
+      }
+      it.Set(static_cast<typename OutputImageType::PixelType>(static_cast<ComputingPixelType>(sum)));
+      ++it;
+      ++inputPixel;
+    }
+    it.NextLine();
+    progress.Completed(region.GetSize(0));
+  }
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkDerivativeOperator.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionIterator.h"
+#include "itkLaplacianOperator.h"
+#include "itkNeighborhoodInnerProduct.h"
+
+#include "itkGTest.h"
+
+#include <random>
+
+
+namespace
+{
+
+template <typename TInputImage, typename TOutputImage>
+class NeighborhoodOperatorImageFilterTest
+{
+public:
+  using FilterType = itk::NeighborhoodOperatorImageFilter<TInputImage, TOutputImage>;
+  using OperatorType = typename FilterType::OutputNeighborhoodType;
+  using ComputingPixelType = typename FilterType::ComputingPixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  NeighborhoodOperatorImageFilterTest()
+  {
+    typename TInputImage::SizeType size;
+    for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
+    {
+      size[i] = 13 + 2 * i;
+    }
+    m_Input = TInputImage::New();
+    m_Input->SetRegions(size);
+    m_Input->Allocate();
+
+    std::mt19937                           randomNumberEngine;
+    std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+    for (itk::ImageRegionIterator<TInputImage> it(m_Input, m_Input->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(static_cast<typename TInputImage::PixelType>(distribution(randomNumberEngine)));
+    }
+  }
+
+  // Tests that the filter yields the inner products of the operator with
+  // the neighborhoods of all the pixels, with the default boundary condition.
+  void
+  ExpectInnerProducts(const OperatorType & op) const
+  {
+    const auto filter = FilterType::New();
+    filter->SetInput(m_Input);
+    filter->SetOperator(op);
+    filter->Update();
+    const TOutputImage * output = filter->GetOutput();
+
+    itk::NeighborhoodInnerProduct<TInputImage, typename OperatorType::PixelType, ComputingPixelType> innerProduct;
+
+    itk::ConstNeighborhoodIterator<TInputImage> it(op.GetRadius(), m_Input, m_Input->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it)
+    {
+      const auto expected = static_cast<OutputPixelType>(innerProduct(it, op));
+      ASSERT_EQ(output->GetPixel(it.GetIndex()), expected) << "at " << it.GetIndex() << ", radius " << op.GetRadius();
+    }
+  }
+
+  void
+  ExpectInnerProductsForAllOperators() const
+  {
+    for (unsigned int direction = 0; direction < TInputImage::ImageDimension; ++direction)
+    {
+      for (const unsigned int order : { 1, 2 })
+      {
+        // A 3-tap kernel.
+        itk::DerivativeOperator<typename OperatorType::PixelType, TInputImage::ImageDimension> derivativeOperator;
+        derivativeOperator.SetDirection(direction);
+        derivativeOperator.SetOrder(order);
+        derivativeOperator.CreateDirectional();
+        this->ExpectInnerProducts(derivativeOperator);
+      }
+
+      // 5-tap and wider kernels.
+      for (const double variance : { 0.5, 1.0, 4.0 })
+      {
+        itk::GaussianOperator<typename OperatorType::PixelType, TInputImage::ImageDimension> gaussianOperator;
+        gaussianOperator.SetDirection(direction);
+        gaussianOperator.SetVariance(variance);
+        gaussianOperator.SetMaximumError(0.01);
+        gaussianOperator.CreateDirectional();
+        this->ExpectInnerProducts(gaussianOperator);
+      }
+    }
+
+    // Not separable.
+    itk::LaplacianOperator<typename OperatorType::PixelType, TInputImage::ImageDimension> laplacianOperator;
+    laplacianOperator.CreateOperator();
+    this->ExpectInnerProducts(laplacianOperator);
+
+    // A single tap.
+    OperatorType identityOperator;
+    identityOperator.SetRadius(itk::SizeValueType{ 0 });
+    identityOperator[0] = 2;
+    this->ExpectInnerProducts(identityOperator);
+  }
+
+private:
+  typename TInputImage::Pointer m_Input;
+};
+
+} // namespace
+
+
+TEST(NeighborhoodOperatorImageFilter, OutputEqualsInnerProducts)
+{
+  using FloatImageType2D = itk::Image<float, 2>;
+  using FloatImageType3D = itk::Image<float, 3>;
+
+  NeighborhoodOperatorImageFilterTest<FloatImageType2D, FloatImageType2D>().ExpectInnerProductsForAllOperators();
+  NeighborhoodOperatorImageFilterTest<FloatImageType3D, FloatImageType3D>().ExpectInnerProductsForAllOperators();
+  NeighborhoodOperatorImageFilterTest<itk::Image<short, 3>, itk::Image<double, 3>>()
+    .ExpectInnerProductsForAllOperators();
+  NeighborhoodOperatorImageFilterTest<itk::Image<double, 1>, itk::Image<short, 1>>()
+    .ExpectInnerProductsForAllOperators();
+}
@@ -71,6 +71,15 @@ namespace itk
  *
  * This filter is implemented as a multithreaded filter.  It provides a
  * DynamicThreadedGenerateData() method for its implementation.
+ *
+ * When the transform is linear, the input is an itk::Image of up to three
+ * dimensions and the interpolator is a LinearInterpolateImageFunction (and
+ * not a subclass of it), the linear interpolation of each output pixel is
+ * computed directly from the input buffer, instead of by the virtual
+ * IsInsideBuffer and EvaluateAtContinuousIndex calls of the interpolator.
+ * The pixels are still interpolated one at a time (there is no vectorized
+ * scanline kernel), and the output is the same as the one of the
+ * interpolator.
  * \warning For multithreading, the TransformPoint method of the
  * user-designated coordinate transform must be threadsafe.
  *
@@ -364,6 +373,66 @@ private:
   static PixelType
   CastPixelWithBoundsChecking(const TPixel value);
 
+  using InterpolatorRealType = typename LinearInterpolatorType::RealType;
+
+  /** Returns the buffer of the input image, when the linear interpolation
+   * can be computed directly from it, and nullptr otherwise. Beyond three
+   * dimensions, LinearInterpolateImageFunction evaluates its neighbors in
+   * another order, so the interpolator is used. */
+  template <typename TImage>
+  static const typename TImage::PixelType *
+  GetBufferForDirectLinearInterpolation(const TImage &, const InterpolatorType &)
+  {
+    return nullptr;
+  }
+
+  template <typename TPixel, unsigned int VDimension>
+  static const TPixel *
+  GetBufferForDirectLinearInterpolation(const Image<TPixel, VDimension> & image, const InterpolatorType & interpolator)
+  {
+    if (VDimension > 3 || typeid(interpolator) != typeid(LinearInterpolatorType))
+    {
+      return nullptr;
+    }
+    return image.GetBufferPointer();
+  }
+
+  /** Interpolates linearly along the first VDimension dimensions, in the
+   * same order as LinearInterpolateImageFunction, the pixel at the given
+   * position of the buffer with its neighbors at the given offsets. A zero
+   * distance means that the neighbor along that dimension is ignored. */
+  template <unsigned int VDimension>
+  static InterpolatorRealType
+  InterpolateLinearly(const InputPixelType *             pixel,
+                      const OffsetValueType *            neighborOffsets,
+                      const TInterpolatorPrecisionType * distances,
+                      std::integral_constant<unsigned int, VDimension>)
+  {
+    const InterpolatorRealType value = InterpolateLinearly(
+      pixel, neighborOffsets, distances, std::integral_constant<unsigned int, VDimension - 1>());
+    const TInterpolatorPrecisionType distance = distances[VDimension - 1];
+    if (distance > 0)
+    {
+      const InterpolatorRealType neighborValue =
+        InterpolateLinearly(pixel + neighborOffsets[VDimension - 1],
+                            neighborOffsets,
+                            distances,
+                            std::integral_constant<unsigned int, VDimension - 1>());
+      return value + (neighborValue - value) * distance;
+    }
+    return value;
+  }
+
+  static InterpolatorRealType
+  InterpolateLinearly(const InputPixelType * pixel,
+                      const OffsetValueType *,
+                      const TInterpolatorPrecisionType *,
+                      std::integral_constant<unsigned int, 0>)
+  {
+    const InterpolatorRealType value = *pixel;
+    return value;
+  }
+
   void
   InitializeTransform();
 
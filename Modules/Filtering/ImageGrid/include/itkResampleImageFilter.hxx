@@ -28,7 +28,9 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkImageAlgorithm.h"
 
+#include <algorithm>   // For max.
 #include <type_traits> // For is_same.
+#include <typeinfo>
 
 namespace itk
 {
@@ -460,7 +462,40 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
   // Cache information from the superclass
   PixelType defaultValue = this->GetDefaultPixelValue();
 
-  using OutputType = typename InterpolatorType::OutputType;
+  // When the interpolator is a LinearInterpolateImageFunction, each pixel
+  // is interpolated directly from the input buffer, without virtual calls.
+  const InputPixelType * const inputBuffer = Self::GetBufferForDirectLinearInterpolation(*inputPtr, *m_Interpolator);
+
+  const OffsetValueType * const    offsetTable = inputPtr->GetOffsetTable();
+  const auto &                     bufferStartIndex = m_Interpolator->GetStartIndex();
+  const auto &                     bufferEndIndex = m_Interpolator->GetEndIndex();
+  const ContinuousInputIndexType & startContinuousIndex = m_Interpolator->GetStartContinuousIndex();
+  const ContinuousInputIndexType & endContinuousIndex = m_Interpolator->GetEndContinuousIndex();
+
+  // Same as m_Interpolator->IsInsideBuffer(inputIndex), followed by
+  // m_Interpolator->EvaluateAtContinuousIndex(inputIndex) if it is inside.
+  const auto interpolateFromBuffer = [&](const ContinuousInputIndexType & inputIndex, OutputType & value) {
+    OffsetValueType            neighborOffsets[InputImageDimension];
+    TInterpolatorPrecisionType distances[InputImageDimension];
+    OffsetValueType            offset = 0;
+    for (unsigned int i = 0; i < InputImageDimension; ++i)
+    {
+      // Test for negative of a positive so we can catch NaN's.
+      if (!(inputIndex[i] >= startContinuousIndex[i] && inputIndex[i] < endContinuousIndex[i]))
+      {
+        return false;
+      }
+      const IndexValueType baseIndex = std::max(Math::Floor<IndexValueType>(inputIndex[i]), bufferStartIndex[i]);
+      const bool           hasNeighbor = baseIndex < bufferEndIndex[i];
+      const TInterpolatorPrecisionType distance = inputIndex[i] - static_cast<TInterpolatorPrecisionType>(baseIndex);
+      distances[i] = (hasNeighbor && distance > 0) ? distance : 0;
+      neighborOffsets[i] = hasNeighbor ? offsetTable[i] : 0;
+      offset += (baseIndex - bufferStartIndex[i]) * offsetTable[i];
+    }
+    value = static_cast<OutputType>(Self::InterpolateLinearly(
+      inputBuffer + offset, neighborOffsets, distances, std::integral_constant<unsigned int, InputImageDimension>()));
+    return true;
+  };
 
   // As we walk across a scan line in the output image, we trace
   // an oriented/scaled/translated line in the input image. Each scan
@@ -512,7 +547,11 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 
       OutputType value;
       // Evaluate input at right position and copy to the output
-      if (m_Interpolator->IsInsideBuffer(inputIndex))
+      if (inputBuffer != nullptr && interpolateFromBuffer(inputIndex, value))
+      {
+        outIt.Set(Self::CastPixelWithBoundsChecking(value));
+      }
+      else if (inputBuffer == nullptr && m_Interpolator->IsInsideBuffer(inputIndex))
       {
         value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
         outIt.Set(Self::CastPixelWithBoundsChecking(value));
@@ -19,14 +19,18 @@
 // The header file to be tested:
 #include "itkResampleImageFilter.h"
 
+#include "itkAffineTransform.h"
 #include "itkImage.h"
+#include "itkImageRegionIterator.h"
 
 // Google Test header file:
 #include <gtest/gtest.h>
 
 // Standard C++ header files:
+#include <algorithm>
 #include <limits>
 #include <random>
+#include <vector>
 
 
 namespace
@@ -111,6 +115,83 @@ Expect_ResampleImageFilter_thows_on_incomplete_configuration(const TPixel inputP
   EXPECT_EQ(TestThrowErrorOnEmptyResampleSpace(inputPixel, true), inputPixel);
 }
 
+
+// A LinearInterpolateImageFunction subclass, which makes ResampleImageFilter
+// use the virtual EvaluateAtContinuousIndex member function of the
+// interpolator, rather than interpolating directly from the input buffer.
+template <typename TImage>
+class DerivedLinearInterpolator : public itk::LinearInterpolateImageFunction<TImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(DerivedLinearInterpolator);
+
+  using Self = DerivedLinearInterpolator;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+
+protected:
+  DerivedLinearInterpolator() = default;
+  ~DerivedLinearInterpolator() override = default;
+};
+
+
+// Tests that the linear interpolation directly from the input buffer yields
+// the same output as the one by the interpolator, for an affine transform
+// that maps part of the output grid outside the input image.
+template <typename TPixel, unsigned int VDimension>
+void
+Expect_direct_linear_interpolation_equals_interpolator_output()
+{
+  using ImageType = itk::Image<TPixel, VDimension>;
+  using FilterType = itk::ResampleImageFilter<ImageType, ImageType>;
+
+  const auto image = ImageType::New();
+  auto       size = ImageType::SizeType::Filled(11);
+  size[0] = 23;
+  image->SetRegions(typename ImageType::RegionType(ImageType::IndexType::Filled(-3), size));
+  image->Allocate();
+
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> distribution(0.0, 100.0);
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<TPixel>(distribution(randomNumberEngine)));
+  }
+
+  const auto transform = itk::AffineTransform<double, VDimension>::New();
+  transform->Rotate(0, 1, 0.3);
+  transform->Scale(0.8);
+  transform->Translate(itk::Vector<double, VDimension>(1.5));
+
+  typename ImageType::Pointer outputs[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    const auto filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetTransform(transform);
+    filter->SetSize(ImageType::SizeType::Filled(17));
+    filter->SetOutputOrigin(itk::Point<double, VDimension>(-4.25));
+    filter->SetOutputSpacing(itk::Vector<double, VDimension>(1.75));
+    filter->SetDefaultPixelValue(42);
+    if (i == 1)
+    {
+      filter->SetInterpolator(DerivedLinearInterpolator<ImageType>::New());
+    }
+    filter->Update();
+    outputs[i] = filter->GetOutput();
+  }
+
+  const auto &              region = outputs[0]->GetBufferedRegion();
+  const TPixel * const      directOutput = outputs[0]->GetBufferPointer();
+  const TPixel * const      interpolatorOutput = outputs[1]->GetBufferPointer();
+  const std::vector<TPixel> expected(interpolatorOutput, interpolatorOutput + region.GetNumberOfPixels());
+  EXPECT_EQ(std::vector<TPixel>(directOutput, directOutput + region.GetNumberOfPixels()), expected);
+
+  // Some output pixels should be mapped outside the input image.
+  EXPECT_NE(std::find(expected.cbegin(), expected.cend(), TPixel{ 42 }), expected.cend());
+}
+
 } // namespace
 
 // Compile time check of mixing transform and precision types
@@ -172,3 +253,16 @@ TEST(ResampleImageFilter, Expect_ResampleImageFilter_thows_on_incomplete_configu
 {
   Expect_ResampleImageFilter_thows_on_incomplete_configuration(128.0);
 }
+
+
+TEST(ResampleImageFilter, DirectLinearInterpolationEqualsInterpolatorOutput)
+{
+  Expect_direct_linear_interpolation_equals_interpolator_output<unsigned char, 2>();
+  Expect_direct_linear_interpolation_equals_interpolator_output<short, 3>();
+  Expect_direct_linear_interpolation_equals_interpolator_output<float, 2>();
+  Expect_direct_linear_interpolation_equals_interpolator_output<double, 3>();
+  // LinearInterpolateImageFunction evaluates the neighbors in another order
+  // in higher dimensions, which the output should follow.
+  Expect_direct_linear_interpolation_equals_interpolator_output<float, 4>();
+  Expect_direct_linear_interpolation_equals_interpolator_output<double, 4>();
+}
@@ -20,10 +20,11 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkConstShapedNeighborhoodIterator.h"
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <functional>
-#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace itk
@@ -134,7 +135,7 @@ protected:
 
   using LineMapType = std::vector<LineEncodingType>;
 
-  using UnionFindType = std::vector<InternalLabelType>;
+  using UnionFindType = std::vector<std::atomic<InternalLabelType>>;
   using ConsecutiveVectorType = std::vector<OutputPixelType>;
 
   SizeValueType
@@ -142,13 +143,12 @@ protected:
   {
     SizeValueType linearIndex = 0;
     SizeValueType stride = 1;
-    RegionType    requestedRegion = m_EnclosingFilter->GetOutput()->GetRequestedRegion();
     // ignore x axis, which is always full size
     for (unsigned dim = 1; dim < ImageDimension; dim++)
     {
-      itkAssertOrThrowMacro(requestedRegion.GetIndex(dim) <= index[dim], "Index must be within the requested region!");
-      linearIndex += (index[dim] - requestedRegion.GetIndex(dim)) * stride;
-      stride *= requestedRegion.GetSize(dim);
+      itkAssertOrThrowMacro(m_LineMapRegion.GetIndex(dim) <= index[dim], "Index must be within the line map region!");
+      linearIndex += (index[dim] - m_LineMapRegion.GetIndex(dim)) * stride;
+      stride *= m_LineMapRegion.GetSize(dim);
     }
     return linearIndex;
   }
@@ -186,20 +186,33 @@ protected:
     return l;
   }
 
+  /** Merges the sets of the two labels. It is lock-free and may be called
+   * concurrently: the root of a set is only ever linked to a smaller root,
+   * so the root of each set is its smallest label, whatever the order of
+   * the calls. */
   void
   LinkLabels(const InternalLabelType label1, const InternalLabelType label2)
   {
-    std::lock_guard<std::mutex> mutexHolder(m_Mutex);
-    InternalLabelType           E1 = this->LookupSet(label1);
-    InternalLabelType           E2 = this->LookupSet(label2);
-
-    if (E1 < E2)
+    InternalLabelType E1 = label1;
+    InternalLabelType E2 = label2;
+    while (true)
     {
-      m_UnionFind[E2] = E1;
-    }
-    else
-    {
-      m_UnionFind[E1] = E2;
+      E1 = this->LookupSet(E1);
+      E2 = this->LookupSet(E2);
+      if (E1 == E2)
+      {
+        return;
+      }
+      if (E1 < E2)
+      {
+        std::swap(E1, E2);
+      }
+      // Fails if E1 is no longer a root, in which case the lookups are redone.
+      InternalLabelType expected = E1;
+      if (m_UnionFind[E1].compare_exchange_weak(expected, E2))
+      {
+        return;
+      }
     }
   }
 
@@ -388,13 +401,22 @@ protected:
 
   void
   SetupLineOffsets(bool wholeNeighborhood)
+  {
+    this->SetupLineOffsets(wholeNeighborhood, m_EnclosingFilter->GetOutput()->GetRequestedRegion());
+  }
+
+  /** Sets up the offsets to the neighbor lines, for a line map of the lines
+   * of the specified region. By default, it is the requested region of the
+   * output. */
+  void
+  SetupLineOffsets(bool wholeNeighborhood, const RegionType & lineMapRegion)
   {
     // Create a neighborhood so that we can generate a table of offsets
     // to "previous" line indexes
     // We are going to mis-use the neighborhood iterators to compute the
     // offset for us. All this messing around produces an array of
     // offsets that will be used to index the map
-    typename TOutputImage::Pointer output = m_EnclosingFilter->GetOutput();
+    m_LineMapRegion = lineMapRegion;
     using PretendImageType = Image<OffsetValueType, TOutputImage::ImageDimension - 1>;
     using PretendSizeType = typename PretendImageType::RegionType::SizeType;
     using PretendIndexType = typename PretendImageType::RegionType::IndexType;
@@ -405,7 +427,7 @@ protected:
 
     typename PretendImageType::RegionType LineRegion;
 
-    OutSizeType OutSize = output->GetRequestedRegion().GetSize();
+    OutSizeType OutSize = lineMapRegion.GetSize();
 
     PretendSizeType PretendSize;
     // The first dimension has been collapsed
@@ -468,6 +490,23 @@ protected:
     return WorkUnitData{ firstLine, lastLine };
   }
 
+  /** Splits the lines of the line map in contiguous ranges, whose
+   * equivalences are computed in parallel. The equivalences do not depend on
+   * the ranges, every line being linked to its neighbors. */
+  void
+  SplitLineMap(const ThreadIdType numberOfWorkUnits)
+  {
+    const SizeValueType linecount = m_LineMap.size();
+    const SizeValueType numberOfRanges =
+      std::min<SizeValueType>(std::max<ThreadIdType>(numberOfWorkUnits, 1), linecount);
+    m_WorkUnitResults.clear();
+    for (SizeValueType i = 0; i < numberOfRanges; ++i)
+    {
+      m_WorkUnitResults.push_back(
+        WorkUnitData{ i * linecount / numberOfRanges, (i + 1) * linecount / numberOfRanges - 1 });
+    }
+  }
+
   /* Process the map and make appropriate entries in an equivalence table */
   void
   ComputeEquivalence(const SizeValueType workUnitResultsIndex, bool strictlyLess)
@@ -518,11 +557,11 @@ protected:
   OffsetVectorType      m_LineOffsets;
   UnionFindType         m_UnionFind;
   ConsecutiveVectorType m_Consecutive;
-  std::mutex            m_Mutex;
 
   std::atomic<SizeValueType> m_NumberOfLabels;
   std::deque<WorkUnitData>   m_WorkUnitResults;
   LineMapType                m_LineMap;
+  RegionType                 m_LineMapRegion;
 };
 } // end namespace itk
 
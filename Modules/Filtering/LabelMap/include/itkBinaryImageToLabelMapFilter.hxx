@@ -98,6 +98,7 @@ BinaryImageToLabelMapFilter<TInputImage, TOutputImage>::GenerateData()
   // insert all the labels into the structure -- an extra loop but
   // saves complicating the ones that come later
   this->InitUnion(nbOfLabels);
+  this->SplitLineMap(multiThreader->GetNumberOfWorkUnits());
 
   ProgressTransformer progress2(0.55f, 0.6f, this);
   multiThreader->ParallelizeArray(
@@ -196,8 +197,6 @@ BinaryImageToLabelMapFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateD
   }
 
   this->m_NumberOfLabels.fetch_add(nbOfLabels, std::memory_order_relaxed);
-  std::lock_guard<std::mutex> mutexHolder(this->m_Mutex);
-  this->m_WorkUnitResults.push_back(workUnitData);
 }
 
 
@@ -21,7 +21,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
-#include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include <queue>
 
 //#define BASIC
@@ -43,6 +43,12 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * When more than one work unit is available, the image is split into
+ * slabs along its last dimension, which are reconstructed concurrently
+ * and reprocessed until the values on their common faces are stable.
+ * The result does not depend on the number of work units; set it to 1
+ * to get the original single threaded algorithm.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -171,6 +177,18 @@ private:
   using InIndexType = typename InputImageType::IndexType;
   using CNInputIterator = ConstShapedNeighborhoodIterator<InputImageType>;
   using NOutputIterator = ShapedNeighborhoodIterator<OutputImageType>;
+
+  /** Runs the raster, anti-raster and FIFO steps on the given region of the
+   * marker image, without modifying the pixels outside of it. Reports
+   * whether the pixels on the lower and upper faces of the region along the
+   * last dimension have been modified. */
+  void
+  ReconstructRegion(OutputImageType *             markerImage,
+                    const MaskImageType *         maskImage,
+                    const OutputImageRegionType & region,
+                    TotalProgressReporter &       progress,
+                    bool &                        lowerFaceChanged,
+                    bool &                        upperFaceChanged);
 }; // end of class
 } // end namespace itk
 
@@ -26,6 +26,9 @@
 #include "itkConstantPadImageFilter.h"
 #include "itkCropImageFilter.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace itk
 {
 template <typename TInputImage, typename TOutputImage, typename TCompare>
@@ -76,9 +79,7 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
   // subset of the pixels. We'll just pretend that the third pass
   // takes the same as each of the others. Is it OK to update more
   // often than pixels?
-  ProgressReporter progress(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() * 3);
-
-  TCompare compare;
+  TotalProgressReporter progress(this, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() * 3);
 
   MarkerImageConstPointer markerImage = this->GetMarkerImage();
   MaskImageConstPointer   maskImage = this->GetMaskImage();
@@ -135,44 +136,160 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
     markerImageP = output;
   }
 
-  // declare our queue type
-  using FifoType = typename std::queue<OutputImageIndexType>;
-  FifoType IndexFifo;
-
-  NOutputIterator   outNIt;
-  InputIteratorType mskIt;
-  CNInputIterator   mskNIt;
-  ISizeType         kernelRadius;
-  kernelRadius.Fill(1);
+  // the region of the (padded) marker image that is processed
+  OutputImageRegionType processedRegion = output->GetRequestedRegion();
   if (m_UseInternalCopy)
   {
+    ISizeType kernelRadius;
+    kernelRadius.Fill(1);
     FaceCalculatorType faceCalculator;
+    FaceListType       faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(), kernelRadius);
+    // we will only be processing the body region
+    processedRegion = faceList.front();
+  }
 
-    FaceListType   faceList;
-    FaceListTypeIt fit;
+  auto * reconstructionImage = const_cast<OutputImageType *>(markerImageP.GetPointer());
+
+  // The region is divided into slabs along the last dimension, which are
+  // reconstructed concurrently: first all even slabs, then all odd ones, so
+  // that a slab is never written while its neighbors are processed. The
+  // pixels of a slab only depend on the neighboring slabs through the pixels
+  // of their common faces, so a slab is processed again as long as the
+  // adjacent face of one of its neighbors changes. The reconstruction is the
+  // unique fixed point of this propagation, so the result does not depend on
+  // the number of slabs.
+  constexpr unsigned int slabDimension = OutputImageDimension - 1;
+  const SizeValueType    numberOfSlabs = std::max<SizeValueType>(
+    1, std::min<SizeValueType>(this->GetNumberOfWorkUnits(), processedRegion.GetSize(slabDimension)));
+
+  std::vector<OutputImageRegionType> slabs(numberOfSlabs, processedRegion);
+  for (SizeValueType slab = 0; slab < numberOfSlabs; ++slab)
+  {
+    const SizeValueType size = processedRegion.GetSize(slabDimension);
+    const SizeValueType begin = size * slab / numberOfSlabs;
+    const SizeValueType end = size * (slab + 1) / numberOfSlabs;
+    slabs[slab].SetIndex(slabDimension,
+                         processedRegion.GetIndex(slabDimension) + static_cast<IndexValueType>(begin));
+    slabs[slab].SetSize(slabDimension, end - begin);
+  }
 
-    faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(), kernelRadius);
-    // we will only be processing the body region
-    fit = faceList.begin();
-    // must be a better way of doing this
-    NOutputIterator tt(kernelRadius, markerImageP, *fit);
-    outNIt = tt;
-
-    InputIteratorType ttt(maskImageP, *fit);
-    mskIt = ttt;
-    CNInputIterator tttt(kernelRadius, maskImageP, *fit);
-    mskNIt = tttt;
+  if (numberOfSlabs == 1)
+  {
+    bool lowerFaceChanged;
+    bool upperFaceChanged;
+    this->ReconstructRegion(
+      reconstructionImage, maskImageP, slabs.front(), progress, lowerFaceChanged, upperFaceChanged);
   }
   else
   {
-    NOutputIterator tt(kernelRadius, markerImageP, output->GetRequestedRegion());
-    outNIt = tt;
+    MultiThreaderBase * multiThreader = this->GetMultiThreader();
+    multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+    // a char per slab rather than a bool, as these are written concurrently
+    std::vector<unsigned char> isActive(numberOfSlabs, 1);
+    std::vector<unsigned char> lowerFaceChanged(numberOfSlabs, 0);
+    std::vector<unsigned char> upperFaceChanged(numberOfSlabs, 0);
+    std::vector<SizeValueType> slabsToProcess;
+    bool                       firstRound = true;
+
+    while (std::find(isActive.cbegin(), isActive.cend(), 1) != isActive.cend())
+    {
+      for (SizeValueType parity = 0; parity < 2; ++parity)
+      {
+        slabsToProcess.clear();
+        for (SizeValueType slab = parity; slab < numberOfSlabs; slab += 2)
+        {
+          if (isActive[slab])
+          {
+            slabsToProcess.push_back(slab);
+          }
+        }
+        multiThreader->ParallelizeArray(
+          0,
+          slabsToProcess.size(),
+          [&](SizeValueType i) {
+            const SizeValueType slab = slabsToProcess[i];
+            // only the first round is accounted for in the progress
+            TotalProgressReporter slabProgress(firstRound ? this : nullptr,
+                                               output->GetRequestedRegion().GetNumberOfPixels() * 3);
+            bool                  lower;
+            bool                  upper;
+            this->ReconstructRegion(reconstructionImage, maskImageP, slabs[slab], slabProgress, lower, upper);
+            lowerFaceChanged[slab] = lower;
+            upperFaceChanged[slab] = upper;
+          },
+          nullptr);
+      }
+
+      for (SizeValueType slab = 0; slab < numberOfSlabs; ++slab)
+      {
+        isActive[slab] = (slab > 0 && upperFaceChanged[slab - 1]) ||
+                         (slab + 1 < numberOfSlabs && lowerFaceChanged[slab + 1]);
+      }
+      std::fill(lowerFaceChanged.begin(), lowerFaceChanged.end(), 0);
+      std::fill(upperFaceChanged.begin(), upperFaceChanged.end(), 0);
+      firstRound = false;
+    }
+  }
+
+  if (m_UseInternalCopy)
+  {
+    using CropType = typename itk::CropImageFilter<InputImageType, OutputImageType>;
+    typename CropType::Pointer crop = CropType::New();
 
-    InputIteratorType ttt(maskImageP, output->GetRequestedRegion());
-    mskIt = ttt;
-    CNInputIterator tttt(kernelRadius, maskImageP, output->GetRequestedRegion());
-    mskNIt = tttt;
+    crop->SetInput(markerImageP);
+    crop->SetUpperBoundaryCropSize(padSize);
+    crop->SetLowerBoundaryCropSize(padSize);
+    crop->GraftOutput(this->GetOutput());
+    /** execute the minipipeline */
+    crop->Update();
+
+    /** graft the minipipeline output back into this filter's output */
+    this->GraftOutput(crop->GetOutput());
   }
+}
+
+template <typename TInputImage, typename TOutputImage, typename TCompare>
+void
+ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::ReconstructRegion(
+  OutputImageType *             markerImage,
+  const MaskImageType *         maskImage,
+  const OutputImageRegionType & region,
+  TotalProgressReporter &       progress,
+  bool &                        lowerFaceChanged,
+  bool &                        upperFaceChanged)
+{
+  TCompare compare;
+
+  constexpr unsigned int slabDimension = OutputImageDimension - 1;
+  const IndexValueType   lowerFace = region.GetIndex(slabDimension);
+  const IndexValueType   upperFace = lowerFace + static_cast<IndexValueType>(region.GetSize(slabDimension)) - 1;
+
+  lowerFaceChanged = false;
+  upperFaceChanged = false;
+
+  // records whether a modified pixel is on one of the faces of the region
+  // along the last dimension
+  const auto recordChange = [lowerFace, upperFace, &lowerFaceChanged, &upperFaceChanged](const OutIndexType & index) {
+    if (index[slabDimension] == lowerFace)
+    {
+      lowerFaceChanged = true;
+    }
+    if (index[slabDimension] == upperFace)
+    {
+      upperFaceChanged = true;
+    }
+  };
+
+  // declare our queue type
+  using FifoType = typename std::queue<OutputImageIndexType>;
+  FifoType IndexFifo;
+
+  ISizeType kernelRadius;
+  kernelRadius.Fill(1);
+  NOutputIterator   outNIt(kernelRadius, markerImage, region);
+  InputIteratorType mskIt(maskImage, region);
+  CNInputIterator   mskNIt(kernelRadius, maskImage, region);
 
   setConnectivityPrevious(&outNIt, m_FullyConnected);
 
@@ -201,6 +318,7 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
     }
 
     // visit the previous neighbours
+    const InputImagePixelType               originalV = V;
     typename NOutputIterator::ConstIterator sIt;
     for (sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt)
     {
@@ -216,6 +334,12 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
     if (compare(V, iV))
     {
       outNIt.SetCenterPixel(iV);
+      V = iV;
+    }
+
+    if (Math::NotExactlyEquals(V, originalV))
+    {
+      recordChange(outNIt.GetIndex());
     }
 
     progress.CompletedPixel();
@@ -246,6 +370,7 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
     --outNIt;
     --mskNIt;
     InputImagePixelType                     V = outNIt.GetCenterPixel();
+    const InputImagePixelType               originalV = V;
     typename NOutputIterator::ConstIterator sIt;
     for (sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt)
     {
@@ -263,6 +388,11 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
       V = iV;
     }
 
+    if (Math::NotExactlyEquals(V, originalV))
+    {
+      recordChange(outNIt.GetIndex());
+    }
+
     // now put indexes in the fifo
     // typename CNInputIterator::ConstIterator mIt;
     for (oLIt = oIndexList.begin(), mLIt = mIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt)
@@ -305,6 +435,13 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
       // candidate for dilation via flooding
       if (compare(V, VN) && Math::NotAlmostEquals(iN, VN))
       {
+        // the pixels outside of the region belong to another slab, which
+        // will be processed again because of the change of this one
+        const OutIndexType neighborIndex = outNIt.GetIndex(*oLIt);
+        if (!region.IsInside(neighborIndex))
+        {
+          continue;
+        }
         if (compare(iN, V))
         {
           // not clamped by the mask, propagate the center value
@@ -315,27 +452,12 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
           // apply the clamping
           outNIt.SetPixel(*oLIt, iN);
         }
-        IndexFifo.push(outNIt.GetIndex(*oLIt));
+        recordChange(neighborIndex);
+        IndexFifo.push(neighborIndex);
       }
     }
     progress.CompletedPixel();
   }
-
-  if (m_UseInternalCopy)
-  {
-    using CropType = typename itk::CropImageFilter<InputImageType, OutputImageType>;
-    typename CropType::Pointer crop = CropType::New();
-
-    crop->SetInput(markerImageP);
-    crop->SetUpperBoundaryCropSize(padSize);
-    crop->SetLowerBoundaryCropSize(padSize);
-    crop->GraftOutput(this->GetOutput());
-    /** execute the minipipeline */
-    crop->Update();
-
-    /** graft the minipipeline output back into this filter's output */
-    this->GraftOutput(crop->GetOutput());
-  }
 }
 
 template <typename TInputImage, typename TOutputImage, typename TCompare>
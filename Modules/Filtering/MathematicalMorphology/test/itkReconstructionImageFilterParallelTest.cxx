@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using PixelType = unsigned char;
+using ImageType = itk::Image<PixelType, Dimension>;
+
+// Runs the reconstruction with a single work unit and with several ones, and
+// checks that the outputs are identical.
+template <typename TFilter>
+bool
+CompareSingleAndMultipleWorkUnits(const ImageType * marker, const ImageType * mask, const char * name)
+{
+  bool passed = true;
+  for (const bool useInternalCopy : { false, true })
+  {
+    for (const bool fullyConnected : { false, true })
+    {
+      ImageType::Pointer outputs[2];
+      for (const unsigned int numberOfWorkUnits : { 1, 7 })
+      {
+        auto filter = TFilter::New();
+        filter->SetMarkerImage(marker);
+        filter->SetMaskImage(mask);
+        filter->SetUseInternalCopy(useInternalCopy);
+        filter->SetFullyConnected(fullyConnected);
+        filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+        filter->Update();
+        outputs[numberOfWorkUnits > 1] = filter->GetOutput();
+        outputs[numberOfWorkUnits > 1]->DisconnectPipeline();
+      }
+
+      itk::ImageRegionConstIteratorWithIndex<ImageType> singleIt(outputs[0], outputs[0]->GetBufferedRegion());
+      itk::ImageRegionConstIteratorWithIndex<ImageType> multipleIt(outputs[1], outputs[1]->GetBufferedRegion());
+      for (; !singleIt.IsAtEnd(); ++singleIt, ++multipleIt)
+      {
+        if (singleIt.Get() != multipleIt.Get())
+        {
+          std::cerr << "Test failed! (" << name << ", UseInternalCopy " << useInternalCopy << ", FullyConnected "
+                    << fullyConnected << ")" << std::endl;
+          std::cerr << "Output with several work units differs at " << singleIt.GetIndex() << ": expected "
+                    << static_cast<int>(singleIt.Get()) << ", actual " << static_cast<int>(multipleIt.Get())
+                    << std::endl;
+          passed = false;
+          break;
+        }
+      }
+    }
+  }
+  return passed;
+}
+
+// A corridor which goes up and down the last dimension several times, so
+// that the reconstruction has to cross the boundaries between the slabs
+// processed by the different work units back and forth.
+bool
+IsOnCorridor(const ImageType::IndexType & index, const ImageType::SizeType & size)
+{
+  const itk::IndexValueType lastX = static_cast<itk::IndexValueType>(size[0]) - 1;
+  const itk::IndexValueType lastZ = static_cast<itk::IndexValueType>(size[2]) - 1;
+  if (index[1] == 1 || index[1] == 5)
+  {
+    if (index[2] % 2 == 0)
+    {
+      return true;
+    }
+    return index[0] == ((index[2] / 2) % 2 == 0 ? lastX : 0);
+  }
+  return index[0] == 0 && index[1] > 1 && index[1] < 5 && index[2] == lastZ;
+}
+} // namespace
+
+
+int
+itkReconstructionImageFilterParallelTest(int, char *[])
+{
+  const ImageType::SizeType size = { { 23, 9, 41 } };
+
+  auto mask = ImageType::New();
+  mask->SetRegions(size);
+  mask->Allocate();
+
+  auto marker = ImageType::New();
+  marker->SetRegions(size);
+  marker->Allocate();
+
+  std::mt19937                       randomNumberEngine;
+  std::uniform_int_distribution<int> distribution(0, 100);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> maskIt(mask, mask->GetBufferedRegion());
+  itk::ImageRegionIteratorWithIndex<ImageType> markerIt(marker, marker->GetBufferedRegion());
+  for (; !maskIt.IsAtEnd(); ++maskIt, ++markerIt)
+  {
+    const int value = IsOnCorridor(maskIt.GetIndex(), size) ? 200 : distribution(randomNumberEngine);
+    maskIt.Set(static_cast<PixelType>(value));
+    markerIt.Set(static_cast<PixelType>(std::max(value - 50, 0)));
+  }
+  // the seed at the beginning of the corridor
+  marker->SetPixel({ { 0, 1, 0 } }, 200);
+
+  bool passed = CompareSingleAndMultipleWorkUnits<itk::ReconstructionByDilationImageFilter<ImageType, ImageType>>(
+    marker, mask, "ReconstructionByDilation");
+
+  // the dual images, for the reconstruction by erosion
+  for (maskIt.GoToBegin(), markerIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt, ++markerIt)
+  {
+    maskIt.Set(static_cast<PixelType>(255 - maskIt.Get()));
+    markerIt.Set(static_cast<PixelType>(255 - markerIt.Get()));
+  }
+
+  passed = CompareSingleAndMultipleWorkUnits<itk::ReconstructionByErosionImageFilter<ImageType, ImageType>>(
+             marker, mask, "ReconstructionByErosion") &&
+           passed;
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,10 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkTotalProgressReporter.h"
+
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -36,6 +40,16 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For integer pixel types of at most 16 bits, the interior of the image is
+ * processed by a sliding histogram: when the neighborhood moves by one pixel
+ * along the first dimension, only the pixels that enter and leave it are
+ * added to and removed from a histogram of all possible pixel values, and the
+ * median is tracked incrementally. The cost per pixel is then proportional to
+ * the size of a single face of the neighborhood, rather than to its volume.
+ * The result is identical to the generic algorithm, which selects the median
+ * of every neighborhood by std::nth_element, and which is still used for the
+ * boundary regions and for all other pixel types.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -84,6 +98,13 @@ public:
 
   using InputSizeType = typename InputImageType::SizeType;
 
+  /** Tells whether the sliding histogram algorithm is used for this input
+   * pixel type: only integer types of at most 16 bits have a histogram of all
+   * possible values that is small enough. */
+  static constexpr bool UsesHistogramAlgorithm = std::is_integral<InputPixelType>::value &&
+                                                 !std::is_same<InputPixelType, bool>::value &&
+                                                 sizeof(InputPixelType) <= 2;
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<InputImageDimension, OutputImageDimension>));
@@ -108,6 +129,26 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  using NeighborhoodOffsetsType = std::vector<Offset<InputImageDimension>>;
+
+  /** Computes the median of each pixel of the specified region, which may not
+   * have neighborhoods that cross the buffer boundary, by std::nth_element. */
+  void
+  GenerateNonBoundaryRegion(const InputImageRegionType &  region,
+                            const NeighborhoodOffsetsType & neighborhoodOffsets,
+                            TotalProgressReporter &         progress,
+                            std::false_type);
+
+  /** Computes the median of each pixel of the specified region, which may not
+   * have neighborhoods that cross the buffer boundary, by a histogram that
+   * slides along the first image dimension. */
+  void
+  GenerateNonBoundaryRegion(const InputImageRegionType &  region,
+                            const NeighborhoodOffsetsType & neighborhoodOffsets,
+                            TotalProgressReporter &         progress,
+                            std::true_type);
 };
 } // end namespace itk
 
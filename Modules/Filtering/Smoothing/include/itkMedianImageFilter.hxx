@@ -30,6 +30,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <limits>
 
 namespace itk
 {
@@ -58,34 +60,22 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const auto neighborhoodOffsets = GenerateRectangularImageNeighborhoodOffsets<InputImageDimension>(radius);
   const auto neighborhoodSize = neighborhoodOffsets.size();
 
-  // All of our neighborhoods have an odd number of pixels, so there is
-  // always a median.
-  std::vector<InputPixelType> pixels(neighborhoodSize);
-  const auto                  medianIterator = pixels.begin() + (neighborhoodSize / 2);
-
-
   TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
 
   const auto nonBoundaryRegion = calculatorResult.GetNonBoundaryRegion();
   if (!nonBoundaryRegion.GetSize().empty())
   {
-    // Process the non-boundary subregion, using a faster pixel access policy without boundary extrapolation.
-    auto neighborhoodRange =
-      ShapedImageNeighborhoodRange<const InputImageType, BufferedImageNeighborhoodPixelAccessPolicy<InputImageType>>(
-        *input, Index<InputImageDimension>(), neighborhoodOffsets);
-    auto outputIterator = ImageRegionRange<OutputImageType>(*output, nonBoundaryRegion).begin();
-
-    for (const auto & index : ImageRegionIndexRange<InputImageDimension>(nonBoundaryRegion))
-    {
-      neighborhoodRange.SetLocation(index);
-      std::copy_n(neighborhoodRange.cbegin(), neighborhoodSize, pixels.begin());
-      std::nth_element(pixels.begin(), medianIterator, pixels.end());
-      *outputIterator = *medianIterator;
-      ++outputIterator;
-      progress.CompletedPixel();
-    }
+    this->GenerateNonBoundaryRegion(nonBoundaryRegion,
+                                    neighborhoodOffsets,
+                                    progress,
+                                    std::integral_constant<bool, UsesHistogramAlgorithm>());
   }
 
+  // All of our neighborhoods have an odd number of pixels, so there is
+  // always a median.
+  std::vector<InputPixelType> pixels(neighborhoodSize);
+  const auto                  medianIterator = pixels.begin() + (neighborhoodSize / 2);
+
   // Process each of the boundary faces.  These are N-d regions which border
   // the edge of the buffer.
   for (const auto & boundaryFace : calculatorResult.GetBoundaryFaces())
@@ -105,6 +95,169 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::GenerateNonBoundaryRegion(
+  const InputImageRegionType &    region,
+  const NeighborhoodOffsetsType & neighborhoodOffsets,
+  TotalProgressReporter &         progress,
+  std::false_type)
+{
+  OutputImageType &      output = *(this->GetOutput());
+  const InputImageType & input = *(this->GetInput());
+
+  const auto neighborhoodSize = neighborhoodOffsets.size();
+
+  std::vector<InputPixelType> pixels(neighborhoodSize);
+  const auto                  medianIterator = pixels.begin() + (neighborhoodSize / 2);
+
+  // Use a faster pixel access policy without boundary extrapolation.
+  auto neighborhoodRange =
+    ShapedImageNeighborhoodRange<const InputImageType, BufferedImageNeighborhoodPixelAccessPolicy<InputImageType>>(
+      input, Index<InputImageDimension>(), neighborhoodOffsets);
+  auto outputIterator = ImageRegionRange<OutputImageType>(output, region).begin();
+
+  for (const auto & index : ImageRegionIndexRange<InputImageDimension>(region))
+  {
+    neighborhoodRange.SetLocation(index);
+    std::copy_n(neighborhoodRange.cbegin(), neighborhoodSize, pixels.begin());
+    std::nth_element(pixels.begin(), medianIterator, pixels.end());
+    *outputIterator = *medianIterator;
+    ++outputIterator;
+    progress.CompletedPixel();
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::GenerateNonBoundaryRegion(
+  const InputImageRegionType &    region,
+  const NeighborhoodOffsetsType & neighborhoodOffsets,
+  TotalProgressReporter &         progress,
+  std::true_type)
+{
+  using NeighborhoodRangeType =
+    ShapedImageNeighborhoodRange<const InputImageType, BufferedImageNeighborhoodPixelAccessPolicy<InputImageType>>;
+
+  OutputImageType &      output = *(this->GetOutput());
+  const InputImageType & input = *(this->GetInput());
+
+  const auto radius0 = static_cast<OffsetValueType>(this->GetRadius()[0]);
+
+  // When the neighborhood moves one pixel along the first dimension, the
+  // pixels at the last position of the first dimension enter it, and those
+  // that were at its first position leave it.
+  NeighborhoodOffsetsType enteringOffsets;
+  NeighborhoodOffsetsType leavingOffsets;
+  for (const auto & offset : neighborhoodOffsets)
+  {
+    if (offset[0] == radius0)
+    {
+      enteringOffsets.push_back(offset);
+      auto leavingOffset = offset;
+      leavingOffset[0] = -radius0 - 1;
+      leavingOffsets.push_back(leavingOffset);
+    }
+  }
+
+  const Index<InputImageDimension> zeroIndex{};
+  NeighborhoodRangeType            neighborhoodRange(input, zeroIndex, neighborhoodOffsets);
+  NeighborhoodRangeType            enteringRange(input, zeroIndex, enteringOffsets);
+  NeighborhoodRangeType            leavingRange(input, zeroIndex, leavingOffsets);
+
+  // A histogram bin for each possible pixel value, ordered by value.
+  const auto     minimumPixelValue = static_cast<std::ptrdiff_t>(std::numeric_limits<InputPixelType>::min());
+  std::vector<SizeValueType> histogram(std::size_t{ 1 } << (8 * sizeof(InputPixelType)));
+
+  const auto toBin = [minimumPixelValue](const InputPixelType pixelValue) {
+    return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(pixelValue) - minimumPixelValue);
+  };
+
+  // The median is the pixel value of the bin that contains the element at
+  // this (zero-based) rank. The number of histogram entries in the bins below
+  // the median bin is tracked while the neighborhood moves, so that the median
+  // bin only needs to move over the bins that are passed by the update.
+  const SizeValueType medianRank = neighborhoodOffsets.size() / 2;
+  std::size_t         medianBin = 0;
+  SizeValueType       numberOfEntriesBelowMedianBin = 0;
+
+  const auto addPixel = [&histogram, &toBin, &medianBin, &numberOfEntriesBelowMedianBin](
+                          const InputPixelType pixelValue) {
+    const auto bin = toBin(pixelValue);
+    ++histogram[bin];
+    if (bin < medianBin)
+    {
+      ++numberOfEntriesBelowMedianBin;
+    }
+  };
+  const auto removePixel = [&histogram, &toBin, &medianBin, &numberOfEntriesBelowMedianBin](
+                             const InputPixelType pixelValue) {
+    const auto bin = toBin(pixelValue);
+    --histogram[bin];
+    if (bin < medianBin)
+    {
+      --numberOfEntriesBelowMedianBin;
+    }
+  };
+  const auto updateMedian = [&histogram, medianRank, minimumPixelValue, &medianBin, &numberOfEntriesBelowMedianBin] {
+    while (numberOfEntriesBelowMedianBin > medianRank)
+    {
+      --medianBin;
+      numberOfEntriesBelowMedianBin -= histogram[medianBin];
+    }
+    while (numberOfEntriesBelowMedianBin + histogram[medianBin] <= medianRank)
+    {
+      numberOfEntriesBelowMedianBin += histogram[medianBin];
+      ++medianBin;
+    }
+    return static_cast<InputPixelType>(static_cast<std::ptrdiff_t>(medianBin) + minimumPixelValue);
+  };
+
+  auto rowRegion = region;
+  rowRegion.SetSize(0, 1);
+  const auto rowLength = static_cast<OffsetValueType>(region.GetSize(0));
+
+  auto outputIterator = ImageRegionRange<OutputImageType>(output, region).begin();
+
+  for (auto index : ImageRegionIndexRange<InputImageDimension>(rowRegion))
+  {
+    neighborhoodRange.SetLocation(index);
+    for (const InputPixelType pixelValue : neighborhoodRange)
+    {
+      addPixel(pixelValue);
+    }
+    *outputIterator = updateMedian();
+    ++outputIterator;
+    progress.CompletedPixel();
+
+    for (OffsetValueType i = 1; i < rowLength; ++i)
+    {
+      ++index[0];
+      leavingRange.SetLocation(index);
+      for (const InputPixelType pixelValue : leavingRange)
+      {
+        removePixel(pixelValue);
+      }
+      enteringRange.SetLocation(index);
+      for (const InputPixelType pixelValue : enteringRange)
+      {
+        addPixel(pixelValue);
+      }
+      *outputIterator = updateMedian();
+      ++outputIterator;
+      progress.CompletedPixel();
+    }
+
+    // Empty the histogram for the next row, by removing the last neighborhood.
+    neighborhoodRange.SetLocation(index);
+    for (const InputPixelType pixelValue : neighborhoodRange)
+    {
+      removePixel(pixelValue);
+    }
+  }
+}
 } // end namespace itk
 
 #endif
@@ -22,7 +22,10 @@
 #include "itkImage.h"
 #include "itkImageBufferRange.h"
 
+#include <algorithm> // For equal.
+#include <limits>
 #include <numeric> // For iota.
+#include <random>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -92,6 +95,68 @@ Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numb
   EXPECT_EQ(outputPixelValues, expectedPixelValues);
 }
 
+
+// Checks that the sliding histogram algorithm, which is used for an integer pixel type, yields the same output as the
+// generic algorithm (using std::nth_element), which is used for the corresponding image of type double.
+template <typename TIntegerImage>
+void
+Expect_histogram_algorithm_yields_same_output_as_generic_algorithm(
+  const typename TIntegerImage::RegionType & imageRegion,
+  const typename TIntegerImage::SizeType &   radius)
+{
+  using IntegerPixelType = typename TIntegerImage::PixelType;
+  using DoubleImageType = itk::Image<double, TIntegerImage::ImageDimension>;
+
+  static_assert(itk::MedianImageFilter<TIntegerImage, TIntegerImage>::UsesHistogramAlgorithm,
+                "The histogram algorithm should be used for the integer pixel type");
+  static_assert(!itk::MedianImageFilter<DoubleImageType, DoubleImageType>::UsesHistogramAlgorithm,
+                "The generic algorithm should be used for double");
+
+  const auto integerImage = TIntegerImage::New();
+  integerImage->SetRegions(imageRegion);
+  integerImage->Allocate();
+  const auto doubleImage = DoubleImageType::New();
+  doubleImage->SetRegions(imageRegion);
+  doubleImage->Allocate();
+
+  std::mt19937                            randomNumberEngine;
+  std::uniform_int_distribution<long long> distribution(std::numeric_limits<IntegerPixelType>::min(),
+                                                        std::numeric_limits<IntegerPixelType>::max());
+
+  const auto integerRange = itk::ImageBufferRange<TIntegerImage>{ *integerImage };
+  const auto doubleRange = itk::ImageBufferRange<DoubleImageType>{ *doubleImage };
+  auto       doubleIterator = doubleRange.begin();
+
+  for (auto && pixel : integerRange)
+  {
+    const auto value = static_cast<IntegerPixelType>(distribution(randomNumberEngine));
+    pixel = value;
+    *doubleIterator = value;
+    ++doubleIterator;
+  }
+
+  const auto integerFilter = itk::MedianImageFilter<TIntegerImage, TIntegerImage>::New();
+  integerFilter->SetInput(integerImage);
+  integerFilter->SetRadius(radius);
+  integerFilter->Update();
+
+  const auto doubleFilter = itk::MedianImageFilter<DoubleImageType, DoubleImageType>::New();
+  doubleFilter->SetInput(doubleImage);
+  doubleFilter->SetRadius(radius);
+  doubleFilter->Update();
+
+  const auto integerOutputRange = itk::MakeImageBufferRange(integerFilter->GetOutput());
+  const auto doubleOutputRange = itk::MakeImageBufferRange(doubleFilter->GetOutput());
+
+  ASSERT_EQ(integerOutputRange.size(), doubleOutputRange.size());
+  EXPECT_TRUE(std::equal(integerOutputRange.cbegin(),
+                         integerOutputRange.cend(),
+                         doubleOutputRange.cbegin(),
+                         [](const IntegerPixelType integerPixel, const double doublePixel) {
+                           return static_cast<double>(integerPixel) == doublePixel;
+                         }));
+}
+
 } // namespace
 
 
@@ -122,3 +187,18 @@ TEST(MedianImageFilter, ExpectedOutputPixelValuesForSequenceOfNaturalNumbers)
   Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numbers<itk::Image<int, 3>>(
     itk::Size<3>{ { 2, 2, 2 } }, { 3, 3, 3, 4, 5, 6, 6, 6 });
 }
+
+
+// Tests that the sliding histogram algorithm for 8-bit and 16-bit pixel types yields the same output as the generic
+// algorithm.
+TEST(MedianImageFilter, HistogramAlgorithmYieldsSameOutputAsGenericAlgorithm)
+{
+  Expect_histogram_algorithm_yields_same_output_as_generic_algorithm<itk::Image<unsigned char>>(
+    itk::Size<>{ { 32, 24 } }, itk::Size<>{ { 3, 2 } });
+  Expect_histogram_algorithm_yields_same_output_as_generic_algorithm<itk::Image<signed char>>(
+    itk::Size<>{ { 17, 9 } }, itk::Size<>{ { 1, 4 } });
+  Expect_histogram_algorithm_yields_same_output_as_generic_algorithm<itk::Image<short, 3>>(
+    itk::Size<3>{ { 12, 11, 10 } }, itk::Size<3>{ { 2, 2, 2 } });
+  Expect_histogram_algorithm_yields_same_output_as_generic_algorithm<itk::Image<unsigned short, 3>>(
+    itk::Size<3>{ { 9, 10, 11 } }, itk::Size<3>{ { 3, 1, 2 } });
+}
@@ -359,6 +359,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
   void
   InternalReadImageInformation();
 
@@ -24,12 +24,6 @@
 #include <vector>
 #include "ITKIOGDCMExport.h"
 
-// forward declaration, to remove compile dependency on GDCM library
-namespace gdcm
-{
-class SerieHelper;
-}
-
 namespace itk
 {
 /**
@@ -51,6 +45,12 @@ namespace itk
  *    DICOM objects, you may want to try calling SetUseSeriesDetails(true)
  *    prior to calling SetDirectory().
  *
+ * The headers of the files are read concurrently, up to their pixel data,
+ * and only the tags which identify and order the series are kept. If a
+ * ScanIndexFileName is set, these tags are also stored in that file, with
+ * the modification time and the size of each file, so that scanning the
+ * directory again only reads the headers of the files which have changed.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOGDCM
@@ -185,6 +185,18 @@ public:
   itkGetConstMacro(LoadPrivateTags, bool);
   itkBooleanMacro(LoadPrivateTags);
 
+  /** Set/Get the name of the file where the tags read from the headers are
+   * stored, and looked up by the following scans, of this directory or
+   * others. No index is used if it is empty, which is the default.
+   * Must be set before the call to SetInputDirectory(). */
+  itkSetStringMacro(ScanIndexFileName);
+  itkGetStringMacro(ScanIndexFileName);
+
+  /** Get the number of files whose header was read by the last scan of a
+   * directory. The headers of the other files were found in the scan
+   * index. */
+  itkGetConstMacro(NumberOfParsedFiles, SizeValueType);
+
 protected:
   GDCMSeriesFileNames();
   ~GDCMSeriesFileNames() override;
@@ -192,6 +204,11 @@ protected:
   PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
+  /** Read the headers of the files of the directory, or look them up in the
+   * scan index, and add them to the SerieHelper. */
+  void
+  ScanDirectory(const std::string & name);
+
   /** Contains the input directory where the DICOM serie is found */
   std::string m_InputDirectory = "";
 
@@ -203,11 +220,19 @@ private:
   FileNamesContainerType m_OutputFileNames;
 
   /** Internal structure to order serie from one directory */
-  std::unique_ptr<gdcm::SerieHelper> m_SerieHelper;
+  class SerieHelper;
+  std::unique_ptr<SerieHelper> m_SerieHelper;
 
   /** Internal structure to keep the list of series UIDs */
   SeriesUIDContainerType m_SeriesUIDs;
 
+  /** The tags added by AddSeriesRestriction(), which the scan must keep */
+  std::vector<std::string> m_SeriesRestrictions;
+
+  std::string m_ScanIndexFileName;
+
+  SizeValueType m_NumberOfParsedFiles = 0;
+
   bool m_UseSeriesDetails = true;
   bool m_Recursive = false;
   bool m_LoadSequences = false;
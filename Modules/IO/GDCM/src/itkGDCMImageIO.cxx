@@ -1587,6 +1587,25 @@ GDCMImageIO::InternalSetCompressor(const std::string & _compressor)
   }
 }
 
+LightObject::Pointer
+GDCMImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_UIDPrefix = this->m_UIDPrefix;
+  rval->m_KeepOriginalUID = this->m_KeepOriginalUID;
+  rval->m_LoadPrivateTags = this->m_LoadPrivateTags;
+  rval->m_ReadYBRtoRGB = this->m_ReadYBRtoRGB;
+  rval->m_CompressionType = this->m_CompressionType;
+
+  return loPtr;
+}
+
 void
 GDCMImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
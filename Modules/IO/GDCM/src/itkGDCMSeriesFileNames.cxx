@@ -21,14 +21,206 @@
 #include "itkGDCMSeriesFileNames.h"
 #include "itksys/SystemTools.hxx"
 #include "itkProgressReporter.h"
+#include "itkMultiThreaderBase.h"
 #include "gdcmSerieHelper.h"
+#include "gdcmDirectory.h"
+#include "gdcmReader.h"
+#include "gdcmWriter.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace
+{
+// The tags read by gdcm::SerieHelper to identify the series, with the
+// default series details, and to order their files.
+const gdcm::Tag SeriesTags[] = {
+  gdcm::Tag(0x0008, 0x0016), // SOP Class UID
+  gdcm::Tag(0x0008, 0x0018), // SOP Instance UID, required by gdcm::Writer
+  gdcm::Tag(0x0008, 0x0060), // Modality
+  gdcm::Tag(0x0008, 0x2112), // Source Image Sequence
+  gdcm::Tag(0x0018, 0x0024), // Sequence Name
+  gdcm::Tag(0x0018, 0x0050), // Slice Thickness
+  gdcm::Tag(0x0020, 0x000e), // Series Instance UID
+  gdcm::Tag(0x0020, 0x0011), // Series Number
+  gdcm::Tag(0x0020, 0x0013), // Instance Number
+  gdcm::Tag(0x0020, 0x0032), // Image Position (Patient)
+  gdcm::Tag(0x0020, 0x0037), // Image Orientation (Patient)
+  gdcm::Tag(0x0028, 0x0008), // Number of Frames
+  gdcm::Tag(0x0028, 0x0010), // Rows
+  gdcm::Tag(0x0028, 0x0011), // Columns
+  gdcm::Tag(0x0054, 0x0022), // Detector Information Sequence
+  gdcm::Tag(0x5200, 0x9229), // Shared Functional Groups Sequence
+  gdcm::Tag(0x5200, 0x9230), // Per-frame Functional Groups Sequence
+};
+
+const char ScanIndexSignature[] = "ITKGDCMScanIndex1";
+
+// The tags of a file kept by a scan, serialized as a DICOM stream, and what
+// identifies the version of the file they were read from.
+struct ScannedFile
+{
+  long int      ModifiedTime{ 0 };
+  unsigned long Length{ 0 };
+  bool          IsImage{ false };
+  std::string   Header;
+};
 
-namespace itk
+using ScanIndexType = std::map<std::string, ScannedFile>;
+
+void
+SelectTags(gdcm::File & file, const std::set<gdcm::Tag> & tags)
+{
+  gdcm::DataSet dataSet;
+  for (const gdcm::Tag & tag : tags)
+  {
+    if (file.GetDataSet().FindDataElement(tag))
+    {
+      dataSet.Insert(file.GetDataSet().GetDataElement(tag));
+    }
+  }
+  file.SetDataSet(dataSet);
+}
+
+// Returns an empty string if the header can not be written.
+std::string
+SerializeHeader(const gdcm::File & file)
+{
+  std::ostringstream stream;
+  gdcm::Writer       writer;
+  writer.SetStream(stream);
+  writer.SetFile(file);
+  writer.CheckFileMetaInformationOff();
+  return writer.Write() ? stream.str() : std::string();
+}
+
+template <typename T>
+void
+WriteValue(std::ostream & stream, const T & value)
+{
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void
+WriteString(std::ostream & stream, const std::string & value)
+{
+  WriteValue(stream, static_cast<uint64_t>(value.size()));
+  stream.write(value.data(), value.size());
+}
+
+template <typename T>
+bool
+ReadValue(std::istream & stream, T & value)
+{
+  return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+bool
+ReadString(std::istream & stream, std::string & value)
+{
+  uint64_t size = 0;
+  if (!ReadValue(stream, size) || size > (uint64_t{ 1 } << 32))
+  {
+    return false;
+  }
+  value.resize(static_cast<size_t>(size));
+  return size == 0 || static_cast<bool>(stream.read(&value[0], value.size()));
+}
+
+// Returns the entries of the scan index, or none if the file does not exist,
+// is not a scan index, or keeps other tags.
+ScanIndexType
+ReadScanIndex(const std::string & fileName, const std::set<gdcm::Tag> & tags)
+{
+  ScanIndexType scanIndex;
+  std::ifstream stream(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string   signature;
+  uint64_t      numberOfTags = 0;
+  if (!stream || !ReadString(stream, signature) || signature != ScanIndexSignature ||
+      !ReadValue(stream, numberOfTags) || numberOfTags != tags.size())
+  {
+    return scanIndex;
+  }
+  for (const gdcm::Tag & tag : tags)
+  {
+    uint32_t element = 0;
+    if (!ReadValue(stream, element) || element != tag.GetElementTag())
+    {
+      return scanIndex;
+    }
+  }
+  std::string path;
+  while (ReadString(stream, path))
+  {
+    ScannedFile scannedFile;
+    int64_t     modifiedTime = 0;
+    uint64_t    length = 0;
+    uint8_t     isImage = 0;
+    if (!ReadValue(stream, modifiedTime) || !ReadValue(stream, length) || !ReadValue(stream, isImage) ||
+        !ReadString(stream, scannedFile.Header))
+    {
+      break;
+    }
+    scannedFile.ModifiedTime = static_cast<long int>(modifiedTime);
+    scannedFile.Length = static_cast<unsigned long>(length);
+    scannedFile.IsImage = isImage != 0;
+    scanIndex[path] = std::move(scannedFile);
+  }
+  return scanIndex;
+}
+
+// Writes the scan index to a temporary file, which then replaces the index,
+// so that a scan index is never read partially written.
+bool
+WriteScanIndex(const std::string & fileName, const std::set<gdcm::Tag> & tags, const ScanIndexType & scanIndex)
 {
+  const std::string temporaryFileName = fileName + ".tmp";
+  {
+    std::ofstream stream(temporaryFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+      return false;
+    }
+    WriteString(stream, ScanIndexSignature);
+    WriteValue(stream, static_cast<uint64_t>(tags.size()));
+    for (const gdcm::Tag & tag : tags)
+    {
+      WriteValue(stream, static_cast<uint32_t>(tag.GetElementTag()));
+    }
+    for (const auto & entry : scanIndex)
+    {
+      WriteString(stream, entry.first);
+      WriteValue(stream, static_cast<int64_t>(entry.second.ModifiedTime));
+      WriteValue(stream, static_cast<uint64_t>(entry.second.Length));
+      WriteValue(stream, static_cast<uint8_t>(entry.second.IsImage));
+      WriteString(stream, entry.second.Header);
+    }
+    if (!stream)
+    {
+      return false;
+    }
+  }
+  // std::rename() does not replace an existing file on all platforms
+  return std::rename(temporaryFileName.c_str(), fileName.c_str()) == 0 ||
+         (itksys::SystemTools::RemoveFile(fileName) && std::rename(temporaryFileName.c_str(), fileName.c_str()) == 0);
+}
+} // namespace
 
+namespace itk
+{
+// The SerieHelper to which the scan adds the headers it reads.
+class GDCMSeriesFileNames::SerieHelper : public gdcm::SerieHelper
+{
+public:
+  using gdcm::SerieHelper::AddFile;
+};
 
 GDCMSeriesFileNames::GDCMSeriesFileNames()
-  : m_SerieHelper{ new gdcm::SerieHelper() }
+  : m_SerieHelper{ new SerieHelper() }
 {}
 
 GDCMSeriesFileNames::~GDCMSeriesFileNames() = default;
@@ -49,6 +241,7 @@ void
 GDCMSeriesFileNames::AddSeriesRestriction(const std::string & tag)
 {
   m_SerieHelper->AddRestriction(tag);
+  m_SeriesRestrictions.push_back(tag);
 }
 
 void
@@ -73,11 +266,121 @@ GDCMSeriesFileNames::SetInputDirectory(std::string const & name)
   m_SerieHelper->Clear();
   m_SerieHelper->SetUseSeriesDetails(m_UseSeriesDetails);
   m_SerieHelper->SetLoadMode((m_LoadSequences ? 0 : gdcm::LD_NOSEQ) | (m_LoadPrivateTags ? 0 : gdcm::LD_NOSHADOW));
-  m_SerieHelper->SetDirectory(name, m_Recursive);
+  this->ScanDirectory(name);
   // as a side effect it also execute
   this->Modified();
 }
 
+void
+GDCMSeriesFileNames::ScanDirectory(const std::string & name)
+{
+  gdcm::Directory directory;
+  directory.Load(name, m_Recursive);
+  const gdcm::Directory::FilenamesType & fileNames = directory.GetFilenames();
+
+  std::set<gdcm::Tag> tags(std::begin(SeriesTags), std::end(SeriesTags));
+  for (const std::string & restriction : m_SeriesRestrictions)
+  {
+    gdcm::Tag tag;
+    tag.ReadFromPipeSeparatedString(restriction.c_str());
+    tags.insert(tag);
+  }
+
+  const bool    useScanIndex = !m_ScanIndexFileName.empty();
+  ScanIndexType scanIndex;
+  if (useScanIndex)
+  {
+    scanIndex = ReadScanIndex(m_ScanIndexFileName, tags);
+  }
+
+  // Read the headers up to the pixel data, unless the file is indexed, as
+  // gdcm::SerieHelper::SetDirectory() would, without reading the pixel data.
+  std::vector<ScannedFile>                            scannedFiles(fileNames.size());
+  std::vector<gdcm::SmartPointer<gdcm::FileWithName>> headers(fileNames.size());
+  std::atomic<SizeValueType>                          numberOfParsedFiles{ 0 };
+  const auto                                          scanFile = [&](SizeValueType i) {
+    const std::string & fileName = fileNames[i];
+    ScannedFile &       scannedFile = scannedFiles[i];
+    scannedFile.ModifiedTime = itksys::SystemTools::ModifiedTime(fileName);
+    scannedFile.Length = itksys::SystemTools::FileLength(fileName);
+
+    // the header of an indexed image is read from the index
+    gdcm::Reader       indexReader;
+    std::istringstream indexedHeader;
+    const auto         indexed = scanIndex.find(fileName);
+    bool               isIndexed = indexed != scanIndex.end() &&
+                                 indexed->second.ModifiedTime == scannedFile.ModifiedTime &&
+                                 indexed->second.Length == scannedFile.Length;
+    if (isIndexed && indexed->second.IsImage)
+    {
+      indexedHeader.str(indexed->second.Header);
+      indexReader.SetStream(indexedHeader);
+      isIndexed = indexReader.Read();
+    }
+
+    gdcm::Reader   fileReader;
+    gdcm::Reader * headerReader = &indexReader;
+    if (isIndexed)
+    {
+      scannedFile.IsImage = indexed->second.IsImage;
+      scannedFile.Header = indexed->second.Header;
+    }
+    else
+    {
+      // Only accept the DICOM files with pixel data, before which the
+      // reading stops.
+      const gdcm::Tag pixelData(0x7fe0, 0x0010);
+      fileReader.SetFileName(fileName.c_str());
+      scannedFile.IsImage = fileReader.ReadUpToTag(pixelData, { pixelData }) &&
+                            fileReader.GetStreamCurrentPosition() < scannedFile.Length;
+      headerReader = &fileReader;
+      ++numberOfParsedFiles;
+      if (scannedFile.IsImage)
+      {
+        SelectTags(fileReader.GetFile(), tags);
+        if (useScanIndex)
+        {
+          scannedFile.Header = SerializeHeader(fileReader.GetFile());
+        }
+      }
+    }
+    if (scannedFile.IsImage)
+    {
+      headers[i] = new gdcm::FileWithName(headerReader->GetFile());
+      headers[i]->filename = fileName;
+    }
+  };
+  MultiThreaderBase::New()->ParallelizeArray(0, static_cast<SizeValueType>(fileNames.size()), scanFile, nullptr);
+  m_NumberOfParsedFiles = numberOfParsedFiles;
+
+  // in the order of the directory, as the order of the files of a series
+  // which can not be sorted depends on it
+  for (const auto & header : headers)
+  {
+    if (header)
+    {
+      m_SerieHelper->AddFile(*header);
+    }
+  }
+
+  if (useScanIndex)
+  {
+    // keep the entries of the files of other directories which still exist
+    for (auto it = scanIndex.begin(); it != scanIndex.end();)
+    {
+      it = itksys::SystemTools::FileExists(it->first) ? std::next(it) : scanIndex.erase(it);
+    }
+    for (size_t i = 0; i < fileNames.size(); ++i)
+    {
+      scanIndex[fileNames[i]] = std::move(scannedFiles[i]);
+    }
+    if (!WriteScanIndex(m_ScanIndexFileName, tags, scanIndex))
+    {
+      itkWarningMacro(<< "The scan index could not be written to " << m_ScanIndexFileName);
+    }
+  }
+}
+
 const GDCMSeriesFileNames::SeriesUIDContainerType &
 GDCMSeriesFileNames::GetSeriesUIDs()
 {
@@ -272,6 +575,8 @@ GDCMSeriesFileNames::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "InputDirectory: " << m_InputDirectory << std::endl;
   os << indent << "LoadSequences:" << m_LoadSequences << std::endl;
   os << indent << "LoadPrivateTags:" << m_LoadPrivateTags << std::endl;
+  os << indent << "ScanIndexFileName: " << m_ScanIndexFileName << std::endl;
+  os << indent << "NumberOfParsedFiles: " << m_NumberOfParsedFiles << std::endl;
   if (m_Recursive)
   {
     os << indent << "Recursive: True" << std::endl;
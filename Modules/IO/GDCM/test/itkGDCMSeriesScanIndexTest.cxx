@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGDCMImageIO.h"
+#include "itkGDCMSeriesFileNames.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+using ImageType = itk::Image<short, 2>;
+using FileNamesType = itk::GDCMSeriesFileNames::FileNamesContainerType;
+
+// Writes a slice of the series at the position z, with a description whose
+// length changes the length of the file.
+int
+WriteSlice(const std::string & fileName,
+           const std::string & seriesUID,
+           int                 z,
+           const std::string & description = "Slice")
+{
+  ImageType::SizeType size;
+  size.Fill(8);
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  image->FillBuffer(static_cast<short>(z));
+
+  itk::MetaDataDictionary & dictionary = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|103e", description);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", seriesUID);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", std::to_string(z + 1));
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", "0\\0\\" + std::to_string(2 * z));
+
+  // the series UID is not replaced by a new one
+  auto imageIO = itk::GDCMImageIO::New();
+  imageIO->KeepOriginalUIDOn();
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  return EXIT_SUCCESS;
+}
+
+// The series and their files, in the order of their files.
+std::vector<FileNamesType>
+GetSeries(itk::GDCMSeriesFileNames * seriesFileNames)
+{
+  std::vector<FileNamesType> series;
+  for (const std::string & seriesUID : seriesFileNames->GetSeriesUIDs())
+  {
+    series.push_back(seriesFileNames->GetFileNames(seriesUID));
+  }
+  std::sort(series.begin(), series.end());
+  return series;
+}
+
+int
+CheckSeries(const std::vector<FileNamesType> & series, const std::vector<FileNamesType> & expected)
+{
+  ITK_TEST_EXPECT_EQUAL(series.size(), expected.size());
+  for (size_t i = 0; i < std::min(series.size(), expected.size()); ++i)
+  {
+    if (series[i] != expected[i])
+    {
+      std::cerr << "The files of the series " << i << " differ from the expected ones:" << std::endl;
+      for (const std::string & fileName : series[i])
+      {
+        std::cerr << "  " << fileName << std::endl;
+      }
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// Scans the directory with a new GDCMSeriesFileNames, and checks the series
+// found and the number of files whose header was read.
+int
+Scan(const std::string &                directory,
+     const std::string &                restriction,
+     const std::string &                scanIndexFileName,
+     const std::vector<FileNamesType> & expected,
+     itk::SizeValueType                 expectedNumberOfParsedFiles)
+{
+  auto seriesFileNames = itk::GDCMSeriesFileNames::New();
+  seriesFileNames->SetScanIndexFileName(scanIndexFileName);
+  seriesFileNames->AddSeriesRestriction(restriction);
+  seriesFileNames->SetInputDirectory(directory);
+  ITK_TEST_EXPECT_EQUAL(seriesFileNames->GetNumberOfParsedFiles(), expectedNumberOfParsedFiles);
+  return CheckSeries(GetSeries(seriesFileNames), expected);
+}
+
+// The files of the directory with the given names, in this order.
+FileNamesType
+GetFileNames(const std::string & directory, std::initializer_list<const char *> names)
+{
+  FileNamesType fileNames;
+  for (const char * name : names)
+  {
+    fileNames.push_back(directory + '/' + name);
+  }
+  return fileNames;
+}
+} // namespace
+
+
+int
+itkGDCMSeriesScanIndexTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // several files read concurrently, whatever the number of processors
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(4);
+
+  const std::string directory = std::string(argv[1]) + "/itkGDCMSeriesScanIndexTest";
+  const std::string scanIndexFileName = std::string(argv[1]) + "/itkGDCMSeriesScanIndexTest.index";
+  itksys::SystemTools::RemoveADirectory(directory);
+  itksys::SystemTools::MakeDirectory(directory);
+  itksys::SystemTools::RemoveFile(scanIndexFileName);
+
+  // two series, whose files are not named in the order of their slices, and
+  // a file which is not a DICOM file
+  const std::string firstSeriesUID = "1.2.826.0.1.3680043.2.1125.1.1";
+  const std::string secondSeriesUID = "1.2.826.0.1.3680043.2.1125.1.2";
+  const int         positions[] = { 3, 0, 5, 1, 4, 2 };
+  for (int i = 0; i < 6; ++i)
+  {
+    const std::string fileName = directory + "/first" + std::to_string(i) + ".dcm";
+    ITK_TEST_EXPECT_EQUAL(WriteSlice(fileName, firstSeriesUID, positions[i]), EXIT_SUCCESS);
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    const std::string fileName = directory + "/second" + std::to_string(i) + ".dcm";
+    ITK_TEST_EXPECT_EQUAL(WriteSlice(fileName, secondSeriesUID, 2 - i), EXIT_SUCCESS);
+  }
+  std::ofstream(directory + "/notDicom.txt") << "This is not a DICOM file." << std::endl;
+
+  auto seriesFileNames = itk::GDCMSeriesFileNames::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(seriesFileNames, GDCMSeriesFileNames, ProcessObject);
+  ITK_TEST_SET_GET_VALUE(std::string(), seriesFileNames->GetScanIndexFileName());
+  ITK_TEST_SET_GET_VALUE(0, seriesFileNames->GetNumberOfParsedFiles());
+
+  const std::string restriction = "0008|103e";
+  int               result = EXIT_SUCCESS;
+
+  // the series ordered by slice position; all the files are read without
+  // the index, and to build it, while none is read with the index built
+  const FileNamesType firstSeries =
+    GetFileNames(directory, { "first1.dcm", "first3.dcm", "first5.dcm", "first0.dcm", "first4.dcm", "first2.dcm" });
+  const FileNamesType secondSeries = GetFileNames(directory, { "second2.dcm", "second1.dcm", "second0.dcm" });
+  std::vector<FileNamesType> expected{ firstSeries, secondSeries };
+  std::sort(expected.begin(), expected.end());
+  for (const std::string & indexFileName : { std::string(), scanIndexFileName })
+  {
+    if (Scan(directory, restriction, indexFileName, expected, 10) != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(scanIndexFileName, true));
+  if (Scan(directory, restriction, scanIndexFileName, expected, 0) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // a file which has changed is read again: the slice moves to the end, in
+  // a series of its own since its description differs
+  ITK_TEST_EXPECT_EQUAL(
+    WriteSlice(directory + "/first1.dcm", firstSeriesUID, 10, "Same series, another description"), EXIT_SUCCESS);
+  expected = { FileNamesType(firstSeries.begin() + 1, firstSeries.end()),
+               GetFileNames(directory, { "first1.dcm" }),
+               secondSeries };
+  std::sort(expected.begin(), expected.end());
+  if (Scan(directory, restriction, scanIndexFileName, expected, 1) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // an index which keeps other tags is not used, and is rewritten
+  std::vector<FileNamesType> expectedWithoutDescription{
+    GetFileNames(directory, { "first3.dcm", "first5.dcm", "first0.dcm", "first4.dcm", "first2.dcm", "first1.dcm" }),
+    secondSeries
+  };
+  std::sort(expectedWithoutDescription.begin(), expectedWithoutDescription.end());
+  if (Scan(directory, "0018|0050", scanIndexFileName, expectedWithoutDescription, 10) != EXIT_SUCCESS ||
+      Scan(directory, "0018|0050", scanIndexFileName, expectedWithoutDescription, 0) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // an index which is not a scan index is not used
+  std::ofstream(scanIndexFileName) << "This is not a scan index." << std::endl;
+  if (Scan(directory, restriction, scanIndexFileName, expected, 10) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
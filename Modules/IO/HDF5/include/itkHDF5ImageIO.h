@@ -79,6 +79,10 @@ namespace itk
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The voxel data is stored in compressed chunks, whose size can be chosen
+ * with SetChunkSize() to match the regions in which the image is streamed.
+ * A region is read by decompressing only the chunks it intersects, several
+ * of them concurrently. A region can also be pasted into an existing file.
  *
  */
 
@@ -137,6 +141,23 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Set/Get the size of the chunks in which the voxel data is written, in
+   * voxels and with the fastest moving index first, like the image size.
+   * A chunk is the unit of compression: reading a voxel decompresses its
+   * whole chunk, so chunks matching the streamed regions, such as blocks of
+   * 64x64x64 voxels for a volume read in blocks, avoid decompressing whole
+   * slices. The chunk size is clamped to the image size. When it is empty,
+   * the default, a chunk is a slice along the slowest moving dimension. */
+  itkSetMacro(ChunkSize, std::vector<SizeValueType>);
+  itkGetConstReferenceMacro(ChunkSize, std::vector<SizeValueType>);
+
+  /** Set/Get the size in bytes of the cache of decompressed chunks of the
+   * voxel data. It should hold the chunks intersected by a streamed region,
+   * so that they are not decompressed (or compressed, when writing) once for
+   * each region. The default, 0, keeps the HDF5 default of 1 MiB. */
+  itkSetMacro(ChunkCacheSize, SizeValueType);
+  itkGetConstMacro(ChunkCacheSize, SizeValueType);
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO() override;
@@ -147,6 +168,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
 private:
   void
   WriteString(const std::string & path, const std::string & value);
@@ -203,6 +227,13 @@ private:
   void
   SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace);
 
+  /** Read the IORegion by reading the compressed chunks it intersects, and
+   * decompressing them concurrently. Returns false, without reading, if the
+   * voxel data is not stored in deflated chunks. Requires HDF5 1.10.2 or
+   * later: with older versions, the voxel data is read as a hyperslab. */
+  bool
+  ReadChunksConcurrently(void * buffer);
+
   void
   CloseH5File();
   void
@@ -211,6 +242,9 @@ private:
   H5::H5File *  m_H5File{ nullptr };
   H5::DataSet * m_VoxelDataSet{ nullptr };
   bool          m_ImageInformationWritten{ false };
+
+  std::vector<SizeValueType> m_ChunkSize;
+  SizeValueType              m_ChunkCacheSize{ 0 };
 };
 } // end namespace itk
 
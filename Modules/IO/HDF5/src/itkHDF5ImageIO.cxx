@@ -19,10 +19,16 @@
 #include "itkHDF5ImageIO.h"
 #include "itkMetaDataObject.h"
 #include "itkArray.h"
+#include "itkMath.h"
+#include "itkMultiThreaderBase.h"
+#include "itkPrintHelper.h"
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
+#include "itk_zlib.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 namespace itk
 {
@@ -52,9 +58,29 @@ HDF5ImageIO::~HDF5ImageIO()
 void
 HDF5ImageIO ::PrintSelf(std::ostream & os, Indent indent) const
 {
+  using namespace print_helper;
+
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize: " << this->m_ChunkSize << std::endl;
+  os << indent << "ChunkCacheSize: " << this->m_ChunkCacheSize << std::endl;
+}
+
+LightObject::Pointer
+HDF5ImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_ChunkSize = this->m_ChunkSize;
+  rval->m_ChunkCacheSize = this->m_ChunkCacheSize;
+
+  return loPtr;
 }
 
 //
@@ -259,6 +285,87 @@ doesAttrExist(const H5::H5Object & object, const char * const name)
   return (H5Aexists(object.getId(), name) > 0 ? true : false);
 }
 
+// Computes the HDF5 hyperslab of the region, whose dimensions are listed
+// slowest moving first, the voxel components being the fastest moving one.
+void
+GetHyperslab(const ImageIORegion & region, int HDFDim, int numComponents, hsize_t * offset, hsize_t * HDFSize)
+{
+  ImageIORegion::SizeType  size = region.GetSize();
+  ImageIORegion::IndexType start = region.GetIndex();
+  const int                limit = region.GetImageDimension();
+  //
+  // fastest moving dimension is intra-voxel
+  // index
+  int i = 0;
+  if (numComponents > 1)
+  {
+    offset[HDFDim - 1] = 0;
+    HDFSize[HDFDim - 1] = numComponents;
+    ++i;
+  }
+
+  for (int j = 0; j < limit && i < HDFDim; ++i, ++j)
+  {
+    offset[HDFDim - i - 1] = start[j];
+    HDFSize[HDFDim - i - 1] = size[j];
+  }
+
+  while (i < HDFDim)
+  {
+    offset[HDFDim - i - 1] = 0;
+    HDFSize[HDFDim - i - 1] = 1;
+    ++i;
+  }
+}
+
+// Returns the access properties of the voxel data set, with a chunk cache
+// of the given size, or the HDF5 default one when the size is 0.
+H5::DSetAccPropList
+CreateChunkCacheAccPropList(size_t cacheSize, size_t chunkBytes)
+{
+  H5::DSetAccPropList accPropList;
+  if (cacheSize > 0)
+  {
+    // HDF5 recommends a prime number of hash table slots, about 100 times
+    // the number of chunks which fit in the cache.
+    const size_t numberOfChunks = std::min<size_t>(cacheSize / std::max<size_t>(chunkBytes, 1), 10000);
+    auto         numberOfSlots = static_cast<unsigned long long>(std::max<size_t>(100 * numberOfChunks, 521));
+    while (!Math::IsPrime(numberOfSlots))
+    {
+      ++numberOfSlots;
+    }
+    accPropList.setChunkCache(static_cast<size_t>(numberOfSlots), cacheSize, H5D_CHUNK_CACHE_W0_DEFAULT);
+  }
+  return accPropList;
+}
+
+// Opens the voxel data set with a chunk cache of the given size. The cache
+// is sized from the chunks of the data set, so it is reopened once they are
+// known.
+H5::DataSet
+OpenVoxelDataSet(const H5::H5File & file, const std::string & name, size_t cacheSize)
+{
+  H5::DataSet dataSet = file.openDataSet(name);
+  if (cacheSize == 0)
+  {
+    return dataSet;
+  }
+  const H5::DSetCreatPropList createPropList = dataSet.getCreatePlist();
+  size_t                      chunkBytes = dataSet.getDataType().getSize();
+  if (createPropList.getLayout() == H5D_CHUNKED)
+  {
+    const int            rank = createPropList.getChunk(0, nullptr);
+    std::vector<hsize_t> chunkDims(rank);
+    createPropList.getChunk(rank, chunkDims.data());
+    for (const hsize_t chunkDim : chunkDims)
+    {
+      chunkBytes *= chunkDim;
+    }
+  }
+  dataSet.close();
+  return file.openDataSet(name, CreateChunkCacheAccPropList(cacheSize, chunkBytes));
+}
+
 } // namespace
 
 void
@@ -712,7 +819,8 @@ HDF5ImageIO ::ReadImageInformation()
 
     std::string VoxelDataName(groupName);
     VoxelDataName += VoxelData;
-    *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+    *(this->m_VoxelDataSet) =
+      OpenVoxelDataSet(*(this->m_H5File), VoxelDataName, static_cast<size_t>(this->m_ChunkCacheSize));
     H5::DataSet   imageSet = *(this->m_VoxelDataSet);
     H5::DataSpace imageSpace = imageSet.getSpace();
     //
@@ -903,63 +1011,252 @@ HDF5ImageIO ::ReadImageInformation()
   {
     itkExceptionMacro(<< error.getCDetailMsg());
   }
+  // catch failure caused by the property list operations
+  catch (H5::PropListIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
 }
 
 void
 HDF5ImageIO ::SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace)
 {
-  ImageIORegion            regionToRead = this->GetIORegion();
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
-  //
   int numComponents = this->GetNumberOfComponents();
 
   const int HDFDim(this->GetNumberOfDimensions() + (numComponents > 1 ? 1 : 0));
 
   const std::unique_ptr<hsize_t[]> offset(new hsize_t[HDFDim]);
   const std::unique_ptr<hsize_t[]> HDFSize(new hsize_t[HDFDim]);
-  const int                        limit = regionToRead.GetImageDimension();
-  //
-  // fastest moving dimension is intra-voxel
-  // index
-  int i = 0;
-  if (numComponents > 1)
+  GetHyperslab(this->GetIORegion(), HDFDim, numComponents, offset.get(), HDFSize.get());
+
+  slabSpace->setExtentSimple(HDFDim, HDFSize.get());
+  imageSpace->selectHyperslab(H5S_SELECT_SET, HDFSize.get(), offset.get());
+}
+
+// H5Dget_chunk_storage_size and H5Dread_chunk were added in HDF5 1.10.2
+#if (H5_VERS_MAJOR > 1) || (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR > 10) ||                                             \
+  (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR == 10) && (H5_VERS_RELEASE >= 2)
+bool
+HDF5ImageIO ::ReadChunksConcurrently(void * buffer)
+{
+  const H5::DSetCreatPropList createPropList = this->m_VoxelDataSet->getCreatePlist();
+  if (createPropList.getLayout() != H5D_CHUNKED || createPropList.getNfilters() != 1)
   {
-    offset[HDFDim - 1] = 0;
-    HDFSize[HDFDim - 1] = numComponents;
-    ++i;
+    return false;
   }
-
-  for (int j = 0; j < limit && i < HDFDim; ++i, ++j)
+  unsigned int flags = 0;
+  size_t       numberOfValues = 0;
+  unsigned int filterConfig = 0;
+  char         filterName[1];
+  if (createPropList.getFilter(0, flags, numberOfValues, nullptr, 0, filterName, filterConfig) != H5Z_FILTER_DEFLATE)
   {
-    offset[HDFDim - i - 1] = start[j];
-    HDFSize[HDFDim - i - 1] = size[j];
+    return false;
   }
 
-  while (i < HDFDim)
+  const int numComponents = this->GetNumberOfComponents();
+  const int HDFDim(this->GetNumberOfDimensions() + (numComponents > 1 ? 1 : 0));
+  if (createPropList.getChunk(0, nullptr) != HDFDim)
   {
-    offset[HDFDim - i - 1] = 0;
-    HDFSize[HDFDim - i - 1] = 1;
-    ++i;
+    return false;
+  }
+  std::vector<hsize_t> chunkDims(HDFDim);
+  std::vector<hsize_t> offset(HDFDim);
+  std::vector<hsize_t> HDFSize(HDFDim);
+  createPropList.getChunk(HDFDim, chunkDims.data());
+  GetHyperslab(this->GetIORegion(), HDFDim, numComponents, offset.data(), HDFSize.data());
+
+  // the chunks intersected by the region, listed in the order of the
+  // region, the last dimension moving fastest
+  std::vector<hsize_t> firstChunk(HDFDim);
+  std::vector<hsize_t> numberOfChunksPerDim(HDFDim);
+  size_t               numberOfChunks = 1;
+  const size_t         elementSize = this->m_VoxelDataSet->getDataType().getSize();
+  size_t               chunkBytes = elementSize;
+  for (int d = 0; d < HDFDim; ++d)
+  {
+    if (HDFSize[d] == 0)
+    {
+      return false;
+    }
+    firstChunk[d] = offset[d] / chunkDims[d];
+    numberOfChunksPerDim[d] = (offset[d] + HDFSize[d] - 1) / chunkDims[d] - firstChunk[d] + 1;
+    numberOfChunks *= numberOfChunksPerDim[d];
+    chunkBytes *= chunkDims[d];
+  }
+  if (numberOfChunks < 2)
+  {
+    // nothing to do concurrently
+    return false;
   }
 
-  slabSpace->setExtentSimple(HDFDim, HDFSize.get());
-  imageSpace->selectHyperslab(H5S_SELECT_SET, HDFSize.get(), offset.get());
+  const hid_t dataSetId = this->m_VoxelDataSet->getId();
+  auto *      outputBuffer = static_cast<unsigned char *>(buffer);
+  const auto  copyChunk = [&](const unsigned char * chunk, const hsize_t * chunkOffset) {
+    // copy the intersection of the chunk with the region, row by row along
+    // the last dimension
+    std::vector<hsize_t> first(HDFDim);
+    std::vector<hsize_t> last(HDFDim);
+    for (int d = 0; d < HDFDim; ++d)
+    {
+      first[d] = std::max(chunkOffset[d], offset[d]);
+      last[d] = std::min(chunkOffset[d] + chunkDims[d], offset[d] + HDFSize[d]);
+    }
+    const size_t         rowBytes = (last[HDFDim - 1] - first[HDFDim - 1]) * elementSize;
+    std::vector<hsize_t> position(first);
+    while (true)
+    {
+      size_t chunkIndex = 0;
+      size_t outputIndex = 0;
+      for (int d = 0; d < HDFDim; ++d)
+      {
+        chunkIndex = chunkIndex * chunkDims[d] + (position[d] - chunkOffset[d]);
+        outputIndex = outputIndex * HDFSize[d] + (position[d] - offset[d]);
+      }
+      std::memcpy(outputBuffer + outputIndex * elementSize, chunk + chunkIndex * elementSize, rowBytes);
+
+      int d = HDFDim - 2;
+      while (d >= 0 && ++position[d] == last[d])
+      {
+        position[d] = first[d];
+        --d;
+      }
+      if (d < 0)
+      {
+        break;
+      }
+    }
+  };
+
+  // The compressed chunks are read serially, since the HDF5 library is not
+  // thread safe, in batches of bounded size which are decompressed
+  // concurrently.
+  constexpr size_t           MaximumBatchBytes = 64 * 1024 * 1024;
+  std::vector<hsize_t>       chunkOffsets;
+  std::vector<std::uint32_t> filterMasks;
+  std::vector<size_t>        compressedOffsets;
+  std::vector<unsigned char> compressedChunks;
+  std::vector<hsize_t>       chunkPosition(firstChunk);
+  size_t                     chunkNumber = 0;
+  const MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  while (chunkNumber < numberOfChunks)
+  {
+    chunkOffsets.clear();
+    filterMasks.clear();
+    compressedOffsets.assign(1, 0);
+    for (; chunkNumber < numberOfChunks && compressedOffsets.back() < MaximumBatchBytes; ++chunkNumber)
+    {
+      std::vector<hsize_t> chunkOffset(HDFDim);
+      for (int d = 0; d < HDFDim; ++d)
+      {
+        chunkOffset[d] = chunkPosition[d] * chunkDims[d];
+      }
+      hsize_t compressedSize = 0;
+      herr_t  status = -1;
+      H5E_BEGIN_TRY
+      {
+        status = H5Dget_chunk_storage_size(dataSetId, chunkOffset.data(), &compressedSize);
+      }
+      H5E_END_TRY;
+      if (status < 0 || compressedSize == 0)
+      {
+        // the chunk is not allocated, and the HDF5 library fills it
+        return false;
+      }
+      compressedChunks.resize(compressedOffsets.back() + compressedSize);
+      std::uint32_t filterMask = 0;
+      if (H5Dread_chunk(dataSetId, H5P_DEFAULT, chunkOffset.data(), &filterMask,
+                        compressedChunks.data() + compressedOffsets.back()) < 0)
+      {
+        itkExceptionMacro(<< "Unable to read a chunk of the voxel data from " << this->GetFileName());
+      }
+      chunkOffsets.insert(chunkOffsets.end(), chunkOffset.begin(), chunkOffset.end());
+      filterMasks.push_back(filterMask);
+      compressedOffsets.push_back(compressedOffsets.back() + compressedSize);
+
+      for (int d = HDFDim - 1; d >= 0; --d)
+      {
+        if (++chunkPosition[d] < firstChunk[d] + numberOfChunksPerDim[d])
+        {
+          break;
+        }
+        chunkPosition[d] = firstChunk[d];
+      }
+    }
+
+    const size_t               numberOfBatchChunks = filterMasks.size();
+    std::vector<unsigned char> decompressed(numberOfBatchChunks, 1);
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBatchChunks,
+      [&](SizeValueType i) {
+        const unsigned char * compressedChunk = compressedChunks.data() + compressedOffsets[i];
+        const size_t          compressedSize = compressedOffsets[i + 1] - compressedOffsets[i];
+        if (filterMasks[i] & 1u)
+        {
+          // the deflate filter was skipped for this chunk
+          if (compressedSize != chunkBytes)
+          {
+            decompressed[i] = 0;
+            return;
+          }
+          copyChunk(compressedChunk, &chunkOffsets[i * HDFDim]);
+          return;
+        }
+        std::vector<unsigned char> chunk(chunkBytes);
+        uLongf                     chunkSize = static_cast<uLongf>(chunkBytes);
+        if (uncompress(chunk.data(), &chunkSize, compressedChunk, static_cast<uLong>(compressedSize)) != Z_OK ||
+            chunkSize != chunkBytes)
+        {
+          decompressed[i] = 0;
+          return;
+        }
+        copyChunk(chunk.data(), &chunkOffsets[i * HDFDim]);
+      },
+      nullptr);
+    if (std::find(decompressed.begin(), decompressed.end(), 0) != decompressed.end())
+    {
+      itkExceptionMacro(<< "Unable to decompress a chunk of the voxel data from " << this->GetFileName());
+    }
+  }
+  return true;
 }
+#endif
 
 void
 HDF5ImageIO ::Read(void * buffer)
 {
-  ImageIORegion            regionToRead = this->GetIORegion();
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
+  try
+  {
+#if (H5_VERS_MAJOR > 1) || (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR > 10) ||                                             \
+  (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR == 10) && (H5_VERS_RELEASE >= 2)
+    if (this->ReadChunksConcurrently(buffer))
+    {
+      return;
+    }
+#endif
 
-  H5::DataType  voxelType = this->m_VoxelDataSet->getDataType();
-  H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
+    H5::DataType  voxelType = this->m_VoxelDataSet->getDataType();
+    H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
 
-  H5::DataSpace dspace;
-  this->SetupStreaming(&imageSpace, &dspace);
-  this->m_VoxelDataSet->read(buffer, voxelType, dspace, imageSpace);
+    H5::DataSpace dspace;
+    this->SetupStreaming(&imageSpace, &dspace);
+    this->m_VoxelDataSet->read(buffer, voxelType, dspace, imageSpace);
+  }
+  // catch failure caused by the DataSet operations
+  catch (H5::DataSetIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  // catch failure caused by the DataSpace operations
+  catch (H5::DataSpaceIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  // catch failure caused by the property list operations
+  catch (H5::PropListIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
 }
 
 template <typename TType>
@@ -1014,6 +1311,22 @@ HDF5ImageIO ::WriteImageInformation()
     this->CloseH5File();
     this->CloseDataSet();
 
+    std::string VoxelDataName(ImageGroup);
+    VoxelDataName += "/0";
+    VoxelDataName += VoxelData;
+
+    if (this->RequestedToStream() && itksys::SystemTools::FileExists(this->GetFileName()))
+    {
+      // Pasting a region into an existing file, which
+      // StreamingImageIOBase::GetActualNumberOfSplitsForWriting has checked
+      // to be compatible: only the voxel data is written.
+      this->m_H5File = new H5::H5File(this->GetFileName(), H5F_ACC_RDWR);
+      this->m_VoxelDataSet = new H5::DataSet(
+        OpenVoxelDataSet(*(this->m_H5File), VoxelDataName, static_cast<size_t>(this->m_ChunkCacheSize)));
+      this->m_ImageInformationWritten = true;
+      return;
+    }
+
     H5::FileAccPropList fapl;
 #if (H5_VERS_MAJOR > 1) || (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR > 10) ||                                             \
   (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR == 10) && (H5_VERS_RELEASE >= 2)
@@ -1072,21 +1385,41 @@ HDF5ImageIO ::WriteImageInformation()
     H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
 
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
+    // by default, set the chunk size to be the N-1 dimension
     // region
     H5::DSetCreatPropList plist;
 
     // we have implicit compression enabled here?
     plist.setDeflate(this->GetCompressionLevel());
 
-    dims[0] = 1;
+    const int imageDims = this->GetNumberOfDimensions();
+    if (this->m_ChunkSize.empty())
+    {
+      dims[0] = 1;
+    }
+    else if (this->m_ChunkSize.size() == static_cast<size_t>(imageDims))
+    {
+      for (int i(0), j(imageDims - 1); i < imageDims; i++, j--)
+      {
+        dims[j] = std::max<hsize_t>(std::min<hsize_t>(this->m_ChunkSize[i], dims[j]), 1);
+      }
+    }
+    else
+    {
+      itkExceptionMacro(<< "The chunk size has " << this->m_ChunkSize.size() << " dimensions instead of "
+                        << imageDims);
+    }
     plist.setChunk(numDims, dims.get());
+    size_t chunkBytes = dataType.getSize();
+    for (int i = 0; i < numDims; i++)
+    {
+      chunkBytes *= dims[i];
+    }
     dims.reset();
 
-    std::string VoxelDataName(ImageGroup);
-    VoxelDataName += "/0";
-    VoxelDataName += VoxelData;
-    *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName, dataType, imageSpace, plist);
+    const H5::DSetAccPropList accPropList =
+      CreateChunkCacheAccPropList(static_cast<size_t>(this->m_ChunkCacheSize), chunkBytes);
+    *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName, dataType, imageSpace, plist, accPropList);
     std::string MetaDataGroupName(groupName);
     MetaDataGroupName += MetaDataName;
     this->m_H5File->createGroup(MetaDataGroupName);
@@ -1246,6 +1579,11 @@ HDF5ImageIO ::WriteImageInformation()
   {
     itkExceptionMacro(<< error.getCDetailMsg());
   }
+  // catch failure caused by the property list operations
+  catch (H5::PropListIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
   //
   // only write image information once.
   this->m_ImageInformationWritten = true;
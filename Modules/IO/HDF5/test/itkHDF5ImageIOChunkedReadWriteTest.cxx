@@ -0,0 +1,221 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+CreateImage(const typename TImage::SizeType & size, int offset)
+{
+  using PixelType = typename TImage::PixelType;
+  using ValueType = typename itk::NumericTraits<PixelType>::ValueType;
+
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    ValueType value = offset;
+    ValueType scale = 1;
+    for (unsigned int d = 0; d < TImage::ImageDimension; ++d, scale *= 10)
+    {
+      value += scale * static_cast<ValueType>(it.GetIndex()[d]);
+    }
+    PixelType pixel;
+    for (unsigned int i = 0; i < itk::NumericTraits<PixelType>::GetLength(pixel); ++i)
+    {
+      itk::DefaultConvertPixelTraits<PixelType>::SetNthComponent(i, pixel, static_cast<ValueType>(value + i));
+    }
+    it.Set(pixel);
+  }
+  return image;
+}
+
+// Checks that the pixels of the region of the buffer match the expected image.
+template <typename TImage>
+bool
+CompareRegion(const typename TImage::PixelType * buffer,
+              const typename TImage::RegionType & region,
+              const TImage *                      expected)
+{
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(expected, region);
+  for (; !it.IsAtEnd(); ++it, ++buffer)
+  {
+    if (*buffer != it.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " read as " << *buffer << " instead of " << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TPixel>
+int
+ChunkedReadWriteTest(const std::string & fileNamePrefix)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  const std::string fileName = fileNamePrefix + ".hdf5";
+
+  // chunks not aligned with the image size
+  const typename ImageType::SizeType size = { { 45, 38, 21 } };
+  const typename ImageType::Pointer  image = CreateImage<ImageType>(size, 0);
+
+  auto hdf5ImageIO = itk::HDF5ImageIO::New();
+  hdf5ImageIO->SetChunkSize({ 16, 16, 8 });
+  hdf5ImageIO->SetChunkCacheSize(1024 * 1024);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(hdf5ImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  writer = nullptr;
+
+  // whole image, whose chunks are decompressed concurrently
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::HDF5ImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(CompareRegion<ImageType>(
+    reader->GetOutput()->GetBufferPointer(), image->GetLargestPossibleRegion(), image.GetPointer()));
+  reader = nullptr;
+
+  // a region intersecting some of the chunks partially
+  typename ImageType::RegionType region;
+  region.SetIndex({ { 5, 17, 3 } });
+  region.SetSize({ { 30, 20, 9 } });
+  itk::ImageIORegion ioRegion(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    ioRegion.SetIndex(i, region.GetIndex(i));
+    ioRegion.SetSize(i, region.GetSize(i));
+  }
+  auto regionImageIO = itk::HDF5ImageIO::New();
+  regionImageIO->SetChunkCacheSize(4 * 1024 * 1024);
+  regionImageIO->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(regionImageIO->ReadImageInformation());
+  regionImageIO->SetIORegion(ioRegion);
+  std::vector<TPixel> buffer(region.GetNumberOfPixels());
+  ITK_TRY_EXPECT_NO_EXCEPTION(regionImageIO->Read(buffer.data()));
+  ITK_TEST_EXPECT_TRUE(CompareRegion<ImageType>(buffer.data(), region, image.GetPointer()));
+  regionImageIO = nullptr;
+
+  // paste the region of another image into the existing file, the other
+  // image being streamed so that only the region is written
+  const std::string pastedFileName = fileNamePrefix + "Pasted.hdf5";
+  auto              pastedWriter = itk::ImageFileWriter<ImageType>::New();
+  pastedWriter->SetInput(CreateImage<ImageType>(size, 5000));
+  pastedWriter->SetFileName(pastedFileName);
+  pastedWriter->SetImageIO(itk::HDF5ImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(pastedWriter->Update());
+  const typename ImageType::Pointer pastedImage = const_cast<ImageType *>(pastedWriter->GetInput());
+  pastedWriter = nullptr;
+
+  auto pastedReader = itk::ImageFileReader<ImageType>::New();
+  pastedReader->SetFileName(pastedFileName);
+  pastedReader->SetImageIO(itk::HDF5ImageIO::New());
+  pastedReader->SetUseStreaming(true);
+  auto pasteWriter = itk::ImageFileWriter<ImageType>::New();
+  pasteWriter->SetInput(pastedReader->GetOutput());
+  pasteWriter->SetFileName(fileName);
+  pasteWriter->SetImageIO(itk::HDF5ImageIO::New());
+  pasteWriter->SetIORegion(ioRegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pasteWriter->Update());
+  ITK_TEST_EXPECT_EQUAL(pastedReader->GetOutput()->GetBufferedRegion(), region);
+  pasteWriter = nullptr;
+
+  reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::HDF5ImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  const ImageType * pasted = reader->GetOutput();
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(pasted, pasted->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const ImageType * expected = region.IsInside(it.GetIndex()) ? pastedImage.GetPointer() : image.GetPointer();
+    if (it.Get() != expected->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " read as " << it.Get() << " instead of "
+                << expected->GetPixel(it.GetIndex()) << " after pasting" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkHDF5ImageIOChunkedReadWriteTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto hdf5ImageIO = itk::HDF5ImageIO::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(hdf5ImageIO, HDF5ImageIO, StreamingImageIOBase);
+
+  const std::vector<itk::SizeValueType> chunkSize{ 64, 64, 64 };
+  hdf5ImageIO->SetChunkSize(chunkSize);
+  ITK_TEST_EXPECT_TRUE(hdf5ImageIO->GetChunkSize() == chunkSize);
+  const itk::SizeValueType chunkCacheSize = 16 * 1024 * 1024;
+  hdf5ImageIO->SetChunkCacheSize(chunkCacheSize);
+  ITK_TEST_SET_GET_VALUE(chunkCacheSize, hdf5ImageIO->GetChunkCacheSize());
+
+  const std::string outputDirectory = argv[1];
+  int               result = EXIT_SUCCESS;
+  if (ChunkedReadWriteTest<short>(outputDirectory + "/itkHDF5ImageIOChunkedReadWriteTest") != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (ChunkedReadWriteTest<itk::Vector<float, 2>>(outputDirectory + "/itkHDF5ImageIOChunkedReadWriteTestVector") !=
+      EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // the chunk size must have the dimension of the image
+  using ImageType = itk::Image<short, 2>;
+  hdf5ImageIO->SetChunkSize({ 8, 8, 8 });
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(CreateImage<ImageType>({ { 10, 10 } }, 0));
+  writer->SetFileName(outputDirectory + "/itkHDF5ImageIOChunkedReadWriteTest2D.hdf5");
+  writer->SetImageIO(hdf5ImageIO);
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBlockGzipCompression_h
+#define itkBlockGzipCompression_h
+#include "ITKIOImageBaseExport.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace itk
+{
+/** \class BlockGzipCompression
+ * \brief Concurrent gzip compression and decompression of a buffer.
+ *
+ * The buffer is split in blocks of equal size, which are deflated
+ * concurrently and independently of each other, in the manner of pigz.
+ * The blocks are concatenated into a single gzip member, so that any gzip
+ * (or zlib, with automatic header detection) decoder can decompress them
+ * serially.
+ *
+ * The sizes of the compressed blocks are recorded in an extra field of the
+ * gzip header, which the decoders skip, so that Decompress() can inflate
+ * the blocks concurrently as well.
+ *
+ * The concurrency is provided by a MultiThreaderBase with the default
+ * number of work units.
+ *
+ * \sa ImageIOBase::SetUseParallelCompression
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT BlockGzipCompression
+{
+public:
+  using CompressedDataType = std::vector<unsigned char>;
+
+  /** The blocks of a gzip member written by Compress(), as described by its
+   * header. The first block starts at the end of the header, and each block
+   * is followed by the next one, the last one by the gzip trailer. */
+  struct BlockLayout
+  {
+    /** Size of the gzip header. */
+    size_t HeaderSize{ 0 };
+    /** Uncompressed size of all the blocks but the last one. */
+    size_t BlockSize{ 0 };
+    /** Compressed size of each block. */
+    std::vector<size_t> CompressedBlockSizes;
+  };
+
+  /** Compress the given number of bytes of the buffer into a gzip member,
+   * with the given zlib compression level (0 to 9, or -1 for the default
+   * level). */
+  static CompressedDataType
+  Compress(const void * buffer, size_t numberOfBytes, int compressionLevel);
+
+  /** Return the maximum size of the gzip header written by Compress(),
+   * which is enough data for IsBlockCompressed(). */
+  static size_t
+  GetMaximumHeaderSize();
+
+  /** Return true if the data starts with a gzip member written by
+   * Compress(), whose blocks can be decompressed concurrently. */
+  static bool
+  IsBlockCompressed(const void * data, size_t size);
+
+  /** Read the layout of the blocks from the header of a gzip member written
+   * by Compress(), at the start of the data. Returns false if the data does
+   * not start with such a header. */
+  static bool
+  ReadBlockLayout(const void * data, size_t size, BlockLayout & layout);
+
+  /** Decompress the gzip member written by Compress() at the start of the
+   * data into the buffer, which must hold exactly the given number of
+   * bytes. Returns false, without changing the buffer, if the data is not
+   * block compressed or does not have the expected size, in which case it
+   * may still be decompressed serially. Throws an exception if the data is
+   * corrupted. */
+  static bool
+  Decompress(const void * data, size_t size, void * buffer, size_t numberOfBytes);
+};
+} // end namespace itk
+
+#endif // itkBlockGzipCompression_h
@@ -118,6 +118,19 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the pixels may be read by mapping the file in memory.
+   * When the ImageIO reports that the pixels to read are stored in the
+   * file with the layout of the output buffer (see ImageIOBase::CanMapRead)
+   * the output image then wraps the mapped pages of the file instead of
+   * copying them: the pixels are only read when they are first accessed,
+   * and the pages are shared with the other processes which read the same
+   * file. The pixels of the output may be modified without modifying the
+   * file, but the file must not be modified while the output is in use.
+   * Default is false. */
+  itkSetMacro(UseMemoryMappedReading, bool);
+  itkGetConstMacro(UseMemoryMappedReading, bool);
+  itkBooleanMacro(UseMemoryMappedReading);
+
 protected:
   ImageFileReader();
   ~ImageFileReader() override = default;
@@ -153,6 +166,12 @@ protected:
   void
   GenerateData() override;
 
+  /** Use a memory mapping of the file as the buffer of the output, when
+   * UseMemoryMappedReading is on and the pixels can be used without
+   * conversion. Returns false if the pixels need to be read. */
+  bool
+  MapOutputBuffer();
+
   ImageIOBase::Pointer m_ImageIO;
 
   bool m_UserSpecifiedImageIO; // keep track whether the
@@ -160,6 +179,8 @@ protected:
 
   bool m_UseStreaming;
 
+  bool m_UseMemoryMappedReading{ false };
+
 private:
   std::string m_ExceptionMessage;
 
@@ -25,6 +25,7 @@
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
+#include "itkMemoryMappedImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
 #include <memory> // For unique_ptr
@@ -51,6 +52,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "UseMemoryMappedReading: " << m_UseMemoryMappedReading << "\n";
 }
 
 template <typename TOutputImage, typename ConvertPixelTraits>
@@ -356,13 +358,6 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
   typename TOutputImage::Pointer output = this->GetOutput();
 
-  itkDebugMacro(<< "ImageFileReader::GenerateData() \n"
-                << "Allocating the buffer with the EnlargedRequestedRegion \n"
-                << output->GetRequestedRegion() << "\n");
-
-  // allocated the output image to the size of the enlarge requested region
-  this->AllocateOutputs();
-
   // Test if the file exists and if it can be opened.
   // An exception will be thrown otherwise, since we can't
   // successfully read the file. We catch the exception because some
@@ -385,6 +380,28 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   itkDebugMacro(<< "Setting imageIO IORegion to: " << m_ActualIORegion);
   m_ImageIO->SetIORegion(m_ActualIORegion);
 
+  if (this->MapOutputBuffer())
+  {
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
+  // a mapped buffer of a previous update is not reused, since its pages
+  // would be copied when they are written
+  if (dynamic_cast<MemoryMappedImageContainer<typename TOutputImage::PixelContainer::ElementIdentifier,
+                                              typename TOutputImage::PixelContainer::Element> *>(
+        output->GetPixelContainer()))
+  {
+    output->SetPixelContainer(TOutputImage::PixelContainer::New());
+  }
+
+  itkDebugMacro(<< "ImageFileReader::GenerateData() \n"
+                << "Allocating the buffer with the EnlargedRequestedRegion \n"
+                << output->GetRequestedRegion() << "\n");
+
+  // allocated the output image to the size of the enlarge requested region
+  this->AllocateOutputs();
+
   // the size of the buffer is computed based on the actual number of
   // pixels to be read and the actual size of the pixels to be read
   // (as opposed to the sizes of the output)
@@ -441,6 +458,60 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MapOutputBuffer()
+{
+  using PixelContainerType = typename TOutputImage::PixelContainer;
+  using MappedPixelContainerType =
+    MemoryMappedImageContainer<typename PixelContainerType::ElementIdentifier, typename PixelContainerType::Element>;
+
+  if (!m_UseMemoryMappedReading)
+  {
+    return false;
+  }
+
+  TOutputImage * output = this->GetOutput();
+
+  // the pixels are used as they are stored, so they must not need a
+  // conversion, and the region read must be the one of the output
+  const IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
+  if (m_ImageIO->GetComponentType() != ioType ||
+      m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents() ||
+      m_ActualIORegion.GetNumberOfPixels() != output->GetRequestedRegion().GetNumberOfPixels())
+  {
+    return false;
+  }
+
+  std::string           dataFileName;
+  ImageIOBase::SizeType dataPosition = 0;
+  if (!m_ImageIO->CanMapRead(dataFileName, dataPosition) ||
+      dataPosition % alignof(typename PixelContainerType::Element) != 0)
+  {
+    return false;
+  }
+
+  const size_t sizeOfActualIORegion =
+    m_ActualIORegion.GetNumberOfPixels() * (m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
+
+  const auto mappedFile = MemoryMappedFile::New();
+  if (!mappedFile->Map(dataFileName, static_cast<std::uint64_t>(dataPosition), sizeOfActualIORegion))
+  {
+    itkDebugMacro(<< "Can not map " << dataFileName << ", reading it instead.");
+    return false;
+  }
+
+  itkDebugMacro(<< "Mapping " << sizeOfActualIORegion << " bytes of " << dataFileName << " at " << dataPosition);
+
+  const auto pixelContainer = MappedPixelContainerType::New();
+  pixelContainer->SetMappedFile(mappedFile,
+                                sizeOfActualIORegion / sizeof(typename PixelContainerType::Element));
+
+  output->SetBufferedRegion(output->GetRequestedRegion());
+  output->SetPixelContainer(pixelContainer);
+  return true;
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(void * inputData, size_t numberOfPixels)
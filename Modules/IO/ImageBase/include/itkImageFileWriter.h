@@ -72,6 +72,10 @@ public:
  * with a suitable suffix (".png", ".jpg", etc) and setting the input
  * to the writer is enough to get the writer to work properly.
  *
+ * When the input is streamed in several pieces and UseOverlappedWriting is
+ * enabled, each piece is written in the background while the upstream
+ * pipeline generates the next one.
+ *
  * \sa ImageSeriesReader
  * \sa ImageIOBase
  *
@@ -169,6 +173,14 @@ public:
   itkSetMacro(NumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get whether each streamed piece is written by another thread while
+   * the upstream pipeline generates the next piece. The pixels of the pieces
+   * are then copied, so that at most two pieces are kept in addition to the
+   * output of the upstream pipeline. Defaults to false. */
+  itkSetMacro(UseOverlappedWriting, bool);
+  itkGetConstReferenceMacro(UseOverlappedWriting, bool);
+  itkBooleanMacro(UseOverlappedWriting);
+
   /** Aliased to the Write() method to be consistent with the rest of the
    * pipeline. */
   void
@@ -221,6 +233,10 @@ protected:
   GenerateData() override;
 
 private:
+  /** Copy the pixels of the region of the input into an image of their own. */
+  InputImagePointer
+  CopyInputRegion(const InputImageRegionType & region);
+
   std::string m_FileName;
 
   ImageIOBase::Pointer m_ImageIO;
@@ -229,6 +245,7 @@ private:
   ImageIORegion m_PasteIORegion{ TInputImage::ImageDimension };
   unsigned int  m_NumberOfStreamDivisions{ 1 };
   bool          m_UserSpecifiedIORegion{ false };
+  bool          m_UseOverlappedWriting{ false };
 
   bool m_FactorySpecifiedImageIO{ false }; // did factory mechanism set the ImageIO?
   bool m_UseCompression{ false };
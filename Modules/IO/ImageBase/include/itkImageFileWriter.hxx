@@ -33,6 +33,8 @@
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
 #include <complex>
+#include <future>
+#include <vector>
 
 namespace itk
 {
@@ -268,11 +270,24 @@ ImageFileWriter<TInputImage>::Write()
    */
   unsigned int piece;
 
+  // The pieces are all split before the first one is written, as the image
+  // IO is not to be used while it writes a piece in the background.
+  std::vector<ImageIORegion> streamIORegions;
+  streamIORegions.reserve(numDivisions);
+  for (piece = 0; piece < numDivisions; piece++)
+  {
+    streamIORegions.push_back(
+      m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion));
+  }
+
+  // The write of the previous piece, when writing is overlapped. Its
+  // destructor waits for the write, if an exception is thrown meanwhile.
+  std::future<void> previousPieceWrite;
+
   for (piece = 0; piece < numDivisions && !this->GetAbortGenerateData(); piece++)
   {
     // get the actual piece to write
-    ImageIORegion streamIORegion =
-      m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion);
+    ImageIORegion streamIORegion = streamIORegions[piece];
 
     // Check whether the paste region is fully contained inside the
     // largest region or not.
@@ -315,6 +330,23 @@ ImageFileWriter<TInputImage>::Write()
       }
     }
 
+    if (m_UseOverlappedWriting && numDivisions > 1)
+    {
+      // the input is updated for the next piece while this one is written
+      const InputImagePointer pieceImage = this->CopyInputRegion(streamRegion);
+      if (previousPieceWrite.valid())
+      {
+        previousPieceWrite.get();
+        this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+      }
+      m_ImageIO->SetIORegion(streamIORegion);
+      ImageIOBase * const imageIO = m_ImageIO;
+      previousPieceWrite = std::async(std::launch::async, [imageIO, pieceImage]() {
+        imageIO->Write(static_cast<const void *>(pieceImage->GetBufferPointer()));
+      });
+      continue;
+    }
+
     m_ImageIO->SetIORegion(streamIORegion);
 
     // write the data
@@ -323,6 +355,12 @@ ImageFileWriter<TInputImage>::Write()
     this->UpdateProgress(static_cast<float>(piece + 1) / static_cast<float>(numDivisions));
   }
 
+  if (previousPieceWrite.valid())
+  {
+    previousPieceWrite.get();
+    this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+  }
+
   // Notify end event observers
   this->InvokeEvent(EndEvent());
 
@@ -386,6 +424,22 @@ ImageFileWriter<TInputImage>::GenerateData()
   m_ImageIO->Write(dataPtr);
 }
 
+//---------------------------------------------------------
+template <typename TInputImage>
+typename ImageFileWriter<TInputImage>::InputImagePointer
+ImageFileWriter<TInputImage>::CopyInputRegion(const InputImageRegionType & region)
+{
+  const InputImageType * input = this->GetInput();
+
+  InputImagePointer regionImage = InputImageType::New();
+  regionImage->CopyInformation(input);
+  regionImage->SetBufferedRegion(region);
+  regionImage->Allocate();
+
+  ImageAlgorithm::Copy(input, regionImage.GetPointer(), region, region);
+  return regionImage;
+}
+
 //---------------------------------------------------------
 template <typename TInputImage>
 void
@@ -407,6 +461,7 @@ ImageFileWriter<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "IO Region: " << m_PasteIORegion << "\n";
   os << indent << "Number of Stream Divisions: " << m_NumberOfStreamDivisions << "\n";
+  os << indent << "UseOverlappedWriting: " << (m_UseOverlappedWriting ? "On" : "Off") << "\n";
   os << indent << "CompressionLevel: " << m_CompressionLevel << "\n";
 
   if (m_UseCompression)
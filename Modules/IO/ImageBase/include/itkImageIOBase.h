@@ -258,6 +258,18 @@ public:
   itkGetConstMacro(UseCompression, bool);
   itkBooleanMacro(UseCompression);
 
+  /** \brief Set/Get a boolean to compress the data in independent blocks
+   *
+   * If compression is enabled by UseCompression, and the ImageIO
+   * supports it, the data is compressed concurrently in independent
+   * blocks (see BlockGzipCompression), which are then decompressed
+   * concurrently when the file is read. The file remains readable by
+   * the decoders that do not know about the blocks.
+   **/
+  itkSetMacro(UseParallelCompression, bool);
+  itkGetConstMacro(UseParallelCompression, bool);
+  itkBooleanMacro(UseParallelCompression);
+
   /** \brief Set/Get a compression level hint
    *
    * If compression is enabled by UseCompression, then the value
@@ -429,6 +441,20 @@ public:
     return false;
   }
 
+  /** Determine if the pixels of the IORegion are stored in a single
+   * file, uncompressed, contiguously and in the byte order of this
+   * machine, with the component type and the number of components of
+   * this ImageIO, so that the file can be mapped in memory and used as
+   * the buffer of the image instead of being read. If so, the name of
+   * this file and the position of the first pixel of the IORegion in it
+   * are returned. Default is false. This is queried after the header of
+   * the file has been read and the IORegion has been set. */
+  virtual bool
+  CanMapRead(std::string & itkNotUsed(dataFileName), SizeType & itkNotUsed(dataPosition)) const
+  {
+    return false;
+  }
+
   /** Read the spacing and dimensions of the image.
    * Assumes SetFileName has been called with a valid file name. */
   virtual void
@@ -661,6 +687,12 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a new ImageIO of the same type, with the same reading and
+   * writing settings, so that several files may be read or written
+   * concurrently. The information of the image is not copied. */
+  LightObject::Pointer
+  InternalClone() const override;
+
   virtual const ImageRegionSplitterBase *
   GetImageRegionSplitter() const;
 
@@ -701,6 +733,8 @@ protected:
   /** Should we compress the data? */
   bool m_UseCompression{ false };
 
+  /** Should we compress the data in independent blocks? */
+  bool m_UseParallelCompression{ false };
 
   int         m_CompressionLevel{ 30 };
   int         m_MaximumCompressionLevel{ 100 };
@@ -852,6 +886,13 @@ protected:
   void
   SetSupportedWriteExtensions(const ArrayOfExtensionsType &);
 
+  /** Compute the offset in bytes of the first pixel of the IORegion from
+   * the first pixel of the image, for pixels stored without padding in
+   * the order of the dimensions. Returns false if the pixels of the
+   * IORegion are not contiguous in this layout. */
+  bool
+  ComputeContiguousIORegionOffset(SizeType & offset) const;
+
   /** an implementation of ImageRegionSplitter:GetNumberOfSplits
    */
   virtual unsigned int
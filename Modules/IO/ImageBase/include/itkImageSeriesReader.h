@@ -35,6 +35,13 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * When ConcurrentReading is enabled, up to NumberOfWorkUnits files are
+ * read and decoded at the same time, directly into the output buffer.
+ * Each file is read with its own clone of the ImageIO. The spacing
+ * checks and the meta data dictionaries are still processed in the
+ * slice order, so the output and the MetaDataDictionaryArray are the
+ * same as with a sequential reading.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -169,6 +176,12 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the files are read concurrently, by at most
+   * NumberOfWorkUnits threads. Off by default. */
+  itkSetMacro(ConcurrentReading, bool);
+  itkGetConstMacro(ConcurrentReading, bool);
+  itkBooleanMacro(ConcurrentReading);
+
   /** Set the relative threshold for issuing warnings about non-uniform sampling */
   itkSetMacro(SpacingWarningRelThreshold, double);
   itkGetConstMacro(SpacingWarningRelThreshold, double);
@@ -221,11 +234,24 @@ private:
   int
   ComputeMovingDimensionIndex(ReaderType * reader);
 
+  /** Read the file of the slice sliceNumber of the output with imageIO, or
+   * with the factory mechanism if imageIO is null. The data is read into
+   * the output buffer when readData is true, otherwise only the
+   * information is read. */
+  typename ReaderType::Pointer
+  ReadSlice(int                     sliceNumber,
+            ImageIOBase *           imageIO,
+            bool                    readData,
+            const ImageRegionType & sliceRegionToRequest,
+            const SizeType &        validSize);
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime;
 
   /** Indicated if the MMDA should be updated */
   bool m_MetaDataDictionaryArrayUpdate{ true };
+
+  bool m_ConcurrentReading{ false };
 };
 } // namespace itk
 
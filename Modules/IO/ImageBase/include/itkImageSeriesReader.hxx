@@ -25,8 +25,10 @@
 #include "itkVector.h"
 #include "itkMath.h"
 #include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkMetaDataObject.h"
 #include <iomanip>
+#include <memory>
 
 namespace itk
 {
@@ -55,6 +57,7 @@ ImageSeriesReader<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) con
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "ForceOrthogonalDirection: " << m_ForceOrthogonalDirection << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "ConcurrentReading: " << m_ConcurrentReading << std::endl;
 
   itkPrintSelfObjectMacro(ImageIO);
 
@@ -253,6 +256,119 @@ ImageSeriesReader<TOutputImage>::EnlargeOutputRequestedRegion(DataObject * outpu
   }
 }
 
+template <typename TOutputImage>
+typename ImageSeriesReader<TOutputImage>::ReaderType::Pointer
+ImageSeriesReader<TOutputImage>::ReadSlice(int                     sliceNumber,
+                                           ImageIOBase *           imageIO,
+                                           bool                    readData,
+                                           const ImageRegionType & sliceRegionToRequest,
+                                           const SizeType &        validSize)
+{
+  TOutputImage *        output = this->GetOutput();
+  const ImageRegionType requestedRegion = output->GetRequestedRegion();
+  const auto            numberOfFiles = static_cast<int>(m_FileNames.size());
+  const int             iFileName = (m_ReverseOrder ? numberOfFiles - sliceNumber - 1 : sliceNumber);
+
+  // configure reader
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(m_FileNames[iFileName].c_str());
+
+  TOutputImage * readerOutput = reader->GetOutput();
+
+  if (imageIO)
+  {
+    reader->SetImageIO(imageIO);
+  }
+  reader->SetUseStreaming(m_UseStreaming);
+  readerOutput->SetRequestedRegion(sliceRegionToRequest);
+
+  // update the data or info
+  if (!readData)
+  {
+    reader->UpdateOutputInformation();
+    return reader;
+  }
+
+  // read the meta data information
+  readerOutput->UpdateOutputInformation();
+
+  // propagate the requested region to determin what the region
+  // will actually be read
+  readerOutput->PropagateRequestedRegion();
+
+  // check that the size of each slice is the same
+  if (readerOutput->GetLargestPossibleRegion().GetSize() != validSize)
+  {
+    itkExceptionMacro(<< "Size mismatch! The size of  " << m_FileNames[iFileName].c_str() << " is "
+                      << readerOutput->GetLargestPossibleRegion().GetSize() << " and does not match the required size "
+                      << validSize << " from file " << m_FileNames[m_ReverseOrder ? numberOfFiles - 1 : 0].c_str());
+  }
+
+  // get the size of the region to be read
+  SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+
+  if (readSize == sliceRegionToRequest.GetSize())
+  {
+    // if the buffer of the ImageReader is going to match that of
+    // ourselves, then set the ImageReader's buffer to a section
+    // of ours
+
+    const size_t numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+
+    using AccessorFunctorType = typename TOutputImage::AccessorFunctorType;
+    const size_t numberOfInternalComponentsPerPixel = AccessorFunctorType::GetVectorLength(output);
+
+
+    const ptrdiff_t sliceOffset = (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+                                    ? (sliceNumber - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage))
+                                    : 0;
+
+    const ptrdiff_t numberOfPixelComponentsUpToSlice =
+      numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+    const bool bufferDelete = false;
+
+    typename TOutputImage::InternalPixelType * outputSliceBuffer =
+      output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
+
+    if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
+    {
+      // if the input image type is a vector image then the number
+      // of components needs to be set for the size
+      readerOutput->GetPixelContainer()->SetImportPointer(
+        outputSliceBuffer,
+        static_cast<unsigned long>(numberOfPixelsInSlice * numberOfInternalComponentsPerPixel),
+        bufferDelete);
+    }
+    else
+    {
+      // otherwise the actual number of pixels needs to be passed
+      readerOutput->GetPixelContainer()->SetImportPointer(
+        outputSliceBuffer, static_cast<unsigned long>(numberOfPixelsInSlice), bufferDelete);
+    }
+    readerOutput->UpdateOutputData();
+  }
+  else
+  {
+    // the read region isn't going to match exactly what we need
+    // to update to buffer created by the reader, then copy
+
+    reader->Update();
+
+    // output of buffer copy
+    ImageRegionType outRegion = requestedRegion;
+
+    // set the moving dimension to a size of 1
+    if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+    {
+      outRegion.SetIndex(this->m_NumberOfDimensionsInImage, sliceNumber);
+      outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+    }
+
+    ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
+  }
+  return reader;
+}
+
 template <typename TOutputImage>
 void
 ImageSeriesReader<TOutputImage>::GenerateData()
@@ -282,9 +398,6 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -293,184 +406,186 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   bool needToUpdateMetaDataDictionaryArray =
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime && m_MetaDataDictionaryArrayUpdate;
 
-  typename TOutputImage::InternalPixelType * outputBuffer = output->GetBufferPointer();
-  IndexType                                  sliceStartIndex = requestedRegion.GetIndex();
-  const auto                                 numberOfFiles = static_cast<int>(m_FileNames.size());
+  IndexType  sliceStartIndex = requestedRegion.GetIndex();
+  const auto numberOfFiles = static_cast<int>(m_FileNames.size());
 
   typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
   typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
   double                             maxSpacingDeviation = 0.0;
   bool                               prevSliceIsValid = false;
 
-  for (int i = 0; i != numberOfFiles; ++i)
-  {
+  const auto isInsideRequestedRegion = [&](int i) {
     if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
     {
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
     }
-
-    const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = (m_ReverseOrder ? numberOfFiles - i - 1 : i);
-    bool       nonUniformSampling = false;
-    double     spacingDeviation = 0.0;
-
-    // check if we need this slice
-    if (!insideRequestedRegion && !needToUpdateMetaDataDictionaryArray)
+    return requestedRegion.IsInside(sliceStartIndex);
+  };
+
+  // Verify the spacing between the slices which have been read and deep copy
+  // the MetaDataDictionary of the slices into the array, in the slice order.
+  const auto processSliceInformation = [&](bool                                     insideRequestedRegion,
+                                           const typename TOutputImage::PointType & sliceOrigin,
+                                           const DictionaryType *                   dictionary) {
+    bool   nonUniformSampling = false;
+    double spacingDeviation = 0.0;
+
+    // verify that slice spacing is the expected one
+    // since we can be skipping some slices because they are outside of requested region
+    // I am using additional variable
+    if (insideRequestedRegion && prevSliceIsValid)
     {
-      continue;
-    }
-
-    // configure reader
-    typename ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName(m_FileNames[iFileName].c_str());
+      using SpacingScalarType = typename TOutputImage::SpacingValueType;
+      Vector<SpacingScalarType, TOutputImage::ImageDimension> dirN;
+      for (size_t j = 0; j < TOutputImage::ImageDimension; ++j)
+      {
+        dirN[j] = static_cast<SpacingScalarType>(sliceOrigin[j]) - static_cast<SpacingScalarType>(prevSliceOrigin[j]);
+      }
+      SpacingScalarType dirNnorm = dirN.GetNorm();
 
-    TOutputImage * readerOutput = reader->GetOutput();
+      if (this->m_SpacingDefined &&
+          !Math::AlmostEquals(
+            dirNnorm,
+            outputSpacing[this->m_NumberOfDimensionsInImage])) // either non-uniform sampling or missing slice
+      {
+        nonUniformSampling = true;
+        spacingDeviation = Math::abs(outputSpacing[this->m_NumberOfDimensionsInImage] - dirNnorm);
+        if (spacingDeviation > maxSpacingDeviation)
+        {
+          maxSpacingDeviation = spacingDeviation;
+        }
 
-    if (m_ImageIO)
-    {
-      reader->SetImageIO(m_ImageIO);
+        needToUpdateMetaDataDictionaryArray = true;
+      }
+      prevSliceOrigin = sliceOrigin;
     }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
-
-    // update the data or info
-    if (!insideRequestedRegion)
+    else if (insideRequestedRegion)
     {
-      reader->UpdateOutputInformation();
+      prevSliceOrigin = sliceOrigin;
+      prevSliceIsValid = true;
     }
-    else
-    {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
-
-      // propagate the requested region to determin what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
 
-      // check that the size of each slice is the same
-      if (readerOutput->GetLargestPossibleRegion().GetSize() != validSize)
+    // Deep copy the MetaDataDictionary into the array
+    if (dictionary && needToUpdateMetaDataDictionaryArray)
+    {
+      auto newDictionary = new DictionaryType;
+      *newDictionary = *dictionary;
+      if (nonUniformSampling)
       {
-        itkExceptionMacro(<< "Size mismatch! The size of  " << m_FileNames[iFileName].c_str() << " is "
-                          << readerOutput->GetLargestPossibleRegion().GetSize()
-                          << " and does not match the required size " << validSize << " from file "
-                          << m_FileNames[m_ReverseOrder ? numberOfFiles - 1 : 0].c_str());
+        // slice-specific information
+        EncapsulateMetaData<double>(*newDictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
       }
+      m_MetaDataDictionaryArray.push_back(newDictionary);
+    }
+  };
 
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
-
-      if (readSize == sliceRegionToRequest.GetSize())
-      {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
-
-        const size_t numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
-
-        using AccessorFunctorType = typename TOutputImage::AccessorFunctorType;
-        const size_t numberOfInternalComponentsPerPixel = AccessorFunctorType::GetVectorLength(output);
-
-
-        const ptrdiff_t sliceOffset = (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
-                                        ? (i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage))
-                                        : 0;
-
-        const ptrdiff_t numberOfPixelComponentsUpToSlice =
-          numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool bufferDelete = false;
+  if (m_ConcurrentReading)
+  {
+    // The information read concurrently from each slice, which is then
+    // processed in the slice order. The dictionaries are kept if they may be
+    // needed, that is if the array is updated or if a non uniform sampling
+    // may be detected.
+    struct SliceInformation
+    {
+      bool                             m_Read{ false };
+      bool                             m_InsideRequestedRegion{ false };
+      typename TOutputImage::PointType m_Origin;
+      std::unique_ptr<DictionaryType>  m_Dictionary;
+    };
+    std::vector<SliceInformation> slices(numberOfFiles);
+    const bool                    keepDictionaries = needToUpdateMetaDataDictionaryArray || this->m_SpacingDefined;
+
+    for (int i = 0; i != numberOfFiles; ++i)
+    {
+      slices[i].m_InsideRequestedRegion = isInsideRequestedRegion(i);
+      slices[i].m_Read = slices[i].m_InsideRequestedRegion || needToUpdateMetaDataDictionaryArray;
+    }
 
-        typename TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+    const SizeValueType numberOfSlicesToRead = requestedRegion.GetSize(TOutputImage::ImageDimension - 1);
 
-        if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
+    MultiThreaderBase * multiThreader = this->GetMultiThreader();
+    multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfFiles,
+      [&](SizeValueType i) {
+        SliceInformation & slice = slices[i];
+        if (!slice.m_Read)
         {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer(
-            outputSliceBuffer,
-            static_cast<unsigned long>(numberOfPixelsInSlice * numberOfInternalComponentsPerPixel),
-            bufferDelete);
+          return;
         }
-        else
+        // the ImageIO can not be shared by concurrent readers
+        ImageIOBase::Pointer imageIO;
+        if (m_ImageIO)
         {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer(
-            outputSliceBuffer, static_cast<unsigned long>(numberOfPixelsInSlice), bufferDelete);
+          imageIO = dynamic_cast<ImageIOBase *>(m_ImageIO->Clone().GetPointer());
         }
-        readerOutput->UpdateOutputData();
-      }
-      else
-      {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
-
-        reader->Update();
-
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex(sliceStartIndex);
-
-        // set the moving dimension to a size of 1
-        if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+        typename ReaderType::Pointer reader =
+          this->ReadSlice(static_cast<int>(i), imageIO, slice.m_InsideRequestedRegion, sliceRegionToRequest, validSize);
+        slice.m_Origin = reader->GetOutput()->GetOrigin();
+        if (reader->GetImageIO() && keepDictionaries)
         {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+          slice.m_Dictionary.reset(new DictionaryType(reader->GetImageIO()->GetMetaDataDictionary()));
         }
+        if (slice.m_InsideRequestedRegion)
+        {
+          // progress reported on a per slice basis
+          TotalProgressReporter progress(this, numberOfSlicesToRead, 100);
+          progress.CompletedPixel();
+        }
+      },
+      nullptr);
 
-        ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
-      }
-
-      // verify that slice spacing is the expected one
-      // since we can be skipping some slices because they are outside of requested region
-      // I am using additional variable
-      if (prevSliceIsValid)
+    for (int i = 0; i != numberOfFiles; ++i)
+    {
+      SliceInformation & slice = slices[i];
+      if (!slice.m_Read)
       {
-        typename TOutputImage::PointType sliceOrigin = readerOutput->GetOrigin();
-        using SpacingScalarType = typename TOutputImage::SpacingValueType;
-        Vector<SpacingScalarType, TOutputImage::ImageDimension> dirN;
-        for (size_t j = 0; j < TOutputImage::ImageDimension; ++j)
+        if (!needToUpdateMetaDataDictionaryArray)
         {
-          dirN[j] = static_cast<SpacingScalarType>(sliceOrigin[j]) - static_cast<SpacingScalarType>(prevSliceOrigin[j]);
+          continue;
         }
-        SpacingScalarType dirNnorm = dirN.GetNorm();
-
-        if (this->m_SpacingDefined &&
-            !Math::AlmostEquals(
-              dirNnorm,
-              outputSpacing[this->m_NumberOfDimensionsInImage])) // either non-uniform sampling or missing slice
+        // a non uniform sampling has been detected, so the information of
+        // the slices outside of the requested region is needed too
+        typename ReaderType::Pointer reader = this->ReadSlice(i, m_ImageIO, false, sliceRegionToRequest, validSize);
+        slice.m_Origin = reader->GetOutput()->GetOrigin();
+        if (reader->GetImageIO())
         {
-          nonUniformSampling = true;
-          spacingDeviation = Math::abs(outputSpacing[this->m_NumberOfDimensionsInImage] - dirNnorm);
-          if (spacingDeviation > maxSpacingDeviation)
-          {
-            maxSpacingDeviation = spacingDeviation;
-          }
-
-          needToUpdateMetaDataDictionaryArray = true;
+          slice.m_Dictionary.reset(new DictionaryType(reader->GetImageIO()->GetMetaDataDictionary()));
         }
-        prevSliceOrigin = sliceOrigin;
       }
-      else
+      processSliceInformation(slice.m_InsideRequestedRegion, slice.m_Origin, slice.m_Dictionary.get());
+    }
+  }
+  else
+  {
+    // progress reported on a per slice basis
+    ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
+
+    for (int i = 0; i != numberOfFiles; ++i)
+    {
+      const bool insideRequestedRegion = isInsideRequestedRegion(i);
+
+      // check if we need this slice
+      if (!insideRequestedRegion && !needToUpdateMetaDataDictionaryArray)
       {
-        prevSliceOrigin = readerOutput->GetOrigin();
-        prevSliceIsValid = true;
+        continue;
       }
 
-      // report progress for read slices
-      progress.CompletedPixel();
-    } // end !insidedRequestedRegion
+      typename ReaderType::Pointer reader =
+        this->ReadSlice(i, m_ImageIO, insideRequestedRegion, sliceRegionToRequest, validSize);
 
-    // Deep copy the MetaDataDictionary into the array
-    if (reader->GetImageIO() && needToUpdateMetaDataDictionaryArray)
-    {
-      auto newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      if (nonUniformSampling)
+      if (insideRequestedRegion)
       {
-        // slice-specific information
-        EncapsulateMetaData<double>(*newDictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
+        // report progress for read slices
+        progress.CompletedPixel();
       }
-      m_MetaDataDictionaryArray.push_back(newDictionary);
-    }
-  } // end per slice loop
+
+      processSliceInformation(insideRequestedRegion,
+                              reader->GetOutput()->GetOrigin(),
+                              reader->GetImageIO() ? &reader->GetImageIO()->GetMetaDataDictionary() : nullptr);
+    } // end per slice loop
+  }
 
 
   if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage &&
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkIndexedGzipFile_h
+#define itkIndexedGzipFile_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class IndexedGzipFile
+ * \brief Random access to the uncompressed data of a gzip file.
+ *
+ * An index of the points of the compressed data from which the
+ * decompression can restart is built the first time the file is read:
+ * the start of each gzip member, and points spaced by about the span of
+ * the index within the members, for which the last 32 KiB of uncompressed
+ * data are kept, in the manner of the zran example of zlib. Building the
+ * index requires decompressing the whole file once, except for the members
+ * written by BlockGzipCompression: their blocks are restart points that do
+ * not depend on the preceding data, and are listed in their header.
+ *
+ * Read() then only decompresses the data from the restart point which
+ * precedes the requested bytes, and decompresses concurrently the parts of
+ * the requested bytes that follow different restart points.
+ *
+ * \sa BlockGzipCompression
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT IndexedGzipFile : public LightObject
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexedGzipFile);
+
+  /** Standard class type aliases. */
+  using Self = IndexedGzipFile;
+  using Superclass = LightObject;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkFactorylessNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(IndexedGzipFile, LightObject);
+
+  /** Set the name of the file, whose index is discarded. The file is only
+   * opened when the index is built, and when it is read. */
+  void
+  SetFileName(const std::string & fileName);
+
+  const std::string &
+  GetFileName() const
+  {
+    return m_FileName;
+  }
+
+  /** Set the distance between the restart points within the members which
+   * are not block compressed, in uncompressed bytes, before the index is
+   * built. A shorter span makes the reads faster, and the index larger,
+   * by 32 KiB per restart point. Defaults to 1 MiB. */
+  void
+  SetSpan(size_t span);
+
+  size_t
+  GetSpan() const
+  {
+    return m_Span;
+  }
+
+  /** Return true if all the members of the file have been written by
+   * BlockGzipCompression, so that the index is built without
+   * decompressing the file. */
+  bool
+  IsBlockCompressed() const;
+
+  /** Build the index, if it is not built yet. Throws an exception if the
+   * file is not a gzip file or is corrupted. */
+  void
+  BuildIndex();
+
+  bool
+  IsIndexBuilt() const
+  {
+    return m_IndexBuilt;
+  }
+
+  /** Number of restart points of the index, which is built. */
+  size_t
+  GetNumberOfRestartPoints() const
+  {
+    return m_RestartPoints.size();
+  }
+
+  /** Size of the uncompressed data of the file, whose index is built. */
+  size_t
+  GetUncompressedSize() const
+  {
+    return m_UncompressedSize;
+  }
+
+  /** Read the given number of uncompressed bytes, starting at the offset,
+   * into the buffer. The index is built if needed. Throws an exception if
+   * the bytes are not within the uncompressed data, or if the file cannot
+   * be read. */
+  void
+  Read(size_t offset, size_t numberOfBytes, void * buffer);
+
+protected:
+  IndexedGzipFile() = default;
+  ~IndexedGzipFile() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  struct RestartPoint
+  {
+    /** Offset of the point in the uncompressed data. */
+    size_t UncompressedOffset{ 0 };
+    /** Offset of the first byte of compressed data after the point. */
+    size_t CompressedOffset{ 0 };
+    /** Number of bits of the preceding byte which are after the point. */
+    int Bits{ 0 };
+    /** Whether a gzip member starts at the point. */
+    bool IsMemberStart{ false };
+    /** Uncompressed data preceding the point, empty if the compressed data
+     * following it does not refer to preceding data. */
+    std::vector<unsigned char> Window;
+  };
+
+  /** Add the restart points of the member which starts at the compressed
+   * offset, from the layout of its blocks or by decompressing it, and
+   * return its compressed size. */
+  size_t
+  IndexMember(std::FILE * file, size_t compressedOffset, size_t fileSize);
+
+  /** Decompress the uncompressed bytes [start, end) into the output,
+   * starting from the restart point. */
+  void
+  DecompressFrom(size_t restartPoint, size_t start, size_t end, unsigned char * output) const;
+
+  std::string               m_FileName;
+  size_t                    m_Span{ 1024 * 1024 };
+  bool                      m_IndexBuilt{ false };
+  size_t                    m_UncompressedSize{ 0 };
+  std::vector<RestartPoint> m_RestartPoints;
+};
+} // end namespace itk
+
+#endif // itkIndexedGzipFile_h
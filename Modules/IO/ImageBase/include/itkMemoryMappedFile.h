@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+
+#include <cstdint>
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief A copy on write memory mapping of a part of a file.
+ *
+ * The mapped bytes are read from the file on demand, when they are first
+ * accessed, and the pages of the file cache are shared by all the
+ * processes which map the same file. The mapped bytes may be modified,
+ * but the modifications are private to the mapping and are never written
+ * to the file. The file must not be truncated while it is mapped.
+ *
+ * The mapping is released when the object is destroyed.
+ *
+ * \sa MemoryMappedImageContainer
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFile : public LightObject
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFile);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedFile;
+  using Superclass = LightObject;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkFactorylessNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFile, LightObject);
+
+  /** Map the given number of bytes of the file, starting at the given
+   * position. Any previous mapping is released. Returns false if the file
+   * can not be opened, is too short, or can not be mapped. */
+  bool
+  Map(const std::string & fileName, std::uint64_t position, size_t length);
+
+  /** Release the mapping. */
+  void
+  Unmap();
+
+  /** Return a pointer to the first mapped byte, or nullptr if nothing is
+   * mapped. */
+  void *
+  GetData() const
+  {
+    return m_Data;
+  }
+
+  /** Return the number of mapped bytes. */
+  size_t
+  GetLength() const
+  {
+    return m_Length;
+  }
+
+protected:
+  MemoryMappedFile() = default;
+  ~MemoryMappedFile() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The mapping starts at a page boundary, which may be before the first
+   * requested byte. */
+  void * m_Mapping{ nullptr };
+  size_t m_MappingLength{ 0 };
+
+  void * m_Data{ nullptr };
+  size_t m_Length{ 0 };
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_h
+#define itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+/** \class MemoryMappedImageContainer
+ * \brief An image container whose buffer is a memory mapping of a file.
+ *
+ * The container uses the mapped bytes of a MemoryMappedFile as its buffer,
+ * without copying them, and keeps the mapping until the buffer is released
+ * or replaced. It is used by the ImageFileReader to read the pixels of an
+ * image directly from the file cache.
+ *
+ * Since the mapping is copy on write, the pixels of the image may be
+ * modified without modifying the file.
+ *
+ * \sa MemoryMappedFile
+ * \sa ImageFileReader::SetUseMemoryMappedReading
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Save the template parameters. */
+  using ElementIdentifier = TElementIdentifier;
+  using Element = TElement;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedImageContainer, ImportImageContainer);
+
+  /** Use the mapped bytes of the file as the buffer of the container,
+   * which then holds the given number of elements. The mapping must hold
+   * at least as many elements, suitably aligned. */
+  void
+  SetMappedFile(MemoryMappedFile * mappedFile, ElementIdentifier size)
+  {
+    this->SetImportPointer(static_cast<TElement *>(mappedFile->GetData()), size, false);
+    m_MappedFile = mappedFile;
+  }
+
+  /** Get the mapping used as the buffer, if any. */
+  itkGetModifiableObjectMacro(MappedFile, MemoryMappedFile);
+
+protected:
+  MemoryMappedImageContainer() = default;
+  ~MemoryMappedImageContainer() override = default;
+
+  /** Release the mapping along with the buffer. */
+  void
+  DeallocateManagedMemory() override
+  {
+    Superclass::DeallocateManagedMemory();
+    m_MappedFile = nullptr;
+  }
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+
+    os << indent << "MappedFile: " << m_MappedFile.GetPointer() << std::endl;
+  }
+
+private:
+  MemoryMappedFile::Pointer m_MappedFile;
+};
+} // end namespace itk
+
+#endif
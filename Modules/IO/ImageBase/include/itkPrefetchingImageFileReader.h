@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPrefetchingImageFileReader_h
+#define itkPrefetchingImageFileReader_h
+
+#include "itkImageFileReader.h"
+
+#include <deque>
+#include <future>
+
+namespace itk
+{
+/** \class PrefetchingImageFileReader
+ * \brief Read a list of image files in the background, ahead of their use.
+ *
+ * Each file is read by an ImageFileReader, in a thread of its own, so that
+ * the disk accesses and the decompression of the next images overlap with
+ * the processing of the current one. GetNextImage() waits for the images in
+ * the order of the file names, and returns them as futures, whose get()
+ * returns the image, or rethrows the exception thrown while reading it.
+ *
+ * At most LookAhead files are being read, or have been read, and have not
+ * been returned by GetNextImage() yet: the reading of the next file starts
+ * once the returned image has been read. The images which are not returned
+ * are read before the list of files is changed, read again, or the reader
+ * is destroyed.
+ *
+ * The ImageIO of the files is created by the ImageIOFactory, unless one is
+ * set, in which case each file is read with its own clone of it.
+ *
+ * \code
+ * auto reader = PrefetchingImageFileReader<ImageType>::New();
+ * reader->SetFileNames(fileNames);
+ * reader->Start();
+ * while (reader->HasNextImage())
+ * {
+ *   ImageType::Pointer image = reader->GetNextImage().get();
+ *   ...
+ * }
+ * \endcode
+ *
+ * \sa ImageFileReader
+ * \sa ImageSeriesReader
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+template <typename TOutputImage>
+class ITK_TEMPLATE_EXPORT PrefetchingImageFileReader : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PrefetchingImageFileReader);
+
+  /** Standard class type aliases. */
+  using Self = PrefetchingImageFileReader;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PrefetchingImageFileReader, Object);
+
+  using OutputImageType = TOutputImage;
+  using OutputImagePointer = typename TOutputImage::Pointer;
+  using ImageFutureType = std::future<OutputImagePointer>;
+  using FileNamesContainer = std::vector<std::string>;
+
+  /** Set the list of the files to read, which stops reading the previous
+   * ones. */
+  void
+  SetFileNames(const FileNamesContainer & fileNames);
+
+  const FileNamesContainer &
+  GetFileNames() const
+  {
+    return m_FileNames;
+  }
+
+  /** Set/Get the maximum number of files which are read ahead of the images
+   * returned. Defaults to 2. */
+  itkSetClampMacro(LookAhead, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(LookAhead, unsigned int);
+
+  /** Set/Get the ImageIO cloned to read each file. If none is set, the
+   * ImageIOFactory creates one for each file. */
+  itkSetObjectMacro(ImageIO, ImageIOBase);
+  itkGetModifiableObjectMacro(ImageIO, ImageIOBase);
+
+  /** Start reading the first files of the list, from the start. */
+  void
+  Start();
+
+  /** Return true if GetNextImage() has images left to return. */
+  bool
+  HasNextImage() const
+  {
+    return m_Started ? !m_Futures.empty() : !m_FileNames.empty();
+  }
+
+  /** Wait for the image of the next file of the list, which is read in the
+   * background, return it, and start reading the file that follows the files
+   * being read. Start() is called if needed. Throws an exception if all the
+   * images have been returned. */
+  ImageFutureType
+  GetNextImage();
+
+protected:
+  PrefetchingImageFileReader() = default;
+  ~PrefetchingImageFileReader() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Read the file with a new ImageFileReader, in the calling thread. */
+  static OutputImagePointer
+  ReadImage(const std::string & fileName, const ImageIOBase::Pointer & imageIO);
+
+  /** Start reading the next files, up to the look ahead. */
+  void
+  ReadAhead();
+
+  FileNamesContainer          m_FileNames;
+  unsigned int                m_LookAhead{ 2 };
+  ImageIOBase::Pointer        m_ImageIO;
+  bool                        m_Started{ false };
+  size_t                      m_NextFileToRead{ 0 };
+  std::deque<ImageFutureType> m_Futures;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkPrefetchingImageFileReader.hxx"
+#endif
+
+#endif // itkPrefetchingImageFileReader_h
@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPrefetchingImageFileReader_hxx
+#define itkPrefetchingImageFileReader_hxx
+
+#include "itkPrefetchingImageFileReader.h"
+
+namespace itk
+{
+template <typename TOutputImage>
+void
+PrefetchingImageFileReader<TOutputImage>::SetFileNames(const FileNamesContainer & fileNames)
+{
+  // the files being read are waited for
+  m_Futures.clear();
+  m_Started = false;
+  m_NextFileToRead = 0;
+  m_FileNames = fileNames;
+  this->Modified();
+}
+
+template <typename TOutputImage>
+void
+PrefetchingImageFileReader<TOutputImage>::Start()
+{
+  m_Futures.clear();
+  m_Started = true;
+  m_NextFileToRead = 0;
+  this->ReadAhead();
+}
+
+template <typename TOutputImage>
+auto
+PrefetchingImageFileReader<TOutputImage>::GetNextImage() -> ImageFutureType
+{
+  if (!m_Started)
+  {
+    this->Start();
+  }
+  if (m_Futures.empty())
+  {
+    itkExceptionMacro(<< "All the " << m_FileNames.size() << " images have been returned");
+  }
+
+  ImageFutureType image = std::move(m_Futures.front());
+  m_Futures.pop_front();
+
+  // the next file is only read once the image has been read, so that at most
+  // LookAhead files are read at once
+  image.wait();
+  this->ReadAhead();
+  return image;
+}
+
+template <typename TOutputImage>
+void
+PrefetchingImageFileReader<TOutputImage>::ReadAhead()
+{
+  while (m_Futures.size() < m_LookAhead && m_NextFileToRead < m_FileNames.size())
+  {
+    // the ImageIO can not be shared by concurrent readers
+    ImageIOBase::Pointer imageIO;
+    if (m_ImageIO)
+    {
+      imageIO = dynamic_cast<ImageIOBase *>(m_ImageIO->Clone().GetPointer());
+    }
+    m_Futures.push_back(std::async(std::launch::async, &Self::ReadImage, m_FileNames[m_NextFileToRead], imageIO));
+    ++m_NextFileToRead;
+  }
+}
+
+template <typename TOutputImage>
+auto
+PrefetchingImageFileReader<TOutputImage>::ReadImage(const std::string & fileName, const ImageIOBase::Pointer & imageIO)
+  -> OutputImagePointer
+{
+  using ReaderType = ImageFileReader<TOutputImage>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  if (imageIO)
+  {
+    reader->SetImageIO(imageIO);
+  }
+  reader->Update();
+
+  OutputImagePointer image = reader->GetOutput();
+  image->DisconnectPipeline();
+  return image;
+}
+
+template <typename TOutputImage>
+void
+PrefetchingImageFileReader<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileNames: " << m_FileNames.size() << std::endl;
+  os << indent << "LookAhead: " << m_LookAhead << std::endl;
+  itkPrintSelfObjectMacro(ImageIO);
+  os << indent << "Started: " << m_Started << std::endl;
+  os << indent << "NextFileToRead: " << m_NextFileToRead << std::endl;
+  os << indent << "NumberOfImagesReadAhead: " << m_Futures.size() << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -11,8 +11,11 @@ itk_module(ITKIOImageBase
   ENABLE_SHARED
   DEPENDS
     ITKCommon
+  PRIVATE_DEPENDS
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
+    ITKZLIB
     ITKIOGDCM
     ITKIOMeta
     ITKImageIntensity
@@ -0,0 +1,297 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkBlockGzipCompression.h"
+#include "itkMultiThreaderBase.h"
+#include "itkMacro.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace itk
+{
+namespace
+{
+// The gzip header is followed by an extra field, made of a single subfield
+// identified by "IK", which holds the uncompressed size of the blocks (all
+// but the last one), followed by the compressed size of each block, as 32
+// bits little endian integers.
+constexpr size_t        GzipHeaderSize = 10;
+constexpr size_t        GzipTrailerSize = 8;
+constexpr size_t        SubfieldHeaderSize = 4;
+constexpr size_t        MaximumExtraFieldSize = 65535;
+constexpr size_t        MaximumNumberOfBlocks = (MaximumExtraFieldSize - SubfieldHeaderSize) / 4 - 1;
+constexpr size_t        MinimumBlockSize = 256 * 1024;
+constexpr unsigned char SubfieldId1 = 'I';
+constexpr unsigned char SubfieldId2 = 'K';
+
+void
+AppendLittleEndian(BlockGzipCompression::CompressedDataType & data, std::uint32_t value, unsigned int numberOfBytes)
+{
+  for (unsigned int i = 0; i < numberOfBytes; ++i)
+  {
+    data.push_back(static_cast<unsigned char>(value >> (8 * i)));
+  }
+}
+
+std::uint32_t
+ReadLittleEndian(const unsigned char * data, unsigned int numberOfBytes)
+{
+  std::uint32_t value = 0;
+  for (unsigned int i = 0; i < numberOfBytes; ++i)
+  {
+    value |= static_cast<std::uint32_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+bool
+ReadBlockIndex(const unsigned char * data, size_t size, BlockGzipCompression::BlockLayout & index)
+{
+  // a gzip member, deflated, with an extra field and no file name or comment
+  if (size < GzipHeaderSize + 2 || data[0] != 0x1f || data[1] != 0x8b || data[2] != Z_DEFLATED || data[3] != 0x04)
+  {
+    return false;
+  }
+  const size_t extraFieldSize = ReadLittleEndian(data + GzipHeaderSize, 2);
+  const size_t extraFieldEnd = GzipHeaderSize + 2 + extraFieldSize;
+  if (size < extraFieldEnd)
+  {
+    return false;
+  }
+
+  for (size_t position = GzipHeaderSize + 2; position + SubfieldHeaderSize <= extraFieldEnd;)
+  {
+    const size_t subfieldSize = ReadLittleEndian(data + position + 2, 2);
+    const size_t subfieldStart = position + SubfieldHeaderSize;
+    if (subfieldStart + subfieldSize > extraFieldEnd)
+    {
+      return false;
+    }
+    if (data[position] == SubfieldId1 && data[position + 1] == SubfieldId2)
+    {
+      if (subfieldSize < 8 || subfieldSize % 4 != 0)
+      {
+        return false;
+      }
+      index.HeaderSize = extraFieldEnd;
+      index.BlockSize = ReadLittleEndian(data + subfieldStart, 4);
+      index.CompressedBlockSizes.resize(subfieldSize / 4 - 1);
+      for (size_t i = 0; i < index.CompressedBlockSizes.size(); ++i)
+      {
+        index.CompressedBlockSizes[i] = ReadLittleEndian(data + subfieldStart + 4 * (i + 1), 4);
+      }
+      return index.BlockSize > 0;
+    }
+    position = subfieldStart + subfieldSize;
+  }
+  return false;
+}
+} // namespace
+
+BlockGzipCompression::CompressedDataType
+BlockGzipCompression::Compress(const void * buffer, size_t numberOfBytes, int compressionLevel)
+{
+  const size_t blockSize =
+    std::max(MinimumBlockSize, (numberOfBytes + MaximumNumberOfBlocks - 1) / MaximumNumberOfBlocks);
+  const size_t numberOfBlocks = std::max<size_t>(1, (numberOfBytes + blockSize - 1) / blockSize);
+  const auto * input = static_cast<const unsigned char *>(buffer);
+
+  // each block is a raw deflate stream that ends on a byte boundary, with
+  // its own dictionary, so that the blocks can simply be concatenated
+  std::vector<CompressedDataType> compressedBlocks(numberOfBlocks);
+  std::vector<uLong>              blockChecksums(numberOfBlocks);
+  std::vector<unsigned char>      succeeded(numberOfBlocks, 0);
+
+  const auto compressBlock = [&](SizeValueType block) {
+    const size_t blockStart = block * blockSize;
+    const size_t blockLength = std::min(blockSize, numberOfBytes - blockStart);
+    const bool   isLastBlock = block + 1 == numberOfBlocks;
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      return;
+    }
+
+    // the bound does not include the empty stored block of a flush
+    CompressedDataType & compressed = compressedBlocks[block];
+    compressed.resize(deflateBound(&stream, static_cast<uLong>(blockLength)) + 16);
+    stream.next_in = const_cast<Bytef *>(input + blockStart);
+    stream.avail_in = static_cast<uInt>(blockLength);
+    stream.next_out = compressed.data();
+    stream.avail_out = static_cast<uInt>(compressed.size());
+
+    const int result = deflate(&stream, isLastBlock ? Z_FINISH : Z_SYNC_FLUSH);
+    if ((isLastBlock ? result == Z_STREAM_END : result == Z_OK) && stream.avail_in == 0 && stream.avail_out > 0)
+    {
+      compressed.resize(compressed.size() - stream.avail_out);
+      blockChecksums[block] = crc32(crc32(0L, Z_NULL, 0), input + blockStart, static_cast<uInt>(blockLength));
+      succeeded[block] = 1;
+    }
+    deflateEnd(&stream);
+  };
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->ParallelizeArray(0, numberOfBlocks, compressBlock, nullptr);
+
+  if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end())
+  {
+    itkGenericExceptionMacro(<< "Failed to compress the data with the compression level " << compressionLevel);
+  }
+
+  const size_t subfieldSize = 4 * (numberOfBlocks + 1);
+  size_t       compressedSize = GzipHeaderSize + 2 + SubfieldHeaderSize + subfieldSize + GzipTrailerSize;
+  for (const auto & compressedBlock : compressedBlocks)
+  {
+    compressedSize += compressedBlock.size();
+  }
+
+  CompressedDataType compressed;
+  compressed.reserve(compressedSize);
+
+  // header: deflate, extra field, no modification time, unknown system
+  const unsigned char header[GzipHeaderSize] = { 0x1f, 0x8b, Z_DEFLATED, 0x04, 0, 0, 0, 0, 0, 255 };
+  compressed.insert(compressed.end(), header, header + GzipHeaderSize);
+  AppendLittleEndian(compressed, static_cast<std::uint32_t>(SubfieldHeaderSize + subfieldSize), 2);
+  compressed.push_back(SubfieldId1);
+  compressed.push_back(SubfieldId2);
+  AppendLittleEndian(compressed, static_cast<std::uint32_t>(subfieldSize), 2);
+  AppendLittleEndian(compressed, static_cast<std::uint32_t>(blockSize), 4);
+  for (const auto & compressedBlock : compressedBlocks)
+  {
+    AppendLittleEndian(compressed, static_cast<std::uint32_t>(compressedBlock.size()), 4);
+  }
+
+  uLong checksum = crc32(0L, Z_NULL, 0);
+  for (size_t block = 0; block < numberOfBlocks; ++block)
+  {
+    compressed.insert(compressed.end(), compressedBlocks[block].begin(), compressedBlocks[block].end());
+    CompressedDataType().swap(compressedBlocks[block]);
+    const size_t blockLength = std::min(blockSize, numberOfBytes - block * blockSize);
+    checksum = crc32_combine(checksum, blockChecksums[block], static_cast<z_off_t>(blockLength));
+  }
+
+  // trailer: checksum and size modulo 2^32 of the uncompressed data
+  AppendLittleEndian(compressed, static_cast<std::uint32_t>(checksum), 4);
+  AppendLittleEndian(compressed, static_cast<std::uint32_t>(numberOfBytes), 4);
+  return compressed;
+}
+
+size_t
+BlockGzipCompression::GetMaximumHeaderSize()
+{
+  return GzipHeaderSize + 2 + MaximumExtraFieldSize;
+}
+
+bool
+BlockGzipCompression::IsBlockCompressed(const void * data, size_t size)
+{
+  BlockLayout index;
+  return ReadBlockIndex(static_cast<const unsigned char *>(data), size, index);
+}
+
+bool
+BlockGzipCompression::ReadBlockLayout(const void * data, size_t size, BlockLayout & layout)
+{
+  return ReadBlockIndex(static_cast<const unsigned char *>(data), size, layout);
+}
+
+bool
+BlockGzipCompression::Decompress(const void * data, size_t size, void * buffer, size_t numberOfBytes)
+{
+  const auto * input = static_cast<const unsigned char *>(data);
+  BlockLayout  index;
+  if (!ReadBlockIndex(input, size, index))
+  {
+    return false;
+  }
+
+  const size_t numberOfBlocks = std::max<size_t>(1, (numberOfBytes + index.BlockSize - 1) / index.BlockSize);
+  if (index.CompressedBlockSizes.size() != numberOfBlocks)
+  {
+    return false;
+  }
+
+  std::vector<size_t> blockOffsets(numberOfBlocks);
+  size_t              offset = index.HeaderSize;
+  for (size_t block = 0; block < numberOfBlocks; ++block)
+  {
+    blockOffsets[block] = offset;
+    offset += index.CompressedBlockSizes[block];
+  }
+  if (offset + GzipTrailerSize > size ||
+      ReadLittleEndian(input + offset + 4, 4) != static_cast<std::uint32_t>(numberOfBytes))
+  {
+    return false;
+  }
+  const std::uint32_t expectedChecksum = ReadLittleEndian(input + offset, 4);
+
+  auto *                     output = static_cast<unsigned char *>(buffer);
+  std::vector<uLong>         blockChecksums(numberOfBlocks);
+  std::vector<unsigned char> succeeded(numberOfBlocks, 0);
+
+  const auto decompressBlock = [&](SizeValueType block) {
+    const size_t blockStart = block * index.BlockSize;
+    const size_t blockLength = std::min(index.BlockSize, numberOfBytes - blockStart);
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+    {
+      return;
+    }
+    stream.next_in = const_cast<Bytef *>(input + blockOffsets[block]);
+    stream.avail_in = static_cast<uInt>(index.CompressedBlockSizes[block]);
+    // zlib does not accept a null output, even when it is empty
+    unsigned char emptyOutput;
+    stream.next_out = blockLength > 0 ? output + blockStart : &emptyOutput;
+    stream.avail_out = static_cast<uInt>(blockLength);
+
+    const int result = inflate(&stream, Z_SYNC_FLUSH);
+    if ((result == Z_OK || result == Z_STREAM_END || result == Z_BUF_ERROR) && stream.avail_out == 0)
+    {
+      blockChecksums[block] = crc32(crc32(0L, Z_NULL, 0), output + blockStart, static_cast<uInt>(blockLength));
+      succeeded[block] = 1;
+    }
+    inflateEnd(&stream);
+  };
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->ParallelizeArray(0, numberOfBlocks, decompressBlock, nullptr);
+
+  uLong checksum = crc32(0L, Z_NULL, 0);
+  for (size_t block = 0; block < numberOfBlocks; ++block)
+  {
+    if (!succeeded[block])
+    {
+      itkGenericExceptionMacro(<< "Failed to decompress the block " << block << " of the compressed data");
+    }
+    const size_t blockLength = std::min(index.BlockSize, numberOfBytes - block * index.BlockSize);
+    checksum = crc32_combine(checksum, blockChecksums[block], static_cast<z_off_t>(blockLength));
+  }
+  if (static_cast<std::uint32_t>(checksum) != expectedChecksum)
+  {
+    itkGenericExceptionMacro(<< "The checksum of the decompressed data does not match the one of the compressed data");
+  }
+  return true;
+}
+
+} // end namespace itk
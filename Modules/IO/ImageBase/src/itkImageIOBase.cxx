@@ -53,6 +53,54 @@ ImageIOBase::Reset(const bool)
 
 ImageIOBase::~ImageIOBase() = default;
 
+LightObject::Pointer
+ImageIOBase::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_UseCompression = this->m_UseCompression;
+  rval->m_UseParallelCompression = this->m_UseParallelCompression;
+  rval->m_CompressionLevel = this->m_CompressionLevel;
+  rval->m_Compressor = this->m_Compressor;
+  rval->m_UseStreamedReading = this->m_UseStreamedReading;
+  rval->m_UseStreamedWriting = this->m_UseStreamedWriting;
+  rval->m_ExpandRGBPalette = this->m_ExpandRGBPalette;
+  rval->m_WritePalette = this->m_WritePalette;
+
+  return loPtr;
+}
+
+bool
+ImageIOBase::ComputeContiguousIORegionOffset(SizeType & offset) const
+{
+  // The pixels are contiguous if the IORegion spans the image in all the
+  // dimensions below the first one where it does not, and has a size of
+  // one in all the dimensions above it.
+  SizeType stride = this->GetPixelSize();
+  bool     isPartial = false;
+
+  offset = 0;
+  for (unsigned int i = 0; i < m_NumberOfDimensions; ++i)
+  {
+    const bool           isInIORegion = i < m_IORegion.GetImageDimension();
+    const SizeValueType  size = isInIORegion ? m_IORegion.GetSize(i) : 1;
+    const IndexValueType index = isInIORegion ? m_IORegion.GetIndex(i) : 0;
+    if (isPartial && size != 1)
+    {
+      return false;
+    }
+    isPartial = isPartial || size != m_Dimensions[i];
+    offset += static_cast<SizeType>(index) * stride;
+    stride *= static_cast<SizeType>(m_Dimensions[i]);
+  }
+  return true;
+}
+
 const ImageIOBase::ArrayOfExtensionsType &
 ImageIOBase::GetSupportedWriteExtensions() const
 {
@@ -1183,6 +1231,14 @@ ImageIOBase::PrintSelf(std::ostream & os, Indent indent) const
   {
     os << indent << "UseCompression: Off" << std::endl;
   }
+  if (m_UseParallelCompression)
+  {
+    os << indent << "UseParallelCompression: On" << std::endl;
+  }
+  else
+  {
+    os << indent << "UseParallelCompression: Off" << std::endl;
+  }
   os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
   os << indent << "MaximumCompressionLevel: " << m_MaximumCompressionLevel << std::endl;
   os << indent << "Compressor: " << m_Compressor << std::endl;
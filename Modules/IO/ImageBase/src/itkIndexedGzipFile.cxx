@@ -0,0 +1,489 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkIndexedGzipFile.h"
+#include "itkBlockGzipCompression.h"
+#include "itkMultiThreaderBase.h"
+#include "itkMacro.h"
+#include "itk_zlib.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace itk
+{
+namespace
+{
+// Size of the window of uncompressed data that deflate may refer to, and of
+// the buffers of compressed data read from the file.
+constexpr size_t WindowSize = 32768;
+constexpr size_t InputSize = 65536;
+constexpr size_t GzipTrailerSize = 8;
+
+struct FileCloser
+{
+  void
+  operator()(std::FILE * file) const
+  {
+    fclose(file);
+  }
+};
+using FilePointer = std::unique_ptr<std::FILE, FileCloser>;
+
+struct InflateEnder
+{
+  void
+  operator()(z_stream * stream) const
+  {
+    inflateEnd(stream);
+  }
+};
+
+FilePointer
+OpenFile(const std::string & fileName)
+{
+  FilePointer file(itksys::SystemTools::Fopen(fileName, "rb"));
+  if (!file)
+  {
+    itkGenericExceptionMacro(<< "Could not open " << fileName << " for reading."
+                             << "\nReason: " << itksys::SystemTools::GetLastSystemError());
+  }
+  return file;
+}
+
+bool
+Seek(std::FILE * file, size_t offset)
+{
+#if defined(_WIN32)
+  return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+  return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+size_t
+GetFileSize(std::FILE * file)
+{
+#if defined(_WIN32)
+  const bool    atEnd = _fseeki64(file, 0, SEEK_END) == 0;
+  const __int64 size = atEnd ? _ftelli64(file) : -1;
+#else
+  const bool  atEnd = fseeko(file, 0, SEEK_END) == 0;
+  const off_t size = atEnd ? ftello(file) : -1;
+#endif
+  return size < 0 ? 0 : static_cast<size_t>(size);
+}
+
+// Reads the block layout of the member which starts at the offset, which
+// is false if the member is not block compressed. The blocks must hold the
+// whole member, whose uncompressed size is computed from its trailer.
+bool
+ReadMemberLayout(std::FILE *                         file,
+                 size_t                              offset,
+                 size_t                              fileSize,
+                 BlockGzipCompression::BlockLayout & layout,
+                 size_t &                            compressedSize,
+                 size_t &                            uncompressedSize)
+{
+  std::vector<unsigned char> header(std::min(BlockGzipCompression::GetMaximumHeaderSize(), fileSize - offset));
+  if (!Seek(file, offset) || fread(header.data(), 1, header.size(), file) != header.size() ||
+      !BlockGzipCompression::ReadBlockLayout(header.data(), header.size(), layout))
+  {
+    return false;
+  }
+
+  compressedSize = layout.HeaderSize + GzipTrailerSize;
+  for (const size_t blockSize : layout.CompressedBlockSizes)
+  {
+    compressedSize += blockSize;
+  }
+  unsigned char trailerSize[4];
+  if (compressedSize > fileSize - offset || !Seek(file, offset + compressedSize - 4) ||
+      fread(trailerSize, 1, 4, file) != 4)
+  {
+    return false;
+  }
+
+  // the trailer holds the uncompressed size modulo 2^32, the last block
+  // being smaller than that
+  std::uint32_t size = 0;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    size |= static_cast<std::uint32_t>(trailerSize[i]) << (8 * i);
+  }
+  const size_t firstBlocksSize = (layout.CompressedBlockSizes.size() - 1) * layout.BlockSize;
+  const size_t lastBlockSize = static_cast<std::uint32_t>(size - static_cast<std::uint32_t>(firstBlocksSize));
+  if (lastBlockSize > layout.BlockSize)
+  {
+    return false;
+  }
+  uncompressedSize = firstBlocksSize + lastBlockSize;
+  return true;
+}
+
+bool
+IsMemberStart(std::FILE * file, size_t offset, size_t fileSize)
+{
+  unsigned char magic[2];
+  return fileSize - offset >= 2 && Seek(file, offset) && fread(magic, 1, 2, file) == 2 && magic[0] == 0x1f &&
+         magic[1] == 0x8b;
+}
+} // namespace
+
+void
+IndexedGzipFile::SetFileName(const std::string & fileName)
+{
+  m_FileName = fileName;
+  m_IndexBuilt = false;
+  m_UncompressedSize = 0;
+  m_RestartPoints.clear();
+}
+
+void
+IndexedGzipFile::SetSpan(size_t span)
+{
+  m_Span = std::max(span, WindowSize);
+}
+
+bool
+IndexedGzipFile::IsBlockCompressed() const
+{
+  const FilePointer file = OpenFile(m_FileName);
+  const size_t      fileSize = GetFileSize(file.get());
+
+  size_t offset = 0;
+  do
+  {
+    BlockGzipCompression::BlockLayout layout;
+    size_t                            compressedSize;
+    size_t                            uncompressedSize;
+    if (!ReadMemberLayout(file.get(), offset, fileSize, layout, compressedSize, uncompressedSize))
+    {
+      return false;
+    }
+    offset += compressedSize;
+  } while (IsMemberStart(file.get(), offset, fileSize));
+  return true;
+}
+
+void
+IndexedGzipFile::BuildIndex()
+{
+  if (m_IndexBuilt)
+  {
+    return;
+  }
+
+  const FilePointer file = OpenFile(m_FileName);
+  const size_t      fileSize = GetFileSize(file.get());
+  if (!IsMemberStart(file.get(), 0, fileSize))
+  {
+    itkGenericExceptionMacro(<< m_FileName << " is not a gzip file.");
+  }
+
+  // the members follow each other, anything else at the end of the file
+  // being ignored, as zlib does
+  m_RestartPoints.clear();
+  m_UncompressedSize = 0;
+  size_t offset = 0;
+  do
+  {
+    offset += this->IndexMember(file.get(), offset, fileSize);
+  } while (IsMemberStart(file.get(), offset, fileSize));
+  m_IndexBuilt = true;
+}
+
+size_t
+IndexedGzipFile::IndexMember(std::FILE * file, size_t compressedOffset, size_t fileSize)
+{
+  RestartPoint memberStart;
+  memberStart.UncompressedOffset = m_UncompressedSize;
+  memberStart.CompressedOffset = compressedOffset;
+  memberStart.IsMemberStart = true;
+  m_RestartPoints.push_back(memberStart);
+
+  // The blocks of a block compressed member do not refer to the preceding
+  // blocks, so that their start is a restart point without window.
+  BlockGzipCompression::BlockLayout layout;
+  size_t                            compressedSize;
+  size_t                            uncompressedSize;
+  if (ReadMemberLayout(file, compressedOffset, fileSize, layout, compressedSize, uncompressedSize))
+  {
+    size_t blockOffset = compressedOffset + layout.HeaderSize + layout.CompressedBlockSizes[0];
+    for (size_t block = 1; block < layout.CompressedBlockSizes.size(); ++block)
+    {
+      RestartPoint point;
+      point.UncompressedOffset = m_UncompressedSize + block * layout.BlockSize;
+      point.CompressedOffset = blockOffset;
+      m_RestartPoints.push_back(point);
+      blockOffset += layout.CompressedBlockSizes[block];
+    }
+    m_UncompressedSize += uncompressedSize;
+    return compressedSize;
+  }
+
+  // Otherwise, the member is decompressed, into a circular window, and a
+  // restart point is added at the first deflate block boundary after each
+  // span of uncompressed data.
+  if (!Seek(file, compressedOffset))
+  {
+    itkGenericExceptionMacro(<< "Could not seek in " << m_FileName);
+  }
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+  {
+    itkGenericExceptionMacro(<< "Could not initialize the decompression of " << m_FileName);
+  }
+  std::vector<unsigned char> input(InputSize);
+  std::vector<unsigned char> window(WindowSize);
+  size_t                     totalIn = 0;
+  size_t                     totalOut = 0;
+  size_t                     lastPoint = 0;
+  int                        result = Z_OK;
+  do
+  {
+    if (stream.avail_in == 0)
+    {
+      stream.avail_in = static_cast<uInt>(fread(input.data(), 1, input.size(), file));
+      stream.next_in = input.data();
+      if (stream.avail_in == 0)
+      {
+        inflateEnd(&stream);
+        itkGenericExceptionMacro(<< "Unexpected end of the compressed data of " << m_FileName);
+      }
+    }
+    if (stream.avail_out == 0)
+    {
+      stream.avail_out = static_cast<uInt>(window.size());
+      stream.next_out = window.data();
+    }
+    const uInt availableIn = stream.avail_in;
+    const uInt availableOut = stream.avail_out;
+    result = inflate(&stream, Z_BLOCK);
+    totalIn += availableIn - stream.avail_in;
+    totalOut += availableOut - stream.avail_out;
+    if (result != Z_OK && result != Z_STREAM_END)
+    {
+      inflateEnd(&stream);
+      itkGenericExceptionMacro(<< "Corrupted compressed data in " << m_FileName << ": "
+                               << (stream.msg ? stream.msg : "inflate failed"));
+    }
+
+    // at the end of a deflate block, which is not the last one
+    if (result == Z_OK && (stream.data_type & 128) && !(stream.data_type & 64) && totalOut - lastPoint > m_Span)
+    {
+      RestartPoint point;
+      point.UncompressedOffset = m_UncompressedSize + totalOut;
+      point.CompressedOffset = compressedOffset + totalIn;
+      point.Bits = stream.data_type & 7;
+      point.Window.resize(WindowSize);
+      const size_t windowEnd = window.size() - stream.avail_out;
+      std::copy(window.begin() + windowEnd, window.end(), point.Window.begin());
+      std::copy(window.begin(), window.begin() + windowEnd, point.Window.end() - windowEnd);
+      m_RestartPoints.push_back(std::move(point));
+      lastPoint = totalOut;
+    }
+  } while (result != Z_STREAM_END);
+  inflateEnd(&stream);
+
+  m_UncompressedSize += totalOut;
+  return totalIn;
+}
+
+void
+IndexedGzipFile::Read(size_t offset, size_t numberOfBytes, void * buffer)
+{
+  this->BuildIndex();
+  if (offset > m_UncompressedSize || numberOfBytes > m_UncompressedSize - offset)
+  {
+    itkGenericExceptionMacro(<< "Could not read " << numberOfBytes << " bytes at " << offset << " from " << m_FileName
+                             << ", whose uncompressed size is " << m_UncompressedSize);
+  }
+  if (numberOfBytes == 0)
+  {
+    return;
+  }
+
+  // the restart points preceding the first byte, and preceding the end
+  const size_t end = offset + numberOfBytes;
+  const auto   isBefore = [](size_t position, const RestartPoint & point) {
+    return position < point.UncompressedOffset;
+  };
+  const size_t firstPoint =
+    std::upper_bound(m_RestartPoints.begin(), m_RestartPoints.end(), offset, isBefore) - m_RestartPoints.begin() - 1;
+  const size_t endPoint =
+    std::upper_bound(m_RestartPoints.begin(), m_RestartPoints.end(), end - 1, isBefore) - m_RestartPoints.begin();
+
+  // The restart points are split in groups, whose bytes are decompressed
+  // concurrently, each one from its first restart point.
+  const MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  const size_t                     numberOfPoints = endPoint - firstPoint;
+  const size_t numberOfGroups = std::min<size_t>(numberOfPoints, multiThreader->GetNumberOfWorkUnits());
+  auto *       output = static_cast<unsigned char *>(buffer);
+  if (numberOfGroups <= 1)
+  {
+    this->DecompressFrom(firstPoint, offset, end, output);
+    return;
+  }
+
+  std::vector<std::string> errors(numberOfGroups);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfGroups,
+    [&](SizeValueType group) {
+      const size_t groupFirstPoint = firstPoint + group * numberOfPoints / numberOfGroups;
+      const size_t groupEndPoint = firstPoint + (group + 1) * numberOfPoints / numberOfGroups;
+      const size_t groupStart = std::max(offset, m_RestartPoints[groupFirstPoint].UncompressedOffset);
+      const size_t groupEnd =
+        groupEndPoint < m_RestartPoints.size() ? std::min(end, m_RestartPoints[groupEndPoint].UncompressedOffset) : end;
+      try
+      {
+        this->DecompressFrom(groupFirstPoint, groupStart, groupEnd, output + (groupStart - offset));
+      }
+      catch (const ExceptionObject & exception)
+      {
+        errors[group] = exception.GetDescription();
+      }
+      catch (...)
+      {
+        errors[group] = "unknown error";
+      }
+    },
+    nullptr);
+
+  for (const std::string & error : errors)
+  {
+    if (!error.empty())
+    {
+      itkGenericExceptionMacro(<< error);
+    }
+  }
+}
+
+void
+IndexedGzipFile::DecompressFrom(size_t restartPoint, size_t start, size_t end, unsigned char * output) const
+{
+  const RestartPoint & point = m_RestartPoints[restartPoint];
+  const FilePointer    file = OpenFile(m_FileName);
+
+  // the bits of the byte preceding the point are primed into the
+  // decompression, which then follows the point
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  bool isRaw = !point.IsMemberStart;
+  if (inflateInit2(&stream, isRaw ? -MAX_WBITS : 16 + MAX_WBITS) != Z_OK)
+  {
+    itkGenericExceptionMacro(<< "Could not initialize the decompression of " << m_FileName);
+  }
+  const std::unique_ptr<z_stream, InflateEnder> streamEnd(&stream);
+
+  bool positioned = Seek(file.get(), point.CompressedOffset - (point.Bits ? 1 : 0));
+  if (positioned && point.Bits)
+  {
+    const int byte = getc(file.get());
+    positioned = byte != EOF && inflatePrime(&stream, point.Bits, byte >> (8 - point.Bits)) == Z_OK;
+  }
+  if (positioned && !point.Window.empty())
+  {
+    positioned =
+      inflateSetDictionary(&stream, point.Window.data(), static_cast<uInt>(point.Window.size())) == Z_OK;
+  }
+  if (!positioned)
+  {
+    itkGenericExceptionMacro(<< "Could not restart the decompression of " << m_FileName << " at "
+                             << point.CompressedOffset);
+  }
+
+  // the bytes before the start are decompressed into a discarded buffer
+  std::vector<unsigned char> input(InputSize);
+  std::vector<unsigned char> discarded(start > point.UncompressedOffset ? WindowSize : 0);
+  size_t                     position = point.UncompressedOffset;
+  size_t                     trailerToSkip = 0;
+  while (position < end)
+  {
+    if (stream.avail_in == 0)
+    {
+      stream.avail_in = static_cast<uInt>(fread(input.data(), 1, input.size(), file.get()));
+      stream.next_in = input.data();
+      if (stream.avail_in == 0)
+      {
+        itkGenericExceptionMacro(<< "Unexpected end of the compressed data of " << m_FileName);
+      }
+    }
+
+    // the trailer of a member decompressed from a raw restart point
+    if (trailerToSkip > 0)
+    {
+      const size_t skipped = std::min<size_t>(trailerToSkip, stream.avail_in);
+      stream.next_in += skipped;
+      stream.avail_in -= static_cast<uInt>(skipped);
+      trailerToSkip -= skipped;
+      continue;
+    }
+
+    if (position < start)
+    {
+      stream.next_out = discarded.data();
+      stream.avail_out = static_cast<uInt>(std::min(discarded.size(), start - position));
+    }
+    else
+    {
+      stream.next_out = output + (position - start);
+      stream.avail_out = static_cast<uInt>(std::min<size_t>(end - position, 1u << 30));
+    }
+    const uInt availableOut = stream.avail_out;
+    const int  result = inflate(&stream, Z_NO_FLUSH);
+    position += availableOut - stream.avail_out;
+
+    if (result == Z_STREAM_END && position < end)
+    {
+      // the next member follows the end of this one, and its trailer
+      if (isRaw)
+      {
+        trailerToSkip = GzipTrailerSize;
+        isRaw = false;
+      }
+      if (inflateReset2(&stream, 16 + MAX_WBITS) != Z_OK)
+      {
+        itkGenericExceptionMacro(<< "Could not decompress the members of " << m_FileName);
+      }
+    }
+    else if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+    {
+      itkGenericExceptionMacro(<< "Corrupted compressed data in " << m_FileName << ": "
+                               << (stream.msg ? stream.msg : "inflate failed"));
+    }
+  }
+}
+
+void
+IndexedGzipFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Span: " << m_Span << std::endl;
+  os << indent << "IndexBuilt: " << (m_IndexBuilt ? "On" : "Off") << std::endl;
+  os << indent << "NumberOfRestartPoints: " << m_RestartPoints.size() << std::endl;
+  os << indent << "UncompressedSize: " << m_UncompressedSize << std::endl;
+}
+
+} // end namespace itk
@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMemoryMappedFile.h"
+
+#if defined(_WIN32)
+#  include "itksys/Encoding.hxx"
+#  include "itkWindows.h"
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+}
+
+bool
+MemoryMappedFile::Map(const std::string & fileName, std::uint64_t position, size_t length)
+{
+  this->Unmap();
+
+  if (length == 0)
+  {
+    return false;
+  }
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileW(itksys::Encoding::ToWindowsExtendedPath(fileName).c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || position + length > static_cast<std::uint64_t>(fileSize.QuadPart))
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  // the view must start at a multiple of the allocation granularity
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const std::uint64_t mappingPosition = position - position % systemInfo.dwAllocationGranularity;
+  const size_t        mappingLength = length + static_cast<size_t>(position - mappingPosition);
+
+  HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (fileMapping == nullptr)
+  {
+    return false;
+  }
+  void * mapping = MapViewOfFile(fileMapping,
+                                 FILE_MAP_COPY,
+                                 static_cast<DWORD>(mappingPosition >> 32),
+                                 static_cast<DWORD>(mappingPosition & 0xffffffff),
+                                 mappingLength);
+  // the view keeps the file mapping alive
+  CloseHandle(fileMapping);
+  if (mapping == nullptr)
+  {
+    return false;
+  }
+#else
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return false;
+  }
+
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0 || position + length > static_cast<std::uint64_t>(fileStatus.st_size))
+  {
+    close(file);
+    return false;
+  }
+
+  // the mapping must start at a multiple of the page size
+  const auto          pageSize = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+  const std::uint64_t mappingPosition = position - position % pageSize;
+  const size_t        mappingLength = length + static_cast<size_t>(position - mappingPosition);
+
+  void * mapping =
+    mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(mappingPosition));
+  // the mapping keeps a reference to the file
+  close(file);
+  if (mapping == MAP_FAILED)
+  {
+    return false;
+  }
+#endif
+
+  m_Mapping = mapping;
+  m_MappingLength = mappingLength;
+  m_Data = static_cast<char *>(mapping) + (position - mappingPosition);
+  m_Length = length;
+  return true;
+}
+
+void
+MemoryMappedFile::Unmap()
+{
+  if (m_Mapping)
+  {
+#if defined(_WIN32)
+    UnmapViewOfFile(m_Mapping);
+#else
+    munmap(m_Mapping, m_MappingLength);
+#endif
+  }
+  m_Mapping = nullptr;
+  m_MappingLength = 0;
+  m_Data = nullptr;
+  m_Length = 0;
+}
+
+void
+MemoryMappedFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Data: " << m_Data << std::endl;
+  os << indent << "Length: " << m_Length << std::endl;
+}
+} // end namespace itk
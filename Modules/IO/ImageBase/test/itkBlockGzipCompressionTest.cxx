@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBlockGzipCompression.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+
+#include <cstring>
+#include <random>
+
+namespace
+{
+using DataType = itk::BlockGzipCompression::CompressedDataType;
+
+// Creates compressible data: runs of random bytes.
+DataType
+CreateData(size_t numberOfBytes)
+{
+  DataType                           data(numberOfBytes);
+  std::mt19937                       randomNumberEngine(static_cast<unsigned int>(numberOfBytes));
+  std::uniform_int_distribution<int> distribution(0, 255);
+  for (size_t i = 0; i < numberOfBytes; ++i)
+  {
+    data[i] = static_cast<unsigned char>(i % 16 == 0 ? distribution(randomNumberEngine) : data[i - 1]);
+  }
+  return data;
+}
+
+// Decompresses the data serially, with a zlib stream that detects the gzip
+// header, as the readers which do not know about the blocks do.
+bool
+InflateSerially(const DataType & compressed, DataType & data, size_t numberOfBytes)
+{
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, 15 + 32) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = const_cast<Bytef *>(compressed.data());
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = data.data();
+  stream.avail_out = static_cast<uInt>(numberOfBytes);
+  const int result = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && stream.avail_out == 0 && stream.avail_in == 0;
+}
+
+// Compresses the data with a plain gzip stream.
+DataType
+DeflateSerially(const DataType & data)
+{
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  DataType compressed(deflateBound(&stream, static_cast<uLong>(data.size())) + 32);
+  stream.next_in = const_cast<Bytef *>(data.data());
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = compressed.data();
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  deflate(&stream, Z_FINISH);
+  compressed.resize(compressed.size() - stream.avail_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+} // namespace
+
+
+int
+itkBlockGzipCompressionTest(int, char *[])
+{
+  bool passed = true;
+
+  // empty, single block, and several blocks, the last one being shorter
+  for (const size_t numberOfBytes : { 0, 1, 1000, 3 * 256 * 1024 + 123 })
+  {
+    for (const int compressionLevel : { 1, 6, 9 })
+    {
+      const DataType data = CreateData(numberOfBytes);
+      const DataType compressed = itk::BlockGzipCompression::Compress(data.data(), data.size(), compressionLevel);
+      ITK_TEST_EXPECT_TRUE(itk::BlockGzipCompression::IsBlockCompressed(compressed.data(), compressed.size()));
+
+      DataType   serial(numberOfBytes + 1);
+      const bool inflated = InflateSerially(compressed, serial, numberOfBytes);
+      serial.resize(numberOfBytes);
+      if (!inflated || serial != data)
+      {
+        std::cerr << "Serial decompression failed for " << numberOfBytes << " bytes at the compression level "
+                  << compressionLevel << std::endl;
+        passed = false;
+      }
+
+      DataType parallel(numberOfBytes + 1);
+      ITK_TEST_EXPECT_TRUE(
+        itk::BlockGzipCompression::Decompress(compressed.data(), compressed.size(), parallel.data(), numberOfBytes));
+      parallel.resize(numberOfBytes);
+      if (parallel != data)
+      {
+        std::cerr << "Parallel decompression failed for " << numberOfBytes << " bytes at the compression level "
+                  << compressionLevel << std::endl;
+        passed = false;
+      }
+    }
+  }
+
+  const DataType data = CreateData(2 * 256 * 1024 + 7);
+  DataType       compressed = itk::BlockGzipCompression::Compress(data.data(), data.size(), 6);
+  DataType       decompressed(data.size());
+
+  // the blocks must have the expected size
+  ITK_TEST_EXPECT_TRUE(
+    !itk::BlockGzipCompression::Decompress(compressed.data(), compressed.size(), decompressed.data(), data.size() - 1));
+
+  // a plain gzip stream is not block compressed
+  const DataType plain = DeflateSerially(data);
+  ITK_TEST_EXPECT_TRUE(!itk::BlockGzipCompression::IsBlockCompressed(plain.data(), plain.size()));
+  ITK_TEST_EXPECT_TRUE(
+    !itk::BlockGzipCompression::Decompress(plain.data(), plain.size(), decompressed.data(), data.size()));
+
+  // corrupted data is detected
+  compressed[compressed.size() / 2] ^= 0x55;
+  ITK_TRY_EXPECT_EXCEPTION(
+    itk::BlockGzipCompression::Decompress(compressed.data(), compressed.size(), decompressed.data(), data.size()));
+
+  if (!passed)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+
+template <typename TImage>
+bool
+IsMapped(const TImage * image)
+{
+  using PixelContainerType = typename TImage::PixelContainer;
+  using MappedPixelContainerType =
+    itk::MemoryMappedImageContainer<typename PixelContainerType::ElementIdentifier,
+                                    typename PixelContainerType::Element>;
+  return dynamic_cast<const MappedPixelContainerType *>(image->GetPixelContainer()) != nullptr;
+}
+
+// Reads the image, with or without a memory mapping, and returns the reader
+// once its output has been updated for the requested region.
+template <typename TImage>
+typename itk::ImageFileReader<TImage>::Pointer
+ReadImage(const std::string & fileName, bool useMemoryMappedReading, const ImageType::RegionType * requestedRegion)
+{
+  auto imageIO = itk::MetaImageIO::New();
+  imageIO->SetUseStreamedReading(requestedRegion != nullptr);
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(imageIO);
+  reader->SetUseMemoryMappedReading(useMemoryMappedReading);
+  reader->UpdateOutputInformation();
+  if (requestedRegion)
+  {
+    reader->GetOutput()->SetRequestedRegion(*requestedRegion);
+  }
+  reader->GetOutput()->Update();
+  return reader;
+}
+
+// Compares the image read with a memory mapping to the image read in an
+// allocated buffer, and verifies whether it has been mapped.
+template <typename TImage>
+bool
+TestMemoryMappedReading(const std::string &           fileName,
+                        bool                          expectedMapped,
+                        const ImageType::RegionType * requestedRegion = nullptr)
+{
+  const auto     expectedReader = ReadImage<TImage>(fileName, false, requestedRegion);
+  const auto     reader = ReadImage<TImage>(fileName, true, requestedRegion);
+  const TImage * expected = expectedReader->GetOutput();
+  const TImage * image = reader->GetOutput();
+  const char *   regionName = requestedRegion ? " with a requested region" : "";
+
+  if (IsMapped(expected))
+  {
+    std::cerr << "Test failed! " << fileName << regionName << " is mapped without UseMemoryMappedReading"
+              << std::endl;
+    return false;
+  }
+  if (IsMapped(image) != expectedMapped)
+  {
+    std::cerr << "Test failed! " << fileName << regionName << (expectedMapped ? " is not mapped" : " is mapped")
+              << std::endl;
+    return false;
+  }
+  if (image->GetBufferedRegion() != expected->GetBufferedRegion())
+  {
+    std::cerr << "Test failed! The buffered region of " << fileName << regionName << " is "
+              << image->GetBufferedRegion() << " instead of " << expected->GetBufferedRegion() << std::endl;
+    return false;
+  }
+
+  itk::ImageRegionConstIteratorWithIndex<TImage> expectedIt(expected, expected->GetBufferedRegion());
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it, ++expectedIt)
+  {
+    if (it.Get() != expectedIt.Get())
+    {
+      std::cerr << "Test failed! The pixel of " << fileName << regionName << " at " << it.GetIndex() << " is "
+                << it.Get() << " instead of " << expectedIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+void
+WriteImage(const TImage * image, const std::string & fileName, bool useCompression)
+{
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(useCompression);
+  writer->Update();
+}
+} // namespace
+
+
+int
+itkImageFileReaderMemoryMappedReadingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  ITK_TEST_SET_GET_BOOLEAN(reader, UseMemoryMappedReading, true);
+  ITK_TEST_SET_GET_BOOLEAN(reader, UseMemoryMappedReading, false);
+
+  const ImageType::SizeType size = { { 31, 17, 9 } };
+
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<short>(1000 * index[2] + 50 * index[1] + index[0] - 4000));
+  }
+
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(size);
+  vectorImage->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<VectorImageType> it(vectorImage, vectorImage->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    VectorImageType::PixelType pixel;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      pixel[i] = 0.5f * static_cast<float>(it.GetIndex()[i]) + static_cast<float>(i);
+    }
+    it.Set(pixel);
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkImageFileReaderMemoryMappedReadingTest";
+  const std::string localFileName = prefix + ".mha";
+  const std::string separateFileName = prefix + ".mhd";
+  const std::string compressedFileName = prefix + "Compressed.mha";
+  const std::string vectorFileName = prefix + "Vector.mhd";
+  const std::string localVectorFileName = prefix + "Vector.mha";
+  ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage<ImageType>(image, localFileName, false));
+  ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage<ImageType>(image, separateFileName, false));
+  ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage<ImageType>(image, compressedFileName, true));
+  ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage<VectorImageType>(vectorImage, vectorFileName, false));
+  ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage<VectorImageType>(vectorImage, localVectorFileName, false));
+
+  // A slab of slices is contiguous in the file, a block is not
+  ImageType::RegionType slabRegion({ { 0, 0, 3 } }, { { 31, 17, 4 } });
+  ImageType::RegionType blockRegion({ { 2, 3, 3 } }, { { 20, 10, 4 } });
+
+  bool passed = true;
+  passed = TestMemoryMappedReading<ImageType>(localFileName, true) && passed;
+  passed = TestMemoryMappedReading<ImageType>(separateFileName, true) && passed;
+  passed = TestMemoryMappedReading<ImageType>(compressedFileName, false) && passed;
+  passed = TestMemoryMappedReading<VectorImageType>(vectorFileName, true) && passed;
+  // The header of the local file is not a multiple of the size of the
+  // components, which would not be aligned if they were mapped
+  passed = TestMemoryMappedReading<VectorImageType>(localVectorFileName, false) && passed;
+  passed = TestMemoryMappedReading<ImageType>(localFileName, true, &slabRegion) && passed;
+  passed = TestMemoryMappedReading<ImageType>(separateFileName, true, &slabRegion) && passed;
+  passed = TestMemoryMappedReading<ImageType>(localFileName, false, &blockRegion) && passed;
+
+  // The pixels which need a conversion are read
+  passed = TestMemoryMappedReading<itk::Image<float, 3>>(localFileName, false) && passed;
+
+  // The modifications of a mapped image are not written to the file
+  const auto mappedReader = ReadImage<ImageType>(localFileName, true, nullptr);
+  mappedReader->GetOutput()->FillBuffer(7);
+  passed = TestMemoryMappedReading<ImageType>(localFileName, true) && passed;
+  if (ReadImage<ImageType>(localFileName, false, nullptr)->GetOutput()->GetPixel({ { 4, 5, 6 } }) != 2254)
+  {
+    std::cerr << "Test failed! The modification of the mapped image has been written to the file" << std::endl;
+    passed = false;
+  }
+
+  // The buffer is allocated again once the mapping is disabled
+  mappedReader->SetUseMemoryMappedReading(false);
+  mappedReader->Modified();
+  mappedReader->Update();
+  if (IsMapped(mappedReader->GetOutput()) || mappedReader->GetOutput()->GetPixel({ { 4, 5, 6 } }) != 2254)
+  {
+    std::cerr << "Test failed! The image is still mapped after disabling UseMemoryMappedReading" << std::endl;
+    passed = false;
+  }
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
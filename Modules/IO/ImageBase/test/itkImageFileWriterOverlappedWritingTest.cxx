@@ -0,0 +1,216 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using WriterType = itk::ImageFileWriter<ImageType>;
+using MonitorType = itk::PipelineMonitorImageFilter<ImageType>;
+
+// A MetaImageIO which counts the calls made to it by the writer while it
+// writes a piece in the background.
+class MonitoredMetaImageIO : public itk::MetaImageIO
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MonitoredMetaImageIO);
+
+  using Self = MonitoredMetaImageIO;
+  using Superclass = itk::MetaImageIO;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(MonitoredMetaImageIO, MetaImageIO);
+
+  void
+  Write(const void * buffer) override
+  {
+    m_IsWriting = true;
+    // long enough for the next piece to be generated meanwhile
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Superclass::Write(buffer);
+    m_IsWriting = false;
+  }
+
+  itk::ImageIORegion
+  GetSplitRegionForWriting(unsigned int               ithPiece,
+                           unsigned int               numberOfActualSplits,
+                           const itk::ImageIORegion & pasteRegion,
+                           const itk::ImageIORegion & largestPossibleRegion) override
+  {
+    // long enough for a write launched just before to start meanwhile
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    this->CountCall();
+    return Superclass::GetSplitRegionForWriting(ithPiece, numberOfActualSplits, pasteRegion, largestPossibleRegion);
+  }
+
+  bool
+  CanStreamWrite() override
+  {
+    this->CountCall();
+    return Superclass::CanStreamWrite();
+  }
+
+  unsigned int
+  GetNumberOfCallsWhileWriting() const
+  {
+    return m_NumberOfCallsWhileWriting;
+  }
+
+protected:
+  MonitoredMetaImageIO() = default;
+  ~MonitoredMetaImageIO() override = default;
+
+private:
+  void
+  CountCall()
+  {
+    if (m_IsWriting)
+    {
+      ++m_NumberOfCallsWhileWriting;
+    }
+  }
+
+  std::atomic<bool>         m_IsWriting{ false };
+  std::atomic<unsigned int> m_NumberOfCallsWhileWriting{ 0 };
+};
+
+// Streams the image of the input file to the output file, in pieces written
+// while the next ones are read, and compares the output with the input.
+int
+StreamImage(const std::string & inputFileName, const std::string & outputFileName, unsigned int numberOfPieces)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->SetUseStreaming(true);
+
+  auto monitor = MonitorType::New();
+  monitor->SetInput(reader->GetOutput());
+
+  // the image IO is not used by the writer while it writes a piece
+  auto imageIO = MonitoredMetaImageIO::New();
+  auto writer = WriterType::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(outputFileName);
+  writer->SetImageIO(imageIO);
+  writer->SetNumberOfStreamDivisions(numberOfPieces);
+  writer->UseOverlappedWritingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfPieces));
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfCallsWhileWriting(), 0);
+
+  auto expectedReader = itk::ImageFileReader<ImageType>::New();
+  expectedReader->SetFileName(inputFileName);
+  auto outputReader = itk::ImageFileReader<ImageType>::New();
+  outputReader->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(expectedReader->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(outputReader->Update());
+  const ImageType * expected = expectedReader->GetOutput();
+  const ImageType * output = outputReader->GetOutput();
+  ITK_TEST_EXPECT_EQUAL(output->GetLargestPossibleRegion(), expected->GetLargestPossibleRegion());
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(expected, expected->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (output->GetPixel(it.GetIndex()) != it.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " written as " << output->GetPixel(it.GetIndex()) << " instead of "
+                << it.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkImageFileWriterOverlappedWritingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  const ImageType::SizeType size = { { 31, 23, 17 } };
+  auto                      image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<short>(index[0] + 100 * index[1] - 1000 * index[2]));
+  }
+  const std::string inputFileName = outputDirectory + "/itkImageFileWriterOverlappedWritingTestInput.mha";
+
+  auto writer = WriterType::New();
+  ITK_TEST_SET_GET_BOOLEAN(writer, UseOverlappedWriting, true);
+  ITK_TEST_SET_GET_BOOLEAN(writer, UseOverlappedWriting, false);
+  writer->SetInput(image);
+  writer->SetFileName(inputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  int result = EXIT_SUCCESS;
+
+  // as many pieces as slices, fewer, and a single piece, which is not
+  // overlapped
+  for (unsigned int numberOfPieces : { 17, 5, 1 })
+  {
+    const std::string outputFileName = outputDirectory + "/itkImageFileWriterOverlappedWritingTest" +
+                                       std::to_string(numberOfPieces) + ".mha";
+    if (StreamImage(inputFileName, outputFileName, numberOfPieces) != EXIT_SUCCESS)
+    {
+      std::cerr << "Writing " << numberOfPieces << " pieces failed" << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+
+  // the exception thrown while writing a piece in the background is rethrown
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->SetUseStreaming(true);
+  auto failingWriter = WriterType::New();
+  failingWriter->SetInput(reader->GetOutput());
+  failingWriter->SetFileName(outputDirectory + "/MissingDirectory/itkImageFileWriterOverlappedWritingTest.mha");
+  failingWriter->SetNumberOfStreamDivisions(4);
+  failingWriter->UseOverlappedWritingOn();
+  ITK_TRY_EXPECT_EXCEPTION(failingWriter->Update());
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using ReaderType = itk::ImageSeriesReader<ImageType>;
+
+// Reads the series, either sequentially or concurrently, and returns the
+// reader once its output has been updated for the requested region.
+ReaderType::Pointer
+ReadSeries(const ReaderType::FileNamesContainer & fileNames,
+           bool                                   concurrentReading,
+           bool                                   useImageIO,
+           bool                                   reverseOrder,
+           const ImageType::RegionType *          requestedRegion)
+{
+  auto reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetConcurrentReading(concurrentReading);
+  reader->SetReverseOrder(reverseOrder);
+  reader->SetNumberOfWorkUnits(4);
+  if (useImageIO)
+  {
+    reader->SetImageIO(itk::MetaImageIO::New());
+  }
+
+  reader->UpdateOutputInformation();
+  if (requestedRegion)
+  {
+    reader->GetOutput()->SetRequestedRegion(*requestedRegion);
+  }
+  reader->GetOutput()->Update();
+  return reader;
+}
+
+bool
+CompareReaders(const ReaderType * expected, const ReaderType * actual)
+{
+  const ImageType * expectedImage = expected->GetOutput();
+  const ImageType * actualImage = actual->GetOutput();
+  if (expectedImage->GetBufferedRegion() != actualImage->GetBufferedRegion())
+  {
+    std::cerr << "Buffered region mismatch: expected " << expectedImage->GetBufferedRegion() << ", actual "
+              << actualImage->GetBufferedRegion() << std::endl;
+    return false;
+  }
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> expectedIt(expectedImage, expectedImage->GetBufferedRegion());
+  itk::ImageRegionConstIteratorWithIndex<ImageType> actualIt(actualImage, actualImage->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "Pixel mismatch at " << expectedIt.GetIndex() << ": expected " << expectedIt.Get() << ", actual "
+                << actualIt.Get() << std::endl;
+      return false;
+    }
+  }
+
+  const std::string deviationKey = "ITK_non_uniform_sampling_deviation";
+  double            expectedDeviation = 0.0;
+  double            actualDeviation = 0.0;
+  itk::ExposeMetaData<double>(expectedImage->GetMetaDataDictionary(), deviationKey, expectedDeviation);
+  itk::ExposeMetaData<double>(actualImage->GetMetaDataDictionary(), deviationKey, actualDeviation);
+  if (expectedDeviation != actualDeviation)
+  {
+    std::cerr << "Sampling deviation mismatch: expected " << expectedDeviation << ", actual " << actualDeviation
+              << std::endl;
+    return false;
+  }
+
+  const auto & expectedArray = *expected->GetMetaDataDictionaryArray();
+  const auto & actualArray = *actual->GetMetaDataDictionaryArray();
+  if (expectedArray.size() != actualArray.size())
+  {
+    std::cerr << "MetaDataDictionaryArray size mismatch: expected " << expectedArray.size() << ", actual "
+              << actualArray.size() << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < expectedArray.size(); ++i)
+  {
+    std::string expectedName;
+    std::string actualName;
+    itk::ExposeMetaData<std::string>(*expectedArray[i], "SliceName", expectedName);
+    itk::ExposeMetaData<std::string>(*actualArray[i], "SliceName", actualName);
+    expectedDeviation = 0.0;
+    actualDeviation = 0.0;
+    itk::ExposeMetaData<double>(*expectedArray[i], deviationKey, expectedDeviation);
+    itk::ExposeMetaData<double>(*actualArray[i], deviationKey, actualDeviation);
+    if (expectedName != actualName || expectedDeviation != actualDeviation)
+    {
+      std::cerr << "MetaDataDictionary mismatch for the slice " << i << ": expected " << expectedName << " ("
+                << expectedDeviation << "), actual " << actualName << " (" << actualDeviation << ")" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkImageSeriesReaderConcurrentReadingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto reader = ReaderType::New();
+  ITK_TEST_SET_GET_BOOLEAN(reader, ConcurrentReading, true);
+  ITK_TEST_SET_GET_BOOLEAN(reader, ConcurrentReading, false);
+
+  // Write a series of single slice volumes, with a missing slice so that a
+  // non uniform sampling is detected, and a name in the meta data of each slice.
+  constexpr unsigned int         numberOfSlices = 13;
+  const ImageType::SizeType      sliceSize = { { 17, 11, 1 } };
+  ReaderType::FileNamesContainer fileNames;
+  auto                           writer = itk::ImageFileWriter<ImageType>::New();
+  for (unsigned int i = 0; i < numberOfSlices; ++i)
+  {
+    auto slice = ImageType::New();
+    slice->SetRegions(sliceSize);
+    slice->Allocate();
+    const double origin[] = { 1.0, -2.0, 2.5 * (i < 7 ? i : i + 1) };
+    slice->SetOrigin(origin);
+
+    itk::ImageRegionIteratorWithIndex<ImageType> it(slice, slice->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it)
+    {
+      it.Set(static_cast<short>(100 * i + 10 * it.GetIndex()[1] + it.GetIndex()[0]));
+    }
+    itk::EncapsulateMetaData<std::string>(slice->GetMetaDataDictionary(), "SliceName", "slice" + std::to_string(i));
+
+    fileNames.push_back(std::string(argv[1]) + "/itkImageSeriesReaderConcurrentReadingTest" + std::to_string(i) +
+                        ".mha");
+    writer->SetInput(slice);
+    writer->SetFileName(fileNames.back());
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  }
+
+  ImageType::RegionType requestedRegion;
+  requestedRegion.SetIndex({ { 2, 3, 4 } });
+  requestedRegion.SetSize({ { 9, 5, 6 } });
+
+  bool passed = true;
+  for (const bool useImageIO : { false, true })
+  {
+    for (const bool reverseOrder : { false, true })
+    {
+      for (const ImageType::RegionType * region : { static_cast<const ImageType::RegionType *>(nullptr),
+                                                    static_cast<const ImageType::RegionType *>(&requestedRegion) })
+      {
+        const auto sequential = ReadSeries(fileNames, false, useImageIO, reverseOrder, region);
+        const auto concurrent = ReadSeries(fileNames, true, useImageIO, reverseOrder, region);
+        if (!CompareReaders(sequential, concurrent))
+        {
+          std::cerr << "Test failed! (ImageIO " << useImageIO << ", ReverseOrder " << reverseOrder
+                    << ", RequestedRegion " << (region != nullptr) << ")" << std::endl;
+          passed = false;
+        }
+      }
+    }
+  }
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBlockGzipCompression.h"
+#include "itkIndexedGzipFile.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace
+{
+using DataType = itk::BlockGzipCompression::CompressedDataType;
+
+// Creates compressible data: runs of random bytes.
+DataType
+CreateData(size_t numberOfBytes, unsigned int seed)
+{
+  DataType                           data(numberOfBytes);
+  std::mt19937                       randomNumberEngine(seed);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  for (size_t i = 0; i < numberOfBytes; ++i)
+  {
+    data[i] = static_cast<unsigned char>(i % 8 == 0 ? distribution(randomNumberEngine) : data[i - 1]);
+  }
+  return data;
+}
+
+// Compresses the data with a plain gzip stream.
+DataType
+DeflateSerially(const DataType & data)
+{
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  DataType compressed(deflateBound(&stream, static_cast<uLong>(data.size())) + 32);
+  stream.next_in = const_cast<Bytef *>(data.data());
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = compressed.data();
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  deflate(&stream, Z_FINISH);
+  compressed.resize(compressed.size() - stream.avail_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+
+void
+WriteFile(const std::string & fileName, const std::vector<DataType> & members)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  for (const DataType & member : members)
+  {
+    file.write(reinterpret_cast<const char *>(member.data()), member.size());
+  }
+}
+
+// Reads ranges of bytes starting at, ending at, and straddling the restart
+// points, and compares them with the data.
+int
+ReadRanges(itk::IndexedGzipFile * gzipFile, const DataType & data)
+{
+  const size_t                     size = data.size();
+  const std::vector<size_t> starts{ 0, 1, 65535, 65536, 100000, 300001, size / 2, size - 70000, size - 1, size };
+  for (const size_t start : starts)
+  {
+    for (const size_t length : { size_t{ 0 }, size_t{ 1 }, size_t{ 4097 }, size_t{ 200000 }, size })
+    {
+      const size_t numberOfBytes = std::min(length, size - start);
+      DataType     read(numberOfBytes + 1, 0xAB);
+      ITK_TRY_EXPECT_NO_EXCEPTION(gzipFile->Read(start, numberOfBytes, read.data()));
+      if (!std::equal(read.begin(), read.end() - 1, data.begin() + start) || read.back() != 0xAB)
+      {
+        std::cerr << "Reading " << numberOfBytes << " bytes at " << start << " from " << gzipFile->GetFileName()
+                  << " failed" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkIndexedGzipFileTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  // several groups of restart points, whatever the number of processors
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(4);
+
+  auto gzipFile = itk::IndexedGzipFile::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(gzipFile, IndexedGzipFile, LightObject);
+  gzipFile->SetSpan(64 * 1024);
+  ITK_TEST_SET_GET_VALUE(64 * 1024, gzipFile->GetSpan());
+
+  int result = EXIT_SUCCESS;
+
+  // a plain gzip file, whose index is built by decompressing it
+  const DataType    plainData = CreateData(1500000, 1);
+  const std::string plainFileName = outputDirectory + "/itkIndexedGzipFileTestPlain.gz";
+  WriteFile(plainFileName, { DeflateSerially(plainData) });
+  gzipFile->SetFileName(plainFileName);
+  ITK_TEST_EXPECT_TRUE(!gzipFile->IsBlockCompressed());
+  ITK_TEST_EXPECT_TRUE(!gzipFile->IsIndexBuilt());
+  ITK_TRY_EXPECT_NO_EXCEPTION(gzipFile->BuildIndex());
+  ITK_TEST_EXPECT_EQUAL(gzipFile->GetUncompressedSize(), plainData.size());
+  ITK_TEST_EXPECT_TRUE(gzipFile->GetNumberOfRestartPoints() > 10);
+  if (ReadRanges(gzipFile, plainData) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // a block compressed file, whose blocks are the restart points
+  const DataType    blockData = CreateData(1300000, 2);
+  const std::string blockFileName = outputDirectory + "/itkIndexedGzipFileTestBlock.gz";
+  WriteFile(blockFileName, { itk::BlockGzipCompression::Compress(blockData.data(), blockData.size(), 6) });
+  gzipFile->SetFileName(blockFileName);
+  ITK_TEST_EXPECT_TRUE(gzipFile->IsBlockCompressed());
+  ITK_TRY_EXPECT_NO_EXCEPTION(gzipFile->BuildIndex());
+  ITK_TEST_EXPECT_EQUAL(gzipFile->GetNumberOfRestartPoints(), 5);
+  if (ReadRanges(gzipFile, blockData) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // several members of both kinds, followed by bytes which are not a member
+  DataType          membersData = CreateData(200000, 3);
+  const DataType    secondData = CreateData(700000, 4);
+  const DataType    thirdData = CreateData(300000, 5);
+  const std::string membersFileName = outputDirectory + "/itkIndexedGzipFileTestMembers.gz";
+  WriteFile(membersFileName,
+            { itk::BlockGzipCompression::Compress(membersData.data(), membersData.size(), 1),
+              DeflateSerially(secondData),
+              itk::BlockGzipCompression::Compress(thirdData.data(), thirdData.size(), 9),
+              DataType(100, 0) });
+  membersData.insert(membersData.end(), secondData.begin(), secondData.end());
+  membersData.insert(membersData.end(), thirdData.begin(), thirdData.end());
+  gzipFile->SetFileName(membersFileName);
+  ITK_TEST_EXPECT_TRUE(!gzipFile->IsBlockCompressed());
+  if (ReadRanges(gzipFile, membersData) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  ITK_TEST_EXPECT_EQUAL(gzipFile->GetUncompressedSize(), membersData.size());
+
+  // the bytes must be within the uncompressed data
+  DataType read(10);
+  ITK_TRY_EXPECT_EXCEPTION(gzipFile->Read(membersData.size() - 5, 10, read.data()));
+
+  // a file which is not a gzip file
+  const std::string notGzipFileName = outputDirectory + "/itkIndexedGzipFileTestNotGzip.gz";
+  WriteFile(notGzipFileName, { plainData });
+  gzipFile->SetFileName(notGzipFileName);
+  ITK_TRY_EXPECT_EXCEPTION(gzipFile->BuildIndex());
+
+  // a corrupted file
+  DataType corrupted = DeflateSerially(plainData);
+  corrupted[corrupted.size() / 2] ^= 0x55;
+  const std::string corruptedFileName = outputDirectory + "/itkIndexedGzipFileTestCorrupted.gz";
+  WriteFile(corruptedFileName, { corrupted });
+  gzipFile->SetFileName(corruptedFileName);
+  ITK_TRY_EXPECT_EXCEPTION(gzipFile->BuildIndex());
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkPrefetchingImageFileReader.h"
+#include "itkTestingMacros.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using ReaderType = itk::PrefetchingImageFileReader<ImageType>;
+
+// A MetaImageIO which counts the files being read at once, and reads them
+// slowly, so that the reads overlap.
+class CountingMetaImageIO : public itk::MetaImageIO
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CountingMetaImageIO);
+
+  using Self = CountingMetaImageIO;
+  using Superclass = itk::MetaImageIO;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(CountingMetaImageIO, MetaImageIO);
+
+  static std::atomic<unsigned int> m_NumberOfReads;
+  static std::atomic<unsigned int> m_MaximumNumberOfReads;
+
+  void
+  Read(void * buffer) override
+  {
+    const unsigned int numberOfReads = ++m_NumberOfReads;
+    unsigned int       maximumNumberOfReads = m_MaximumNumberOfReads;
+    while (numberOfReads > maximumNumberOfReads &&
+           !m_MaximumNumberOfReads.compare_exchange_weak(maximumNumberOfReads, numberOfReads))
+    {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Superclass::Read(buffer);
+    --m_NumberOfReads;
+  }
+
+protected:
+  CountingMetaImageIO() = default;
+  ~CountingMetaImageIO() override = default;
+};
+
+std::atomic<unsigned int> CountingMetaImageIO::m_NumberOfReads{ 0 };
+std::atomic<unsigned int> CountingMetaImageIO::m_MaximumNumberOfReads{ 0 };
+
+// The value of the pixel of the index in the i-th image.
+short
+PixelValue(unsigned int i, const ImageType::IndexType & index)
+{
+  return static_cast<short>(100 * i + index[0] + 3 * index[1] - 7 * index[2]);
+}
+
+bool
+CheckImage(const ImageType * image, unsigned int i)
+{
+  if (image->GetLargestPossibleRegion().GetSize(0) != 20 + i)
+  {
+    std::cerr << "Image " << i << " has the size of another image: " << image->GetLargestPossibleRegion() << std::endl;
+    return false;
+  }
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != PixelValue(i, it.GetIndex()))
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " of image " << i << " read as " << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads all the images, which must be the images written.
+int
+ReadImages(ReaderType * reader, unsigned int numberOfImages)
+{
+  for (unsigned int i = 0; i < numberOfImages; ++i)
+  {
+    ITK_TEST_EXPECT_TRUE(reader->HasNextImage());
+    ReaderType::ImageFutureType future = reader->GetNextImage();
+    ImageType::Pointer          image;
+    ITK_TRY_EXPECT_NO_EXCEPTION(image = future.get());
+    if (!CheckImage(image, i))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  ITK_TEST_EXPECT_TRUE(!reader->HasNextImage());
+  ITK_TRY_EXPECT_EXCEPTION(reader->GetNextImage());
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkPrefetchingImageFileReaderTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // images of different sizes, so that they can not be mistaken for each other
+  constexpr unsigned int         numberOfImages = 7;
+  ReaderType::FileNamesContainer fileNames;
+  for (unsigned int i = 0; i < numberOfImages; ++i)
+  {
+    const ImageType::SizeType size = { { 20 + i, 30, 10 } };
+    auto                      image = ImageType::New();
+    image->SetRegions(size);
+    image->Allocate();
+    itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it)
+    {
+      it.Set(PixelValue(i, it.GetIndex()));
+    }
+
+    fileNames.push_back(std::string(argv[1]) + "/itkPrefetchingImageFileReaderTest" + std::to_string(i) + ".mha");
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileNames.back());
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  }
+
+  auto reader = ReaderType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(reader, PrefetchingImageFileReader, Object);
+  ITK_TEST_SET_GET_VALUE(2, reader->GetLookAhead());
+  ITK_TEST_EXPECT_TRUE(!reader->HasNextImage());
+
+  int result = EXIT_SUCCESS;
+
+  // the images are read in the order of the files, whatever the look ahead
+  for (unsigned int lookAhead : { 1, 3, 100 })
+  {
+    reader->SetFileNames(fileNames);
+    reader->SetLookAhead(lookAhead);
+    ITK_TEST_SET_GET_VALUE(lookAhead, reader->GetLookAhead());
+    reader->Start();
+    if (ReadImages(reader, numberOfImages) != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  // the look ahead is at least one image
+  reader->SetLookAhead(0);
+  ITK_TEST_SET_GET_VALUE(1, reader->GetLookAhead());
+
+  // reading the files with a clone of the ImageIO for each file, from the
+  // first image returned, without calling Start()
+  reader->SetImageIO(itk::MetaImageIO::New());
+  reader->SetLookAhead(4);
+  reader->SetFileNames(fileNames);
+  ITK_TEST_EXPECT_TRUE(reader->HasNextImage());
+  if (ReadImages(reader, numberOfImages) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  // and again, from the start
+  reader->Start();
+  if (ReadImages(reader, numberOfImages) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // no more than LookAhead files are read at once, while the images returned
+  // are processed
+  reader->SetImageIO(CountingMetaImageIO::New());
+  reader->SetLookAhead(2);
+  reader->Start();
+  for (unsigned int i = 0; i < numberOfImages; ++i)
+  {
+    ReaderType::ImageFutureType future = reader->GetNextImage();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ITK_TRY_EXPECT_NO_EXCEPTION(future.get());
+  }
+  ITK_TEST_EXPECT_EQUAL(CountingMetaImageIO::m_MaximumNumberOfReads.load(), 2);
+  reader->SetImageIO(nullptr);
+
+  // the images which are not returned are dropped
+  reader->Start();
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->GetNextImage().get());
+  reader->SetFileNames(fileNames);
+  if (ReadImages(reader, numberOfImages) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // a file which can not be read, whose exception is thrown by its future
+  // only
+  ReaderType::FileNamesContainer missingFileNames = fileNames;
+  missingFileNames[1] = std::string(argv[1]) + "/itkPrefetchingImageFileReaderTestMissing.mha";
+  reader->SetFileNames(missingFileNames);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->GetNextImage().get());
+  ReaderType::ImageFutureType missingImage = reader->GetNextImage();
+  ImageType::Pointer          image;
+  ITK_TRY_EXPECT_NO_EXCEPTION(image = reader->GetNextImage().get());
+  ITK_TEST_EXPECT_TRUE(CheckImage(image, 2));
+  ITK_TRY_EXPECT_EXCEPTION(missingImage.get());
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
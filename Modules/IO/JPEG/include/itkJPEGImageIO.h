@@ -110,6 +110,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
   void
   WriteSlice(std::string & fileName, const void * buffer);
 
@@ -276,6 +276,21 @@ JPEGImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Progressive : " << m_Progressive << "\n";
 }
 
+LightObject::Pointer
+JPEGImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_Progressive = this->m_Progressive;
+
+  return loPtr;
+}
+
 void
 JPEGImageIO::ReadImageInformation()
 {
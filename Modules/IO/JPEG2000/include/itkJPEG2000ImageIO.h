@@ -73,6 +73,11 @@ extern ITKIOJPEG2000_EXPORT std::ostream &
  *  JPEG2000 offers a large collection of interesting features including:
  *  compression (lossless and lossy), streaming, multi-channel images.
  *
+ *  Only the tiles intersecting the requested region are decoded, the tiles
+ *  being decoded concurrently. A reduced resolution of the image can be read,
+ *  at a fraction of the cost of decoding the full resolution, by discarding
+ *  the highest resolution levels with SetReductionFactor().
+ *
  *
  * This code was contributed in the Insight Journal paper:
  * "Support for Streaming the JPEG2000 File Format"
@@ -146,6 +151,14 @@ public:
   void
   SetTileSize(int x, int y);
 
+  /** Set/Get the number of highest resolution levels which are discarded
+   * when reading, each of them halving the dimensions of the image which is
+   * read, and doubling its spacing. The default of 0 reads the full
+   * resolution. The factor must be lower than the number of resolution
+   * levels of the file. */
+  itkSetMacro(ReductionFactor, unsigned int);
+  itkGetConstMacro(ReductionFactor, unsigned int);
+
   /** Currently JPEG2000 does not support streamed writing
    *
    * These methods are re-overridden to not support streaming for
@@ -161,6 +174,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
 private:
   std::unique_ptr<JPEG2000ImageIOInternal> m_Internal;
 
@@ -169,6 +185,13 @@ private:
 
   void
   ComputeRegionInTileBoundaries(unsigned int dimension, SizeValueType tileSize, ImageIORegion & streamableRegion) const;
+
+  /** Decodes the tiles of an area of the full resolution image, with its own
+   * decompressor, into the buffer of the IO region. */
+  void
+  DecodeArea(void * buffer, const IndexValueType areaStart[2], const IndexValueType areaEnd[2]) const;
+
+  unsigned int m_ReductionFactor{ 0 };
 };
 } // end namespace itk
 
@@ -17,8 +17,12 @@
  *=========================================================================*/
 
 #include "itkJPEG2000ImageIO.h"
+#include "itkMultiThreaderBase.h"
 #include "itksys/SystemTools.hxx"
 
+#include <algorithm>
+#include <vector>
+
 // for memset
 // for malloc
 
@@ -65,9 +69,57 @@ public:
   OPJ_UINT32 m_NumberOfTilesInX;
   OPJ_UINT32 m_NumberOfTilesInY;
 
+  // End of the full resolution image in the reference grid
+  OPJ_UINT32 m_ImageEndX;
+  OPJ_UINT32 m_ImageEndY;
+
   opj_dparameters_t m_DecompressionParameters; /* decompression parameters */
 };
 
+namespace
+{
+// Owns the objects of a decompression, which are released on all the paths.
+struct Decompression
+{
+  FILE *         m_File{ nullptr };
+  opj_stream_t * m_Stream{ nullptr };
+  opj_codec_t *  m_Codec{ nullptr };
+  opj_image_t *  m_Image{ nullptr };
+
+  Decompression() = default;
+  Decompression(const Decompression &) = delete;
+  Decompression &
+  operator=(const Decompression &) = delete;
+
+  ~Decompression()
+  {
+    if (m_Stream)
+    {
+      opj_stream_destroy(m_Stream);
+    }
+    if (m_File)
+    {
+      fclose(m_File);
+    }
+    if (m_Codec)
+    {
+      opj_destroy_codec(m_Codec);
+    }
+    if (m_Image)
+    {
+      opj_image_destroy(m_Image);
+    }
+  }
+};
+
+// Coordinate of the reference grid at a resolution reduced by the factor
+OPJ_INT32
+ReduceCoordinate(OPJ_INT32 coordinate, unsigned int reductionFactor)
+{
+  return (coordinate + (OPJ_INT32{ 1 } << reductionFactor) - 1) >> reductionFactor;
+}
+} // namespace
+
 
 JPEG2000ImageIO::JPEG2000ImageIO()
   : m_Internal(new JPEG2000ImageIOInternal)
@@ -89,6 +141,9 @@ JPEG2000ImageIO::JPEG2000ImageIO()
   this->m_Internal->m_NumberOfTilesInX = 0;
   this->m_Internal->m_NumberOfTilesInY = 0;
 
+  this->m_Internal->m_ImageEndX = 0;
+  this->m_Internal->m_ImageEndY = 0;
+
   const char * extensions[] = { ".j2k", ".jp2", ".jpt" };
 
   for (auto ext : extensions)
@@ -104,6 +159,25 @@ void
 JPEG2000ImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "ReductionFactor: " << m_ReductionFactor << std::endl;
+}
+
+LightObject::Pointer
+JPEG2000ImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_Internal->m_TileWidth = this->m_Internal->m_TileWidth;
+  rval->m_Internal->m_TileHeight = this->m_Internal->m_TileHeight;
+  rval->m_ReductionFactor = this->m_ReductionFactor;
+
+  return loPtr;
 }
 
 bool
@@ -152,6 +226,7 @@ JPEG2000ImageIO::ReadImageInformation()
 
   /* set decoding parameters to default values */
   opj_set_default_decoder_parameters(&(this->m_Internal->m_DecompressionParameters));
+  this->m_Internal->m_DecompressionParameters.cp_reduce = static_cast<int>(m_ReductionFactor);
 
   opj_stream_t * cio = opj_stream_create_default_file_stream(l_file, true);
 
@@ -272,8 +347,9 @@ JPEG2000ImageIO::ReadImageInformation()
   if (!bResult)
   {
     opj_stream_destroy(cio);
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: opj_read_header returns false");
+    itkExceptionMacro("JPEG2000ImageIO failed to read file: "
+                      << this->GetFileName() << std::endl
+                      << "Reason: opj_read_header returns false, the reduction factor being " << m_ReductionFactor);
   }
 
   if (!l_image)
@@ -341,11 +417,19 @@ JPEG2000ImageIO::ReadImageInformation()
   itkDebugMacro(<< "image->x1 = " << l_image->x1);
   itkDebugMacro(<< "image->y1 = " << l_image->y1);
 
-  this->SetDimensions(0, l_image->x1);
-  this->SetDimensions(1, l_image->y1);
+  this->m_Internal->m_ImageEndX = l_image->x1;
+  this->m_Internal->m_ImageEndY = l_image->y1;
+
+  // A reduced resolution covers the same physical extent as the full one,
+  // with fewer pixels.
+  const double reductionScale = static_cast<double>(1u << m_ReductionFactor);
+  this->SetDimensions(0, ReduceCoordinate(l_image->x1, m_ReductionFactor));
+  this->SetDimensions(1, ReduceCoordinate(l_image->y1, m_ReductionFactor));
 
-  this->SetSpacing(0, 1.0); // FIXME : Get the real pixel resolution.
-  this->SetSpacing(1, 1.0); // FIXME : Get the real pixel resolution.
+  this->SetSpacing(0, reductionScale); // FIXME : Get the real pixel resolution.
+  this->SetSpacing(1, reductionScale); // FIXME : Get the real pixel resolution.
+  this->SetOrigin(0, 0.5 * (reductionScale - 1.0));
+  this->SetOrigin(1, 0.5 * (reductionScale - 1.0));
 
   /* close the byte stream */
   opj_stream_destroy(cio);
@@ -368,330 +452,267 @@ JPEG2000ImageIO::Read(void * buffer)
 {
   itkDebugMacro(<< "JPEG2000ImageIO::Read() Begin");
 
-  FILE * l_file = fopen(this->m_FileName.c_str(), "rb");
+  const ImageIORegion & regionToRead = this->GetIORegion();
+  if (regionToRead.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
 
-  if (!l_file)
+  // The area of the region in the reference grid of the full resolution
+  const IndexValueType imageEnd[2] = { this->m_Internal->m_ImageEndX, this->m_Internal->m_ImageEndY };
+  const IndexValueType tileStart[2] = { this->m_Internal->m_TileStartX, this->m_Internal->m_TileStartY };
+  const IndexValueType tileSize[2] = { this->m_Internal->m_TileWidth, this->m_Internal->m_TileHeight };
+  IndexValueType       start[2];
+  IndexValueType       end[2];
+  IndexValueType       numberOfTiles[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    start[i] = regionToRead.GetIndex(i) << m_ReductionFactor;
+    end[i] = std::min<IndexValueType>((regionToRead.GetIndex(i) + regionToRead.GetSize(i)) << m_ReductionFactor,
+                                      imageEnd[i]);
+    numberOfTiles[i] = 1;
+    if (tileSize[i] > 0)
+    {
+      numberOfTiles[i] = (end[i] - 1 - tileStart[i]) / tileSize[i] - (start[i] - tileStart[i]) / tileSize[i] + 1;
+    }
+  }
+
+  // The tiles are split in bands of tile rows, or of tile columns when the
+  // area is within a single row of tiles. The bands are decoded concurrently,
+  // each of them by its own decompressor, since the openjpeg decompressors
+  // decode their tiles sequentially.
+  const unsigned int               bandDimension = numberOfTiles[1] > 1 ? 1 : 0;
+  const MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  const IndexValueType             numberOfBands =
+    std::min<IndexValueType>(numberOfTiles[bandDimension], multiThreader->GetNumberOfWorkUnits());
+  if (numberOfBands <= 1)
+  {
+    this->DecodeArea(buffer, start, end);
+    itkDebugMacro(<< "JPEG2000ImageIO::Read() End");
+    return;
+  }
+
+  const IndexValueType     firstTile = (start[bandDimension] - tileStart[bandDimension]) / tileSize[bandDimension];
+  std::vector<std::string> errors(numberOfBands);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBands,
+    [&](SizeValueType band) {
+      const IndexValueType bandFirstTile = firstTile + band * numberOfTiles[bandDimension] / numberOfBands;
+      const IndexValueType bandEndTile = firstTile + (band + 1) * numberOfTiles[bandDimension] / numberOfBands;
+      IndexValueType       bandStart[2] = { start[0], start[1] };
+      IndexValueType       bandEnd[2] = { end[0], end[1] };
+      bandStart[bandDimension] =
+        std::max(start[bandDimension], tileStart[bandDimension] + bandFirstTile * tileSize[bandDimension]);
+      bandEnd[bandDimension] =
+        std::min(end[bandDimension], tileStart[bandDimension] + bandEndTile * tileSize[bandDimension]);
+      try
+      {
+        this->DecodeArea(buffer, bandStart, bandEnd);
+      }
+      catch (const ExceptionObject & exception)
+      {
+        errors[band] = exception.GetDescription();
+      }
+      catch (...)
+      {
+        errors[band] = "unknown error";
+      }
+    },
+    nullptr);
+
+  for (const std::string & error : errors)
+  {
+    if (!error.empty())
+    {
+      itkExceptionMacro(<< error);
+    }
+  }
+
+  itkDebugMacro(<< "JPEG2000ImageIO::Read() End");
+}
+
+void
+JPEG2000ImageIO::DecodeArea(void * buffer, const IndexValueType areaStart[2], const IndexValueType areaEnd[2]) const
+{
+  Decompression decompression;
+
+  decompression.m_File = fopen(this->m_FileName.c_str(), "rb");
+  if (!decompression.m_File)
   {
     itkExceptionMacro("JPEG2000ImageIO failed to open file for reading: " << this->GetFileName() << std::endl
                                                                           << "Reason: "
                                                                           << itksys::SystemTools::GetLastSystemError());
   }
 
-  opj_stream_t * l_stream = opj_stream_create_default_file_stream(l_file, true);
-  if (!l_stream)
+  decompression.m_Stream = opj_stream_create_default_file_stream(decompression.m_File, true);
+  if (!decompression.m_Stream)
   {
     itkExceptionMacro("JPEG2000ImageIO failed to read file: "
                       << this->GetFileName() << std::endl
                       << "Reason: opj_stream_create_default_file_stream returns nullptr");
   }
 
-  this->m_Internal->m_Dinfo = nullptr; /* handle to a decompressor */
-
-  opj_image_t * l_image = nullptr;
-
   /* decode the code-stream */
   /* ---------------------- */
-  switch (this->m_Internal->m_DecompressionParameters.decod_format)
+  opj_dparameters_t parameters = this->m_Internal->m_DecompressionParameters;
+  switch (parameters.decod_format)
   {
     case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::J2K_CFMT):
-    {
       /* JPEG-2000 codestream */
-      /* get a decoder handle */
-      this->m_Internal->m_Dinfo = opj_create_decompress(CODEC_J2K);
-      if (!this->m_Internal->m_Dinfo)
-      {
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                          << this->GetFileName() << std::endl
-                          << "Reason: opj_create_decompress(CODEC_J2K) returns nullptr");
-      }
+      decompression.m_Codec = opj_create_decompress(CODEC_J2K);
       break;
-    }
     case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::JP2_CFMT):
-    {
       /* JPEG 2000 compressed image data */
-      /* get a decoder handle */
-      this->m_Internal->m_Dinfo = opj_create_decompress(CODEC_JP2);
-      if (!this->m_Internal->m_Dinfo)
-      {
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                          << this->GetFileName() << std::endl
-                          << "Reason: opj_create_decompress(CODEC_JP2) returns nullptr");
-      }
+      decompression.m_Codec = opj_create_decompress(CODEC_JP2);
       break;
-    }
     case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::JPT_CFMT):
-    {
       /* JPEG 2000, JPIP */
-      /* get a decoder handle */
-      this->m_Internal->m_Dinfo = opj_create_decompress(CODEC_JPT);
-      if (!this->m_Internal->m_Dinfo)
-      {
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                          << this->GetFileName() << std::endl
-                          << "Reason: opj_create_decompress(CODEC_JPT) returns nullptr");
-      }
+      decompression.m_Codec = opj_create_decompress(CODEC_JPT);
       break;
-    }
     default:
-      fclose(l_file);
       itkExceptionMacro("JPEG2000ImageIO failed to read file: "
                         << this->GetFileName() << std::endl
                         << "Reason: "
-                        << "Unknown decode format: " << this->m_Internal->m_DecompressionParameters.decod_format);
+                        << "Unknown decode format: " << parameters.decod_format);
+  }
+  if (!decompression.m_Codec)
+  {
+    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
+                                                              << "Reason: opj_create_decompress returns nullptr");
   }
-  /* catch events using our callbacks and give a local context */
 
   /* setup the decoder decoding parameters using user parameters */
-  if (!opj_setup_decoder(this->m_Internal->m_Dinfo, &(this->m_Internal->m_DecompressionParameters)))
+  if (!opj_setup_decoder(decompression.m_Codec, &parameters))
   {
     itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
                                                               << "Reason: opj_setup_decoder returns false");
   }
 
-  OPJ_INT32 l_tile_x0, l_tile_y0;
-
+  OPJ_INT32  l_tile_x0, l_tile_y0;
   OPJ_UINT32 l_tile_width;
   OPJ_UINT32 l_tile_height;
   OPJ_UINT32 l_nb_tiles_x;
   OPJ_UINT32 l_nb_tiles_y;
-
-  bool bResult = opj_read_header(this->m_Internal->m_Dinfo,
-                                 &l_image,
-                                 &l_tile_x0,
-                                 &l_tile_y0,
-                                 &l_tile_width,
-                                 &l_tile_height,
-                                 &l_nb_tiles_x,
-                                 &l_nb_tiles_y,
-                                 l_stream);
-
-  if (!bResult)
+  if (!opj_read_header(decompression.m_Codec,
+                       &decompression.m_Image,
+                       &l_tile_x0,
+                       &l_tile_y0,
+                       &l_tile_width,
+                       &l_tile_height,
+                       &l_nb_tiles_x,
+                       &l_nb_tiles_y,
+                       decompression.m_Stream))
   {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
     itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
                                                               << "Reason: opj_read_header returns false");
   }
 
-  ImageIORegion regionToRead = this->GetIORegion();
-
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
-
-  const unsigned int sizex = size[0];
-  const unsigned int sizey = size[1];
-  // const unsigned int sizez = size[2];
-
-  const unsigned int startx = start[0];
-  const unsigned int starty = start[1];
-  // const unsigned int startz = start[2];
-
-  auto p_start_x = static_cast<OPJ_INT32>(startx);
-  auto p_start_y = static_cast<OPJ_INT32>(starty);
-  auto p_end_x = static_cast<OPJ_INT32>(startx + sizex);
-  auto p_end_y = static_cast<OPJ_INT32>(starty + sizey);
-
-  itkDebugMacro(<< "opj_set_decode_area() before");
-  itkDebugMacro(<< "p_start_x = " << p_start_x);
-  itkDebugMacro(<< "p_start_y = " << p_start_y);
-  itkDebugMacro(<< "p_end_x = " << p_end_x);
-  itkDebugMacro(<< "p_end_y = " << p_end_y);
-
-  bResult = opj_set_decode_area(this->m_Internal->m_Dinfo, p_start_x, p_start_y, p_end_x, p_end_y);
-
-  itkDebugMacro(<< "opj_set_decode_area() after");
-
-  if (!bResult)
+  itkDebugMacro(<< "opj_set_decode_area(" << areaStart[0] << ", " << areaStart[1] << ", " << areaEnd[0] << ", "
+                << areaEnd[1] << ")");
+  if (!opj_set_decode_area(decompression.m_Codec,
+                           static_cast<OPJ_INT32>(areaStart[0]),
+                           static_cast<OPJ_INT32>(areaStart[1]),
+                           static_cast<OPJ_INT32>(areaEnd[0]),
+                           static_cast<OPJ_INT32>(areaEnd[1])))
   {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
     itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
                                                               << "Reason: opj_set_decode_area returns false");
   }
 
-  OPJ_INT32 l_current_tile_x0;
-  OPJ_INT32 l_current_tile_y0;
-  OPJ_INT32 l_current_tile_x1;
-  OPJ_INT32 l_current_tile_y1;
-
-  OPJ_UINT32 l_tile_index;
-  OPJ_UINT32 l_data_size;
-
-  OPJ_UINT32 l_nb_comps;
-
-  OPJ_UINT32 l_max_data_size = 1000;
-
-  bool l_go_on = true;
-
-  auto * l_data = (OPJ_BYTE *)malloc(1000);
-
+  const ImageIORegion & regionToRead = this->GetIORegion();
+  const IndexValueType  regionStartX = regionToRead.GetIndex(0);
+  const IndexValueType  regionStartY = regionToRead.GetIndex(1);
+  const SizeValueType   regionSizeX = regionToRead.GetSize(0);
+  const IndexValueType  regionEndX = regionStartX + static_cast<IndexValueType>(regionSizeX);
+  const IndexValueType  regionEndY = regionStartY + static_cast<IndexValueType>(regionToRead.GetSize(1));
+  const SizeValueType   numberOfComponents = this->GetNumberOfComponents();
+  const SizeValueType   componentSize = this->GetComponentSize();
+
+  std::vector<OPJ_BYTE> l_data;
+  bool                  l_go_on = true;
   while (l_go_on)
   {
-    bool tileHeaderRead = opj_read_tile_header(this->m_Internal->m_Dinfo,
-                                               &l_tile_index,
-                                               &l_data_size,
-                                               &l_current_tile_x0,
-                                               &l_current_tile_y0,
-                                               &l_current_tile_x1,
-                                               &l_current_tile_y1,
-                                               &l_nb_comps,
-                                               &l_go_on,
-                                               l_stream);
-
-    if (!tileHeaderRead)
+    OPJ_INT32  l_current_tile_x0;
+    OPJ_INT32  l_current_tile_y0;
+    OPJ_INT32  l_current_tile_x1;
+    OPJ_INT32  l_current_tile_y1;
+    OPJ_UINT32 l_tile_index;
+    OPJ_UINT32 l_data_size;
+    OPJ_UINT32 l_nb_comps;
+    if (!opj_read_tile_header(decompression.m_Codec,
+                              &l_tile_index,
+                              &l_data_size,
+                              &l_current_tile_x0,
+                              &l_current_tile_y0,
+                              &l_current_tile_x1,
+                              &l_current_tile_y1,
+                              &l_nb_comps,
+                              &l_go_on,
+                              decompression.m_Stream))
     {
-      free(l_data);
-      opj_stream_destroy(l_stream);
-      fclose(l_file);
-      opj_destroy_codec(this->m_Internal->m_Dinfo);
-      opj_image_destroy(l_image);
       itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
                                                                 << "Reason: opj_read_tile_header returns false");
     }
+    if (!l_go_on)
+    {
+      break;
+    }
 
     itkDebugMacro(<< "l_tile_index " << l_tile_index);
     itkDebugMacro(<< "l_data_size " << l_data_size);
-    itkDebugMacro(<< "l_current_tile_x0 " << l_current_tile_x0);
-    itkDebugMacro(<< "l_current_tile_y0 " << l_current_tile_y0);
-    itkDebugMacro(<< "l_current_tile_x1 " << l_current_tile_x1);
-    itkDebugMacro(<< "l_current_tile_y1 " << l_current_tile_y1);
-    itkDebugMacro(<< "l_nb_comps " << l_nb_comps);
-    itkDebugMacro(<< "l_go_on " << l_go_on);
-
-    if (l_go_on)
-    {
-      if (l_data_size > l_max_data_size)
-      {
-        l_data = (OPJ_BYTE *)realloc(l_data, l_data_size);
-
-        if (!l_data)
-        {
-          opj_stream_destroy(l_stream);
-          fclose(l_file);
-          opj_destroy_codec(this->m_Internal->m_Dinfo);
-          opj_image_destroy(l_image);
-          itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                                    << "Reason: Error reallocating memory");
-        }
-
-        itkDebugMacro(<< "reallocated for " << l_data_size);
-
-        l_max_data_size = l_data_size;
-      }
-
-      bool decodeTileData =
-        opj_decode_tile_data(this->m_Internal->m_Dinfo, l_tile_index, l_data, l_data_size, l_stream);
 
-      if (!decodeTileData)
-      {
-        free(l_data);
-        opj_stream_destroy(l_stream);
-        fclose(l_file);
-        opj_destroy_codec(this->m_Internal->m_Dinfo);
-        opj_image_destroy(l_image);
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                                  << "Reason: opj_decode_tile_data returns false");
-      }
-
-      OPJ_BYTE * l_data_ptr = l_data;
-
-      const SizeValueType tsizex = l_current_tile_x1 - l_current_tile_x0;
-      const SizeValueType tsizey = l_current_tile_y1 - l_current_tile_y0;
-      const SizeValueType numberOfPixels = tsizex * tsizey;
-      const SizeValueType numberOfComponents = this->GetNumberOfComponents();
-      const SizeValueType sizePerComponentInBytes = l_data_size / (numberOfPixels * numberOfComponents);
-      const SizeValueType sizePerChannelInBytes = l_data_size / (numberOfComponents);
-
-      itkDebugMacro(<< "sizePerComponentInBytes: " << sizePerComponentInBytes);
-      itkDebugMacro(<< "sizePerChannelInBytes:   " << sizePerChannelInBytes);
-
-      const SizeValueType sizePerStrideXInBytes = sizePerChannelInBytes / tsizey;
-      const SizeValueType initialStrideInBytes =
-        (l_current_tile_y0 - p_start_y) * sizex * sizePerComponentInBytes * numberOfComponents;
-      const SizeValueType priorStrideInBytes =
-        (l_current_tile_x0 - p_start_x) * sizePerComponentInBytes * numberOfComponents;
-      const SizeValueType postStrideInBytes =
-        (p_end_x - l_current_tile_x1) * sizePerComponentInBytes * numberOfComponents;
-
-      itkDebugMacro(<< "sizePerStrideYInBytes:   " << sizePerChannelInBytes / tsizex);
-      itkDebugMacro(<< "sizePerStrideXInBytes:   " << sizePerStrideXInBytes);
-      itkDebugMacro(<< "initialStrideInBytes:    " << initialStrideInBytes);
-      itkDebugMacro(<< "priorStrideInBytes:      " << priorStrideInBytes);
-      itkDebugMacro(<< "postStrideInBytes:       " << postStrideInBytes);
+    l_data.resize(std::max<size_t>(l_data.size(), l_data_size));
+    if (!opj_decode_tile_data(decompression.m_Codec, l_tile_index, l_data.data(), l_data_size, decompression.m_Stream))
+    {
+      itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
+                                                                << "Reason: opj_decode_tile_data returns false");
+    }
 
+    // The decoded tile, at the reduced resolution, whose components are
+    // stored one after the other. The decoded tiles are not cropped to the
+    // area, so only their intersection with the region is copied.
+    const IndexValueType tileStartX = ReduceCoordinate(l_current_tile_x0, m_ReductionFactor);
+    const IndexValueType tileStartY = ReduceCoordinate(l_current_tile_y0, m_ReductionFactor);
+    const IndexValueType tileEndX = ReduceCoordinate(l_current_tile_x1, m_ReductionFactor);
+    const IndexValueType tileEndY = ReduceCoordinate(l_current_tile_y1, m_ReductionFactor);
+    const SizeValueType  tileSizeX = tileEndX - tileStartX;
+    const SizeValueType  tileSizeY = tileEndY - tileStartY;
+    if (tileSizeX * tileSizeY * numberOfComponents * componentSize != l_data_size)
+    {
+      itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
+                                                                << "Reason: unexpected size of the tile "
+                                                                << l_tile_index);
+    }
 
-      // TODO: Read the void buffer within the tile ROI. How do we specify the
-      // tile ROI iteration
-      for (unsigned int k = 0; k < numberOfComponents; k++)
+    const IndexValueType copyStartX = std::max(tileStartX, regionStartX);
+    const IndexValueType copyStartY = std::max(tileStartY, regionStartY);
+    const IndexValueType copyEndX = std::min(tileEndX, regionEndX);
+    const IndexValueType copyEndY = std::min(tileEndY, regionEndY);
+    for (SizeValueType k = 0; k < numberOfComponents; ++k)
+    {
+      for (IndexValueType y = copyStartY; y < copyEndY; ++y)
       {
-        auto * charBuffer = (unsigned char *)buffer;
-        charBuffer += k * sizePerComponentInBytes;
-
-        charBuffer += initialStrideInBytes;
-
-        for (SizeValueType m = 0; m < tsizey; m++)
+        const OPJ_BYTE * l_data_ptr =
+          l_data.data() + ((k * tileSizeY + (y - tileStartY)) * tileSizeX + (copyStartX - tileStartX)) * componentSize;
+        const SizeValueType firstPixel = (y - regionStartY) * regionSizeX + (copyStartX - regionStartX);
+        auto *              charBuffer =
+          static_cast<unsigned char *>(buffer) + (firstPixel * numberOfComponents + k) * componentSize;
+        for (IndexValueType x = copyStartX; x < copyEndX; ++x)
         {
-          charBuffer += priorStrideInBytes;
-          for (SizeValueType j = 0; j < sizePerStrideXInBytes; j++)
-          {
-            *charBuffer = (unsigned char)(*l_data_ptr++);
-            charBuffer += numberOfComponents;
-          }
-          charBuffer += postStrideInBytes;
+          std::copy_n(l_data_ptr, componentSize, charBuffer);
+          l_data_ptr += componentSize;
+          charBuffer += numberOfComponents * componentSize;
         }
       }
     }
-    //       l_go_on = 0;
   }
 
-  //  l_image = opj_decode( this->m_Dinfo, l_stream );
-
-  if (!opj_end_decompress(this->m_Internal->m_Dinfo, l_stream))
+  if (!opj_end_decompress(decompression.m_Codec, decompression.m_Stream))
   {
-    free(l_data);
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    opj_image_destroy(l_image);
     itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
                                                               << "Reason: opj_end_decompress returns false");
   }
-
-  if (!l_image)
-  {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: error whle reading image");
-  }
-
-  /* close the byte stream */
-  opj_stream_destroy(l_stream);
-  fclose(l_file);
-
-  if (this->m_Internal->m_Dinfo)
-  {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-  }
-
-  if (l_image)
-  {
-    opj_image_destroy(l_image);
-  }
-
-  if (l_data)
-  {
-    free(l_data);
-  }
-
-  itkDebugMacro(<< "JPEG2000ImageIO::Read() End");
 }
 
 bool
@@ -1078,8 +1099,11 @@ JPEG2000ImageIO ::GenerateStreamableReadRegionFromRequestedRegion(const ImageIOR
     // Compute the required set of tiles that fully contain the requested region
     streamableRegion = requestedRegion;
 
-    this->ComputeRegionInTileBoundaries(0, this->m_Internal->m_TileWidth, streamableRegion);
-    this->ComputeRegionInTileBoundaries(1, this->m_Internal->m_TileHeight, streamableRegion);
+    // the tiles are smaller at a reduced resolution
+    const auto tileWidth = static_cast<OPJ_INT32>(this->m_Internal->m_TileWidth);
+    const auto tileHeight = static_cast<OPJ_INT32>(this->m_Internal->m_TileHeight);
+    this->ComputeRegionInTileBoundaries(0, ReduceCoordinate(tileWidth, m_ReductionFactor), streamableRegion);
+    this->ComputeRegionInTileBoundaries(1, ReduceCoordinate(tileHeight, m_ReductionFactor), streamableRegion);
   }
 
   itkDebugMacro(<< "Streamable region = " << streamableRegion);
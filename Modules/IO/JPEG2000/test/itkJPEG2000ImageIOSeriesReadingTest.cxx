@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageSeriesReader.h"
+#include "itkJPEG2000ImageIO.h"
+#include "itkTestingMacros.h"
+
+/* The concurrent reading of ImageSeriesReader reads each file with a clone of
+ * the ImageIO. This test checks that the clones keep the ReductionFactor of
+ * the JPEG2000ImageIO, so that the series is read at the same reduced
+ * resolution as by the sequential reading. */
+
+namespace
+{
+using SliceType = itk::Image<unsigned char, 2>;
+using VolumeType = itk::Image<unsigned char, 3>;
+using ReaderType = itk::ImageSeriesReader<VolumeType>;
+
+VolumeType::Pointer
+ReadSeries(const ReaderType::FileNamesContainer & fileNames, bool concurrentReading)
+{
+  auto jpeg2000ImageIO = itk::JPEG2000ImageIO::New();
+  jpeg2000ImageIO->SetReductionFactor(1);
+
+  auto reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetImageIO(jpeg2000ImageIO);
+  reader->SetConcurrentReading(concurrentReading);
+  reader->SetNumberOfWorkUnits(4);
+  reader->Update();
+  return reader->GetOutput();
+}
+} // namespace
+
+
+int
+itkJPEG2000ImageIOSeriesReadingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the clone of an image IO keeps its reduction factor
+  auto jpeg2000ImageIO = itk::JPEG2000ImageIO::New();
+  jpeg2000ImageIO->SetReductionFactor(2);
+  itk::JPEG2000ImageIO::Pointer clone = jpeg2000ImageIO->Clone();
+  ITK_TEST_EXPECT_EQUAL(clone->GetReductionFactor(), 2);
+
+  // slices of different contents, tiled so that they have several resolutions
+  const SliceType::SizeType       size = { { 64, 48 } };
+  ReaderType::FileNamesContainer fileNames;
+  for (unsigned int slice = 0; slice < 6; ++slice)
+  {
+    auto image = SliceType::New();
+    image->SetRegions(size);
+    image->Allocate();
+    itk::ImageRegionIteratorWithIndex<SliceType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it)
+    {
+      const SliceType::IndexType index = it.GetIndex();
+      it.Set(static_cast<unsigned char>(3 * index[0] + (slice + 1) * index[1]));
+    }
+
+    fileNames.push_back(std::string(argv[1]) + "/itkJPEG2000ImageIOSeriesReadingTest" + std::to_string(slice) +
+                        ".j2k");
+    auto writerImageIO = itk::JPEG2000ImageIO::New();
+    writerImageIO->SetTileSize(32, 32);
+    auto writer = itk::ImageFileWriter<SliceType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileNames.back());
+    writer->SetImageIO(writerImageIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  }
+
+  VolumeType::Pointer sequential;
+  VolumeType::Pointer concurrent;
+  ITK_TRY_EXPECT_NO_EXCEPTION(sequential = ReadSeries(fileNames, false));
+  ITK_TRY_EXPECT_NO_EXCEPTION(concurrent = ReadSeries(fileNames, true));
+
+  // both readings are at half the resolution
+  const VolumeType::SizeType expectedSize = { { size[0] / 2, size[1] / 2, fileNames.size() } };
+  ITK_TEST_EXPECT_EQUAL(sequential->GetLargestPossibleRegion().GetSize(), expectedSize);
+  ITK_TEST_EXPECT_EQUAL(concurrent->GetLargestPossibleRegion().GetSize(), expectedSize);
+  ITK_TEST_EXPECT_EQUAL(concurrent->GetSpacing(), sequential->GetSpacing());
+
+  itk::ImageRegionConstIteratorWithIndex<VolumeType> it(sequential, sequential->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (concurrent->GetPixel(it.GetIndex()) != it.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " read concurrently as "
+                << static_cast<int>(concurrent->GetPixel(it.GetIndex())) << " instead of "
+                << static_cast<int>(it.Get()) << std::endl;
+      std::cout << "Test failed!" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkJPEG2000ImageIO.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Checks that the pixels of the region of the buffer match the expected image.
+template <typename TImage>
+bool
+CompareRegion(const typename TImage::PixelType * buffer,
+              const typename TImage::RegionType & region,
+              const TImage *                      expected)
+{
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(expected, region);
+  for (; !it.IsAtEnd(); ++it, ++buffer)
+  {
+    if (*buffer != it.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " read as " << *buffer << " instead of " << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads the region of the file with a new JPEG2000ImageIO.
+template <typename TImage>
+int
+ReadRegion(const std::string &                 fileName,
+           unsigned int                        reductionFactor,
+           const typename TImage::RegionType & region,
+           std::vector<typename TImage::PixelType> & buffer)
+{
+  auto jpeg2000ImageIO = itk::JPEG2000ImageIO::New();
+  jpeg2000ImageIO->SetFileName(fileName);
+  jpeg2000ImageIO->SetReductionFactor(reductionFactor);
+  ITK_TRY_EXPECT_NO_EXCEPTION(jpeg2000ImageIO->ReadImageInformation());
+  itk::ImageIORegion ioRegion(2);
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    ioRegion.SetIndex(i, region.GetIndex(i));
+    ioRegion.SetSize(i, region.GetSize(i));
+  }
+  jpeg2000ImageIO->SetIORegion(ioRegion);
+  buffer.resize(region.GetNumberOfPixels());
+  ITK_TRY_EXPECT_NO_EXCEPTION(jpeg2000ImageIO->Read(buffer.data()));
+  return EXIT_SUCCESS;
+}
+
+// Writes a tiled lossless image, and reads it back entirely, by streamed
+// regions, and at reduced resolutions.
+template <typename TPixel>
+int
+TileDecodingTest(const std::string & fileName)
+{
+  using ImageType = itk::Image<TPixel, 2>;
+  using ValueType = typename itk::NumericTraits<TPixel>::ValueType;
+
+  // the last row of tiles is not aligned with the image size, the columns
+  // are, since the bundled openjpeg does not encode horizontally clipped
+  // tiles correctly
+  const typename ImageType::SizeType size = { { 256, 157 } };
+  auto                               image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const typename ImageType::IndexType index = it.GetIndex();
+    TPixel                              pixel;
+    for (unsigned int i = 0; i < itk::NumericTraits<TPixel>::GetLength(pixel); ++i)
+    {
+      itk::DefaultConvertPixelTraits<TPixel>::SetNthComponent(
+        i, pixel, static_cast<ValueType>(3 * index[0] + 5 * index[1] + 40 * i));
+    }
+    it.Set(pixel);
+  }
+
+  auto jpeg2000ImageIO = itk::JPEG2000ImageIO::New();
+  jpeg2000ImageIO->SetTileSize(64, 64);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(jpeg2000ImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // the whole image, whose bands of tiles are decoded concurrently
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::JPEG2000ImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(CompareRegion<ImageType>(
+    reader->GetOutput()->GetBufferPointer(), image->GetLargestPossibleRegion(), image.GetPointer()));
+
+  // a region streamed in tile boundaries
+  const typename ImageType::RegionType requestedRegion({ { 70, 70 } }, { { 61, 40 } });
+  const typename ImageType::RegionType tileRegion({ { 64, 64 } }, { { 128, 64 } });
+  auto                                 streamingReader = itk::ImageFileReader<ImageType>::New();
+  streamingReader->SetFileName(fileName);
+  streamingReader->SetImageIO(itk::JPEG2000ImageIO::New());
+  streamingReader->SetUseStreaming(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->UpdateOutputInformation());
+  streamingReader->GetOutput()->SetRequestedRegion(requestedRegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+  ITK_TEST_EXPECT_EQUAL(streamingReader->GetOutput()->GetBufferedRegion(), tileRegion);
+  ITK_TEST_EXPECT_TRUE(
+    CompareRegion<ImageType>(streamingReader->GetOutput()->GetBufferPointer(), tileRegion, image.GetPointer()));
+
+  // any region can be read by the image IO
+  std::vector<TPixel> buffer;
+  if (ReadRegion<ImageType>(fileName, 0, requestedRegion, buffer) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  ITK_TEST_EXPECT_TRUE(CompareRegion<ImageType>(buffer.data(), requestedRegion, image.GetPointer()));
+
+  // the reduced resolutions, whose regions match the whole reduced image
+  for (unsigned int reductionFactor = 1; reductionFactor <= 2; ++reductionFactor)
+  {
+    auto reducedReader = itk::ImageFileReader<ImageType>::New();
+    auto reducedImageIO = itk::JPEG2000ImageIO::New();
+    reducedImageIO->SetReductionFactor(reductionFactor);
+    reducedReader->SetFileName(fileName);
+    reducedReader->SetImageIO(reducedImageIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reducedReader->Update());
+    const ImageType *                    reduced = reducedReader->GetOutput();
+    const typename ImageType::SizeType   reducedSize = reduced->GetLargestPossibleRegion().GetSize();
+    const itk::SizeValueType             scale = itk::SizeValueType{ 1 } << reductionFactor;
+    const typename ImageType::SizeType   expectedSize = { { (size[0] + scale - 1) / scale,
+                                                           (size[1] + scale - 1) / scale } };
+    ITK_TEST_EXPECT_EQUAL(reducedSize, expectedSize);
+    ITK_TEST_EXPECT_EQUAL(reduced->GetSpacing()[0], static_cast<double>(scale));
+
+    const typename ImageType::RegionType reducedRegion({ { 5, 7 } }, { { reducedSize[0] - 9, reducedSize[1] - 8 } });
+    if (ReadRegion<ImageType>(fileName, reductionFactor, reducedRegion, buffer) != EXIT_SUCCESS)
+    {
+      return EXIT_FAILURE;
+    }
+    ITK_TEST_EXPECT_TRUE(CompareRegion<ImageType>(buffer.data(), reducedRegion, reduced));
+  }
+
+  // the reduction factor must be lower than the number of resolutions
+  auto invalidImageIO = itk::JPEG2000ImageIO::New();
+  invalidImageIO->SetFileName(fileName);
+  invalidImageIO->SetReductionFactor(10);
+  ITK_TRY_EXPECT_EXCEPTION(invalidImageIO->ReadImageInformation());
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkJPEG2000ImageIOTileDecodingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto jpeg2000ImageIO = itk::JPEG2000ImageIO::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(jpeg2000ImageIO, JPEG2000ImageIO, StreamingImageIOBase);
+  ITK_TEST_SET_GET_VALUE(0, jpeg2000ImageIO->GetReductionFactor());
+  jpeg2000ImageIO->SetReductionFactor(3);
+  ITK_TEST_SET_GET_VALUE(3, jpeg2000ImageIO->GetReductionFactor());
+
+  // several bands of tiles, whatever the number of processors
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(4);
+
+  const std::string outputDirectory = argv[1];
+  int               result = EXIT_SUCCESS;
+  if (TileDecodingTest<unsigned char>(outputDirectory + "/itkJPEG2000ImageIOTileDecodingTest.j2k") != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (TileDecodingTest<unsigned short>(outputDirectory + "/itkJPEG2000ImageIOTileDecodingTestShort.jp2") !=
+      EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (TileDecodingTest<itk::RGBPixel<unsigned char>>(outputDirectory + "/itkJPEG2000ImageIOTileDecodingTestRGB.j2k") !=
+      EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -146,6 +146,13 @@ public:
     return true;
   }
 
+  /** Determine if the pixels of the IORegion can be mapped in memory. They
+   * can if the data is binary, uncompressed, in the byte order of this
+   * machine and stored in a single file, and if the IORegion is not
+   * subsampled. */
+  bool
+  CanMapRead(std::string & dataFileName, SizeType & dataPosition) const override;
+
   /** Determine if the ImageIO can stream writing to this
    *  file. Only time cannot stream read/write is if compression is used.
    *  Assumes file passes a CanRead call and its pixels are of the same
@@ -187,10 +194,29 @@ protected:
   ~MetaImageIO() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
+
+  LightObject::Pointer
+  InternalClone() const override;
   template <unsigned int VNRows, unsigned int VNColumns = VNRows>
   bool
   WriteMatrixInMetaData(std::ostringstream & strs, const MetaDataDictionary & metaDict, const std::string & metaString);
 
+  /** Get the name of the file which holds the pixels, and whether it is the
+   * header file itself. Returns false if the pixels are stored in a list or
+   * a pattern of files. */
+  bool
+  GetElementDataFileName(std::string & dataFileName, bool & isLocal) const;
+
+  /** Read the whole image from a file compressed in independent blocks,
+   * concurrently. Returns false if the file is not block compressed. */
+  bool
+  ReadBlockCompressedData(void * buffer);
+
+  /** Write the whole image compressed in independent blocks, concurrently.
+   * MetaIO writes the header, without the pixels. */
+  void
+  WriteBlockCompressedData(const void * buffer);
+
 private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
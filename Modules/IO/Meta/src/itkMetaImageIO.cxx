@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkMetaImageIO.h"
+#include "itkBlockGzipCompression.h"
 #include "itkSpatialOrientationAdapter.h"
 #include "itkIOCommon.h"
 #include "itksys/SystemTools.hxx"
@@ -68,6 +69,22 @@ MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << "\n";
 }
 
+LightObject::Pointer
+MetaImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->SetDoublePrecision(const_cast<MetaImage &>(this->m_MetaImage).GetDoublePrecision());
+  rval->m_SubSamplingFactor = this->m_SubSamplingFactor;
+
+  return loPtr;
+}
+
 void
 MetaImageIO::SetDataFileName(const char * filename)
 {
@@ -480,7 +497,7 @@ MetaImageIO::Read(void * buffer)
 
     m_MetaImage.ElementByteOrderFix(m_IORegion.GetNumberOfPixels());
   }
-  else
+  else if (!this->ReadBlockCompressedData(buffer))
   {
     if (!m_MetaImage.Read(m_FileName.c_str(), true, buffer))
     {
@@ -1118,6 +1135,23 @@ MetaImageIO ::Write(const void * buffer)
     delete[] indexMin;
     delete[] indexMax;
   }
+  else if (m_UseCompression && m_UseParallelCompression && binaryData &&
+           std::string(m_MetaImage.ElementDataFileName()).find('%') == std::string::npos)
+  {
+    // compress the data concurrently, in independent blocks, unless it is
+    // split in a pattern of files
+    try
+    {
+      this->WriteBlockCompressedData(buffer);
+    }
+    catch (...)
+    {
+      delete[] dSize;
+      delete[] eSpacing;
+      delete[] eOrigin;
+      throw;
+    }
+  }
   else
   {
     if (!m_MetaImage.Write(m_FileName.c_str()))
@@ -1135,6 +1169,226 @@ MetaImageIO ::Write(const void * buffer)
   delete[] eOrigin;
 }
 
+bool
+MetaImageIO::CanMapRead(std::string & dataFileName, SizeType & dataPosition) const
+{
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || m_SubSamplingFactor != 1 ||
+      (m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() && this->GetComponentSize() > 1))
+  {
+    return false;
+  }
+
+  SizeType regionOffset = 0;
+  if (!this->ComputeContiguousIORegionOffset(regionOffset))
+  {
+    return false;
+  }
+
+  // a missing data file may be read from a compressed one
+  bool isLocal = false;
+  if (!this->GetElementDataFileName(dataFileName, isLocal) || !itksys::SystemTools::FileExists(dataFileName, true))
+  {
+    return false;
+  }
+
+  // the data is at the given header size, at the end of the file, or right
+  // after the header of a local file, which then ends the file
+  const SizeType dataSize = this->GetImageSizeInBytes();
+  const auto     fileSize = static_cast<SizeType>(itksys::SystemTools::FileLength(dataFileName));
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    dataPosition = m_MetaImage.HeaderSize();
+  }
+  else if (m_MetaImage.HeaderSize() == -1 || isLocal)
+  {
+    dataPosition = fileSize - dataSize;
+  }
+  else
+  {
+    dataPosition = 0;
+  }
+  if (dataPosition < 0 || dataPosition + dataSize > fileSize)
+  {
+    return false;
+  }
+
+  if (isLocal && m_MetaImage.HeaderSize() == 0)
+  {
+    // verify that the header ends where the data is expected to start
+    std::ifstream file(dataFileName.c_str(), std::ios::in | std::ios::binary);
+    std::string   headerEnd(static_cast<size_t>(std::min<SizeType>(dataPosition, 7)), '\0');
+    file.seekg(dataPosition - static_cast<SizeType>(headerEnd.size()));
+    file.read(&headerEnd[0], headerEnd.size());
+    headerEnd = itksys::SystemTools::UpperCase(headerEnd);
+    if (!file || !(itksys::SystemTools::StringEndsWith(headerEnd, "LOCAL\n") ||
+                   itksys::SystemTools::StringEndsWith(headerEnd, "LOCAL\r\n")))
+    {
+      return false;
+    }
+  }
+
+  dataPosition += regionOffset;
+  return true;
+}
+
+bool
+MetaImageIO::GetElementDataFileName(std::string & dataFileName, bool & isLocal) const
+{
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  isLocal = elementDataFileName == "LOCAL" || elementDataFileName == "Local" || elementDataFileName == "local";
+  if (isLocal)
+  {
+    dataFileName = m_FileName;
+  }
+  else if (elementDataFileName.compare(0, 4, "LIST") == 0 || elementDataFileName.find('%') != std::string::npos)
+  {
+    return false;
+  }
+  else if (itksys::SystemTools::FileIsFullPath(elementDataFileName))
+  {
+    dataFileName = elementDataFileName;
+  }
+  else
+  {
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    dataFileName = path.empty() ? elementDataFileName : path + '/' + elementDataFileName;
+  }
+  return true;
+}
+
+bool
+MetaImageIO::ReadBlockCompressedData(void * buffer)
+{
+  std::string dataFileName;
+  bool        isLocal = false;
+  if (!m_MetaImage.BinaryData() || !m_MetaImage.CompressedData() || m_MetaImage.HeaderSize() != 0 ||
+      m_SubSamplingFactor != 1 ||
+      (m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() && this->GetComponentSize() > 1) ||
+      !this->GetElementDataFileName(dataFileName, isLocal))
+  {
+    return false;
+  }
+
+  std::ifstream file(dataFileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+  {
+    return false;
+  }
+
+  // the data of a local file starts right after the ElementDataFile field,
+  // which ends the header
+  if (isLocal)
+  {
+    std::string line;
+    while (std::getline(file, line))
+    {
+      if (line.compare(0, 15, "ElementDataFile") == 0 && line.find_first_not_of(' ', 15) != std::string::npos &&
+          line[line.find_first_not_of(' ', 15)] == '=')
+      {
+        break;
+      }
+    }
+    if (!file)
+    {
+      return false;
+    }
+  }
+
+  const std::streampos dataPosition = file.tellg();
+  file.seekg(0, std::ios::end);
+  const auto compressedSize = static_cast<size_t>(file.tellg() - dataPosition);
+  file.seekg(dataPosition);
+
+  // the header of the compressed data tells whether it is block compressed,
+  // before reading all of it
+  BlockGzipCompression::CompressedDataType compressedData(
+    std::min(compressedSize, BlockGzipCompression::GetMaximumHeaderSize()));
+  if (!file.read(reinterpret_cast<char *>(compressedData.data()), compressedData.size()) ||
+      !BlockGzipCompression::IsBlockCompressed(compressedData.data(), compressedData.size()))
+  {
+    return false;
+  }
+  const size_t headerSize = compressedData.size();
+  compressedData.resize(compressedSize);
+  if (!file.read(reinterpret_cast<char *>(compressedData.data() + headerSize), compressedSize - headerSize))
+  {
+    return false;
+  }
+
+  return BlockGzipCompression::Decompress(
+    compressedData.data(), compressedData.size(), buffer, static_cast<size_t>(this->GetImageSizeInBytes()));
+}
+
+void
+MetaImageIO::WriteBlockCompressedData(const void * buffer)
+{
+  const BlockGzipCompression::CompressedDataType compressedData = BlockGzipCompression::Compress(
+    buffer, static_cast<size_t>(this->GetImageSizeInBytes()), this->GetCompressionLevel());
+
+  // unless it is set, the data file is named as MetaIO names it
+  std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  const bool  isNamed = !elementDataFileName.empty();
+  if (!isNamed)
+  {
+    if (itksys::SystemTools::GetFilenameLastExtension(m_FileName) == ".mha")
+    {
+      elementDataFileName = "LOCAL";
+    }
+    else
+    {
+      const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+      const std::string name = itksys::SystemTools::GetFilenameWithoutLastExtension(m_FileName) + ".zraw";
+      elementDataFileName = path.empty() ? name : path + '/' + name;
+    }
+  }
+
+  // MetaIO would compress the data again to write the header of compressed
+  // data, so it writes the header of raw data, whose CompressedData field is
+  // then changed
+  m_MetaImage.CompressedData(false);
+  const bool isHeaderWritten =
+    m_MetaImage.Write(m_FileName.c_str(), isNamed ? nullptr : elementDataFileName.c_str(), false);
+  m_MetaImage.CompressedData(true);
+
+  const std::string headerFileName = m_MetaImage.FileName();
+  std::string       dataFileName = elementDataFileName;
+  bool              isLocal = elementDataFileName == "LOCAL";
+  std::string       header;
+  if (isHeaderWritten && (!isNamed || this->GetElementDataFileName(dataFileName, isLocal)))
+  {
+    std::ifstream headerFile(headerFileName.c_str(), std::ios::in | std::ios::binary);
+    header.assign(std::istreambuf_iterator<char>(headerFile), std::istreambuf_iterator<char>());
+  }
+  const std::string::size_type fieldPosition = header.find("CompressedData = False");
+  const std::string::size_type lineEnd = header.find('\n', fieldPosition);
+  if (fieldPosition == std::string::npos || lineEnd == std::string::npos)
+  {
+    itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+  const std::string::size_type fieldEnd = header[lineEnd - 1] == '\r' ? lineEnd - 1 : lineEnd;
+  const std::string            lineEnding = header.substr(fieldEnd, lineEnd + 1 - fieldEnd);
+  const std::string compressedFields =
+    "CompressedData = True" + lineEnding + "CompressedDataSize = " + std::to_string(compressedData.size());
+  header.replace(fieldPosition, fieldEnd - fieldPosition, compressedFields);
+
+  std::ofstream headerFile(headerFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  headerFile.write(header.data(), static_cast<std::streamsize>(header.size()));
+  std::ofstream dataFile;
+  if (!isLocal)
+  {
+    dataFile.open(dataFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  }
+  std::ofstream & stream = isLocal ? headerFile : dataFile;
+  stream.write(reinterpret_cast<const char *>(compressedData.data()),
+               static_cast<std::streamsize>(compressedData.size()));
+  if (!headerFile || !stream)
+  {
+    itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
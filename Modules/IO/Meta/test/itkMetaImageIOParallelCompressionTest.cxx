@@ -0,0 +1,124 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+
+#include <cstring>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+// Writes the image with the parallel compression, then reads it both
+// concurrently, by MetaImageIO, and serially, by MetaIO itself.
+int
+WriteAndReadImage(const ImageType * image, const std::string & fileName)
+{
+  auto metaImageIO = itk::MetaImageIO::New();
+  metaImageIO->SetUseParallelCompression(true);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(metaImageIO);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+  // the header written by MetaIO keeps the meta data
+  std::string note;
+  if (!itk::ExposeMetaData<std::string>(reader->GetOutput()->GetMetaDataDictionary(), "Note", note) ||
+      note != "blocks")
+  {
+    std::cerr << "The meta data of " << fileName << " was not written" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const size_t numberOfBytes = image->GetBufferedRegion().GetNumberOfPixels() * sizeof(ImageType::PixelType);
+  if (std::memcmp(image->GetBufferPointer(), reader->GetOutput()->GetBufferPointer(), numberOfBytes) != 0)
+  {
+    std::cerr << "The image read concurrently from " << fileName << " differs from the written one" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  MetaImage metaImage;
+  if (!metaImage.Read(fileName.c_str()) || !metaImage.CompressedData() ||
+      std::memcmp(image->GetBufferPointer(), metaImage.ElementData(), numberOfBytes) != 0)
+  {
+    std::cerr << "The image read serially from " << fileName << " differs from the written one" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkMetaImageIOParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto metaImageIO = itk::MetaImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(metaImageIO, UseParallelCompression, true);
+  ITK_TEST_SET_GET_BOOLEAN(metaImageIO, UseParallelCompression, false);
+
+  // large enough to be compressed in several blocks
+  const ImageType::SizeType size = { { 67, 59, 43 } };
+  auto                      image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<short>(index[0] * index[1] - 7 * index[2]));
+  }
+  itk::EncapsulateMetaData<std::string>(image->GetMetaDataDictionary(), "Note", "blocks");
+
+  const std::string outputDirectory = argv[1];
+  bool              passed = true;
+  for (const char * extension : { ".mha", ".mhd" })
+  {
+    if (WriteAndReadImage(image, outputDirectory + "/itkMetaImageIOParallelCompressionTest" + extension) !=
+        EXIT_SUCCESS)
+    {
+      passed = false;
+    }
+  }
+
+  if (!passed)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -24,6 +24,7 @@
 #include <fstream>
 #include <memory>
 #include "itkImageIOBase.h"
+#include "itkIndexedGzipFile.h"
 
 namespace itk
 {
@@ -61,6 +62,12 @@ extern ITKIONIFTI_EXPORT std::ostream &
  * The specification for this file format is taken from the
  * web site http://analyzedirect.com/support/10.0Documents/Analyze_Resource_01.pdf
  *
+ * The regions of gzipped (.nii.gz, .img.gz) images are read through an
+ * IndexedGzipFile, which only decompresses the data from the restart point
+ * preceding each region. When UseParallelCompression is enabled, the data
+ * of gzipped images is written by BlockGzipCompression, with the
+ * CompressionLevel, so that it is also decompressed concurrently.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
@@ -168,6 +175,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
   virtual bool
   GetUseLegacyModeForTwoFileWriting() const
   {
@@ -199,6 +209,22 @@ private:
   void
   SetImageIOMetadataFromNIfTI();
 
+  /** Read the data of the region from a gzipped image file through the index
+   * of its restart points, which is built by the first read of a region and
+   * kept for the following ones. The whole image is only read this way when
+   * the index is built or the file is block compressed, since it is then
+   * decompressed concurrently. Returns the data, allocated with malloc,
+   * or nullptr if niftilib has to read it. */
+  void *
+  ReadIndexedGzipData(const int * origin, const int * size, bool wholeImage);
+
+  /** Write the image, with the data in the layout of niftilib, compressed
+   * concurrently in independent blocks if UseParallelCompression is enabled
+   * and the data file is gzipped. The data is only referred to by the nifti
+   * image while it is written. */
+  void
+  WriteNiftiImage(const void * data);
+
   // This proxy class provides a nifti_image pointer interface to the internal implementation
   // of itk::NiftiImageIO, while hiding the niftilib interface from the external ITK interface.
   class NiftiImageProxy;
@@ -215,6 +241,10 @@ private:
   IOComponentEnum m_OnDiskComponentType{ IOComponentEnum::UNKNOWNCOMPONENTTYPE };
 
   Analyze75Flavor m_LegacyAnalyze75Mode;
+
+  IndexedGzipFile::Pointer m_GzipFile;
+  long int                 m_GzipFileModifiedTime{ 0 };
+  unsigned long            m_GzipFileLength{ 0 };
 };
 
 
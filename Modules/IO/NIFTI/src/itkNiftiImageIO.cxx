@@ -16,11 +16,16 @@
  *
  *=========================================================================*/
 #include "itkNiftiImageIO.h"
+#include "itkBlockGzipCompression.h"
 #include "itkIOCommon.h"
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
+#include "itksys/SystemTools.hxx"
 #include <nifti1_io.h>
 
+#include <cmath>
+#include <memory>
+
 #include "itkNiftiImageIOConfigurePrivate.h"
 
 namespace itk
@@ -451,6 +456,8 @@ NiftiImageIO::NiftiImageIO()
   , m_LegacyAnalyze75Mode{ ITK_NIFTI_IO_ANALYZE_FLAVOR_DEFAULT }
 {
   this->SetNumberOfDimensions(3);
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(6);
   nifti_set_debug_level(0); // suppress error messages
 
   const char * extensions[] = { ".nia", ".nii", ".nii.gz", ".hdr", ".img", ".img.gz" };
@@ -472,6 +479,22 @@ NiftiImageIO ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "LegacyAnalyze75Mode: " << this->m_LegacyAnalyze75Mode << std::endl;
+  itkPrintSelfObjectMacro(GzipFile);
+}
+
+LightObject::Pointer
+NiftiImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_LegacyAnalyze75Mode = this->m_LegacyAnalyze75Mode;
+
+  return loPtr;
 }
 
 bool
@@ -515,6 +538,132 @@ CastCopy(float * to, const void * from, size_t pixelcount)
   }
 }
 
+namespace
+{
+// Replace the values which are not finite by zero, as niftilib does.
+template <typename TValue>
+void
+ZeroNonFiniteValues(void * data, size_t numberOfBytes)
+{
+  auto * values = static_cast<TValue *>(data);
+  for (size_t i = 0; i < numberOfBytes / sizeof(TValue); ++i)
+  {
+    if (!std::isfinite(values[i]))
+    {
+      values[i] = 0;
+    }
+  }
+}
+} // namespace
+
+void *
+NiftiImageIO::ReadIndexedGzipData(const int * origin, const int * size, bool wholeImage)
+{
+  nifti_image * nim = this->m_NiftiImage;
+  if (nim->iname == nullptr || !nifti_is_gzfile(nim->iname) || nim->iname_offset < 0)
+  {
+    return nullptr;
+  }
+
+  // the index is kept as long as the file is not changed
+  const std::string   fileName = nim->iname;
+  const long int      modifiedTime = itksys::SystemTools::ModifiedTime(fileName);
+  const unsigned long fileLength = itksys::SystemTools::FileLength(fileName);
+  if (this->m_GzipFile.IsNull() || this->m_GzipFile->GetFileName() != fileName ||
+      this->m_GzipFileModifiedTime != modifiedTime || this->m_GzipFileLength != fileLength)
+  {
+    this->m_GzipFile = IndexedGzipFile::New();
+    this->m_GzipFile->SetFileName(fileName);
+    this->m_GzipFileModifiedTime = modifiedTime;
+    this->m_GzipFileLength = fileLength;
+  }
+
+  // building the index of a plain gzip file would be slower than
+  // decompressing it serially
+  if (wholeImage && !this->m_GzipFile->IsIndexBuilt() && !this->m_GzipFile->IsBlockCompressed())
+  {
+    return nullptr;
+  }
+
+  const size_t pixelSize = nim->nbyper;
+  size_t       dims[7];
+  size_t       strides[7];
+  size_t       numberOfBytes = pixelSize;
+  size_t       numberOfVolumes = 1;
+  for (unsigned int i = 0; i < 7; ++i)
+  {
+    dims[i] = static_cast<size_t>(std::max(nim->dim[i + 1], 1));
+    strides[i] = i == 0 ? pixelSize : strides[i - 1] * dims[i - 1];
+    if (origin[i] < 0 || size[i] < 1 || static_cast<size_t>(origin[i] + size[i]) > dims[i])
+    {
+      itkExceptionMacro(<< "The region to read is not within the image of " << this->GetFileName());
+    }
+    numberOfBytes *= size[i];
+    if (i >= 3)
+    {
+      numberOfVolumes *= size[i];
+    }
+  }
+
+  std::unique_ptr<char, void (*)(void *)> data(static_cast<char *>(malloc(numberOfBytes)), free);
+  if (data == nullptr)
+  {
+    itkExceptionMacro(<< "Could not allocate " << numberOfBytes << " bytes to read " << this->GetFileName());
+  }
+  const auto offset = static_cast<size_t>(nim->iname_offset);
+  if (wholeImage)
+  {
+    this->m_GzipFile->Read(offset, numberOfBytes, data.get());
+  }
+  else
+  {
+    // the region is read by 3D volumes, whose rows are contiguous in the
+    // file, so that the rows of a volume are decompressed concurrently
+    const size_t      rowSize = size[0] * pixelSize;
+    const size_t      volumeSpan = (size[2] - 1) * strides[2] + (size[1] - 1) * strides[1] + rowSize;
+    std::vector<char> volume(volumeSpan);
+    char *            output = data.get();
+    for (size_t v = 0; v < numberOfVolumes; ++v)
+    {
+      size_t volumeStart = offset + origin[0] * strides[0] + origin[1] * strides[1] + origin[2] * strides[2];
+      size_t index = v;
+      for (unsigned int i = 3; i < 7; ++i)
+      {
+        volumeStart += (origin[i] + index % size[i]) * strides[i];
+        index /= size[i];
+      }
+      this->m_GzipFile->Read(volumeStart, volumeSpan, volume.data());
+      for (int z = 0; z < size[2]; ++z)
+      {
+        for (int y = 0; y < size[1]; ++y, output += rowSize)
+        {
+          memcpy(output, volume.data() + z * strides[2] + y * strides[1], rowSize);
+        }
+      }
+    }
+  }
+
+  // the data is processed as nifti_read_buffer does
+  if (nim->swapsize > 1 && nim->byteorder != nifti_short_order())
+  {
+    nifti_swap_Nbytes(static_cast<int>(numberOfBytes / nim->swapsize), nim->swapsize, data.get());
+  }
+  switch (nim->datatype)
+  {
+    case NIFTI_TYPE_FLOAT32:
+    case NIFTI_TYPE_COMPLEX64:
+      ZeroNonFiniteValues<float>(data.get(), numberOfBytes);
+      break;
+    case NIFTI_TYPE_FLOAT64:
+    case NIFTI_TYPE_COMPLEX128:
+      ZeroNonFiniteValues<double>(data.get(), numberOfBytes);
+      break;
+    default:
+      break;
+  }
+  return data.release();
+}
+
 void
 NiftiImageIO::Read(void * buffer)
 {
@@ -576,7 +725,17 @@ NiftiImageIO::Read(void * buffer)
   }
   // if all dimensions match requested size, just read in
   // all data as a block
-  if (i == this->GetNumberOfDimensions())
+  const bool wholeImage = i == this->GetNumberOfDimensions();
+  data = this->ReadIndexedGzipData(_origin, _size, wholeImage);
+  if (data != nullptr)
+  {
+    if (wholeImage)
+    {
+      // freed with the nifti image, like the data loaded by niftilib
+      this->m_NiftiImage->data = data;
+    }
+  }
+  else if (wholeImage)
   {
     if (nifti_image_load(this->m_NiftiImage) == -1)
     {
@@ -2168,6 +2327,68 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short int origdims, unsign
   this->m_NiftiImage->sform_code = NIFTI_XFORM_SCANNER_ANAT;
 }
 
+void
+NiftiImageIO::WriteNiftiImage(const void * data)
+{
+  nifti_image * nim = this->m_NiftiImage;
+
+  // niftilib would free the data along with the image if it were left
+  // pointing to it, also when an exception is thrown
+  struct DataReference
+  {
+    ~DataReference() { image->data = nullptr; }
+    nifti_image * image;
+  } dataReference{ nim };
+  nim->data = const_cast<void *>(data);
+
+  const bool    singleFile = nim->nifti_type == NIFTI_FTYPE_NIFTI1_1;
+  const char *  dataFileName = singleFile ? nim->fname : nim->iname;
+  if (!this->GetUseParallelCompression() || nim->nifti_type == NIFTI_FTYPE_ASCII || dataFileName == nullptr ||
+      !nifti_is_gzfile(dataFileName))
+  {
+    nifti_image_write(nim);
+    return;
+  }
+
+  // niftilib only writes the header, and the extensions, which are then
+  // rewritten in a block compressed member of their own, padded with zeros
+  // up to the offset of the data, so that all the members of the file are
+  // block compressed. The data follows in another member. The data file is
+  // left open, so that the handle tells whether the header was written.
+  znzFile fp = nifti_image_write_hdr_img(nim, 2, "wb");
+  if (znz_isnull(fp))
+  {
+    itkExceptionMacro(<< "Could not write the header of " << nim->fname);
+  }
+  znzclose(fp);
+  std::vector<char> header(static_cast<size_t>(nim->iname_offset), 0);
+  if (singleFile)
+  {
+    auto headerFile = IndexedGzipFile::New();
+    headerFile->SetFileName(nim->fname);
+    headerFile->BuildIndex();
+    if (headerFile->GetUncompressedSize() > header.size())
+    {
+      itkExceptionMacro(<< "The header of " << nim->fname << " overlaps its data");
+    }
+    headerFile->Read(0, headerFile->GetUncompressedSize(), header.data());
+  }
+
+  std::ofstream dataFile(dataFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!header.empty())
+  {
+    const BlockGzipCompression::CompressedDataType compressedHeader =
+      BlockGzipCompression::Compress(header.data(), header.size(), this->GetCompressionLevel());
+    dataFile.write(reinterpret_cast<const char *>(compressedHeader.data()), compressedHeader.size());
+  }
+  const BlockGzipCompression::CompressedDataType compressedData =
+    BlockGzipCompression::Compress(nim->data, nifti_get_volsize(nim), this->GetCompressionLevel());
+  if (!dataFile.write(reinterpret_cast<const char *>(compressedData.data()), compressedData.size()))
+  {
+    itkExceptionMacro(<< "Could not write the data of " << nim->fname << " to " << dataFileName);
+  }
+}
+
 void
 NiftiImageIO ::Write(const void * buffer)
 {
@@ -2178,12 +2399,7 @@ NiftiImageIO ::Write(const void * buffer)
       (numComponents == 3 && this->GetPixelType() == IOPixelEnum::RGB) ||
       (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA))
   {
-    // Need a const cast here so that we don't have to copy the memory
-    // for writing.
-    this->m_NiftiImage->data = const_cast<void *>(buffer);
-    nifti_image_write(this->m_NiftiImage);
-    this->m_NiftiImage->data = nullptr; // if left pointing to data buffer
-    // nifti_image_free will try and free this memory
+    this->WriteNiftiImage(buffer);
   }
   else /// Image intent is vector image
   {
@@ -2199,8 +2415,8 @@ NiftiImageIO ::Write(const void * buffer)
     const size_t buffer_size = numVoxels * numComponents // Number of components
                                * this->m_NiftiImage->nbyper;
 
-    auto *             nifti_buf = new char[buffer_size];
-    const auto * const itkbuf = (const char *)buffer;
+    std::unique_ptr<char[]> nifti_buf(new char[buffer_size]);
+    const auto * const      itkbuf = (const char *)buffer;
     // Data must be rearranged to meet nifti organzation.
     // nifti_layout[vec][t][z][y][x] = itk_layout[t][z][y][z][vec]
     const size_t rowdist = m_NiftiImage->dim[1];
@@ -2258,12 +2474,7 @@ NiftiImageIO ::Write(const void * buffer)
     }
     delete[] vecOrder;
     dumpdata(buffer);
-    // Need a const cast here so that we don't have to copy the memory for
-    // writing.
-    this->m_NiftiImage->data = static_cast<void *>(nifti_buf);
-    nifti_image_write(this->m_NiftiImage);
-    this->m_NiftiImage->data = nullptr; // if left pointing to data buffer
-    delete[] nifti_buf;
+    this->WriteNiftiImage(nifti_buf.get());
   }
 }
 
@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkIndexedGzipFile.h"
+#include "itkMultiThreaderBase.h"
+#include "itkNiftiImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+// Checks that the pixels of the region of the image read match the expected image.
+bool
+CompareRegion(const ImageType * image, const ImageType::RegionType & region, const ImageType * expected)
+{
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(expected, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (image->GetPixel(it.GetIndex()) != it.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " read as " << image->GetPixel(it.GetIndex()) << " instead of "
+                << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the image, serially or in parallel, and reads it back entirely and
+// by streamed regions, with a single image IO that keeps the index.
+int
+WriteAndReadImage(const std::string & fileName, bool useParallelCompression, bool expectBlockCompressed)
+{
+  // large enough to have several restart points
+  const ImageType::SizeType size = { { 128, 128, 100 } };
+  auto                      image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<short>((index[0] * index[1]) % 251 - 3 * index[2]));
+  }
+
+  auto writerImageIO = itk::NiftiImageIO::New();
+  writerImageIO->SetUseParallelCompression(useParallelCompression);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(writerImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto gzipFile = itk::IndexedGzipFile::New();
+  gzipFile->SetFileName(fileName);
+  ITK_TEST_EXPECT_EQUAL(gzipFile->IsBlockCompressed(), expectBlockCompressed);
+
+  // the readers share the image IO, which keeps the index
+  auto niftiImageIO = itk::NiftiImageIO::New();
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(niftiImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(CompareRegion(reader->GetOutput(), image->GetLargestPossibleRegion(), image));
+
+  for (const ImageType::RegionType & region : { ImageType::RegionType({ { 0, 0, 90 } }, { { 128, 128, 2 } }),
+                                                ImageType::RegionType({ { 3, 17, 5 } }, { { 41, 30, 83 } }),
+                                                ImageType::RegionType({ { 127, 127, 99 } }, { { 1, 1, 1 } }) })
+  {
+    auto streamingReader = itk::ImageFileReader<ImageType>::New();
+    streamingReader->SetFileName(fileName);
+    streamingReader->SetImageIO(niftiImageIO);
+    streamingReader->SetUseStreaming(true);
+    ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->UpdateOutputInformation());
+    streamingReader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+    ITK_TEST_EXPECT_EQUAL(streamingReader->GetOutput()->GetBufferedRegion(), region);
+    ITK_TEST_EXPECT_TRUE(CompareRegion(streamingReader->GetOutput(), region, image));
+  }
+
+  // the whole image again, once the index is built
+  auto indexedReader = itk::ImageFileReader<ImageType>::New();
+  indexedReader->SetFileName(fileName);
+  indexedReader->SetImageIO(niftiImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(indexedReader->Update());
+  ITK_TEST_EXPECT_TRUE(CompareRegion(indexedReader->GetOutput(), image->GetLargestPossibleRegion(), image));
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkNiftiImageIOIndexedGzipTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto niftiImageIO = itk::NiftiImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(niftiImageIO, UseParallelCompression, true);
+  ITK_TEST_SET_GET_BOOLEAN(niftiImageIO, UseParallelCompression, false);
+  ITK_TEST_EXPECT_EQUAL(niftiImageIO->GetCompressionLevel(), 6);
+
+  // several groups of restart points, whatever the number of processors
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(4);
+
+  const std::string outputDirectory = std::string(argv[1]) + "/itkNiftiImageIOIndexedGzipTest";
+  int               result = EXIT_SUCCESS;
+  if (WriteAndReadImage(outputDirectory + ".nii.gz", false, false) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (WriteAndReadImage(outputDirectory + "Parallel.nii.gz", true, true) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (WriteAndReadImage(outputDirectory + "Parallel.img.gz", true, true) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // the header can not be written, so neither is the data
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 4, 4, 4 } });
+    image->Allocate(true);
+    auto writerImageIO = itk::NiftiImageIO::New();
+    writerImageIO->SetUseParallelCompression(true);
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(outputDirectory + "Missing/Parallel.nii.gz");
+    writer->SetImageIO(writerImageIO);
+    ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
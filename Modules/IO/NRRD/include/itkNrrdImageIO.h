@@ -36,7 +36,7 @@ namespace itk
  *
  * The compressor supported may include "gzip" (default) and
  * "bzip2".  Only the "gzip" compressor support the compression level
- * in the range 0-9.
+ * in the range 0-9, and UseParallelCompression.
  *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
@@ -78,6 +78,13 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Determine if the pixels of the IORegion can be mapped in memory. They
+   * can if the data is raw, attached to the header in a single file, in the
+   * byte order of this machine, and with the components of a pixel
+   * contiguous. */
+  bool
+  CanMapRead(std::string & dataFileName, SizeType & dataPosition) const override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -109,7 +116,21 @@ protected:
   IOComponentEnum
   NrrdToITKComponentType(const int) const;
 
+  /** Read the whole image from a gzip encoded file, compressed in
+   * independent blocks, concurrently. Returns false if the data is not
+   * block compressed, or has to be processed by NrrdIO. Only called for
+   * the files whose header gives the gzip encoding. */
+  bool
+  ReadBlockCompressedData(void * buffer);
+
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+  /** The encoding of the data of the file whose header was read last. */
+  const NrrdEncoding_t * m_NrrdReadEncoding{ nullptr };
+
+  /** The position of the raw data attached to the header of the file read
+   * last, or -1 if it can not be mapped in memory. */
+  SizeType m_RawDataPosition{ -1 };
 };
 } // end namespace itk
 
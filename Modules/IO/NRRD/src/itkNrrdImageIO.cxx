@@ -19,9 +19,13 @@
 #include "itkNrrdImageIO.h"
 #include "NrrdIO.h"
 
+#include "itkBlockGzipCompression.h"
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
 
 namespace itk
 {
@@ -278,6 +282,10 @@ NrrdImageIO::ReadImageInformation()
     // this is the mechanism by which we tell nrrdLoad to read
     // just the header, and none of the data
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    // and to keep the data file open right where the data starts
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+    m_NrrdReadEncoding = nullptr;
+    m_RawDataPosition = -1;
     if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
     {
       char * err = biffGetDone(NRRD);
@@ -298,6 +306,16 @@ NrrdImageIO::ReadImageInformation()
       FloatingPointExceptions::SetEnabled(saveFPEState);
     }
 
+    // raw data attached to the header may be mapped in memory
+    SizeType dataPosition = -1;
+    if (nio->dataFile != nullptr)
+    {
+      if (nio->encoding == nrrdEncodingRaw && nio->dataFNFormat == nullptr && nio->dataFNArr->len == 0)
+      {
+        dataPosition = static_cast<SizeType>(ftell(nio->dataFile));
+      }
+      nio->dataFile = airFclose(nio->dataFile);
+    }
 
     if (nrrdTypeBlock == nrrd->type)
     {
@@ -317,6 +335,7 @@ NrrdImageIO::ReadImageInformation()
       this->SetByteOrder(IOByteOrderEnum::OrderNotApplicable);
     }
 
+    m_NrrdReadEncoding = nio->encoding;
     if (nio->encoding == nrrdEncodingAscii)
     {
       this->SetFileTypeToASCII();
@@ -695,6 +714,15 @@ NrrdImageIO::ReadImageInformation()
       EncapsulateMetaData<std::vector<std::vector<double>>>(thisDic, std::string(key), msrFrame);
     }
 
+    // the mapped data has to be in the byte order of this machine, with the
+    // range axis (if any) as the fastest one, since NrrdIO is not there to
+    // fix them
+    if (dataPosition >= 0 && IOPixelEnum::SYMMETRICSECONDRANKTENSOR != this->GetPixelType() &&
+        (nrrdElementSize(nrrd) == 1 || nio->endian == airMyEndian()) && (0 == rangeAxisNum || 0 == rangeAxisIdx[0]))
+    {
+      m_RawDataPosition = dataPosition;
+    }
+
     nrrd = nrrdNix(nrrd);
     nio = nrrdIoStateNix(nio);
   }
@@ -709,9 +737,109 @@ NrrdImageIO::ReadImageInformation()
   }
 }
 
+bool
+NrrdImageIO::CanMapRead(std::string & dataFileName, SizeType & dataPosition) const
+{
+  SizeType regionOffset = 0;
+  if (m_RawDataPosition < 0 || !this->ComputeContiguousIORegionOffset(regionOffset) ||
+      m_RawDataPosition + this->GetImageSizeInBytes() >
+        static_cast<SizeType>(itksys::SystemTools::FileLength(this->GetFileName())))
+  {
+    return false;
+  }
+  dataFileName = this->GetFileName();
+  dataPosition = m_RawDataPosition + regionOffset;
+  return true;
+}
+
+bool
+NrrdImageIO::ReadBlockCompressedData(void * buffer)
+{
+  if (IOPixelEnum::SYMMETRICSECONDRANKTENSOR == this->GetPixelType())
+  {
+    return false;
+  }
+
+  // read the header only, and keep the data file open right where the data
+  // starts
+  Nrrd *        nrrd = nrrdNew();
+  NrrdIoState * nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+
+  // nrrd causes exceptions on purpose, so mask them
+  bool saveFPEState(false);
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    saveFPEState = FloatingPointExceptions::GetEnabled();
+    FloatingPointExceptions::Disable();
+  }
+
+  const bool loaded = nrrdLoad(nrrd, this->GetFileName(), nio) == 0;
+
+  // restore state
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    FloatingPointExceptions::SetEnabled(saveFPEState);
+  }
+
+  // the data has to be in a single file, with no bytes to skip, in the
+  // byte order of this machine, and with the range axis (if any) as the
+  // fastest one, since NrrdIO is not there to fix them
+  unsigned int rangeAxisNum = 0;
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX];
+  if (loaded)
+  {
+    rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+  }
+  else
+  {
+    free(biffGetDone(NRRD));
+  }
+  const bool canRead =
+    loaded && nio->dataFile != nullptr && nio->encoding == nrrdEncodingGzip && nio->byteSkip == 0 &&
+    (nrrdElementSize(nrrd) == 1 || nio->endian == airMyEndian()) &&
+    nrrdElementSize(nrrd) * nrrdElementNumber(nrrd) == static_cast<size_t>(this->GetImageSizeInBytes()) &&
+    (rangeAxisNum == 0 || (rangeAxisNum == 1 && rangeAxisIdx[0] == 0));
+
+  BlockGzipCompression::CompressedDataType compressedData;
+  bool                                     isBlockCompressed = false;
+  if (canRead)
+  {
+    // the header of the compressed data tells whether it is block
+    // compressed, before reading all of it
+    compressedData.resize(BlockGzipCompression::GetMaximumHeaderSize());
+    size_t size = fread(compressedData.data(), 1, compressedData.size(), nio->dataFile);
+    isBlockCompressed = BlockGzipCompression::IsBlockCompressed(compressedData.data(), size);
+    while (isBlockCompressed && !feof(nio->dataFile) && !ferror(nio->dataFile))
+    {
+      compressedData.resize(2 * compressedData.size());
+      size += fread(compressedData.data() + size, 1, compressedData.size() - size, nio->dataFile);
+    }
+    isBlockCompressed = isBlockCompressed && !ferror(nio->dataFile);
+    compressedData.resize(size);
+  }
+
+  if (nio->dataFile != nullptr)
+  {
+    nio->dataFile = airFclose(nio->dataFile);
+  }
+  nrrdNuke(nrrd);
+  nrrdIoStateNix(nio);
+
+  return isBlockCompressed &&
+         BlockGzipCompression::Decompress(
+           compressedData.data(), compressedData.size(), buffer, static_cast<size_t>(this->GetImageSizeInBytes()));
+}
+
 void
 NrrdImageIO::Read(void * buffer)
 {
+  if (m_NrrdReadEncoding == nrrdEncodingGzip && this->ReadBlockCompressedData(buffer))
+  {
+    return;
+  }
+
   Nrrd * nrrd = nrrdNew();
   bool   nrrdAllocated;
 
@@ -1109,6 +1237,16 @@ NrrdImageIO::Write(const void * buffer)
       break;
   }
 
+  // Compress the data concurrently, in independent blocks, so that NrrdIO
+  // only writes the header.
+  BlockGzipCompression::CompressedDataType compressedData;
+  if (nio->encoding == nrrdEncodingGzip && this->GetUseParallelCompression())
+  {
+    compressedData = BlockGzipCompression::Compress(
+      buffer, nrrdElementSize(nrrd) * nrrdElementNumber(nrrd), this->GetCompressionLevel());
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  }
+
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
@@ -1116,6 +1254,29 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (!compressedData.empty())
+  {
+    // The data follows an attached header, or is the whole detached data
+    // file, whose name has been chosen by NrrdIO.
+    std::string dataFileName = this->GetFileName();
+    if (nio->detachedHeader && nio->dataFNArr->len == 1)
+    {
+      dataFileName = nio->dataFN[0];
+      if (!itksys::SystemTools::FileIsFullPath(dataFileName) && airStrlen(nio->path))
+      {
+        dataFileName = std::string(nio->path) + '/' + dataFileName;
+      }
+    }
+    std::ofstream dataFile(dataFileName.c_str(),
+                           std::ios::out | std::ios::binary | (nio->detachedHeader ? std::ios::trunc : std::ios::app));
+    if (!dataFile.write(reinterpret_cast<const char *>(compressedData.data()), compressedData.size()))
+    {
+      nrrdNix(nrrd);
+      nrrdIoStateNix(nio);
+      itkExceptionMacro("Write: Error writing the data of " << this->GetFileName() << " to " << dataFileName);
+    }
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkNrrdImageIO.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+// Writes the image, and reads it back with the memory mapped reading on.
+// Only the raw data attached to the header can be mapped.
+template <typename TPixel>
+int
+WriteAndReadImage(const std::string & fileName, bool useCompression, bool expectMapped)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  using PixelTraitsType = itk::DefaultConvertPixelTraits<TPixel>;
+  using ValueType = typename PixelTraitsType::ComponentType;
+  using PixelContainerType = typename ImageType::PixelContainer;
+  using MappedPixelContainerType =
+    itk::MemoryMappedImageContainer<typename PixelContainerType::ElementIdentifier,
+                                    typename PixelContainerType::Element>;
+
+  const typename ImageType::SizeType size = { { 23, 19, 11 } };
+  auto                               image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const typename ImageType::IndexType index = it.GetIndex();
+    TPixel                              pixel;
+    for (unsigned int i = 0; i < PixelTraitsType::GetNumberOfComponents(); ++i)
+    {
+      PixelTraitsType::SetNthComponent(i, pixel, static_cast<ValueType>(index[0] * index[1] + 3 * i - 2 * index[2]));
+    }
+    it.Set(pixel);
+  }
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(useCompression);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto nrrdImageIO = itk::NrrdImageIO::New();
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(nrrdImageIO);
+  reader->UseMemoryMappedReadingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  const ImageType * output = reader->GetOutput();
+
+  // the data ends the file, and is mapped if it is aligned for its components
+  std::string                dataFileName;
+  itk::ImageIOBase::SizeType dataPosition = 0;
+  const bool                 canMapRead = nrrdImageIO->CanMapRead(dataFileName, dataPosition);
+  ITK_TEST_EXPECT_EQUAL(canMapRead, expectMapped);
+  if (canMapRead)
+  {
+    ITK_TEST_EXPECT_EQUAL(dataFileName, fileName);
+    ITK_TEST_EXPECT_EQUAL(dataPosition + nrrdImageIO->GetImageSizeInBytes(),
+                          static_cast<itk::ImageIOBase::SizeType>(itksys::SystemTools::FileLength(fileName)));
+  }
+  const bool isMapped = dynamic_cast<const MappedPixelContainerType *>(output->GetPixelContainer()) != nullptr;
+  if (isMapped != (canMapRead && dataPosition % alignof(ValueType) == 0))
+  {
+    std::cerr << fileName << (isMapped ? " is" : " is not") << " mapped in memory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    if (output->GetPixel(it.GetIndex()) != it.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " of " << fileName << " read as " << output->GetPixel(it.GetIndex())
+                << " instead of " << it.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkNrrdImageIOMemoryMappedReadingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkNrrdImageIOMemoryMappedReadingTest";
+  int               result = EXIT_SUCCESS;
+
+  // raw data attached to the header, of scalars and of vectors
+  if (WriteAndReadImage<short>(prefix + ".nrrd", false, true) != EXIT_SUCCESS ||
+      WriteAndReadImage<itk::Vector<float, 3>>(prefix + "Vector.nrrd", false, true) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // raw data in a detached file, and compressed data, which are read
+  if (WriteAndReadImage<short>(prefix + ".nhdr", false, false) != EXIT_SUCCESS ||
+      WriteAndReadImage<short>(prefix + "Compressed.nrrd", true, false) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNrrdImageIO.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkTestingMacros.h"
+
+#include <cstring>
+
+namespace
+{
+// Writes the image with the parallel compression, and reads it back. The
+// vector images are read concurrently by NrrdImageIO, while the tensor
+// images are read serially by NrrdIO.
+template <typename TPixel>
+int
+WriteAndReadImage(const std::string & fileName)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  using ValueType = typename itk::NumericTraits<TPixel>::ValueType;
+
+  // large enough to be compressed in several blocks
+  const typename ImageType::SizeType size = { { 41, 37, 29 } };
+  auto                               image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const typename ImageType::IndexType index = it.GetIndex();
+    TPixel                              pixel;
+    for (unsigned int i = 0; i < itk::NumericTraits<TPixel>::GetLength(pixel); ++i)
+    {
+      pixel[i] = static_cast<ValueType>(index[0] * index[1] + i - 0.5 * index[2]);
+    }
+    it.Set(pixel);
+  }
+
+  auto nrrdImageIO = itk::NrrdImageIO::New();
+  nrrdImageIO->SetUseParallelCompression(true);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(nrrdImageIO);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+  const size_t numberOfBytes = image->GetBufferedRegion().GetNumberOfPixels() * sizeof(TPixel);
+  if (std::memcmp(image->GetBufferPointer(), reader->GetOutput()->GetBufferPointer(), numberOfBytes) != 0)
+  {
+    std::cerr << "The image read from " << fileName << " differs from the written one" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkNrrdImageIOParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto nrrdImageIO = itk::NrrdImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(nrrdImageIO, UseParallelCompression, true);
+  ITK_TEST_SET_GET_BOOLEAN(nrrdImageIO, UseParallelCompression, false);
+
+  const std::string outputDirectory = std::string(argv[1]) + "/itkNrrdImageIOParallelCompressionTest";
+  bool              passed = true;
+  for (const char * extension : { ".nrrd", ".nhdr" })
+  {
+    if (WriteAndReadImage<itk::Vector<float, 3>>(outputDirectory + extension) != EXIT_SUCCESS ||
+        WriteAndReadImage<itk::SymmetricSecondRankTensor<float, 3>>(outputDirectory + "Tensor" + extension) !=
+          EXIT_SUCCESS)
+    {
+      passed = false;
+    }
+  }
+
+  if (!passed)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
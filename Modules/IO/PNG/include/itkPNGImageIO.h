@@ -113,6 +113,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
   void
   WriteSlice(const std::string & fileName, const void * buffer);
 
@@ -321,6 +321,21 @@ PNGImageIO::PrintSelf(std::ostream & os, Indent indent) const
   }
 }
 
+LightObject::Pointer
+PNGImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_ColorPalette = this->m_ColorPalette;
+
+  return loPtr;
+}
+
 void
 PNGImageIO::ReadImageInformation()
 {
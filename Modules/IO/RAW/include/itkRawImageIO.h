@@ -166,6 +166,11 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Binary files have no image information, so the clone also copies the
+   * image information set by the user. */
+  LightObject::Pointer
+  InternalClone() const override;
+
   // void ComputeInternalFileName(unsigned long slice);
 
 private:
@@ -76,6 +76,32 @@ RawImageIO<TPixel, VImageDimension>::PrintSelf(std::ostream & os, Indent indent)
   os << indent << "FileDimensionality: " << m_FileDimensionality << std::endl;
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+LightObject::Pointer
+RawImageIO<TPixel, VImageDimension>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->SetNumberOfDimensions(this->GetNumberOfDimensions());
+  rval->m_Dimensions = this->m_Dimensions;
+  rval->m_Spacing = this->m_Spacing;
+  rval->m_Origin = this->m_Origin;
+  rval->m_Direction = this->m_Direction;
+  rval->m_ByteOrder = this->m_ByteOrder;
+  rval->m_FileType = this->m_FileType;
+  rval->m_FileDimensionality = this->m_FileDimensionality;
+  rval->m_ManualHeaderSize = this->m_ManualHeaderSize;
+  rval->m_HeaderSize = this->m_HeaderSize;
+  rval->m_ImageMask = this->m_ImageMask;
+
+  return loPtr;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 SizeValueType
 RawImageIO<TPixel, VImageDimension>::GetHeaderSize()
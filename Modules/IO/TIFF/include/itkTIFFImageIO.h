@@ -38,6 +38,11 @@ class TIFFReaderInternal;
  * supports the compression level for JPEG quality parameter in the
  * range 0-100.
  *
+ * Tiled images are read tile by tile, decoding the tiles concurrently, and
+ * can be streamed: only the tiles intersecting the requested region are
+ * decoded. A reduced resolution level of a pyramidal image can be read
+ * instead of the full resolution image with SetResolutionLevel().
+ *
  * \ingroup IOFilters
  * \ingroup ITKIOTIFF
  *
@@ -83,6 +88,28 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** Tiled images can be streamed, once the image information has been
+   * read. */
+  bool
+  CanStreamRead() override;
+
+  /** For a tiled image, the streamable region is the requested region. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const override;
+
+  /** Set/Get the resolution level to read from a pyramidal image. The level
+   * 0, the default, is the full resolution image of the first directory. The
+   * following levels are its reduced resolution versions, stored either as
+   * SubIFDs of the first directory or as reduced resolution subfiles. A
+   * reduced resolution level is read as a 2D image, with the spacing of its
+   * own tags. */
+  itkSetMacro(ResolutionLevel, unsigned int);
+  itkGetConstMacro(ResolutionLevel, unsigned int);
+
+  /** Get the number of resolution levels of the file, which is known once
+   * the image information has been read. */
+  itkGetConstMacro(NumberOfResolutionLevels, unsigned int);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -196,6 +223,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  LightObject::Pointer
+  InternalClone() const override;
+
   void
   InternalSetCompressor(const std::string & _compressor) override;
 
@@ -263,6 +293,20 @@ private:
   void
   RGBAImageToBuffer(void * out, const uint32_t * tempImage);
 
+  // Read the tiles of the current page which intersect the IORegion
+  void
+  ReadTiles(void * out);
+
+  template <typename TComponent>
+  void
+  ReadTiles(void * out);
+
+  // Convert xsize pixels of the given format, starting at the given pixel of
+  // the decoded buffer
+  template <typename TComponent>
+  void
+  PutPixels(unsigned int format, TComponent * to, void * from, size_t fromPixelOffset, unsigned int xsize);
+
   template <typename TType>
   void
   PutGrayscale(TType *      to,
@@ -309,6 +353,10 @@ private:
   uint16_t *   m_ColorBlue;
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+
+  unsigned int m_ResolutionLevel{ 0 };
+  unsigned int m_NumberOfResolutionLevels{ 1 };
+  bool         m_IsReadAsTiles{ false };
 };
 } // end namespace itk
 
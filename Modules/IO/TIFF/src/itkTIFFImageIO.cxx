@@ -20,9 +20,12 @@
 #include "itkTIFFReaderInternal.h"
 #include "itksys/SystemTools.hxx"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
 
 #include "itk_tiff.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -77,6 +80,31 @@ TIFFImageIO::ReadGenericImage(void * out, unsigned int width, unsigned int heigh
   }
 }
 
+void
+TIFFImageIO::ReadTiles(void * out)
+{
+  if (m_ComponentType == IOComponentEnum::UCHAR)
+  {
+    this->ReadTiles<unsigned char>(out);
+  }
+  else if (m_ComponentType == IOComponentEnum::CHAR)
+  {
+    this->ReadTiles<char>(out);
+  }
+  else if (m_ComponentType == IOComponentEnum::USHORT)
+  {
+    this->ReadTiles<unsigned short>(out);
+  }
+  else if (m_ComponentType == IOComponentEnum::SHORT)
+  {
+    this->ReadTiles<short>(out);
+  }
+  else if (m_ComponentType == IOComponentEnum::FLOAT)
+  {
+    this->ReadTiles<float>(out);
+  }
+}
+
 void
 TIFFImageIO::GetColor(uint64_t index, uint16_t * red, uint16_t * green, uint16_t * blue)
 {
@@ -148,10 +176,16 @@ TIFFImageIO::GetFormat()
 void
 TIFFImageIO::ReadVolume(void * buffer)
 {
-  const size_t width{ m_InternalImage->m_Width };
-  const size_t height{ m_InternalImage->m_Height };
+  // only the pages of the IO region are read, tiled pages being also
+  // read in the x and y range of the region
+  const ImageIORegion & region = this->GetIORegion();
+  const size_t          width{ m_IsReadAsTiles ? region.GetSize(0) : m_InternalImage->m_Width };
+  const size_t          height{ m_IsReadAsTiles ? region.GetSize(1) : m_InternalImage->m_Height };
+  const size_t          firstSlice = region.GetIndex(2);
+  const size_t          lastSlice = firstSlice + region.GetSize(2);
 
-  for (uint16 page = 0; page < m_InternalImage->m_NumberOfPages; page++)
+  size_t slice = 0;
+  for (uint16 page = 0; page < m_InternalImage->m_NumberOfPages && slice < lastSlice; page++)
   {
     if (m_InternalImage->m_IgnoredSubFiles > 0)
     {
@@ -168,9 +202,13 @@ TIFFImageIO::ReadVolume(void * buffer)
     }
 
 
-    const size_t pixelOffset = width * height * this->GetNumberOfComponents() * page;
+    if (slice >= firstSlice)
+    {
+      const size_t pixelOffset = width * height * this->GetNumberOfComponents() * (slice - firstSlice);
 
-    ReadCurrentPage(buffer, pixelOffset);
+      ReadCurrentPage(buffer, pixelOffset);
+    }
+    ++slice;
 
     TIFFReadDirectory(m_InternalImage->m_Image);
   }
@@ -187,11 +225,16 @@ TIFFImageIO::Read(void * buffer)
     {
       itkExceptionMacro(<< "Cannot open file " << this->m_FileName << "!");
     }
+    if (!m_InternalImage->SetResolutionLevel(m_ResolutionLevel))
+    {
+      itkExceptionMacro(<< "Cannot read the resolution level " << m_ResolutionLevel << " of file "
+                        << this->m_FileName);
+    }
   }
 
   // The IO region should be of dimensions 3 otherwise we read only the first
-  // page
-  if (m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
+  // page. A reduced resolution level is a single page.
+  if (m_ResolutionLevel == 0 && m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
   {
     this->ReadVolume(buffer);
   }
@@ -241,6 +284,39 @@ TIFFImageIO::~TIFFImageIO()
   delete m_InternalImage;
 }
 
+bool
+TIFFImageIO::CanStreamRead()
+{
+  return m_IsReadAsTiles;
+}
+
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const
+{
+  if (!m_UseStreamedReading || !m_IsReadAsTiles)
+  {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requested);
+  }
+
+  // only the tiles which intersect the requested region are read
+  const unsigned int dimension = std::max(this->GetNumberOfDimensions(), requested.GetImageDimension());
+  ImageIORegion      streamableRegion(dimension);
+  for (unsigned int i = 0; i < dimension; ++i)
+  {
+    if (i < requested.GetImageDimension())
+    {
+      streamableRegion.SetIndex(i, requested.GetIndex(i));
+      streamableRegion.SetSize(i, requested.GetSize(i));
+    }
+    else
+    {
+      streamableRegion.SetIndex(i, 0);
+      streamableRegion.SetSize(i, 1);
+    }
+  }
+  return streamableRegion;
+}
+
 void
 TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -258,6 +334,26 @@ TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
          << std::endl;
     }
   }
+  os << indent << "ResolutionLevel: " << m_ResolutionLevel << std::endl;
+  os << indent << "NumberOfResolutionLevels: " << m_NumberOfResolutionLevels << std::endl;
+  os << indent << "IsReadAsTiles: " << (m_IsReadAsTiles ? "On" : "Off") << std::endl;
+}
+
+LightObject::Pointer
+TIFFImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  Self * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_Compression = this->m_Compression;
+  rval->m_ColorPalette = this->m_ColorPalette;
+  rval->m_ResolutionLevel = this->m_ResolutionLevel;
+
+  return loPtr;
 }
 
 
@@ -343,10 +439,17 @@ TIFFImageIO::ReadImageInformation()
     }
   }
 
+  m_NumberOfResolutionLevels = m_InternalImage->GetNumberOfResolutionLevels();
+  if (!m_InternalImage->SetResolutionLevel(m_ResolutionLevel))
+  {
+    itkExceptionMacro(<< "Cannot read the resolution level " << m_ResolutionLevel << " of file " << this->m_FileName
+                      << ", which has " << m_NumberOfResolutionLevels << " resolution levels");
+  }
+
   ReadTIFFTags();
 
-  // if the tiff file is multi-pages
-  if (m_InternalImage->m_NumberOfPages - m_InternalImage->m_IgnoredSubFiles > 1)
+  // if the tiff file is multi-pages, and the full resolution is read
+  if (m_ResolutionLevel == 0 && m_InternalImage->m_NumberOfPages - m_InternalImage->m_IgnoredSubFiles > 1)
   {
     this->SetNumberOfDimensions(3);
     if (m_InternalImage->m_SubFiles > 0)
@@ -520,6 +623,12 @@ TIFFImageIO::ReadImageInformation()
     // make sure the palette is empty
     m_ColorPalette.resize(0);
   }
+
+  // tiled images are read tile by tile, either natively or as RGBA tiles
+  m_IsReadAsTiles = m_InternalImage->m_NumberOfTiles > 0 &&
+                    (m_InternalImage->CanRead() ||
+                     (this->GetNumberOfComponents() == 4 && m_ComponentType == IOComponentEnum::UCHAR &&
+                      m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT));
 }
 
 bool
@@ -1277,7 +1386,15 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
   const uint32 height = m_InternalImage->m_Height;
 
 
-  if (!m_InternalImage->CanRead())
+  if (m_IsReadAsTiles)
+  {
+    if (m_InternalImage->CanRead())
+    {
+      this->InitializeColors();
+    }
+    this->ReadTiles(static_cast<char *>(buffer) + pixelOffset * this->GetComponentSize());
+  }
+  else if (!m_InternalImage->CanRead())
   {
     uint32 * tempImage = nullptr;
 
@@ -1409,71 +1526,248 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
       image = out + inc * width * (height - (row + 1));
     }
 
-    switch (this->GetFormat())
+    this->PutPixels<ComponentType>(this->GetFormat(), image, buf, 0, width);
+  }
+
+  _TIFFfree(buf);
+}
+
+template <typename TComponent>
+void
+TIFFImageIO::ReadTiles(void * _out)
+{
+  using ComponentType = TComponent;
+
+  TIFF * const tiff = m_InternalImage->m_Image;
+  uint32       tileWidth = 0;
+  uint32       tileHeight = 0;
+  if (!TIFFIsTiled(tiff) || !TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &tileWidth) ||
+      !TIFFGetField(tiff, TIFFTAG_TILELENGTH, &tileHeight) || tileWidth == 0 || tileHeight == 0)
+  {
+    itkExceptionMacro(<< "The current page of " << m_FileName << " is not tiled");
+  }
+
+  const size_t width = m_InternalImage->m_Width;
+  const size_t height = m_InternalImage->m_Height;
+
+  // the region of the page to read, in the image coordinates
+  const ImageIORegion & region = this->GetIORegion();
+  size_t                regionIndex[2] = { 0, 0 };
+  size_t                regionSize[2] = { width, height };
+  if (region.GetImageDimension() >= 2)
+  {
+    for (unsigned int i = 0; i < 2; ++i)
     {
-      case TIFFImageIO::GRAYSCALE:
-        // check inverted
-        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
-        break;
-      case TIFFImageIO::RGB_:
-        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
-        break;
+      regionIndex[i] = region.GetIndex(i);
+      regionSize[i] = region.GetSize(i);
+    }
+  }
+  if (regionIndex[0] + regionSize[0] > width || regionIndex[1] + regionSize[1] > height)
+  {
+    itkExceptionMacro(<< "The region to read is outside of the image of " << m_FileName);
+  }
+
+  // tiles which cannot be read natively are read as RGBA tiles, whose rows
+  // are stored bottom up
+  const bool         isRGBA = !m_InternalImage->CanRead();
+  const bool         isBottomLeft = !isRGBA && m_InternalImage->m_Orientation == ORIENTATION_BOTLEFT;
+  const unsigned int format = isRGBA ? static_cast<unsigned int>(TIFFImageIO::OTHER) : this->GetFormat();
+  const size_t       numberOfComponents = this->GetNumberOfComponents();
+
+  // the rows of the region in the file
+  const size_t firstRow = isBottomLeft ? height - regionIndex[1] - regionSize[1] : regionIndex[1];
+  const size_t lastRow = firstRow + regionSize[1];
+  const size_t firstColumn = regionIndex[0];
+  const size_t lastColumn = firstColumn + regionSize[0];
+
+  std::vector<std::pair<uint32, uint32>> tiles;
+  for (size_t y = firstRow / tileHeight * tileHeight; y < lastRow; y += tileHeight)
+  {
+    for (size_t x = firstColumn / tileWidth * tileWidth; x < lastColumn; x += tileWidth)
+    {
+      tiles.emplace_back(static_cast<uint32>(x), static_cast<uint32>(y));
+    }
+  }
+
+  // decodes the tiles of the range with the given handle, and copies their
+  // intersection with the region
+  auto * out = static_cast<ComponentType *>(_out);
+  auto   readTiles = [&](TIFF * handle, size_t first, size_t last) -> bool {
+    const size_t               tileBytes = isRGBA ? size_t{ tileWidth } * tileHeight * sizeof(uint32)
+                                                  : static_cast<size_t>(TIFFTileSize(handle));
+    std::vector<unsigned char> tileBuffer(tileBytes);
+    for (size_t i = first; i < last; ++i)
+    {
+      const size_t x = tiles[i].first;
+      const size_t y = tiles[i].second;
+      if (isRGBA)
+      {
+        if (!TIFFReadRGBATile(handle, tiles[i].first, tiles[i].second, reinterpret_cast<uint32 *>(tileBuffer.data())))
+        {
+          return false;
+        }
+      }
+      else if (TIFFReadTile(handle, tileBuffer.data(), tiles[i].first, tiles[i].second, 0, 0) < 0)
+      {
+        return false;
+      }
+
+      const size_t columnBegin = std::max(x, firstColumn);
+      const size_t columnEnd = std::min(x + tileWidth, lastColumn);
+      const size_t rowEnd = std::min(y + tileHeight, lastRow);
+      for (size_t row = std::max(y, firstRow); row < rowEnd; ++row)
+      {
+        const size_t    imageRow = isBottomLeft ? height - 1 - row : row;
+        ComponentType * to =
+          out + ((imageRow - regionIndex[1]) * regionSize[0] + columnBegin - firstColumn) * numberOfComponents;
+        const size_t tileRow = row - y;
+        if (isRGBA)
+        {
+          const uint32 * from = reinterpret_cast<const uint32 *>(tileBuffer.data()) +
+                                (tileHeight - 1 - tileRow) * tileWidth + columnBegin - x;
+          for (size_t column = columnBegin; column < columnEnd; ++column, ++from)
+          {
+            *(to++) = static_cast<ComponentType>(TIFFGetR(*from));
+            *(to++) = static_cast<ComponentType>(TIFFGetG(*from));
+            *(to++) = static_cast<ComponentType>(TIFFGetB(*from));
+            *(to++) = static_cast<ComponentType>(TIFFGetA(*from));
+          }
+        }
+        else
+        {
+          this->PutPixels<ComponentType>(format,
+                                         to,
+                                         tileBuffer.data(),
+                                         tileRow * tileWidth + columnBegin - x,
+                                         static_cast<unsigned int>(columnEnd - columnBegin));
+        }
+      }
+    }
+    return true;
+  };
+
+  // The tiles are decoded concurrently, in contiguous ranges, each work unit
+  // having its own handle on the file since libtiff handles are not thread
+  // safe.
+  const MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  const size_t                     numberOfRanges =
+    std::min(tiles.size(), static_cast<size_t>(multiThreader->GetNumberOfWorkUnits()));
+  if (numberOfRanges <= 1)
+  {
+    if (!readTiles(tiff, 0, tiles.size()))
+    {
+      itkExceptionMacro(<< "Cannot read the tiles of " << m_FileName);
+    }
+    return;
+  }
+
+  const toff_t               directoryOffset = TIFFCurrentDirOffset(tiff);
+  std::vector<unsigned char> succeeded(numberOfRanges, 0);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfRanges,
+    [&](SizeValueType i) {
+      TIFF * handle = TIFFOpen(m_FileName.c_str(), "r");
+      if (handle == nullptr)
+      {
+        return;
+      }
+      if (TIFFSetSubDirectory(handle, directoryOffset))
+      {
+        try
+        {
+          succeeded[i] = readTiles(handle, i * tiles.size() / numberOfRanges, (i + 1) * tiles.size() / numberOfRanges);
+        }
+        catch (...)
+        {
+        }
+      }
+      TIFFClose(handle);
+    },
+    nullptr);
+  if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end())
+  {
+    itkExceptionMacro(<< "Cannot read the tiles of " << m_FileName);
+  }
+}
+
+template <typename TComponent>
+void
+TIFFImageIO::PutPixels(unsigned int format, TComponent * to, void * from, size_t fromPixelOffset, unsigned int xsize)
+{
+  using ComponentType = TComponent;
 
-      case TIFFImageIO::PALETTE_GRAYSCALE:
+  switch (format)
+  {
+    case TIFFImageIO::GRAYSCALE:
+      // check inverted
+      PutGrayscale<ComponentType>(to, static_cast<ComponentType *>(from) + fromPixelOffset, xsize, 1, 0, 0);
+      break;
+    case TIFFImageIO::RGB_:
+      PutRGB_<ComponentType>(to,
+                             static_cast<ComponentType *>(from) + fromPixelOffset * m_InternalImage->m_SamplesPerPixel,
+                             xsize,
+                             1,
+                             0,
+                             0);
+      break;
+
+    case TIFFImageIO::PALETTE_GRAYSCALE:
+      switch (m_InternalImage->m_BitsPerSample)
+      {
+        case 8:
+          PutPaletteGrayscale<ComponentType, unsigned char>(
+            to, static_cast<unsigned char *>(from) + fromPixelOffset, xsize, 1, 0, 0);
+          break;
+        case 16:
+          PutPaletteGrayscale<ComponentType, unsigned short>(
+            to, static_cast<unsigned short *>(from) + fromPixelOffset, xsize, 1, 0, 0);
+          break;
+        default:
+          itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
+                            << "-bit samples with palette.");
+      }
+      break;
+    case TIFFImageIO::PALETTE_RGB:
+      if (!this->GetIsReadAsScalarPlusPalette())
+      {
         switch (m_InternalImage->m_BitsPerSample)
         {
           case 8:
-            PutPaletteGrayscale<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+            PutPaletteRGB<ComponentType, unsigned char>(
+              to, static_cast<unsigned char *>(from) + fromPixelOffset, xsize, 1, 0, 0);
             break;
           case 16:
-            PutPaletteGrayscale<ComponentType, unsigned short>(
-              image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+            PutPaletteRGB<ComponentType, unsigned short>(
+              to, static_cast<unsigned short *>(from) + fromPixelOffset, xsize, 1, 0, 0);
             break;
           default:
             itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
                               << "-bit samples with palette.");
         }
-        break;
-      case TIFFImageIO::PALETTE_RGB:
-        if (!this->GetIsReadAsScalarPlusPalette())
-        {
-          switch (m_InternalImage->m_BitsPerSample)
-          {
-            case 8:
-              PutPaletteRGB<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
-              break;
-            case 16:
-              PutPaletteRGB<ComponentType, unsigned short>(image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
-              break;
-            default:
-              itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
-                                << "-bit samples with palette.");
-          }
-        }
-        else
+      }
+      else
+      {
+        switch (m_InternalImage->m_BitsPerSample)
         {
-          switch (m_InternalImage->m_BitsPerSample)
-          {
-            case 8:
-              PutPaletteScalar<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
-              break;
-            case 16:
-              PutPaletteScalar<ComponentType, unsigned short>(
-                image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
-              break;
-            default:
-              itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
-                                << "-bit samples with palette.");
-          }
+          case 8:
+            PutPaletteScalar<ComponentType, unsigned char>(
+              to, static_cast<unsigned char *>(from) + fromPixelOffset, xsize, 1, 0, 0);
+            break;
+          case 16:
+            PutPaletteScalar<ComponentType, unsigned short>(
+              to, static_cast<unsigned short *>(from) + fromPixelOffset, xsize, 1, 0, 0);
+            break;
+          default:
+            itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
+                              << "-bit samples with palette.");
         }
-        break;
+      }
+      break;
 
-      default:
-        itkExceptionMacro("Logic Error: Unexpected format!");
-    }
+    default:
+      itkExceptionMacro("Logic Error: Unexpected format!");
   }
-
-  _TIFFfree(buf);
 }
 
 // iso component scalar
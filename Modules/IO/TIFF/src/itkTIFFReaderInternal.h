@@ -21,6 +21,7 @@
 #include "ITKIOTIFFExport.h"
 #include "itkIntTypes.h"
 #include "itk_tiff.h"
+#include <vector>
 
 
 namespace itk
@@ -42,6 +43,17 @@ public:
   int
   Open(const char * filename);
 
+  /** Number of resolution levels of the image: the full resolution image of
+   * the first directory, followed by its reduced resolution versions, stored
+   * as SubIFDs of the first directory or as reduced resolution subfiles. */
+  unsigned int
+  GetNumberOfResolutionLevels() const;
+
+  /** Make the directory of the given resolution level the current one.
+   * Returns 0 if it cannot be read. */
+  int
+  SetResolutionLevel(unsigned int level);
+
   TIFF *   m_Image;
   bool     m_IsOpen;
   uint32_t m_Width;
@@ -66,6 +78,14 @@ public:
   float    m_XResolution;
   float    m_YResolution;
   uint16_t m_SampleFormat;
+
+  unsigned int          m_ResolutionLevel;
+  std::vector<uint64_t> m_SubIFDOffsets;
+  std::vector<uint16_t> m_ReducedResolutionPages;
+
+private:
+  int
+  InitializeDirectory();
 };
 
 } // namespace itk
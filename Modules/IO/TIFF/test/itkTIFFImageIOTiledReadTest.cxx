@@ -0,0 +1,340 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTIFFImageIO.h"
+#include "itkTestingMacros.h"
+#include "itk_tiff.h"
+
+#include <vector>
+
+namespace
+{
+constexpr uint32 TileSize = 16;
+
+// The value of a sample of a page of the test files, the page being either a
+// resolution level or a slice.
+unsigned int
+SampleValue(unsigned int page, size_t x, size_t y, unsigned int sample)
+{
+  return static_cast<unsigned int>(x * 3 + y * 7 + sample * 11 + page * 50);
+}
+
+// Writes a tiled page whose samples are given by SampleValue.
+template <typename TComponent>
+void
+WriteTiledPage(TIFF *       tiff,
+               unsigned int page,
+               uint32       width,
+               uint32       height,
+               uint16       samplesPerPixel,
+               uint16       orientation,
+               uint32       subfileType)
+{
+  TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, subfileType);
+  TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, width);
+  TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, height);
+  TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, static_cast<uint16>(8 * sizeof(TComponent)));
+  TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, samplesPerPixel);
+  TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, samplesPerPixel == 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK);
+  TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  TIFFSetField(tiff, TIFFTAG_ORIENTATION, orientation);
+  TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_DEFLATE);
+  TIFFSetField(tiff, TIFFTAG_TILEWIDTH, TileSize);
+  TIFFSetField(tiff, TIFFTAG_TILELENGTH, TileSize);
+  if (samplesPerPixel == 2)
+  {
+    // gray and alpha, which are read as RGBA
+    const uint16 extraSample = EXTRASAMPLE_ASSOCALPHA;
+    TIFFSetField(tiff, TIFFTAG_EXTRASAMPLES, 1, &extraSample);
+  }
+
+  std::vector<TComponent> tile(TileSize * TileSize * samplesPerPixel);
+  for (uint32 y = 0; y < height; y += TileSize)
+  {
+    for (uint32 x = 0; x < width; x += TileSize)
+    {
+      auto * sample = tile.data();
+      for (uint32 row = y; row < y + TileSize; ++row)
+      {
+        const size_t imageRow = orientation == ORIENTATION_BOTLEFT ? height - 1 - row : row;
+        for (uint32 column = x; column < x + TileSize; ++column)
+        {
+          for (unsigned int s = 0; s < samplesPerPixel; ++s)
+          {
+            *(sample++) = static_cast<TComponent>(SampleValue(page, column, imageRow, s));
+          }
+        }
+      }
+      TIFFWriteTile(tiff, tile.data(), x, y, 0, 0);
+    }
+  }
+  TIFFWriteDirectory(tiff);
+}
+
+// Checks the components of a region of a page, given the samples per pixel
+// of the file.
+template <typename TComponent>
+bool
+CheckRegion(const TComponent *          buffer,
+            unsigned int                page,
+            const itk::ImageRegion<2> & region,
+            unsigned int                numberOfComponents,
+            uint16                      samplesPerPixel,
+            const std::string &         description)
+{
+  for (size_t y = 0; y < region.GetSize(1); ++y)
+  {
+    for (size_t x = 0; x < region.GetSize(0); ++x)
+    {
+      const size_t imageX = region.GetIndex(0) + x;
+      const size_t imageY = region.GetIndex(1) + y;
+      for (unsigned int c = 0; c < numberOfComponents; ++c, ++buffer)
+      {
+        // gray and alpha samples are read as RGBA components
+        const unsigned int sample = samplesPerPixel == 2 ? (c == 3 ? 1 : 0) : c;
+        const auto         expected = static_cast<TComponent>(SampleValue(page, imageX, imageY, sample));
+        if (*buffer != expected)
+        {
+          std::cerr << description << ": component " << c << " of pixel [" << imageX << ", " << imageY
+                    << "] of page " << page << " read as " << static_cast<double>(*buffer) << " instead of "
+                    << static_cast<double>(expected) << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Reads the whole image and a region of the given resolution level of the
+// file with TIFFImageIO.
+template <typename TComponent>
+int
+ReadLevel(const std::string & fileName,
+          unsigned int        level,
+          uint32              width,
+          uint32              height,
+          unsigned int        numberOfComponents,
+          uint16              samplesPerPixel)
+{
+  auto tiffImageIO = itk::TIFFImageIO::New();
+  tiffImageIO->SetFileName(fileName);
+  tiffImageIO->SetResolutionLevel(level);
+  ITK_TRY_EXPECT_NO_EXCEPTION(tiffImageIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(tiffImageIO->GetNumberOfDimensions(), 2);
+  ITK_TEST_EXPECT_EQUAL(tiffImageIO->GetDimensions(0), width);
+  ITK_TEST_EXPECT_EQUAL(tiffImageIO->GetDimensions(1), height);
+  ITK_TEST_EXPECT_EQUAL(tiffImageIO->GetNumberOfComponents(), numberOfComponents);
+  ITK_TEST_EXPECT_EQUAL(tiffImageIO->GetComponentSize(), sizeof(TComponent));
+  ITK_TEST_EXPECT_TRUE(tiffImageIO->CanStreamRead());
+
+  // the whole image, and a region which is not aligned on the tiles
+  const itk::ImageRegion<2> largestRegion({ { 0, 0 } }, { { width, height } });
+  const itk::ImageRegion<2> region({ { 3, height / 3 } }, { { width - 5, height / 2 } });
+  bool                      passed = true;
+  for (const itk::ImageRegion<2> & readRegion : { largestRegion, region })
+  {
+    itk::ImageIORegion ioRegion(2);
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      ioRegion.SetIndex(i, readRegion.GetIndex(i));
+      ioRegion.SetSize(i, readRegion.GetSize(i));
+    }
+    tiffImageIO->SetIORegion(ioRegion);
+    std::vector<TComponent> buffer(readRegion.GetNumberOfPixels() * numberOfComponents);
+    ITK_TRY_EXPECT_NO_EXCEPTION(tiffImageIO->Read(buffer.data()));
+    if (!CheckRegion<TComponent>(buffer.data(), level, readRegion, numberOfComponents, samplesPerPixel, fileName))
+    {
+      passed = false;
+    }
+  }
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Writes a single page tiled file, and reads it back.
+template <typename TComponent>
+int
+TiledReadTest(const std::string & fileName,
+              uint32              width,
+              uint32              height,
+              uint16              samplesPerPixel,
+              uint16              orientation,
+              unsigned int        numberOfComponents)
+{
+  TIFF * tiff = TIFFOpen(fileName.c_str(), "w");
+  ITK_TEST_EXPECT_TRUE(tiff != nullptr);
+  WriteTiledPage<TComponent>(tiff, 0, width, height, samplesPerPixel, orientation, 0);
+  TIFFClose(tiff);
+
+  return ReadLevel<TComponent>(fileName, 0, width, height, numberOfComponents, samplesPerPixel);
+}
+
+// Writes a pyramidal file, whose reduced resolution levels are either SubIFDs
+// or reduced resolution pages, and reads its levels back.
+int
+PyramidReadTest(const std::string & fileName, bool useSubIFDs)
+{
+  constexpr unsigned int numberOfLevels = 3;
+  const uint32           widths[numberOfLevels] = { 90, 45, 23 };
+  const uint32           heights[numberOfLevels] = { 70, 35, 18 };
+
+  TIFF * tiff = TIFFOpen(fileName.c_str(), "w");
+  ITK_TEST_EXPECT_TRUE(tiff != nullptr);
+  if (useSubIFDs)
+  {
+    // the offsets of the SubIFDs are filled when they are written
+    toff_t subIFDOffsets[numberOfLevels - 1] = { 0, 0 };
+    TIFFSetField(tiff, TIFFTAG_SUBIFD, numberOfLevels - 1, subIFDOffsets);
+  }
+  WriteTiledPage<unsigned char>(tiff, 0, widths[0], heights[0], 1, ORIENTATION_TOPLEFT, 0);
+  for (unsigned int level = 1; level < numberOfLevels; ++level)
+  {
+    WriteTiledPage<unsigned char>(
+      tiff, level, widths[level], heights[level], 1, ORIENTATION_TOPLEFT, FILETYPE_REDUCEDIMAGE);
+  }
+  TIFFClose(tiff);
+
+  auto tiffImageIO = itk::TIFFImageIO::New();
+  tiffImageIO->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(tiffImageIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(tiffImageIO->GetNumberOfResolutionLevels(), numberOfLevels);
+
+  int result = EXIT_SUCCESS;
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    if (ReadLevel<unsigned char>(fileName, level, widths[level], heights[level], 1, 1) != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  tiffImageIO->SetResolutionLevel(numberOfLevels);
+  ITK_TRY_EXPECT_EXCEPTION(tiffImageIO->ReadImageInformation());
+
+  // the reduced resolution levels are also streamed by the reader
+  using ImageType = itk::Image<unsigned char, 2>;
+  auto streamingImageIO = itk::TIFFImageIO::New();
+  streamingImageIO->SetResolutionLevel(1);
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(streamingImageIO);
+  reader->SetUseStreaming(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->UpdateOutputInformation());
+  const ImageType::RegionType region({ { 20, 5 } }, { { 17, 20 } });
+  reader->GetOutput()->SetRequestedRegion(region);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+  if (!CheckRegion<unsigned char>(reader->GetOutput()->GetBufferPointer(), 1, region, 1, 1, fileName))
+  {
+    result = EXIT_FAILURE;
+  }
+  return result;
+}
+
+// Writes a multi-page tiled file, and streams a region of its volume.
+int
+VolumeStreamingTest(const std::string & fileName)
+{
+  constexpr unsigned int numberOfSlices = 4;
+  constexpr uint32       width = 40;
+  constexpr uint32       height = 33;
+
+  TIFF * tiff = TIFFOpen(fileName.c_str(), "w");
+  ITK_TEST_EXPECT_TRUE(tiff != nullptr);
+  for (unsigned int slice = 0; slice < numberOfSlices; ++slice)
+  {
+    WriteTiledPage<unsigned short>(tiff, slice, width, height, 1, ORIENTATION_TOPLEFT, 0);
+  }
+  TIFFClose(tiff);
+
+  using ImageType = itk::Image<unsigned short, 3>;
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::TIFFImageIO::New());
+  reader->SetUseStreaming(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->UpdateOutputInformation());
+  const ImageType::RegionType region({ { 9, 4, 1 } }, { { 25, 20, 2 } });
+  reader->GetOutput()->SetRequestedRegion(region);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(reader->GetOutput(), region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    const auto                 expected = static_cast<unsigned short>(SampleValue(index[2], index[0], index[1], 0));
+    if (it.Get() != expected)
+    {
+      std::cerr << "Pixel " << index << " read as " << it.Get() << " instead of " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkTIFFImageIOTiledReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto tiffImageIO = itk::TIFFImageIO::New();
+  ITK_TEST_SET_GET_VALUE(0, tiffImageIO->GetResolutionLevel());
+  ITK_TEST_SET_GET_VALUE(1, tiffImageIO->GetNumberOfResolutionLevels());
+  tiffImageIO->SetResolutionLevel(2);
+  ITK_TEST_SET_GET_VALUE(2, tiffImageIO->GetResolutionLevel());
+
+  const std::string prefix = std::string(argv[1]) + "/itkTIFFImageIOTiledReadTest";
+  int               result = EXIT_SUCCESS;
+  const int         results[] = {
+    TiledReadTest<unsigned char>(prefix + "UChar.tif", 75, 41, 1, ORIENTATION_TOPLEFT, 1),
+    TiledReadTest<unsigned short>(prefix + "UShortBottomLeft.tif", 75, 41, 1, ORIENTATION_BOTLEFT, 1),
+    TiledReadTest<unsigned char>(prefix + "RGB.tif", 75, 41, 3, ORIENTATION_TOPLEFT, 3),
+    // tiles which are not read natively are read as RGBA tiles, the width
+    // being a multiple of the tile width since libtiff does not convert the
+    // horizontally clipped tiles of gray and alpha images
+    TiledReadTest<unsigned char>(prefix + "GrayAlpha.tif", 80, 41, 2, ORIENTATION_TOPLEFT, 4),
+    PyramidReadTest(prefix + "SubIFDs.tif", true),
+    PyramidReadTest(prefix + "ReducedPages.tif", false),
+    VolumeStreamingTest(prefix + "Volume.tif")
+  };
+  for (const int r : results)
+  {
+    if (r != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
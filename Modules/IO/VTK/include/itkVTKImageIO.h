@@ -92,6 +92,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Determine if the pixels of the IORegion can be mapped in memory. They
+   * can only be if the file is binary and its big endian components do not
+   * need to be swapped, and if the pixels are not symmetric tensors. */
+  bool
+  CanMapRead(std::string & dataFileName, SizeType & dataPosition) const override;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
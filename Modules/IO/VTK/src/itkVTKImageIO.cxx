@@ -516,6 +516,22 @@ VTKImageIO::ReadSymmetricTensorBufferAsBinary(std::istream & is, void * buffer,
   }
 }
 
+bool
+VTKImageIO::CanMapRead(std::string & dataFileName, SizeType & dataPosition) const
+{
+  SizeType regionOffset = 0;
+  if (m_FileType != IOFileEnum::Binary || this->GetHeaderSize() == 0 ||
+      this->GetPixelType() == IOPixelEnum::SYMMETRICSECONDRANKTENSOR ||
+      (this->GetComponentSize() > 1 && !ByteSwapper<uint16_t>::SystemIsBigEndian()) ||
+      !this->ComputeContiguousIORegionOffset(regionOffset))
+  {
+    return false;
+  }
+  dataFileName = m_FileName;
+  dataPosition = this->GetHeaderSize() + regionOffset;
+  return true;
+}
+
 void
 VTKImageIO::Read(void * buffer)
 {
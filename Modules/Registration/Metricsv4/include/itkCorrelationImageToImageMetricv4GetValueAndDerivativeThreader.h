@@ -70,6 +70,8 @@ public:
 
   using InternalComputationValueType = typename Superclass::InternalComputationValueType;
   using NumberOfParametersType = typename Superclass::NumberOfParametersType;
+  using MovingBSplineWeightsValueType = typename Superclass::MovingBSplineWeightsValueType;
+  using MovingBSplineParameterIndexValueType = typename Superclass::MovingBSplineParameterIndexValueType;
 
 protected:
   CorrelationImageToImageMetricv4GetValueAndDerivativeThreader();
@@ -223,8 +223,8 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
 
   try
   {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateMovingPoint(
-      virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+    pointIsValid =
+      this->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue, threadId);
     if (pointIsValid && this->m_CorrelationAssociate->GetComputeDerivative() &&
         this->m_CorrelationAssociate->GetGradientSourceIncludesMoving())
     {
@@ -313,6 +313,29 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
 
   if (this->m_CorrelationAssociate->GetComputeDerivative())
   {
+    /* The derivatives of the parameters outside of the support region of the
+     * point of a B-spline transform are zero. */
+    const MovingBSplineWeightsValueType *        bsplineWeights;
+    const MovingBSplineParameterIndexValueType * bsplineIndices;
+    SizeValueType                                numberOfBSplineWeights;
+    if (this->GetMovingBSplineJacobianWeights(bsplineWeights, bsplineIndices, numberOfBSplineWeights, threadId))
+    {
+      const MovingImageGradientType bsplineImageGradient = this->GetMovingBSplineImageGradient(movingImageGradient);
+      const NumberOfParametersType  numberOfParametersPerDimension =
+        this->m_CorrelationAssociate->GetNumberOfLocalParameters() / ImageToImageMetricv4Type::MovingImageDimension;
+      for (SizeValueType k = 0; k < numberOfBSplineWeights; ++k)
+      {
+        for (SizeValueType dim = 0; dim < ImageToImageMetricv4Type::MovingImageDimension; dim++)
+        {
+          const NumberOfParametersType       par = bsplineIndices[k] + dim * numberOfParametersPerDimension;
+          const InternalComputationValueType sum = bsplineImageGradient[dim] * bsplineWeights[k];
+          cumsum.fdm[par] += f1 * sum;
+          cumsum.mdm[par] += m1 * sum;
+        }
+      }
+      return true;
+    }
+
     /* Use a pre-allocated jacobian object for efficiency */
     using JacobianReferenceType = typename TImageToImageMetric::JacobianType &;
     JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
@@ -320,8 +343,7 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
       this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
 
     /** For dense transforms, this returns identity */
-    this->m_CorrelationAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
-      virtualPoint, jacobian, jacobianPositional);
+    this->ComputeMovingTransformJacobian(virtualPoint, jacobian, jacobianPositional, threadId);
 
     for (unsigned int par = 0; par < this->m_CorrelationAssociate->GetNumberOfLocalParameters(); par++)
     {
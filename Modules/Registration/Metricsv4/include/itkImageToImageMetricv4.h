@@ -466,6 +466,20 @@ public:
   itkGetConstReferenceMacro(UseFixedImageGradientFilter, bool);
   itkBooleanMacro(UseFixedImageGradientFilter);
 
+  /** Set/Get a gradient image of the fixed image computed beforehand, e.g.
+   * by an ImageRegistrationFixedImagePyramid, which is used instead of the
+   * output of the fixed image gradient filter. */
+  itkSetConstObjectMacro(PrecomputedFixedImageGradientImage, FixedImageGradientImageType);
+  itkGetConstObjectMacro(PrecomputedFixedImageGradientImage, FixedImageGradientImageType);
+
+  /** Get whether the fixed image gradient filter is the default one, i.e. no
+   * other filter has been set. */
+  bool
+  GetFixedImageGradientFilterIsDefault() const
+  {
+    return this->m_FixedImageGradientFilter.GetPointer() == this->m_DefaultFixedImageGradientFilter.GetPointer();
+  }
+
   /** Set/Get gradient computation via an image filter. */
   itkSetMacro(UseMovingImageGradientFilter, bool);
   itkGetConstReferenceMacro(UseMovingImageGradientFilter, bool);
@@ -659,6 +673,13 @@ protected:
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const;
 
+  /** Evaluate a point of the MovingImage domain, mapped from the VirtualImage
+   * domain by the moving transform, as TransformAndEvaluateMovingPoint does
+   * once the point is mapped. */
+  bool
+  EvaluateMappedMovingPoint(const MovingImagePointType & mappedMovingPoint,
+                            MovingImagePixelType &       mappedMovingPixelValue) const;
+
   /** Compute image derivatives for a Fixed point. */
   virtual void
   ComputeFixedImageGradientAtPoint(const FixedImagePointType & mappedPoint, FixedImageGradientType & gradient) const;
@@ -730,6 +751,8 @@ protected:
   mutable FixedImageGradientImagePointer  m_FixedImageGradientImage;
   mutable MovingImageGradientImagePointer m_MovingImageGradientImage;
 
+  typename FixedImageGradientImageType::ConstPointer m_PrecomputedFixedImageGradientImage;
+
   /** Image gradient calculators */
   FixedImageGradientCalculatorPointer  m_FixedImageGradientCalculator;
   MovingImageGradientCalculatorPointer m_MovingImageGradientCalculator;
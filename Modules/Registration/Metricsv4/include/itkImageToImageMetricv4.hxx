@@ -355,9 +355,6 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const
 {
-  bool pointIsValid = true;
-  mappedMovingPixelValue = NumericTraits<MovingImagePixelType>::ZeroValue();
-
   // map the point into moving space
 
   // Before transforming points, we should convert their types from the ImagePointType (aka Point<double, dim>)
@@ -371,6 +368,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   localMappedMovingPoint = this->m_MovingTransform->TransformPoint(localVirtualPoint);
   mappedMovingPoint.CastFrom(localMappedMovingPoint);
 
+  return this->EvaluateMappedMovingPoint(mappedMovingPoint, mappedMovingPixelValue);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  EvaluateMappedMovingPoint(const MovingImagePointType & mappedMovingPoint,
+                            MovingImagePixelType &       mappedMovingPixelValue) const
+{
+  bool pointIsValid = true;
+  mappedMovingPixelValue = NumericTraits<MovingImagePixelType>::ZeroValue();
+
   // check against the mask if one is assigned
   if (this->m_MovingImageMask)
   {
@@ -456,9 +469,18 @@ void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   ComputeFixedImageGradientFilterImage()
 {
-  this->m_FixedImageGradientFilter->SetInput(this->m_FixedImage);
-  this->m_FixedImageGradientFilter->Update();
-  this->m_FixedImageGradientImage = this->m_FixedImageGradientFilter->GetOutput();
+  if (this->m_PrecomputedFixedImageGradientImage)
+  {
+    // The gradient image is only read, by the interpolator and the threaders.
+    this->m_FixedImageGradientImage =
+      const_cast<FixedImageGradientImageType *>(this->m_PrecomputedFixedImageGradientImage.GetPointer());
+  }
+  else
+  {
+    this->m_FixedImageGradientFilter->SetInput(this->m_FixedImage);
+    this->m_FixedImageGradientFilter->Update();
+    this->m_FixedImageGradientImage = this->m_FixedImageGradientFilter->GetOutput();
+  }
   this->m_FixedImageGradientInterpolator->SetInputImage(this->m_FixedImageGradientImage);
 }
 
@@ -682,6 +704,7 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   itkPrintSelfObjectMacro(MovingTransform);
   itkPrintSelfObjectMacro(FixedImageMask);
   itkPrintSelfObjectMacro(MovingImageMask);
+  itkPrintSelfObjectMacro(PrecomputedFixedImageGradientImage);
 }
 
 } // namespace itk
@@ -104,8 +104,8 @@ protected:
   /** Constructor. */
   ImageToImageMetricv4GetValueAndDerivativeThreader() = default;
 
-  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoint on every
-   * point. */
+  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoints on
+   * every block of points. */
   void
   ThreadedExecution(const DomainType & subdomain, const ThreadIdType threadId) override;
 
@@ -180,8 +180,8 @@ protected:
   /** Constructor. */
   ImageToImageMetricv4GetValueAndDerivativeThreader() = default;
 
-  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoint on every
-   * point. */
+  /** Walk through the given range of the sampled point set, and call \c
+   * ProcessVirtualSampledPoints on every block of points. */
   void
   ThreadedExecution(const DomainType & subdomain, const ThreadIdType threadId) override;
 
@@ -32,12 +32,22 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<
 {
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
   using IteratorType = ImageRegionConstIteratorWithIndex<VirtualImageType>;
-  VirtualPointType virtualPoint;
+  VirtualIndexType virtualIndices[Superclass::VirtualPointsBlockSize];
+  VirtualPointType virtualPoints[Superclass::VirtualPointsBlockSize];
+  SizeValueType    numberOfPoints = 0;
   for (IteratorType it(virtualImage, imageSubRegion); !it.IsAtEnd(); ++it)
   {
-    const VirtualIndexType & virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    virtualIndices[numberOfPoints] = it.GetIndex();
+    virtualImage->TransformIndexToPhysicalPoint(virtualIndices[numberOfPoints], virtualPoints[numberOfPoints]);
+    if (++numberOfPoints == Superclass::VirtualPointsBlockSize)
+    {
+      this->ProcessVirtualPoints(virtualIndices, virtualPoints, numberOfPoints, threadId);
+      numberOfPoints = 0;
+    }
+  }
+  if (numberOfPoints > 0)
+  {
+    this->ProcessVirtualPoints(virtualIndices, virtualPoints, numberOfPoints, threadId);
   }
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
@@ -54,11 +64,24 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<ThreadedIndexedContainerPartit
   const ElementIdentifierType             begin = indexSubRange[0];
   const ElementIdentifierType             end = indexSubRange[1];
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
+  VirtualIndexType                        virtualIndices[Superclass::VirtualPointsBlockSize];
+  VirtualPointType                        virtualPoints[Superclass::VirtualPointsBlockSize];
+  SizeValueType                           numberOfPoints = 0;
   for (ElementIdentifierType i = begin; i <= end; ++i)
   {
-    const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint(i);
-    const auto               virtualIndex = virtualImage->TransformPhysicalPointToIndex(virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    virtualPoints[numberOfPoints] = virtualSampledPointSet->GetPoint(i);
+    virtualIndices[numberOfPoints] = virtualImage->TransformPhysicalPointToIndex(virtualPoints[numberOfPoints]);
+    if (++numberOfPoints == Superclass::VirtualPointsBlockSize)
+    {
+      this->ProcessVirtualSampledPoints(
+        virtualIndices, virtualPoints, numberOfPoints, i + 1 - numberOfPoints, threadId);
+      numberOfPoints = 0;
+    }
+  }
+  if (numberOfPoints > 0)
+  {
+    this->ProcessVirtualSampledPoints(
+      virtualIndices, virtualPoints, numberOfPoints, end + 1 - numberOfPoints, threadId);
   }
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
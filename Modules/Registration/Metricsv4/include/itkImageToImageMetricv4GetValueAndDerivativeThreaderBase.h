@@ -20,6 +20,10 @@
 
 #include "itkDomainThreader.h"
 #include "itkCompensatedSummation.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+
+#include <memory>
 
 namespace itk
 {
@@ -36,9 +40,47 @@ namespace itk
  *
  *  The \c ThreadedExecution in
  *  ImageToImageMetricv4GetValueAndDerivativeThreader calls \c
- *  ProcessVirtualPoint on every point in the virtual image domain.  \c
+ *  ProcessVirtualPoints on blocks of points of the virtual image domain,
+ *  which calls \c ProcessVirtualPoint on each point.  \c
  *  ProcessVirtualPoint calls \c ProcessPoint on each point.
  *
+ *  When the moving transform is a cubic B-spline transform, the points of a
+ *  block are mapped together by its \c TransformPoints, which also gives the
+ *  weights of the non-zero entries of their Jacobians. The moving points of
+ *  \c TransformAndEvaluateMovingPoint, and the Jacobians of \c
+ *  ComputeMovingTransformJacobian, are then taken from the block, instead of
+ *  being computed by the transform for each point. This is also the case
+ *  when the moving transform is a CompositeTransform, as set up by
+ *  ImageRegistrationMethodv4, whose only optimized transform is a cubic
+ *  B-spline transform, added last so that it is the first one applied to the
+ *  points, and whose other transforms are linear: the points mapped by the
+ *  B-spline transform are then mapped by the linear transforms.
+ *
+ *  When the metric is evaluated on its sampled point set, and the derived
+ *  class enables it with \c GetUseSampleCache, the values of the samples
+ *  which do not change between evaluations are cached the first time the
+ *  samples are processed: the mapped fixed points and their values, and the
+ *  weights and parameter indices of the Jacobians of a moving cubic
+ *  BSplineTransform, whose moving points are then computed from the cached
+ *  weights. The weights of the B-spline transform of a composite moving
+ *  transform are cached too: they only depend on the virtual points, to which
+ *  it is applied first, and on its grid, the linear transforms which follow
+ *  it being applied at each evaluation. The cache is computed again when the
+ *  sampled point set, the fixed image, the fixed transform, the fixed
+ *  interpolator, the fixed image mask, the moving transform or the grid of
+ *  its B-spline transform change.
+ *
+ *  For global transforms, the derivatives accumulated by each thread are
+ *  stored by blocks of parameters, allocated when first accumulated into, and
+ *  \c AfterThreadedExecution sums the blocks of the threads concurrently,
+ *  each block of the result being written by a single thread. The points of a
+ *  B-spline transform only accumulate into the parameters of their support
+ *  regions, so that each thread only allocates and sums the blocks of the part
+ *  of the grid its points are in. The supports are the ones of the B-spline
+ *  transform whose points are mapped by blocks, which is also the optimized
+ *  B-spline transform of a composite moving transform, whose parameters are
+ *  the ones of the composite transform.
+ *
  * \ingroup ITKMetricsv4 */
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
 class ITK_TEMPLATE_EXPORT ImageToImageMetricv4GetValueAndDerivativeThreaderBase
@@ -77,6 +119,24 @@ public:
   using MovingTransformType = typename ImageToImageMetricv4Type::MovingTransformType;
   using MovingOutputPointType = typename MovingTransformType::OutputPointType;
 
+  /** Type of the moving transforms whose points are mapped by blocks. */
+  using MovingBSplineTransformType = BSplineBaseTransform<typename MovingTransformType::ParametersValueType,
+                                                          TImageToImageMetricv4::MovingImageDimension,
+                                                          3>;
+  using MovingBSplineInputPointType = typename MovingBSplineTransformType::InputPointType;
+  using MovingBSplineWeightsValueType = typename MovingBSplineTransformType::WeightsValueType;
+  using MovingBSplineParameterIndexValueType = typename MovingBSplineTransformType::ParameterIndexValueType;
+
+  /** Type of the composite moving transforms whose B-spline transform maps
+   * the points by blocks. */
+  using MovingCompositeTransformType =
+    CompositeTransform<typename MovingTransformType::ParametersValueType, TImageToImageMetricv4::MovingImageDimension>;
+
+  /** Type of the moving transforms whose weights are cached with the samples. */
+  using MovingBSplineCachedTransformType = BSplineTransform<typename MovingTransformType::ParametersValueType,
+                                                            TImageToImageMetricv4::MovingImageDimension,
+                                                            3>;
+
   using MeasureType = typename ImageToImageMetricv4Type::MeasureType;
   using DerivativeType = typename ImageToImageMetricv4Type::DerivativeType;
   using DerivativeValueType = typename ImageToImageMetricv4Type::DerivativeValueType;
@@ -120,6 +180,97 @@ protected:
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId);
 
+  /** Number of virtual points processed together by \c ProcessVirtualPoints. */
+  static constexpr SizeValueType VirtualPointsBlockSize = 64;
+
+  /** Method called by the threaders to process a block of at most
+   * VirtualPointsBlockSize virtual points, which calls \c ProcessVirtualPoint
+   * on each of them, after having mapped them together when the moving
+   * transform is a cubic B-spline transform. */
+  void
+  ProcessVirtualPoints(const VirtualIndexType * virtualIndices,
+                       const VirtualPointType * virtualPoints,
+                       SizeValueType            numberOfPoints,
+                       const ThreadIdType       threadId);
+
+  /** Method called by the sparse threader to process a block of at most
+   * VirtualPointsBlockSize consecutive samples of the sampled point set of
+   * the metric, the first one being firstSample. It calls \c
+   * ProcessVirtualPoints, unless the samples are cached, in which case the
+   * values of the samples are taken from the cache, or stored into it if
+   * they have not been computed yet. */
+  void
+  ProcessVirtualSampledPoints(const VirtualIndexType * virtualIndices,
+                              const VirtualPointType * virtualPoints,
+                              SizeValueType            numberOfPoints,
+                              SizeValueType            firstSample,
+                              const ThreadIdType       threadId);
+
+  /** Get whether the values of the samples of the sampled point set of the
+   * metric which do not change between its evaluations are cached. Derived
+   * classes enable it, the Jacobians of a B-spline transform being taken
+   * from the cache. Defaults to false. */
+  virtual bool
+  GetUseSampleCache() const
+  {
+    return false;
+  }
+
+  /** Transform a point from the virtual domain to the moving image domain
+   * and evaluate it, as the TransformAndEvaluateMovingPoint of the metric
+   * does, with the point mapped by \c ProcessVirtualPoints if the thread is
+   * processing a block of points of a B-spline transform. */
+  bool
+  TransformAndEvaluateMovingPoint(const VirtualPointType & virtualPoint,
+                                  MovingImagePointType &   mappedMovingPoint,
+                                  MovingImagePixelType &   mappedMovingPixelValue,
+                                  const ThreadIdType       threadId) const;
+
+  /** Compute the Jacobian of the moving transform with respect to its
+   * parameters at the virtual point processed by the thread, from its
+   * weights if it was mapped by \c ProcessVirtualPoints, or by the
+   * transform otherwise. The Jacobian is dense, all its entries being set
+   * for each point: the derived classes of this module use \c
+   * GetMovingBSplineJacobianWeights instead, to only compute the derivatives
+   * of the parameters of the support region of the point. */
+  void
+  ComputeMovingTransformJacobian(const VirtualPointType & virtualPoint,
+                                 JacobianType &           jacobian,
+                                 JacobianType &           jacobianPositional,
+                                 const ThreadIdType       threadId) const;
+
+  /** Number of parameters of the blocks of the derivatives accumulated by
+   * each thread for global transforms. */
+  static constexpr NumberOfParametersType DerivativesBlockSize = 256;
+
+  /** Get the block of the derivatives accumulated by the thread for a global
+   * transform, allocated and initialized to zero if it was not yet. */
+  CompensatedDerivativeValueType *
+  GetCompensatedDerivativesBlock(const NumberOfParametersType block, const ThreadIdType threadId) const;
+
+  /** Get the weights and the parameter indices of the non-zero entries of
+   * the Jacobian of the moving B-spline transform at the virtual point
+   * processed by the thread: the entry (d, indices[k] + d *
+   * numberOfParametersPerDimension) is weights[k], for k lower than
+   * numberOfWeights, which is zero when the point is outside of the grid.
+   * Returns false if the point was not mapped by \c ProcessVirtualPoints.
+   * The derivative of a moving image value with respect to the parameter
+   * (d, indices[k] + d * numberOfParametersPerDimension) is then weights[k]
+   * times the component d of \c GetMovingBSplineImageGradient. */
+  bool
+  GetMovingBSplineJacobianWeights(const MovingBSplineWeightsValueType *&        weights,
+                                  const MovingBSplineParameterIndexValueType *& indices,
+                                  SizeValueType &                              numberOfWeights,
+                                  const ThreadIdType                           threadId) const;
+
+  /** Get the gradient of the moving image with respect to the point mapped
+   * by the moving B-spline transform, from the moving image gradient at the
+   * moving point: the same gradient, unless the B-spline transform is
+   * followed by linear transforms in a composite moving transform. Each
+   * component of a multi-component gradient is transformed. */
+  MovingImageGradientType
+  GetMovingBSplineImageGradient(const MovingImageGradientType & movingImageGradient) const;
+
   /** Method to calculate the metric value and derivative
    * given a point, value and image derivative for both fixed and moving
    * spaces. The provided values have been calculated from \c virtualPoint,
@@ -168,14 +319,24 @@ protected:
   virtual void
   StorePointDerivativeResult(const VirtualIndexType & virtualIndex, const ThreadIdType threadId);
 
+  /** The mapped fixed point of a sample and its value, if it is valid. */
+  struct CachedFixedSampleType
+  {
+    FixedImagePointType Point;
+    FixedImagePixelType PixelValue;
+    bool                IsValid;
+  };
+
   struct GetValueAndDerivativePerThreadStruct
   {
     /** Intermediary threaded metric value storage. */
     InternalComputationValueType Measure;
     /** Intermediary threaded metric value storage. */
     DerivativeType Derivatives;
-    /** Intermediary threaded metric value storage. This is used only with global transforms. */
-    CompensatedDerivativeType CompensatedDerivatives;
+    /** Intermediary threaded metric value storage. This is used only with
+     * global transforms, by blocks of DerivativesBlockSize parameters, which
+     * are null until accumulated into. */
+    std::vector<std::unique_ptr<CompensatedDerivativeValueType[]>> CompensatedDerivatives;
     /** Intermediary threaded metric value storage. */
     DerivativeType LocalDerivatives;
     /** Intermediary threaded metric value storage. */
@@ -184,6 +345,25 @@ protected:
      * classes for efficiency. */
     JacobianType MovingTransformJacobian;
     JacobianType MovingTransformJacobianPositional;
+    /** Block of points mapped by the moving B-spline transform, with the
+     * weights and parameter indices of their Jacobians, and the point of the
+     * block being processed. */
+    std::vector<MovingBSplineInputPointType>          MovingBSplineInputPoints;
+    std::vector<MovingOutputPointType>                MovingBSplineOutputPoints;
+    std::vector<MovingBSplineWeightsValueType>        MovingBSplineWeights;
+    std::vector<MovingBSplineParameterIndexValueType> MovingBSplineIndices;
+    std::unique_ptr<bool[]>                           MovingBSplineInside;
+    SizeValueType                                     MovingBSplineNumberOfPoints;
+    SizeValueType                                     MovingBSplineCurrentPoint;
+    /** The weights, parameter indices and insideness of the points of the
+     * block, either the ones above or the ones of the sample cache. */
+    const MovingBSplineWeightsValueType *        MovingBSplineBlockWeights;
+    const MovingBSplineParameterIndexValueType * MovingBSplineBlockIndices;
+    const bool *                                 MovingBSplineBlockInside;
+    /** The cached fixed sample of the point being processed, if the samples
+     * are cached, and whether it has been computed. */
+    CachedFixedSampleType * CachedFixedSample;
+    bool                    CachedFixedSampleIsComputed;
   };
   itkPadStruct(ITK_CACHE_LINE_ALIGNMENT,
                GetValueAndDerivativePerThreadStruct,
@@ -197,6 +377,62 @@ protected:
    *  These will only be set once threading has been started. */
   mutable NumberOfParametersType m_CachedNumberOfParameters;
   mutable NumberOfParametersType m_CachedNumberOfLocalParameters;
+
+  /** The cubic B-spline transform whose points are mapped by blocks, if
+   * any: the moving transform, or the B-spline transform of a composite
+   * moving transform. */
+  const MovingBSplineTransformType * m_MovingBSplineTransform;
+
+private:
+  using MovingBSplineOutputTransformType = typename MovingCompositeTransformType::TransformType;
+  using MovingBSplineOutputJacobianType = Matrix<typename MovingTransformType::ParametersValueType,
+                                                 TImageToImageMetricv4::MovingImageDimension,
+                                                 TImageToImageMetricv4::MovingImageDimension>;
+
+  /** Set m_MovingBSplineTransform, and the transforms which map its output
+   * points, from the moving transform. */
+  void
+  InitializeMovingBSplineTransform();
+
+  /** Map the points of the block mapped by the B-spline transform by the
+   * linear transforms which follow it in the composite moving transform. */
+  void
+  TransformMovingBSplineOutputPoints(SizeValueType numberOfPoints, const ThreadIdType threadId) const;
+
+  /** Enable the sample cache, computing it again if it is out of date. */
+  void
+  InitializeSampleCache();
+
+  /** Compute the moving points of a block of samples from their cached
+   * weights, as the TransformPoints of the B-spline transform does. */
+  void
+  TransformMovingBSplinePointsFromCache(SizeValueType numberOfPoints, const ThreadIdType threadId) const;
+
+  /** The values of the samples which do not change between evaluations of
+   * the metric, whether each sample has been computed, and the objects they
+   * were computed from. */
+  struct SampleCacheType
+  {
+    bool                                                           IsEnabled{ false };
+    std::unique_ptr<bool[]>                                        IsComputed;
+    std::vector<CachedFixedSampleType>                             FixedSamples;
+    std::vector<MovingBSplineWeightsValueType>                     MovingBSplineWeights;
+    std::vector<MovingBSplineParameterIndexValueType>              MovingBSplineIndices;
+    std::unique_ptr<bool[]>                                        MovingBSplineInside;
+    SizeValueType                                                  NumberOfSamples{ 0 };
+    std::vector<const Object *>                                    Sources;
+    const MovingTransformType *                                    MovingTransform{ nullptr };
+    typename MovingBSplineCachedTransformType::FixedParametersType MovingBSplineFixedParameters;
+    TimeStamp                                                      ComputeTime;
+  };
+  SampleCacheType m_SampleCache;
+
+  /** The linear transforms applied to the points mapped by the B-spline
+   * transform of a composite moving transform, in the order in which they are
+   * applied, and the Jacobian of their composition with respect to the
+   * position, which is the same at each point. */
+  std::vector<const MovingBSplineOutputTransformType *> m_MovingBSplineOutputTransforms;
+  MovingBSplineOutputJacobianType                       m_MovingBSplineOutputJacobian;
 };
 
 } // end namespace itk
@@ -21,6 +21,8 @@
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreaderBase.h"
 #include "itkNumericTraits.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -30,6 +32,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   : m_GetValueAndDerivativePerThreadVariables(nullptr)
   , m_CachedNumberOfParameters(0)
   , m_CachedNumberOfLocalParameters(0)
+  , m_MovingBSplineTransform(nullptr)
 {}
 
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
@@ -88,35 +91,180 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
         /* Global transforms get a separate derivatives container for each thread
          * that holds the result over a particular image region.
          * Use a CompensatedSummation value to provide for better consistency between
-         * different number of threads. */
-        this->m_GetValueAndDerivativePerThreadVariables[i].CompensatedDerivatives.resize(globalDerivativeSize);
+         * different number of threads.
+         * Its blocks are allocated, and initialized to zero, when first used. */
+        const NumberOfParametersType numberOfBlocks =
+          (globalDerivativeSize + DerivativesBlockSize - 1) / DerivativesBlockSize;
+        this->m_GetValueAndDerivativePerThreadVariables[i].CompensatedDerivatives.resize(numberOfBlocks);
       }
     }
   }
 
+  /* Store the casted pointer to avoid dynamic casting for each block. */
+  this->InitializeMovingBSplineTransform();
+
   //---------------------------------------------------------------
   // Set initial values.
   for (ThreadIdType thread = 0; thread < numThreadsUsed; ++thread)
   {
+    this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineNumberOfPoints = 0;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineCurrentPoint = 0;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineBlockWeights = nullptr;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineBlockIndices = nullptr;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineBlockInside = nullptr;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].CachedFixedSample = nullptr;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].CachedFixedSampleIsComputed = false;
+    if (this->m_MovingBSplineTransform != nullptr)
+    {
+      const SizeValueType numberOfWeights = this->m_MovingBSplineTransform->GetNumberOfWeights();
+      this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineInputPoints.resize(VirtualPointsBlockSize);
+      this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineOutputPoints.resize(VirtualPointsBlockSize);
+      this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineWeights.resize(VirtualPointsBlockSize *
+                                                                                          numberOfWeights);
+      this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineIndices.resize(VirtualPointsBlockSize *
+                                                                                          numberOfWeights);
+      this->m_GetValueAndDerivativePerThreadVariables[thread].MovingBSplineInside.reset(
+        new bool[VirtualPointsBlockSize]);
+    }
     this->m_GetValueAndDerivativePerThreadVariables[thread].NumberOfValidPoints =
       NumericTraits<SizeValueType>::ZeroValue();
     this->m_GetValueAndDerivativePerThreadVariables[thread].Measure =
       NumericTraits<InternalComputationValueType>::ZeroValue();
-    if (this->m_Associate->GetComputeDerivative())
+  }
+
+  if (this->m_Associate->GetUseSampledPointSet() && this->GetUseSampleCache())
+  {
+    this->InitializeSampleCache();
+  }
+  else if (this->m_SampleCache.IsEnabled)
+  {
+    // Release the memory of the cache.
+    this->m_SampleCache = SampleCacheType();
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
+                                                      TImageToImageMetricv4>::InitializeMovingBSplineTransform()
+{
+  this->m_MovingBSplineTransform = nullptr;
+  this->m_MovingBSplineOutputTransforms.clear();
+
+  const MovingTransformType * movingTransform = this->m_Associate->m_MovingTransform.GetPointer();
+  const auto * compositeTransform = dynamic_cast<const MovingCompositeTransformType *>(movingTransform);
+  if (compositeTransform == nullptr)
+  {
+    this->m_MovingBSplineTransform = dynamic_cast<const MovingBSplineTransformType *>(movingTransform);
+    return;
+  }
+
+  /* The B-spline transform must be the only transform optimized, so that the
+   * parameters of the composite transform are its own, and the last one added,
+   * which is the first one applied. The transforms applied after it must be
+   * linear, so that the Jacobian of the composite transform is the product of
+   * their constant Jacobian with respect to the position by its own. */
+  const SizeValueType numberOfTransforms = compositeTransform->GetNumberOfTransforms();
+  if (numberOfTransforms == 0 || !compositeTransform->GetNthTransformToOptimize(numberOfTransforms - 1))
+  {
+    return;
+  }
+  const auto * bsplineTransform = dynamic_cast<const MovingBSplineTransformType *>(
+    compositeTransform->GetNthTransformConstPointer(numberOfTransforms - 1));
+  if (bsplineTransform == nullptr)
+  {
+    return;
+  }
+  std::vector<const MovingBSplineOutputTransformType *> outputTransforms;
+  for (SizeValueType n = numberOfTransforms - 1; n > 0; --n)
+  {
+    const MovingBSplineOutputTransformType * transform = compositeTransform->GetNthTransformConstPointer(n - 1);
+    if (compositeTransform->GetNthTransformToOptimize(n - 1) || !transform->IsLinear())
     {
-      if (this->m_Associate->m_MovingTransform->GetTransformCategory() !=
-          MovingTransformType::TransformCategoryEnum::DisplacementField)
-      {
-        /* Be sure to init to 0 here, because the threader may not use
-         * all the threads if the region is better split into fewer
-         * subregions. */
-        for (NumberOfParametersType p = 0; p < this->m_CachedNumberOfParameters; p++)
-        {
-          this->m_GetValueAndDerivativePerThreadVariables[thread].CompensatedDerivatives[p].ResetToZero();
-        }
-      }
+      return;
+    }
+    outputTransforms.push_back(transform);
+  }
+
+  /* The columns of the Jacobian are the unit vectors mapped by the linear
+   * transforms. */
+  constexpr unsigned int dimension = TImageToImageMetricv4::MovingImageDimension;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    typename MovingBSplineOutputTransformType::OutputVectorType vector;
+    vector.Fill(0.0);
+    vector[d] = 1.0;
+    for (const MovingBSplineOutputTransformType * transform : outputTransforms)
+    {
+      vector = transform->TransformVector(vector);
+    }
+    for (unsigned int r = 0; r < dimension; ++r)
+    {
+      this->m_MovingBSplineOutputJacobian(r, d) = vector[r];
     }
   }
+  this->m_MovingBSplineTransform = bsplineTransform;
+  this->m_MovingBSplineOutputTransforms = outputTransforms;
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
+                                                      TImageToImageMetricv4>::InitializeSampleCache()
+{
+  SampleCacheType & cache = this->m_SampleCache;
+  cache.IsEnabled = true;
+
+  const SizeValueType numberOfSamples = this->m_Associate->GetVirtualSampledPointSet()->GetNumberOfPoints();
+  const std::vector<const Object *> sources = { this->m_Associate->GetVirtualSampledPointSet(),
+                                                this->m_Associate->GetFixedImage(),
+                                                this->m_Associate->GetFixedTransform(),
+                                                this->m_Associate->GetFixedInterpolator(),
+                                                this->m_Associate->GetFixedImageMask() };
+  const MovingTransformType *       movingTransform = this->m_Associate->m_MovingTransform;
+  const auto *                      movingBSplineTransform =
+    dynamic_cast<const MovingBSplineCachedTransformType *>(this->m_MovingBSplineTransform);
+  typename MovingBSplineCachedTransformType::FixedParametersType movingBSplineFixedParameters;
+  if (movingBSplineTransform != nullptr)
+  {
+    movingBSplineFixedParameters = movingBSplineTransform->GetFixedParameters();
+  }
+
+  // The cache is up to date if it has been computed from the same objects,
+  // none of which has been modified since, except for the parameters of the
+  // moving transform.
+  bool isUpToDate = cache.IsComputed != nullptr && cache.NumberOfSamples == numberOfSamples &&
+                    cache.Sources == sources && cache.MovingTransform == movingTransform &&
+                    cache.MovingBSplineFixedParameters == movingBSplineFixedParameters;
+  for (const Object * source : sources)
+  {
+    isUpToDate = isUpToDate && (source == nullptr || source->GetMTime() <= cache.ComputeTime.GetMTime());
+  }
+  if (isUpToDate)
+  {
+    return;
+  }
+
+  cache.IsComputed.reset(new bool[numberOfSamples]());
+  cache.FixedSamples.resize(numberOfSamples);
+  if (movingBSplineTransform != nullptr)
+  {
+    const SizeValueType numberOfWeights = movingBSplineTransform->GetNumberOfWeights();
+    cache.MovingBSplineWeights.resize(numberOfSamples * numberOfWeights);
+    cache.MovingBSplineIndices.resize(numberOfSamples * numberOfWeights);
+    cache.MovingBSplineInside.reset(new bool[numberOfSamples]);
+  }
+  else
+  {
+    std::vector<MovingBSplineWeightsValueType>().swap(cache.MovingBSplineWeights);
+    std::vector<MovingBSplineParameterIndexValueType>().swap(cache.MovingBSplineIndices);
+    cache.MovingBSplineInside.reset();
+  }
+  cache.NumberOfSamples = numberOfSamples;
+  cache.Sources = sources;
+  cache.MovingTransform = movingTransform;
+  cache.MovingBSplineFixedParameters = movingBSplineFixedParameters;
+  cache.ComputeTime.Modified();
 }
 
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
@@ -140,16 +288,41 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
     if (this->m_Associate->m_MovingTransform->GetTransformCategory() !=
         MovingTransformType::TransformCategoryEnum::DisplacementField)
     {
-      for (NumberOfParametersType p = 0; p < this->m_Associate->GetNumberOfParameters(); p++)
-      {
-        /* Use a compensated sum to be ready for when there is a very large number of threads */
-        CompensatedDerivativeValueType sum;
-        sum.ResetToZero();
-        for (ThreadIdType i = 0; i < numThreadsUsed; i++)
+      /* The blocks of parameters are summed concurrently, each one by a
+       * single thread, skipping the threads which did not accumulate into
+       * them. */
+      const NumberOfParametersType numberOfParameters = this->m_Associate->GetNumberOfParameters();
+      const NumberOfParametersType blockSize = DerivativesBlockSize;
+      DerivativeValueType *        derivativeResult = this->m_Associate->m_DerivativeResult->data_block();
+      const auto                   sumBlock = [this, numThreadsUsed, numberOfParameters, blockSize, derivativeResult](
+                                SizeValueType block) {
+        const NumberOfParametersType blockStart = block * blockSize;
+        const NumberOfParametersType blockEnd = std::min(numberOfParameters, blockStart + blockSize);
+        for (NumberOfParametersType p = 0; p < blockEnd - blockStart; p++)
         {
-          sum += this->m_GetValueAndDerivativePerThreadVariables[i].CompensatedDerivatives[p].GetSum();
+          /* Use a compensated sum to be ready for when there is a very large number of threads */
+          CompensatedDerivativeValueType sum;
+          sum.ResetToZero();
+          for (ThreadIdType i = 0; i < numThreadsUsed; i++)
+          {
+            const CompensatedDerivativeValueType * threadBlock =
+              this->m_GetValueAndDerivativePerThreadVariables[i].CompensatedDerivatives[block].get();
+            if (threadBlock != nullptr)
+            {
+              sum += threadBlock[p].GetSum();
+            }
+          }
+          derivativeResult[blockStart + p] += sum.GetSum();
         }
-        (*(this->m_Associate->m_DerivativeResult))[p] += sum.GetSum();
+      };
+      const NumberOfParametersType numberOfBlocks = (numberOfParameters + blockSize - 1) / blockSize;
+      if (numberOfBlocks > 1)
+      {
+        this->GetMultiThreader()->ParallelizeArray(0, numberOfBlocks, sumBlock, nullptr);
+      }
+      else if (numberOfBlocks == 1)
+      {
+        sumBlock(0);
       }
     }
   }
@@ -201,8 +374,26 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
   {
-    pointIsValid =
-      this->m_Associate->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
+    AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+      this->m_GetValueAndDerivativePerThreadVariables[threadId];
+    CachedFixedSampleType * cachedFixedSample = threadVariables.CachedFixedSample;
+    if (cachedFixedSample != nullptr && threadVariables.CachedFixedSampleIsComputed)
+    {
+      mappedFixedPoint = cachedFixedSample->Point;
+      mappedFixedPixelValue = cachedFixedSample->PixelValue;
+      pointIsValid = cachedFixedSample->IsValid;
+    }
+    else
+    {
+      pointIsValid =
+        this->m_Associate->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
+      if (cachedFixedSample != nullptr)
+      {
+        cachedFixedSample->Point = mappedFixedPoint;
+        cachedFixedSample->PixelValue = mappedFixedPixelValue;
+        cachedFixedSample->IsValid = pointIsValid;
+      }
+    }
     if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
         this->m_Associate->GetGradientSourceIncludesFixed())
     {
@@ -225,7 +416,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   try
   {
     pointIsValid =
-      this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+      this->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue, threadId);
     if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
         this->m_Associate->GetGradientSourceIncludesMoving())
     {
@@ -281,6 +472,336 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   return pointIsValid;
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::ProcessVirtualPoints(
+  const VirtualIndexType * virtualIndices,
+  const VirtualPointType * virtualPoints,
+  SizeValueType            numberOfPoints,
+  const ThreadIdType       threadId)
+{
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  if (this->m_MovingBSplineTransform == nullptr)
+  {
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      this->ProcessVirtualPoint(virtualIndices[i], virtualPoints[i], threadId);
+    }
+    return;
+  }
+
+  /* Map the points of the block, and compute the weights of their Jacobians,
+   * which are then used by ProcessVirtualPoint for each point. */
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    threadVariables.MovingBSplineInputPoints[i].CastFrom(virtualPoints[i]);
+  }
+  threadVariables.MovingBSplineBlockWeights = threadVariables.MovingBSplineWeights.data();
+  threadVariables.MovingBSplineBlockIndices = threadVariables.MovingBSplineIndices.data();
+  threadVariables.MovingBSplineBlockInside = threadVariables.MovingBSplineInside.get();
+  try
+  {
+    this->m_MovingBSplineTransform->TransformPoints(threadVariables.MovingBSplineInputPoints.data(),
+                                                    numberOfPoints,
+                                                    threadVariables.MovingBSplineOutputPoints.data(),
+                                                    threadVariables.MovingBSplineWeights.data(),
+                                                    threadVariables.MovingBSplineIndices.data(),
+                                                    threadVariables.MovingBSplineInside.get());
+    this->TransformMovingBSplineOutputPoints(numberOfPoints, threadId);
+  }
+  catch (ExceptionObject & exc)
+  {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+  }
+
+  threadVariables.MovingBSplineNumberOfPoints = numberOfPoints;
+  for (threadVariables.MovingBSplineCurrentPoint = 0; threadVariables.MovingBSplineCurrentPoint < numberOfPoints;
+       ++threadVariables.MovingBSplineCurrentPoint)
+  {
+    const SizeValueType i = threadVariables.MovingBSplineCurrentPoint;
+    this->ProcessVirtualPoint(virtualIndices[i], virtualPoints[i], threadId);
+  }
+  threadVariables.MovingBSplineNumberOfPoints = 0;
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  ProcessVirtualSampledPoints(const VirtualIndexType * virtualIndices,
+                              const VirtualPointType * virtualPoints,
+                              SizeValueType            numberOfPoints,
+                              SizeValueType            firstSample,
+                              const ThreadIdType       threadId)
+{
+  SampleCacheType & cache = this->m_SampleCache;
+  if (!cache.IsEnabled)
+  {
+    this->ProcessVirtualPoints(virtualIndices, virtualPoints, numberOfPoints, threadId);
+    return;
+  }
+
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  // The samples are computed together the first time they are processed, so
+  // that those of a block either all are or none is.
+  bool * const isComputed = cache.IsComputed.get() + firstSample;
+  const bool   blockIsComputed = std::all_of(isComputed, isComputed + numberOfPoints, [](bool b) { return b; });
+
+  if (this->m_MovingBSplineTransform != nullptr)
+  {
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      threadVariables.MovingBSplineInputPoints[i].CastFrom(virtualPoints[i]);
+    }
+    if (cache.MovingBSplineInside != nullptr)
+    {
+      const SizeValueType numberOfWeights = this->m_MovingBSplineTransform->GetNumberOfWeights();
+      const SizeValueType                    firstWeight = firstSample * numberOfWeights;
+      MovingBSplineWeightsValueType *        weights = cache.MovingBSplineWeights.data() + firstWeight;
+      MovingBSplineParameterIndexValueType * indices = cache.MovingBSplineIndices.data() + firstWeight;
+      bool *                                 inside = cache.MovingBSplineInside.get() + firstSample;
+      threadVariables.MovingBSplineBlockWeights = weights;
+      threadVariables.MovingBSplineBlockIndices = indices;
+      threadVariables.MovingBSplineBlockInside = inside;
+      if (blockIsComputed)
+      {
+        this->TransformMovingBSplinePointsFromCache(numberOfPoints, threadId);
+      }
+      else
+      {
+        this->m_MovingBSplineTransform->TransformPoints(threadVariables.MovingBSplineInputPoints.data(),
+                                                        numberOfPoints,
+                                                        threadVariables.MovingBSplineOutputPoints.data(),
+                                                        weights,
+                                                        indices,
+                                                        inside);
+      }
+    }
+    else
+    {
+      threadVariables.MovingBSplineBlockWeights = threadVariables.MovingBSplineWeights.data();
+      threadVariables.MovingBSplineBlockIndices = threadVariables.MovingBSplineIndices.data();
+      threadVariables.MovingBSplineBlockInside = threadVariables.MovingBSplineInside.get();
+      this->m_MovingBSplineTransform->TransformPoints(threadVariables.MovingBSplineInputPoints.data(),
+                                                      numberOfPoints,
+                                                      threadVariables.MovingBSplineOutputPoints.data(),
+                                                      threadVariables.MovingBSplineWeights.data(),
+                                                      threadVariables.MovingBSplineIndices.data(),
+                                                      threadVariables.MovingBSplineInside.get());
+    }
+    this->TransformMovingBSplineOutputPoints(numberOfPoints, threadId);
+    threadVariables.MovingBSplineNumberOfPoints = numberOfPoints;
+  }
+
+  threadVariables.CachedFixedSampleIsComputed = blockIsComputed;
+  for (threadVariables.MovingBSplineCurrentPoint = 0; threadVariables.MovingBSplineCurrentPoint < numberOfPoints;
+       ++threadVariables.MovingBSplineCurrentPoint)
+  {
+    const SizeValueType i = threadVariables.MovingBSplineCurrentPoint;
+    threadVariables.CachedFixedSample = &cache.FixedSamples[firstSample + i];
+    this->ProcessVirtualPoint(virtualIndices[i], virtualPoints[i], threadId);
+  }
+  threadVariables.CachedFixedSample = nullptr;
+  threadVariables.MovingBSplineNumberOfPoints = 0;
+  std::fill(isComputed, isComputed + numberOfPoints, true);
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  TransformMovingBSplinePointsFromCache(SizeValueType numberOfPoints, const ThreadIdType threadId) const
+{
+  using ScalarType = typename MovingBSplineCachedTransformType::ScalarType;
+  using ParametersValueType = typename MovingBSplineCachedTransformType::ParametersValueType;
+  constexpr unsigned int dimension = TImageToImageMetricv4::MovingImageDimension;
+
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  const SizeValueType numberOfWeights = this->m_MovingBSplineTransform->GetNumberOfWeights();
+  const typename MovingBSplineCachedTransformType::CoefficientImageArray coefficientImages =
+    this->m_MovingBSplineTransform->GetCoefficientImages();
+  const ParametersValueType * coefficients[dimension];
+  for (unsigned int j = 0; j < dimension; ++j)
+  {
+    coefficients[j] = coefficientImages[j]->GetBufferPointer();
+  }
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    const MovingBSplineInputPointType & point = threadVariables.MovingBSplineInputPoints[i];
+    MovingOutputPointType &             outputPoint = threadVariables.MovingBSplineOutputPoints[i];
+    if (!threadVariables.MovingBSplineBlockInside[i])
+    {
+      outputPoint = point;
+      continue;
+    }
+
+    // The sums of TransformPoints(), in the same order.
+    const MovingBSplineWeightsValueType * pointWeights =
+      threadVariables.MovingBSplineBlockWeights + i * numberOfWeights;
+    const MovingBSplineParameterIndexValueType * pointIndices =
+      threadVariables.MovingBSplineBlockIndices + i * numberOfWeights;
+    for (unsigned int j = 0; j < dimension; ++j)
+    {
+      ScalarType displacement = NumericTraits<ScalarType>::ZeroValue();
+      for (SizeValueType k = 0; k < numberOfWeights; ++k)
+      {
+        displacement += static_cast<ScalarType>(pointWeights[k] * coefficients[j][pointIndices[k]]);
+      }
+      outputPoint[j] = displacement + point[j];
+    }
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  TransformMovingBSplineOutputPoints(SizeValueType numberOfPoints, const ThreadIdType threadId) const
+{
+  if (this->m_MovingBSplineOutputTransforms.empty())
+  {
+    return;
+  }
+
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    MovingOutputPointType & point = threadVariables.MovingBSplineOutputPoints[i];
+    for (const MovingBSplineOutputTransformType * transform : this->m_MovingBSplineOutputTransforms)
+    {
+      point = transform->TransformPoint(point);
+    }
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  TransformAndEvaluateMovingPoint(const VirtualPointType & virtualPoint,
+                                  MovingImagePointType &   mappedMovingPoint,
+                                  MovingImagePixelType &   mappedMovingPixelValue,
+                                  const ThreadIdType       threadId) const
+{
+  const AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  if (threadVariables.MovingBSplineCurrentPoint < threadVariables.MovingBSplineNumberOfPoints)
+  {
+    mappedMovingPoint.CastFrom(threadVariables.MovingBSplineOutputPoints[threadVariables.MovingBSplineCurrentPoint]);
+    return this->m_Associate->EvaluateMappedMovingPoint(mappedMovingPoint, mappedMovingPixelValue);
+  }
+  return this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  GetMovingBSplineJacobianWeights(const MovingBSplineWeightsValueType *&        weights,
+                                  const MovingBSplineParameterIndexValueType *& indices,
+                                  SizeValueType &                              numberOfWeights,
+                                  const ThreadIdType                           threadId) const
+{
+  const AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  const SizeValueType point = threadVariables.MovingBSplineCurrentPoint;
+  if (point >= threadVariables.MovingBSplineNumberOfPoints)
+  {
+    return false;
+  }
+
+  const SizeValueType numberOfPointWeights = this->m_MovingBSplineTransform->GetNumberOfWeights();
+  weights = threadVariables.MovingBSplineBlockWeights + point * numberOfPointWeights;
+  indices = threadVariables.MovingBSplineBlockIndices + point * numberOfPointWeights;
+  numberOfWeights = threadVariables.MovingBSplineBlockInside[point] ? numberOfPointWeights : 0;
+  return true;
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+typename ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
+                                                               TImageToImageMetricv4>::MovingImageGradientType
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  GetMovingBSplineImageGradient(const MovingImageGradientType & movingImageGradient) const
+{
+  if (this->m_MovingBSplineOutputTransforms.empty())
+  {
+    return movingImageGradient;
+  }
+
+  /* The gradient is transformed by the transposed Jacobian of the linear
+   * transforms, for each component. */
+  constexpr unsigned int dimension = TImageToImageMetricv4::MovingImageDimension;
+  const unsigned int numberOfComponents = NumericTraits<MovingImageGradientType>::GetLength(movingImageGradient) /
+                                          dimension;
+  MovingImageGradientType bsplineImageGradient(movingImageGradient);
+  for (unsigned int c = 0; c < numberOfComponents; ++c)
+  {
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      typename MovingImageGradientType::ValueType sum = 0.0;
+      for (unsigned int r = 0; r < dimension; ++r)
+      {
+        sum += this->m_MovingBSplineOutputJacobian(r, d) * movingImageGradient[c * dimension + r];
+      }
+      bsplineImageGradient[c * dimension + d] = sum;
+    }
+  }
+  return bsplineImageGradient;
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  ComputeMovingTransformJacobian(const VirtualPointType & virtualPoint,
+                                 JacobianType &           jacobian,
+                                 JacobianType &           jacobianPositional,
+                                 const ThreadIdType       threadId) const
+{
+  const MovingBSplineWeightsValueType *        weights;
+  const MovingBSplineParameterIndexValueType * indices;
+  SizeValueType                                numberOfWeights;
+  if (!this->GetMovingBSplineJacobianWeights(weights, indices, numberOfWeights, threadId))
+  {
+    this->m_Associate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
+      virtualPoint, jacobian, jacobianPositional);
+    return;
+  }
+
+  /* Only the entries of the support region of the point are non-zero, the
+   * same weights being used for each dimension, and multiplied by the
+   * Jacobian of the linear transforms which follow the B-spline transform. */
+  constexpr unsigned int       dimension = TImageToImageMetricv4::MovingImageDimension;
+  const NumberOfParametersType numberOfParametersPerDimension = this->m_CachedNumberOfParameters / dimension;
+  const bool                   hasOutputTransforms = !this->m_MovingBSplineOutputTransforms.empty();
+  jacobian.SetSize(dimension, this->m_CachedNumberOfParameters);
+  jacobian.Fill(0.0);
+  for (SizeValueType k = 0; k < numberOfWeights; ++k)
+  {
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      const NumberOfParametersType p = indices[k] + d * numberOfParametersPerDimension;
+      if (hasOutputTransforms)
+      {
+        for (unsigned int r = 0; r < dimension; ++r)
+        {
+          jacobian(r, p) = this->m_MovingBSplineOutputJacobian(r, d) * weights[k];
+        }
+      }
+      else
+      {
+        jacobian(d, p) = weights[k];
+      }
+    }
+  }
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
 void
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
@@ -290,6 +811,36 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
       MovingTransformType::TransformCategoryEnum::DisplacementField)
   {
     /* Global support */
+    const MovingBSplineWeightsValueType *        weights;
+    const MovingBSplineParameterIndexValueType * indices;
+    SizeValueType                                numberOfWeights;
+    if (this->GetMovingBSplineJacobianWeights(weights, indices, numberOfWeights, threadId))
+    {
+      /* Only the parameters of the support region of the point have non-zero
+       * derivatives, the Jacobian of the transform being zero elsewhere. Those
+       * of the B-spline transform of a composite moving transform are the
+       * ones of the composite transform, since it is its only optimized one. */
+      AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+        this->m_GetValueAndDerivativePerThreadVariables[threadId];
+      constexpr unsigned int       dimension = TImageToImageMetricv4::MovingImageDimension;
+      const NumberOfParametersType numberOfParametersPerDimension = this->m_CachedNumberOfParameters / dimension;
+      const DerivativeValueType correctionResolution = this->m_Associate->GetFloatingPointCorrectionResolution();
+      for (SizeValueType k = 0; k < numberOfWeights; ++k)
+      {
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+          const NumberOfParametersType p = indices[k] + d * numberOfParametersPerDimension;
+          if (this->m_Associate->GetUseFloatingPointCorrection())
+          {
+            auto test = static_cast<intmax_t>(threadVariables.LocalDerivatives[p] * correctionResolution);
+            threadVariables.LocalDerivatives[p] = static_cast<DerivativeValueType>(test / correctionResolution);
+          }
+          this->GetCompensatedDerivativesBlock(p / DerivativesBlockSize, threadId)[p % DerivativesBlockSize] +=
+            threadVariables.LocalDerivatives[p];
+        }
+      }
+      return;
+    }
     if (this->m_Associate->GetUseFloatingPointCorrection())
     {
       DerivativeValueType correctionResolution = this->m_Associate->GetFloatingPointCorrectionResolution();
@@ -301,10 +852,15 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
           static_cast<DerivativeValueType>(test / correctionResolution);
       }
     }
-    for (NumberOfParametersType p = 0; p < this->m_CachedNumberOfParameters; p++)
+    const NumberOfParametersType blockSize = DerivativesBlockSize;
+    for (NumberOfParametersType blockStart = 0; blockStart < this->m_CachedNumberOfParameters; blockStart += blockSize)
     {
-      this->m_GetValueAndDerivativePerThreadVariables[threadId].CompensatedDerivatives[p] +=
-        this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives[p];
+      CompensatedDerivativeValueType * block = this->GetCompensatedDerivativesBlock(blockStart / blockSize, threadId);
+      const NumberOfParametersType     blockEnd = std::min(this->m_CachedNumberOfParameters, blockStart + blockSize);
+      for (NumberOfParametersType p = blockStart; p < blockEnd; p++)
+      {
+        block[p - blockStart] += this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives[p];
+      }
     }
   }
   else
@@ -335,6 +891,22 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   }
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+typename ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
+                                                               TImageToImageMetricv4>::CompensatedDerivativeValueType *
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  GetCompensatedDerivativesBlock(const NumberOfParametersType block, const ThreadIdType threadId) const
+{
+  std::unique_ptr<CompensatedDerivativeValueType[]> & compensatedDerivatives =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].CompensatedDerivatives[block];
+  if (compensatedDerivatives == nullptr)
+  {
+    /* The default constructor of CompensatedSummation initializes to zero. */
+    compensatedDerivatives.reset(new CompensatedDerivativeValueType[DerivativesBlockSize]);
+  }
+  return compensatedDerivatives.get();
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
 bool
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::GetComputeDerivative()
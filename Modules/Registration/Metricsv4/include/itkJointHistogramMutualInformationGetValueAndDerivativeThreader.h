@@ -71,6 +71,8 @@ public:
   using JointPDFInterpolatorPointer = typename JointHistogramMetricType::JointPDFInterpolatorPointer;
   using MarginalPDFInterpolatorPointer = typename JointHistogramMetricType::MarginalPDFInterpolatorPointer;
   using NumberOfParametersType = typename JointHistogramMetricType::NumberOfParametersType;
+  using MovingBSplineWeightsValueType = typename Superclass::MovingBSplineWeightsValueType;
+  using MovingBSplineParameterIndexValueType = typename Superclass::MovingBSplineParameterIndexValueType;
   using JointPDFType = typename JointHistogramMetricType::JointPDFType;
   using MarginalPDFType = typename JointHistogramMetricType::MarginalPDFType;
   using MarginalPDFPointType = typename MarginalPDFType::PointType;
@@ -166,6 +166,27 @@ JointHistogramMutualInformationGetValueAndDerivativeThreader<
     scalingfactor = NumericTraits<InternalComputationValueType>::ZeroValue();
   }
 
+  /* The derivatives of the parameters outside of the support region of the
+   * point of a B-spline transform are zero, and are not stored. */
+  const MovingBSplineWeightsValueType *        bsplineWeights;
+  const MovingBSplineParameterIndexValueType * bsplineIndices;
+  SizeValueType                                numberOfBSplineWeights;
+  if (this->GetMovingBSplineJacobianWeights(bsplineWeights, bsplineIndices, numberOfBSplineWeights, threadId))
+  {
+    const MovingImageGradientType bsplineImageGradient = this->GetMovingBSplineImageGradient(movingImageGradient);
+    const NumberOfParametersType  numberOfParametersPerDimension =
+      this->GetCachedNumberOfLocalParameters() / TImageToImageMetric::MovingImageDimension;
+    for (SizeValueType k = 0; k < numberOfBSplineWeights; ++k)
+    {
+      for (SizeValueType dim = 0; dim < TImageToImageMetric::MovingImageDimension; dim++)
+      {
+        localDerivativeReturn[bsplineIndices[k] + dim * numberOfParametersPerDimension] =
+          scalingfactor * bsplineWeights[k] * bsplineImageGradient[dim];
+      }
+    }
+    return true;
+  }
+
   /* Use a pre-allocated jacobian object for efficiency */
   using JacobianReferenceType = JacobianType &;
   JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
@@ -173,8 +194,7 @@ JointHistogramMutualInformationGetValueAndDerivativeThreader<
     this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
 
   /** For dense transforms, this returns identity */
-  this->m_JointAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
-    virtualPoint, jacobian, jacobianPositional);
+  this->ComputeMovingTransformJacobian(virtualPoint, jacobian, jacobianPositional, threadId);
 
   for (NumberOfParametersType par = 0; par < this->GetCachedNumberOfLocalParameters(); par++)
   {
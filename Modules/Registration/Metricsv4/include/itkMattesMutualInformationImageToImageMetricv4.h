@@ -157,6 +157,23 @@ public:
   itkSetClampMacro(NumberOfHistogramBins, SizeValueType, 5, NumericTraits<SizeValueType>::max());
   itkGetConstReferenceMacro(NumberOfHistogramBins, SizeValueType);
 
+  /** Set/Get whether the values of the samples which do not change between
+   * iterations are cached, when the metric is evaluated on a sampled point
+   * set: the mapped fixed points and their values, which give the fixed
+   * image Parzen windows of the samples, and, if the moving transform is a
+   * cubic BSplineTransform, the weights of the interpolation of its
+   * coefficients, from which the moving points and the Jacobians are then
+   * computed. The weights are also cached for the B-spline transform of a
+   * CompositeTransform, as set up by ImageRegistrationMethodv4, whose only
+   * optimized transform is that B-spline transform, added last, and whose
+   * other transforms are linear. This trades a memory of the number of samples times the number
+   * of weights of the transform for faster iterations. The moving image is
+   * still interpolated at each iteration, its points depending on the
+   * parameters. Defaults to false. */
+  itkSetMacro(UseCachingOfSampleWeights, bool);
+  itkGetConstMacro(UseCachingOfSampleWeights, bool);
+  itkBooleanMacro(UseCachingOfSampleWeights);
+
   void
   Initialize() override;
 
@@ -246,6 +263,7 @@ protected:
 
   /** Variables to define the marginal and joint histograms. */
   SizeValueType m_NumberOfHistogramBins{ 50 };
+  bool          m_UseCachingOfSampleWeights{ false };
   PDFValueType  m_MovingImageNormalizedMin;
   PDFValueType  m_FixedImageNormalizedMin;
   PDFValueType  m_FixedImageTrueMin;
@@ -333,12 +351,39 @@ protected:
     PDFValueType *
     GetNextElementAndAddOffset(const OffsetValueType & offset)
     {
+      if (m_MemoryBlock.empty())
+      {
+        this->AllocateMemoryBlock();
+      }
       m_BufferOffsetContainer[m_CurrentFillSize] = offset;
       PDFValueType * PDFBufferForWriting = m_BufferPDFValuesContainer[m_CurrentFillSize];
       ++m_CurrentFillSize;
       return PDFBufferForWriting;
     }
 
+    /**
+     * Get the buffer of the next line of contributions of a transform whose
+     * Jacobian has only numberOfElements non-zero entries, as a B-spline
+     * transform, instead of one for each parameter. The offsets of the
+     * contributions are the offsets of the joint PDF derivatives they are
+     * added to, parameter included.
+     */
+    void
+    GetNextSparseElements(const size_t numberOfElements, OffsetValueType *& offsets, PDFValueType *& values)
+    {
+      if (m_CurrentSparseElementsSize + numberOfElements > m_SparseValuesContainer.size())
+      {
+        const size_t sparseSize =
+          std::max(m_CurrentSparseElementsSize + numberOfElements, numberOfElements * m_MaxBufferSize);
+        m_SparseOffsetContainer.resize(sparseSize);
+        m_SparseValuesContainer.resize(sparseSize);
+      }
+      offsets = &m_SparseOffsetContainer[m_CurrentSparseElementsSize];
+      values = &m_SparseValuesContainer[m_CurrentSparseElementsSize];
+      m_CurrentSparseElementsSize += numberOfElements;
+      ++m_CurrentSparseFillSize;
+    }
+
     /**
      * Apply the operations stored in the buffer.
      * This method is not thread safe and requires a lock while threading.
@@ -347,14 +392,24 @@ protected:
     ReduceBuffer();
 
   private:
+    // Allocate the memory of the lines of contributions to every parameter,
+    // which is not used by the transforms with sparse Jacobians
+    void
+    AllocateMemoryBlock();
+
     // How many AccumlatorElements used
     size_t m_CurrentFillSize{ 0 };
+    // How many lines, and elements, of sparse contributions used
+    size_t m_CurrentSparseFillSize{ 0 };
+    size_t m_CurrentSparseElementsSize{ 0 };
     // Continguous chunk of memory for efficiency
     std::vector<PDFValueType> m_MemoryBlock;
     // The (number of lines in the buffer) * (cells per line)
     size_t                       m_MemoryBlockSize;
     std::vector<PDFValueType *>  m_BufferPDFValuesContainer;
     std::vector<OffsetValueType> m_BufferOffsetContainer;
+    std::vector<OffsetValueType> m_SparseOffsetContainer;
+    std::vector<PDFValueType>    m_SparseValuesContainer;
     size_t                       m_CachedNumberOfLocalParameters;
     size_t                       m_MaxBufferSize;
     // Pointer handle to parent version
@@ -506,6 +506,9 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TMetricTraits>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+  os << indent << "UseCachingOfSampleWeights: " << (this->m_UseCachingOfSampleWeights ? "On" : "Off") << std::endl;
 }
 
 template <typename TFixedImage,
@@ -564,6 +567,8 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
              typename JointPDFDerivativesType::Pointer parentJointPDFDerivatives)
 {
   m_CurrentFillSize = 0;
+  m_CurrentSparseFillSize = 0;
+  m_CurrentSparseElementsSize = 0;
   m_MemoryBlockSize = cachedNumberOfLocalParameters * maxBufferLength;
   m_BufferPDFValuesContainer.resize(maxBufferLength, nullptr);
   m_BufferOffsetContainer.resize(maxBufferLength, 0);
@@ -571,11 +576,29 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   m_MaxBufferSize = maxBufferLength;
   m_ParentJointPDFDerivativesLockPtr = parentDerivativeLockPtr;
   m_ParentJointPDFDerivatives = parentJointPDFDerivatives;
-  // Allocate and initialize to zero (note the () at the end of the new
-  // operator)
-  // the memory as a single block
+  // The memory is allocated when first used, since the transforms with
+  // sparse Jacobians do not use it
+  if (!m_MemoryBlock.empty())
+  {
+    this->AllocateMemoryBlock();
+  }
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::DerivativeBufferManager ::AllocateMemoryBlock()
+{
+  // Allocate and initialize to zero the memory as a single block
   m_MemoryBlock.resize(m_MemoryBlockSize, 0.0);
-  for (size_t index = 0; index < maxBufferLength; ++index)
+  for (size_t index = 0; index < m_MaxBufferSize; ++index)
   {
     this->m_BufferPDFValuesContainer[index] = &(this->m_MemoryBlock[0]) + index * m_CachedNumberOfLocalParameters;
   }
@@ -597,10 +620,9 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   m_MemoryBlockSize = m_MemoryBlockSize * 2;
   m_BufferPDFValuesContainer.resize(m_MaxBufferSize, nullptr);
   m_BufferOffsetContainer.resize(m_MaxBufferSize, 0);
-  m_MemoryBlock.resize(m_MemoryBlockSize, 0.0);
-  for (size_t index = 0; index < m_MaxBufferSize; ++index)
+  if (!m_MemoryBlock.empty())
   {
-    this->m_BufferPDFValuesContainer[index] = &(this->m_MemoryBlock[0]) + index * m_CachedNumberOfLocalParameters;
+    this->AllocateMemoryBlock();
   }
 }
 
@@ -616,7 +638,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::DerivativeBufferManager ::CheckAndReduceIfNecessary()
 {
-  if (m_CurrentFillSize == m_MaxBufferSize)
+  if (m_CurrentFillSize + m_CurrentSparseFillSize >= m_MaxBufferSize)
   {
     // Attempt to acquire the lock once
     std::unique_lock<std::mutex> FirstTryLockHolder(*this->m_ParentJointPDFDerivativesLockPtr, std::try_to_lock);
@@ -655,7 +677,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::DerivativeBufferManager ::BlockAndReduce()
 {
-  if (m_CurrentFillSize > 0)
+  if (m_CurrentFillSize > 0 || m_CurrentSparseFillSize > 0)
   {
     std::lock_guard<std::mutex> LockHolder(*this->m_ParentJointPDFDerivativesLockPtr);
     ReduceBuffer();
@@ -704,6 +726,15 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
     ++bufferIndex;
   }
   m_CurrentFillSize = 0; // Reset fill size back to zero.
+
+  // The sparse contributions are added to the elements of their offsets.
+  JointPDFDerivativesValueType * const derivativesBuffer = this->m_ParentJointPDFDerivatives->GetBufferPointer();
+  for (size_t elementIndex = 0; elementIndex < m_CurrentSparseElementsSize; ++elementIndex)
+  {
+    derivativesBuffer[m_SparseOffsetContainer[elementIndex]] += m_SparseValuesContainer[elementIndex];
+  }
+  m_CurrentSparseFillSize = 0;
+  m_CurrentSparseElementsSize = 0;
 }
 
 } // end namespace itk
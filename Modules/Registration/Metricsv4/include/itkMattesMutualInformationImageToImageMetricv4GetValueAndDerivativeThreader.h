@@ -66,6 +66,8 @@ public:
   using DerivativeType = typename Superclass::DerivativeType;
   using DerivativeValueType = typename Superclass::DerivativeValueType;
   using NumberOfParametersType = typename Superclass::NumberOfParametersType;
+  using MovingBSplineWeightsValueType = typename Superclass::MovingBSplineWeightsValueType;
+  using MovingBSplineParameterIndexValueType = typename Superclass::MovingBSplineParameterIndexValueType;
 
   using MovingTransformType = typename ImageToImageMetricv4Type::MovingTransformType;
 
@@ -98,6 +100,11 @@ protected:
   void
   AfterThreadedExecution() override;
 
+  /** The samples are cached if the UseCachingOfSampleWeights of the metric
+   * is on. */
+  bool
+  GetUseSampleCache() const override;
+
   /** This function computes the local voxel-wise contribution of
    *  the metric to the global integral of the metric/derivative.
    */
@@ -234,6 +234,18 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   }
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric>
+bool
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
+  TDomainPartitioner,
+  TImageToImageMetric,
+  TMattesMutualInformationMetric>::GetUseSampleCache() const
+{
+  // Called by Superclass::BeforeThreadedExecution(), before m_MattesAssociate is set.
+  const auto * mattesAssociate = dynamic_cast<const TMattesMutualInformationMetric *>(this->m_Associate);
+  return mattesAssociate != nullptr && mattesAssociate->GetUseCachingOfSampleWeights();
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric>
 bool
 MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
@@ -333,15 +345,30 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
     }
   }
 
-  // Compute the transform Jacobian.
+  // Compute the transform Jacobian, or get its non-zero entries for a
+  // B-spline transform.
   using JacobianReferenceType = JacobianType &;
   JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
+  const MovingBSplineWeightsValueType *        bsplineWeights = nullptr;
+  const MovingBSplineParameterIndexValueType * bsplineIndices = nullptr;
+  SizeValueType                                bsplineNumberOfWeights = 0;
+  bool                                         isBSplineJacobian = false;
+  MovingImageGradientType                      bsplineImageGradient;
   if (doComputeDerivative)
   {
-    JacobianReferenceType jacobianPositional =
-      this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
-    this->m_MattesAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
-      virtualPoint, jacobian, jacobianPositional);
+    isBSplineJacobian =
+      this->GetMovingBSplineJacobianWeights(bsplineWeights, bsplineIndices, bsplineNumberOfWeights, threadId);
+    if (isBSplineJacobian)
+    {
+      bsplineImageGradient = this->GetMovingBSplineImageGradient(movingImageGradient);
+    }
+    else
+    {
+      JacobianReferenceType jacobianPositional =
+        this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
+      this->m_MattesAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
+        virtualPoint, jacobian, jacobianPositional);
+    }
   }
 
   SizeValueType movingParzenBin = 0;
@@ -380,19 +407,45 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
           (fixedImageParzenWindowIndex * this->m_MattesAssociate->m_JointPDFDerivatives->GetOffsetTable()[2]) +
           (pdfMovingIndex * this->m_MattesAssociate->m_JointPDFDerivatives->GetOffsetTable()[1]);
 
-        PDFValueType * derivativeContributionPtr =
-          this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(ThisIndexOffset);
-        for (NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement;
-             ++mu)
+        if (isBSplineJacobian)
         {
-          PDFValueType innerProduct = 0.0;
-          for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+          // Only the parameters of the support region of the point have
+          // non-zero contributions, each in a single dimension, which are
+          // buffered alone.
+          const NumberOfParametersType numberOfParametersPerDimension =
+            this->GetCachedNumberOfLocalParameters() / this->m_MattesAssociate->MovingImageDimension;
+          OffsetValueType * derivativeOffsetPtr;
+          PDFValueType *    derivativeContributionPtr;
+          this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextSparseElements(
+            bsplineNumberOfWeights * this->m_MattesAssociate->MovingImageDimension,
+            derivativeOffsetPtr,
+            derivativeContributionPtr);
+          for (SizeValueType k = 0; k < bsplineNumberOfWeights; ++k)
           {
-            innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+            for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+            {
+              const PDFValueType innerProduct = bsplineWeights[k] * bsplineImageGradient[dim];
+              *(derivativeOffsetPtr++) = ThisIndexOffset + bsplineIndices[k] + dim * numberOfParametersPerDimension;
+              *(derivativeContributionPtr++) = innerProduct * cubicBSplineDerivativeValue;
+            }
+          }
+        }
+        else
+        {
+          PDFValueType * derivativeContributionPtr =
+            this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(ThisIndexOffset);
+          for (NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement;
+               ++mu)
+          {
+            PDFValueType innerProduct = 0.0;
+            for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+            {
+              innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+            }
+
+            *(derivativeContributionPtr) = innerProduct * cubicBSplineDerivativeValue;
+            ++derivativeContributionPtr;
           }
-
-          *(derivativeContributionPtr) = innerProduct * cubicBSplineDerivativeValue;
-          ++derivativeContributionPtr;
         }
         this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].CheckAndReduceIfNecessary();
       }
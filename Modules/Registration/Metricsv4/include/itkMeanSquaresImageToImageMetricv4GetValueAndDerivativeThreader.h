@@ -63,6 +63,8 @@ public:
   using DerivativeType = typename Superclass::DerivativeType;
   using DerivativeValueType = typename Superclass::DerivativeValueType;
   using NumberOfParametersType = typename Superclass::NumberOfParametersType;
+  using MovingBSplineWeightsValueType = typename Superclass::MovingBSplineWeightsValueType;
+  using MovingBSplineParameterIndexValueType = typename Superclass::MovingBSplineParameterIndexValueType;
 
 protected:
   MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader() = default;
@@ -57,6 +57,35 @@ MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader<
     return true;
   }
 
+  /* The derivatives of the parameters outside of the support region of the
+   * point of a B-spline transform are zero, and are not stored. */
+  const MovingBSplineWeightsValueType *        bsplineWeights;
+  const MovingBSplineParameterIndexValueType * bsplineIndices;
+  SizeValueType                                numberOfBSplineWeights;
+  if (this->GetMovingBSplineJacobianWeights(bsplineWeights, bsplineIndices, numberOfBSplineWeights, threadId))
+  {
+    const MovingImageGradientType bsplineImageGradient = this->GetMovingBSplineImageGradient(movingImageGradient);
+    const NumberOfParametersType  numberOfParametersPerDimension =
+      this->GetCachedNumberOfLocalParameters() / ImageToImageMetricv4Type::MovingImageDimension;
+    for (SizeValueType k = 0; k < numberOfBSplineWeights; ++k)
+    {
+      for (SizeValueType dim = 0; dim < ImageToImageMetricv4Type::MovingImageDimension; dim++)
+      {
+        const NumberOfParametersType par = bsplineIndices[k] + dim * numberOfParametersPerDimension;
+        localDerivativeReturn[par] = NumericTraits<DerivativeValueType>::ZeroValue();
+        for (unsigned int nc = 0; nc < nComponents; nc++)
+        {
+          MeasureType diffValue = DefaultConvertPixelTraits<FixedImagePixelType>::GetNthComponent(nc, diff);
+          const auto gradientIndex = ImageToImageMetricv4Type::FixedImageDimension * nc + dim;
+          localDerivativeReturn[par] +=
+            2.0 * diffValue * bsplineWeights[k] *
+            DefaultConvertPixelTraits<MovingImageGradientType>::GetNthComponent(gradientIndex, bsplineImageGradient);
+        }
+      }
+    }
+    return true;
+  }
+
   /* Use a pre-allocated jacobian object for efficiency */
   using JacobianReferenceType = typename TImageToImageMetric::JacobianType &;
   JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
@@ -64,8 +93,7 @@ MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader<
     this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
 
   /** For dense transforms, this returns identity */
-  this->m_Associate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
-    virtualPoint, jacobian, jacobianPositional);
+  this->ComputeMovingTransformJacobian(virtualPoint, jacobian, jacobianPositional, threadId);
 
   for (unsigned int par = 0; par < this->GetCachedNumberOfLocalParameters(); par++)
   {
@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkIdentityTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageToImageMetricv4TestSupport.h"
+#include "itkJointHistogramMutualInformationImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTestingMacros.h"
+
+/* The points of a B-spline moving transform are mapped by blocks, the
+ * Jacobians are computed from the weights of the blocks, and only the
+ * derivatives of the parameters of their support regions are accumulated by
+ * each thread. This is also the case for a composite transform whose
+ * B-spline transform, added last, is the only one optimized, the others
+ * being linear. This test checks that the metrics give the values and
+ * derivatives of the per-point path, whatever the number of threads. The
+ * per-point path is taken for the same composite transforms followed by a
+ * non-optimized identity transform, since the B-spline transform is then not
+ * the last one added. */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using BSplineType = itk::BSplineTransform<double, Dimension, 3>;
+using CompositeType = itk::CompositeTransform<double, Dimension>;
+using TransformType = CompositeType::TransformType;
+
+ImageType::Pointer
+CreateImage(double shift)
+{
+  ImageType::SizeType size;
+  size.Fill(20);
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->Allocate();
+
+  // a gaussian blob, off the center of the image
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    const double x = point[0] - 14.0 - shift;
+    const double y = point[1] - 9.0;
+    const double z = point[2] - 20.0 + shift;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + y * y + z * z) / 80.0) + 10.0));
+  }
+  return image;
+}
+
+// Composes the transforms, of which only the B-spline transform is optimized.
+CompositeType::Pointer
+Compose(const std::vector<TransformType::Pointer> & transforms, const BSplineType * bspline)
+{
+  auto composite = CompositeType::New();
+  for (const TransformType::Pointer & transform : transforms)
+  {
+    composite->AddTransform(transform);
+  }
+  composite->SetAllTransformsToOptimize(false);
+  for (unsigned int n = 0; n < transforms.size(); ++n)
+  {
+    if (transforms[n].GetPointer() == bspline)
+    {
+      composite->SetNthTransformToOptimizeOn(n);
+    }
+  }
+  return composite;
+}
+
+template <typename TMetric>
+int
+CompareMetric(const std::string & name,
+              const ImageType *   fixedImage,
+              const ImageType *   movingImage,
+              TransformType *     transform,
+              TransformType *     perPointTransform,
+              bool                useSampling,
+              unsigned int        numberOfWorkUnits)
+{
+  typename TMetric::MeasureType    values[2];
+  typename TMetric::DerivativeType derivatives[2];
+  itk::SizeValueType               numberOfValidPoints[2];
+  const typename TMetric::MovingTransformType::Pointer transforms[2] = { transform, perPointTransform };
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    auto metric = TMetric::New();
+    metric->SetFixedImage(fixedImage);
+    metric->SetMovingImage(movingImage);
+    metric->SetMovingTransform(transforms[i]);
+    metric->SetMaximumNumberOfWorkUnits(numberOfWorkUnits);
+    if (useSampling)
+    {
+      using PointSetType = typename TMetric::FixedSampledPointSetType;
+      auto                pointSet = PointSetType::New();
+      itk::SizeValueType  numberOfPoints = 0;
+      itk::ImageRegionConstIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion());
+      for (itk::SizeValueType n = 0; !it.IsAtEnd(); ++it, ++n)
+      {
+        if (n % 7 == 0)
+        {
+          typename PointSetType::PointType point;
+          fixedImage->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+          pointSet->SetPoint(numberOfPoints++, point);
+        }
+      }
+      metric->SetFixedSampledPointSet(pointSet);
+      metric->SetUseSampledPointSet(true);
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(metric->Initialize());
+    ITK_TRY_EXPECT_NO_EXCEPTION(metric->GetValueAndDerivative(values[i], derivatives[i]));
+    numberOfValidPoints[i] = metric->GetNumberOfValidPoints();
+  }
+
+  std::cout << name << (useSampling ? " with sampling" : "") << ", " << numberOfWorkUnits
+            << " work units: " << values[0] << ", " << numberOfValidPoints[0] << " valid points" << std::endl;
+  ITK_TEST_EXPECT_EQUAL(numberOfValidPoints[0], numberOfValidPoints[1]);
+  return CompareMetricValueAndDerivative(name, values[0], derivatives[0], values[1], derivatives[1]);
+}
+
+// Compares the metrics with the transform and with the transform whose
+// points are mapped one by one.
+int
+CompareWithPerPointPath(const std::string & name,
+                        const ImageType *   fixedImage,
+                        const ImageType *   movingImage,
+                        TransformType *     transform,
+                        TransformType *     perPointTransform)
+{
+  using MattesType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+  using MeanSquaresType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using CorrelationType = itk::CorrelationImageToImageMetricv4<ImageType, ImageType>;
+  using JointHistogramType = itk::JointHistogramMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+  int result = EXIT_SUCCESS;
+  for (unsigned int numberOfWorkUnits : { 1, 4 })
+  {
+    for (bool useSampling : { false, true })
+    {
+      if (CompareMetric<MattesType>(name + ", Mattes",
+                                    fixedImage,
+                                    movingImage,
+                                    transform,
+                                    perPointTransform,
+                                    useSampling,
+                                    numberOfWorkUnits) != EXIT_SUCCESS ||
+          CompareMetric<MeanSquaresType>(name + ", MeanSquares",
+                                         fixedImage,
+                                         movingImage,
+                                         transform,
+                                         perPointTransform,
+                                         useSampling,
+                                         numberOfWorkUnits) != EXIT_SUCCESS ||
+          CompareMetric<CorrelationType>(name + ", Correlation",
+                                         fixedImage,
+                                         movingImage,
+                                         transform,
+                                         perPointTransform,
+                                         useSampling,
+                                         numberOfWorkUnits) != EXIT_SUCCESS ||
+          CompareMetric<JointHistogramType>(name + ", JointHistogram",
+                                            fixedImage,
+                                            movingImage,
+                                            transform,
+                                            perPointTransform,
+                                            useSampling,
+                                            numberOfWorkUnits) != EXIT_SUCCESS)
+      {
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  return result;
+}
+} // namespace
+
+
+int
+itkImageToImageMetricv4BSplineTransformTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = CreateImage(0.0);
+  const ImageType::Pointer movingImage = CreateImage(1.5);
+
+  // a transform whose grid covers part of the fixed image only, so that some
+  // points are outside of it
+  auto                           bspline = BSplineType::New();
+  BSplineType::OriginType        origin;
+  BSplineType::PhysicalDimensionsType dimensions;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    origin[d] = 2.0 * fixedImage->GetSpacing()[d];
+    dimensions[d] = 15.0 * fixedImage->GetSpacing()[d];
+  }
+  BSplineType::MeshSizeType meshSize;
+  meshSize.Fill(4);
+  bspline->SetTransformDomainOrigin(origin);
+  bspline->SetTransformDomainPhysicalDimensions(dimensions);
+  bspline->SetTransformDomainMeshSize(meshSize);
+  BSplineType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int p = 0; p < parameters.Size(); ++p)
+  {
+    parameters[p] = 0.8 * std::sin(0.7 * p);
+  }
+  bspline->SetParameters(parameters);
+
+  // a rotation, scaling and translation applied after the B-spline transform
+  using AffineType = itk::AffineTransform<double, Dimension>;
+  auto                         affine = AffineType::New();
+  AffineType::OutputVectorType axis;
+  axis[0] = 1.0;
+  axis[1] = 2.0;
+  axis[2] = 0.5;
+  affine->Rotate3D(axis, 0.1);
+  affine->Scale(1.05);
+  axis.Fill(0.7);
+  affine->Translate(axis);
+  const TransformType::Pointer identity = itk::IdentityTransform<double, Dimension>::New().GetPointer();
+  const TransformType::Pointer bsplineTransform = bspline.GetPointer();
+  const TransformType::Pointer affineTransform = affine.GetPointer();
+
+  int result = EXIT_SUCCESS;
+  if (CompareWithPerPointPath(
+        "BSpline", fixedImage, movingImage, bspline, Compose({ bsplineTransform, identity }, bspline)) !=
+        EXIT_SUCCESS ||
+      CompareWithPerPointPath("Composite",
+                              fixedImage,
+                              movingImage,
+                              Compose({ bsplineTransform }, bspline),
+                              Compose({ bsplineTransform, identity }, bspline)) != EXIT_SUCCESS ||
+      CompareWithPerPointPath("Composite with affine",
+                              fixedImage,
+                              movingImage,
+                              Compose({ affineTransform, bsplineTransform }, bspline),
+                              Compose({ affineTransform, bsplineTransform, identity }, bspline)) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkImageToImageMetricv4TestSupport_h
+#define itkImageToImageMetricv4TestSupport_h
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Compares the value and the derivative of a metric with the ones computed
+// another way, such as by mapping the points one by one or without cache.
+// Both must agree up to rounding, and the derivative must not be null, so
+// that the comparison checks it.
+template <typename TMeasure, typename TDerivative>
+int
+CompareMetricValueAndDerivative(const std::string & name,
+                                TMeasure            value,
+                                const TDerivative & derivative,
+                                TMeasure            expectedValue,
+                                const TDerivative & expectedDerivative)
+{
+  if (derivative.Size() != expectedDerivative.Size())
+  {
+    std::cerr << name << ": the derivative has " << derivative.Size() << " parameters instead of "
+              << expectedDerivative.Size() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  double maximumDerivative = 0.0;
+  double maximumDifference = 0.0;
+  for (unsigned int p = 0; p < derivative.Size(); ++p)
+  {
+    maximumDerivative = std::max(maximumDerivative, std::abs(static_cast<double>(expectedDerivative[p])));
+    maximumDifference =
+      std::max(maximumDifference, std::abs(static_cast<double>(derivative[p] - expectedDerivative[p])));
+  }
+  if (std::abs(value - expectedValue) > 1e-12 * std::abs(expectedValue) || maximumDerivative == 0.0 ||
+      maximumDifference > 1e-10 * maximumDerivative)
+  {
+    std::cerr << name << ": the values " << value << " and " << expectedValue
+              << " or the derivatives, whose maximum difference is " << maximumDifference << " for a maximum of "
+              << maximumDerivative << ", differ" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+#endif
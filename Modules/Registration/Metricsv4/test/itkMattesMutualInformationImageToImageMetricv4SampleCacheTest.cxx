@@ -0,0 +1,271 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageToImageMetricv4TestSupport.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkTestingMacros.h"
+
+/* With UseCachingOfSampleWeights on, the Mattes metric caches the fixed
+ * values of the samples and the weights of the B-spline moving transform. This
+ * test checks that it gives the values and derivatives of the metric without
+ * the cache as the parameters of the transform change, and after the sampled
+ * points and the fixed image are changed, including for a composite transform
+ * whose optimized B-spline transform is followed by an affine transform, as
+ * set up by ImageRegistrationMethodv4. */
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using BSplineType = itk::BSplineTransform<double, Dimension, 3>;
+using AffineType = itk::AffineTransform<double, Dimension>;
+using CompositeType = itk::CompositeTransform<double, Dimension>;
+using MetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+using PointSetType = MetricType::FixedSampledPointSetType;
+
+// Fills the image with a texture of stripes over a ramp, whose values spread
+// over the histogram bins. The phase shifts the stripes, so that the values
+// of the fixed samples change when the fixed image is filled again.
+void
+FillImage(ImageType * image, double phase)
+{
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    it.Set(static_cast<float>(40.0 * std::sin(0.35 * point[0] + phase) * std::cos(0.2 * point[1]) + point[0] +
+                              0.5 * point[1]));
+  }
+  image->Modified();
+}
+
+ImageType::Pointer
+CreateImage(double phase)
+{
+  ImageType::SizeType size;
+  size[0] = 48;
+  size[1] = 40;
+  ImageType::PointType origin;
+  origin[0] = -2.0;
+  origin[1] = 1.0;
+
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->SetOrigin(origin);
+  image->Allocate();
+  FillImage(image, phase);
+  return image;
+}
+
+PointSetType::Pointer
+CreatePointSet(const ImageType * image, itk::SizeValueType step, itk::SizeValueType offset)
+{
+  auto                                              pointSet = PointSetType::New();
+  itk::SizeValueType                                numberOfPoints = 0;
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (itk::SizeValueType n = 0; !it.IsAtEnd(); ++it, ++n)
+  {
+    if (n % step == offset)
+    {
+      PointSetType::PointType point;
+      image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      pointSet->SetPoint(numberOfPoints++, point);
+    }
+  }
+  return pointSet;
+}
+
+int
+Compare(const std::string & name, MetricType * cachedMetric, MetricType * metric)
+{
+  MetricType::MeasureType    values[2];
+  MetricType::DerivativeType derivatives[2];
+  ITK_TRY_EXPECT_NO_EXCEPTION(cachedMetric->GetValueAndDerivative(values[0], derivatives[0]));
+  ITK_TRY_EXPECT_NO_EXCEPTION(metric->GetValueAndDerivative(values[1], derivatives[1]));
+
+  std::cout << name << ": " << values[0] << ", " << cachedMetric->GetNumberOfValidPoints() << " valid points"
+            << std::endl;
+  ITK_TEST_EXPECT_EQUAL(cachedMetric->GetNumberOfValidPoints(), metric->GetNumberOfValidPoints());
+  return CompareMetricValueAndDerivative(name, values[0], derivatives[0], values[1], derivatives[1]);
+}
+
+// Compares the metric with and without cache for the transform. The linear
+// transform of a composite transform, if any, is moved between evaluations.
+int
+TestTransform(const std::string &               name,
+              MetricType::MovingTransformType * transform,
+              unsigned int                      numberOfWorkUnits,
+              AffineType *                      linearTransform = nullptr)
+{
+  const ImageType::Pointer fixedImage = CreateImage(0.0);
+  const ImageType::Pointer movingImage = CreateImage(0.8);
+
+  MetricType::Pointer metrics[2] = { MetricType::New(), MetricType::New() };
+  for (MetricType * metric : metrics)
+  {
+    metric->SetFixedImage(fixedImage);
+    metric->SetMovingImage(movingImage);
+    metric->SetMovingTransform(transform);
+    metric->SetMaximumNumberOfWorkUnits(numberOfWorkUnits);
+    metric->SetFixedSampledPointSet(CreatePointSet(fixedImage, 5, 0));
+    metric->SetUseSampledPointSet(true);
+    ITK_TRY_EXPECT_NO_EXCEPTION(metric->Initialize());
+  }
+  ITK_TEST_SET_GET_BOOLEAN(metrics[0], UseCachingOfSampleWeights, true);
+  metrics[1]->UseCachingOfSampleWeightsOff();
+
+  const std::string prefix = name + ", " + std::to_string(numberOfWorkUnits) + " work units";
+  int               result = EXIT_SUCCESS;
+
+  // the cache is filled by the first evaluation, then used as the parameters
+  // change
+  const MetricType::ParametersType initialParameters = transform->GetParameters();
+  for (unsigned int iteration = 0; iteration < 3; ++iteration)
+  {
+    MetricType::ParametersType parameters = initialParameters;
+    for (unsigned int p = 0; p < parameters.Size(); ++p)
+    {
+      parameters[p] += 0.05 * (iteration + 1) * std::cos(0.3 * p);
+    }
+    transform->SetParameters(parameters);
+    if (Compare(prefix + ", iteration " + std::to_string(iteration), metrics[0], metrics[1]) != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  // the linear transform applied after the cached B-spline transform moves
+  if (linearTransform != nullptr)
+  {
+    const AffineType::ParametersType linearParameters = linearTransform->GetParameters();
+    AffineType::OutputVectorType     translation;
+    translation[0] = 0.6;
+    translation[1] = -0.4;
+    linearTransform->Translate(translation);
+    linearTransform->Rotate2D(-0.05);
+    if (Compare(prefix + ", other linear transform", metrics[0], metrics[1]) != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+    linearTransform->SetParameters(linearParameters);
+  }
+
+  // other points, as many as before
+  for (MetricType * metric : metrics)
+  {
+    metric->SetFixedSampledPointSet(CreatePointSet(fixedImage, 5, 2));
+    ITK_TRY_EXPECT_NO_EXCEPTION(metric->Initialize());
+  }
+  if (Compare(prefix + ", other points", metrics[0], metrics[1]) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // other fixed values
+  FillImage(fixedImage, 0.4);
+  if (Compare(prefix + ", other fixed image", metrics[0], metrics[1]) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  // no sampling, which does not use the cache
+  for (MetricType * metric : metrics)
+  {
+    metric->SetUseSampledPointSet(false);
+    ITK_TRY_EXPECT_NO_EXCEPTION(metric->Initialize());
+  }
+  if (Compare(prefix + ", no sampling", metrics[0], metrics[1]) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  transform->SetParameters(initialParameters);
+  return result;
+}
+} // namespace
+
+
+int
+itkMattesMutualInformationImageToImageMetricv4SampleCacheTest(int, char *[])
+{
+  // a transform whose grid covers part of the fixed image only, so that the
+  // cache holds points inside and outside of its support
+  auto                                bspline = BSplineType::New();
+  BSplineType::OriginType             origin;
+  BSplineType::PhysicalDimensionsType dimensions;
+  origin[0] = 4.0;
+  origin[1] = 6.0;
+  dimensions[0] = 30.0;
+  dimensions[1] = 24.0;
+  BSplineType::MeshSizeType meshSize;
+  meshSize[0] = 5;
+  meshSize[1] = 3;
+  bspline->SetTransformDomainOrigin(origin);
+  bspline->SetTransformDomainPhysicalDimensions(dimensions);
+  bspline->SetTransformDomainMeshSize(meshSize);
+  BSplineType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int p = 0; p < parameters.Size(); ++p)
+  {
+    parameters[p] = 1.2 * std::sin(0.9 * p);
+  }
+  bspline->SetParameters(parameters);
+
+  auto                         affine = AffineType::New();
+  AffineType::OutputVectorType translation;
+  translation.Fill(0.5);
+  affine->Translate(translation);
+
+  // the B-spline transform is the first one applied, and the only one
+  // optimized
+  auto                         composite = CompositeType::New();
+  auto                         initialAffine = AffineType::New();
+  AffineType::OutputVectorType initialTranslation;
+  initialTranslation[0] = -0.8;
+  initialTranslation[1] = 0.3;
+  initialAffine->Translate(initialTranslation);
+  initialAffine->Rotate2D(0.1);
+  initialAffine->Scale(1.05);
+  composite->AddTransform(initialAffine);
+  composite->AddTransform(bspline);
+  composite->SetOnlyMostRecentTransformToOptimizeOn();
+
+  int result = EXIT_SUCCESS;
+  for (unsigned int numberOfWorkUnits : { 1, 4 })
+  {
+    if (TestTransform("BSpline", bspline, numberOfWorkUnits) != EXIT_SUCCESS ||
+        TestTransform("Affine", affine, numberOfWorkUnits) != EXIT_SUCCESS ||
+        TestTransform("Composite", composite, numberOfWorkUnits, initialAffine) != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
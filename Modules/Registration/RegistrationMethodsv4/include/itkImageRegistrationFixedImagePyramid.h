@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegistrationFixedImagePyramid_h
+#define itkImageRegistrationFixedImagePyramid_h
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkDefaultImageToImageMetricTraitsv4.h"
+
+namespace itk
+{
+/** \class ImageRegistrationFixedImagePyramid
+ * \brief Multi-resolution levels of a fixed image, computed once for many
+ * registrations.
+ *
+ * For each level, the pyramid holds what ImageRegistrationMethodv4 computes
+ * from the fixed image at the start of the level: the virtual domain image
+ * shrunk by the shrink factors of the level, the fixed image smoothed with
+ * the smoothing sigma of the level, the gradient image of the smoothed fixed
+ * image, as computed by the default gradient filter of the image metrics,
+ * and the virtual domain samples of the metric sampling strategy.
+ *
+ * Once Update() has been called, the pyramid is not modified by the
+ * registrations it is set to, with
+ * ImageRegistrationMethodv4::SetFixedImagePyramid(), so that it can be
+ * shared by registrations of many moving images against the same fixed
+ * image, including concurrent ones. The levels of a registration must
+ * have the shrink factors and the smoothing sigmas of the pyramid, and its
+ * virtual domain the one of the pyramid.
+ *
+ * The samples are drawn by ImageRegistrationMetricSampler, as
+ * ImageRegistrationMethodv4 draws them for a single metric, from the
+ * RandomSeed: a registration whose metric sampling seed is the same gets the
+ * same samples.
+ *
+ * \code
+ * auto pyramid = ImageRegistrationFixedImagePyramid<ImageType>::New();
+ * pyramid->SetFixedImage(fixedImage);
+ * pyramid->SetShrinkFactorsPerLevel(shrinkFactors);
+ * pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+ * pyramid->Update();
+ * for (...)
+ * {
+ *   auto registration = RegistrationType::New();
+ *   registration->SetFixedImage(fixedImage);
+ *   registration->SetFixedImagePyramid(pyramid);
+ *   ...
+ * }
+ * \endcode
+ *
+ * \sa ImageRegistrationMethodv4
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template <typename TFixedImage, typename TVirtualImage = TFixedImage, typename TInternalComputationValueType = double>
+class ITK_TEMPLATE_EXPORT ImageRegistrationFixedImagePyramid : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageRegistrationFixedImagePyramid);
+
+  /** Standard class type aliases. */
+  using Self = ImageRegistrationFixedImagePyramid;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageRegistrationFixedImagePyramid, Object);
+
+  /** ImageDimension constants */
+  static constexpr unsigned int ImageDimension = TFixedImage::ImageDimension;
+
+  using FixedImageType = TFixedImage;
+  using FixedImagePointer = typename FixedImageType::Pointer;
+  using FixedImageConstPointer = typename FixedImageType::ConstPointer;
+  using VirtualImageType = TVirtualImage;
+  using VirtualImagePointer = typename VirtualImageType::Pointer;
+  using VirtualImageBaseType = ImageBase<ImageDimension>;
+  using VirtualImageBaseConstPointer = typename VirtualImageBaseType::ConstPointer;
+  using RealType = TInternalComputationValueType;
+
+  using MetricTraitsType =
+    DefaultImageToImageMetricTraitsv4<FixedImageType, FixedImageType, VirtualImageType, TInternalComputationValueType>;
+  using FixedImageGradientImageType = typename MetricTraitsType::FixedImageGradientImageType;
+  using FixedImageGradientImagePointer = typename FixedImageGradientImageType::Pointer;
+  using FixedImageGradientFilterType = typename MetricTraitsType::DefaultFixedImageGradientFilter;
+
+  using FixedImageMaskType = SpatialObject<ImageDimension>;
+  using FixedImageMaskConstPointer = typename FixedImageMaskType::ConstPointer;
+
+  using ShrinkFilterType = ShrinkImageFilter<VirtualImageType, VirtualImageType>;
+  using ShrinkFactorsPerDimensionContainerType = typename ShrinkFilterType::ShrinkFactorsType;
+  using ShrinkFactorsArrayType = Array<SizeValueType>;
+  using SmoothingSigmasArrayType = Array<RealType>;
+
+  using MetricSamplingStrategyEnum = ImageRegistrationMethodv4Enums::MetricSamplingStrategy;
+  using MetricSamplingPercentageArrayType = Array<RealType>;
+  using MetricSamplePointSetType = PointSet<typename FixedImageType::PixelType, ImageDimension>;
+  using MetricSamplePointSetPointer = typename MetricSamplePointSetType::Pointer;
+
+  /** Set/Get the fixed image. */
+  itkSetConstObjectMacro(FixedImage, FixedImageType);
+  itkGetConstObjectMacro(FixedImage, FixedImageType);
+
+  /** Set the virtual domain image, whose information defines the virtual
+   * domain of the registrations. Defaults to the fixed image. */
+  itkSetConstObjectMacro(VirtualDomainImage, VirtualImageBaseType);
+
+  /** Get the virtual domain image, or the fixed image if none is set. */
+  const VirtualImageBaseType *
+  GetVirtualDomainImage() const;
+
+  /** Set/Get the mask of the fixed image, outside of which no virtual
+   * domain samples are drawn. */
+  itkSetConstObjectMacro(FixedImageMask, FixedImageMaskType);
+  itkGetConstObjectMacro(FixedImageMask, FixedImageMaskType);
+
+  /** Set the shrink factors of the virtual domain for each level, with a
+   * constant shrink factor for each dimension. The number of levels is the
+   * number of factors. */
+  void
+  SetShrinkFactorsPerLevel(const ShrinkFactorsArrayType & factors);
+
+  /** Set/Get the shrink factors of a level for each dimension. */
+  void
+  SetShrinkFactorsPerDimension(unsigned int level, const ShrinkFactorsPerDimensionContainerType & factors);
+  ShrinkFactorsPerDimensionContainerType
+  GetShrinkFactorsPerDimension(unsigned int level) const;
+
+  /** Get the number of levels. */
+  SizeValueType
+  GetNumberOfLevels() const
+  {
+    return static_cast<SizeValueType>(this->m_ShrinkFactorsPerLevel.size());
+  }
+
+  /** Set/Get the smoothing sigmas of the fixed image for each level, as for
+   * ImageRegistrationMethodv4. */
+  itkSetMacro(SmoothingSigmasPerLevel, SmoothingSigmasArrayType);
+  itkGetConstMacro(SmoothingSigmasPerLevel, SmoothingSigmasArrayType);
+
+  /** Set/Get whether the smoothing sigmas are specified in physical units
+   * (default) or in terms of voxels. */
+  itkSetMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits, bool);
+  itkGetConstMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits, bool);
+  itkBooleanMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits);
+
+  /** Set/Get whether the gradient images of the smoothed fixed images are
+   * computed. Defaults to true. */
+  itkSetMacro(ComputeFixedImageGradient, bool);
+  itkGetConstMacro(ComputeFixedImageGradient, bool);
+  itkBooleanMacro(ComputeFixedImageGradient);
+
+  /** Set/Get the strategy of the virtual domain samples. Defaults to NONE,
+   * in which case no samples are drawn. */
+  itkSetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
+  itkGetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
+
+  /** Set/Get the percentage of the virtual domain which is sampled at each
+   * level. Valid values are in (0.0, 1.0]. */
+  itkSetMacro(MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType);
+  itkGetConstMacro(MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType);
+
+  /** Set/Get the seed of the virtual domain samples. */
+  itkSetMacro(RandomSeed, int);
+  itkGetConstMacro(RandomSeed, int);
+
+  /** Compute the levels, if the pyramid or its fixed image has been
+   * modified since they were last computed. */
+  void
+  Update();
+
+  /** Get the virtual domain image of a level. */
+  const VirtualImageType *
+  GetLevelVirtualDomainImage(SizeValueType level) const;
+
+  /** Get the smoothed fixed image of a level. */
+  const FixedImageType *
+  GetLevelFixedImage(SizeValueType level) const;
+
+  /** Get the gradient image of the smoothed fixed image of a level, or
+   * nullptr if ComputeFixedImageGradient is off. */
+  const FixedImageGradientImageType *
+  GetLevelFixedImageGradientImage(SizeValueType level) const;
+
+  /** Get the virtual domain samples of a level, or nullptr if the metric
+   * sampling strategy is NONE. */
+  const MetricSamplePointSetType *
+  GetLevelMetricSamplePointSet(SizeValueType level) const;
+
+protected:
+  ImageRegistrationFixedImagePyramid();
+  ~ImageRegistrationFixedImagePyramid() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Throw an exception if the levels have not been computed up to the
+   * level. */
+  void
+  CheckLevel(SizeValueType level) const;
+
+  FixedImageConstPointer       m_FixedImage;
+  VirtualImageBaseConstPointer m_VirtualDomainImage;
+  FixedImageMaskConstPointer   m_FixedImageMask;
+
+  std::vector<ShrinkFactorsPerDimensionContainerType> m_ShrinkFactorsPerLevel;
+  SmoothingSigmasArrayType                            m_SmoothingSigmasPerLevel;
+  bool                                                m_SmoothingSigmasAreSpecifiedInPhysicalUnits{ true };
+  bool                                                m_ComputeFixedImageGradient{ true };
+
+  MetricSamplingStrategyEnum        m_MetricSamplingStrategy{ MetricSamplingStrategyEnum::NONE };
+  MetricSamplingPercentageArrayType m_MetricSamplingPercentagePerLevel;
+  int                               m_RandomSeed;
+
+  std::vector<VirtualImagePointer>            m_LevelVirtualDomainImages;
+  std::vector<FixedImageConstPointer>         m_LevelFixedImages;
+  std::vector<FixedImageGradientImagePointer> m_LevelFixedImageGradientImages;
+  std::vector<MetricSamplePointSetPointer>    m_LevelMetricSamplePointSets;
+  TimeStamp                                   m_UpdateTime;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageRegistrationFixedImagePyramid.hxx"
+#endif
+
+#endif // itkImageRegistrationFixedImagePyramid_h
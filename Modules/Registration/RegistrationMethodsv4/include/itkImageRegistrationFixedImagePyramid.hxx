@@ -0,0 +1,291 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegistrationFixedImagePyramid_hxx
+#define itkImageRegistrationFixedImagePyramid_hxx
+
+#include "itkImageRegistrationFixedImagePyramid.h"
+
+#include "itkImageRegistrationMetricSampler.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+
+namespace itk
+{
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  ImageRegistrationFixedImagePyramid()
+{
+  // The defaults of ImageRegistrationMethodv4.
+  ShrinkFactorsArrayType shrinkFactors(3);
+  shrinkFactors[0] = 2;
+  shrinkFactors[1] = 1;
+  shrinkFactors[2] = 1;
+  this->SetShrinkFactorsPerLevel(shrinkFactors);
+
+  this->m_SmoothingSigmasPerLevel.SetSize(3);
+  this->m_SmoothingSigmasPerLevel[0] = 2;
+  this->m_SmoothingSigmasPerLevel[1] = 1;
+  this->m_SmoothingSigmasPerLevel[2] = 0;
+
+  this->m_MetricSamplingPercentagePerLevel.SetSize(3);
+  this->m_MetricSamplingPercentagePerLevel.Fill(1.0);
+
+  this->m_RandomSeed = Statistics::MersenneTwisterRandomVariateGenerator::GetNextSeed();
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::GetVirtualDomainImage()
+  const -> const VirtualImageBaseType *
+{
+  if (this->m_VirtualDomainImage)
+  {
+    return this->m_VirtualDomainImage;
+  }
+  return this->m_FixedImage;
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  SetShrinkFactorsPerLevel(const ShrinkFactorsArrayType & factors)
+{
+  this->m_ShrinkFactorsPerLevel.resize(factors.Size());
+  for (SizeValueType level = 0; level < factors.Size(); ++level)
+  {
+    this->m_ShrinkFactorsPerLevel[level].Fill(static_cast<typename ShrinkFactorsPerDimensionContainerType::ValueType>(
+      factors[level]));
+  }
+  this->Modified();
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  SetShrinkFactorsPerDimension(unsigned int level, const ShrinkFactorsPerDimensionContainerType & factors)
+{
+  if (level >= this->m_ShrinkFactorsPerLevel.size())
+  {
+    this->m_ShrinkFactorsPerLevel.resize(level + 1);
+  }
+  this->m_ShrinkFactorsPerLevel[level] = factors;
+  this->Modified();
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  GetShrinkFactorsPerDimension(unsigned int level) const -> ShrinkFactorsPerDimensionContainerType
+{
+  if (level >= this->m_ShrinkFactorsPerLevel.size())
+  {
+    itkExceptionMacro("Requesting level greater than the number of levels.");
+  }
+  return this->m_ShrinkFactorsPerLevel[level];
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::Update()
+{
+  if (this->m_FixedImage.IsNull())
+  {
+    itkExceptionMacro("The fixed image is not present.");
+  }
+  if (this->m_UpdateTime > this->GetMTime() && this->m_UpdateTime > this->m_FixedImage->GetMTime() &&
+      (this->m_VirtualDomainImage.IsNull() || this->m_UpdateTime > this->m_VirtualDomainImage->GetMTime()))
+  {
+    return;
+  }
+
+  const SizeValueType numberOfLevels = this->GetNumberOfLevels();
+  if (this->m_SmoothingSigmasPerLevel.Size() != numberOfLevels)
+  {
+    itkExceptionMacro("The number of smoothing sigmas does not equal the number of levels.");
+  }
+  if (this->m_MetricSamplingStrategy != MetricSamplingStrategyEnum::NONE &&
+      this->m_MetricSamplingPercentagePerLevel.Size() != numberOfLevels)
+  {
+    itkExceptionMacro("The number of metric sampling percentages does not equal the number of levels.");
+  }
+
+  // The full resolution virtual domain, as allocated by the registration.
+  const VirtualImageBaseType * virtualDomainBaseImage = this->GetVirtualDomainImage();
+  VirtualImagePointer          virtualDomainImage = VirtualImageType::New();
+  virtualDomainImage->CopyInformation(virtualDomainBaseImage);
+  virtualDomainImage->SetRegions(virtualDomainBaseImage->GetLargestPossibleRegion());
+  virtualDomainImage->Allocate();
+
+  this->m_LevelVirtualDomainImages.assign(numberOfLevels, nullptr);
+  this->m_LevelFixedImages.assign(numberOfLevels, nullptr);
+  this->m_LevelFixedImageGradientImages.assign(numberOfLevels, nullptr);
+  this->m_LevelMetricSamplePointSets.assign(numberOfLevels, nullptr);
+
+  int currentRandomSeed = this->m_RandomSeed;
+  for (SizeValueType level = 0; level < numberOfLevels; ++level)
+  {
+    auto shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors(this->m_ShrinkFactorsPerLevel[level]);
+    shrinkFilter->SetInput(virtualDomainImage);
+    shrinkFilter->Update();
+    this->m_LevelVirtualDomainImages[level] = shrinkFilter->GetOutput();
+    this->m_LevelVirtualDomainImages[level]->DisconnectPipeline();
+
+    if (this->m_SmoothingSigmasPerLevel[level] > 0)
+    {
+      using SmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
+      auto                                         smoothingFilter = SmoothingFilterType::New();
+      typename SmoothingFilterType::SigmaArrayType sigmaArray(this->m_SmoothingSigmasPerLevel[level]);
+      if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
+      {
+        const typename FixedImageType::SpacingType & fixedSpacing = this->m_FixedImage->GetSpacing();
+        for (unsigned int i = 0; i < sigmaArray.Size(); ++i)
+        {
+          sigmaArray[i] *= fixedSpacing[i];
+        }
+      }
+      smoothingFilter->SetSigmaArray(sigmaArray);
+      smoothingFilter->SetInput(this->m_FixedImage);
+      smoothingFilter->Update();
+      FixedImagePointer smoothImage = smoothingFilter->GetOutput();
+      smoothImage->DisconnectPipeline();
+      this->m_LevelFixedImages[level] = smoothImage;
+    }
+    else
+    {
+      this->m_LevelFixedImages[level] = this->m_FixedImage;
+    }
+
+    if (this->m_ComputeFixedImageGradient)
+    {
+      // The settings of ImageToImageMetricv4::InitializeDefaultFixedImageGradientFilter().
+      const typename FixedImageType::SpacingType & spacing = this->m_FixedImage->GetSpacing();
+      double                                       maximumSpacing = 0.0;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        maximumSpacing = std::max(maximumSpacing, static_cast<double>(spacing[i]));
+      }
+      auto gradientFilter = FixedImageGradientFilterType::New();
+      gradientFilter->SetSigma(maximumSpacing);
+      gradientFilter->SetNormalizeAcrossScale(true);
+      gradientFilter->SetUseImageDirection(true);
+      gradientFilter->SetInput(this->m_LevelFixedImages[level]);
+      gradientFilter->Update();
+      this->m_LevelFixedImageGradientImages[level] = gradientFilter->GetOutput();
+      this->m_LevelFixedImageGradientImages[level]->DisconnectPipeline();
+    }
+
+    if (this->m_MetricSamplingStrategy != MetricSamplingStrategyEnum::NONE)
+    {
+      // The samples drawn by ImageRegistrationMethodv4::SetMetricSamplePoints() for a single metric.
+      using SamplerType = ImageRegistrationMetricSampler<FixedImageType, VirtualImageType, RealType>;
+      auto sampler = SamplerType::New();
+      sampler->SetVirtualImage(this->m_LevelVirtualDomainImages[level]);
+      sampler->SetFixedImage(this->m_LevelFixedImages[level]);
+      sampler->SetFixedImageMask(this->m_FixedImageMask);
+      sampler->SetMetricSamplingStrategy(this->m_MetricSamplingStrategy);
+      sampler->SetMetricSamplingPercentage(this->m_MetricSamplingPercentagePerLevel[level]);
+      sampler->SetRandomSeed(currentRandomSeed);
+      this->m_LevelMetricSamplePointSets[level] = sampler->GenerateSamplePointSet();
+      currentRandomSeed = sampler->GetRandomSeed();
+    }
+  }
+
+  this->m_UpdateTime.Modified();
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::CheckLevel(
+  SizeValueType level) const
+{
+  if (level >= this->m_LevelVirtualDomainImages.size())
+  {
+    itkExceptionMacro("The level " << level << " has not been computed: " << this->m_LevelVirtualDomainImages.size()
+                                   << " levels are computed by Update().");
+  }
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  GetLevelVirtualDomainImage(SizeValueType level) const -> const VirtualImageType *
+{
+  this->CheckLevel(level);
+  return this->m_LevelVirtualDomainImages[level];
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::GetLevelFixedImage(
+  SizeValueType level) const -> const FixedImageType *
+{
+  this->CheckLevel(level);
+  return this->m_LevelFixedImages[level];
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  GetLevelFixedImageGradientImage(SizeValueType level) const -> const FixedImageGradientImageType *
+{
+  this->CheckLevel(level);
+  return this->m_LevelFixedImageGradientImages[level];
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::
+  GetLevelMetricSamplePointSet(SizeValueType level) const -> const MetricSamplePointSetType *
+{
+  this->CheckLevel(level);
+  return this->m_LevelMetricSamplePointSets[level];
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationFixedImagePyramid<TFixedImage, TVirtualImage, TInternalComputationValueType>::PrintSelf(
+  std::ostream & os,
+  Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(FixedImage);
+  itkPrintSelfObjectMacro(VirtualDomainImage);
+  itkPrintSelfObjectMacro(FixedImageMask);
+
+  os << indent << "Number of levels: " << this->GetNumberOfLevels() << std::endl;
+  for (SizeValueType level = 0; level < this->GetNumberOfLevels(); ++level)
+  {
+    os << indent << "  Shrink factors (level " << level << "): " << this->m_ShrinkFactorsPerLevel[level] << std::endl;
+  }
+  os << indent << "Smoothing sigmas: " << this->m_SmoothingSigmasPerLevel << std::endl;
+  os << indent << "Smoothing sigmas are specified in physical units: "
+     << (this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits ? "On" : "Off") << std::endl;
+  os << indent << "Compute fixed image gradient: " << (this->m_ComputeFixedImageGradient ? "On" : "Off")
+     << std::endl;
+  os << indent << "Metric sampling strategy: " << this->m_MetricSamplingStrategy << std::endl;
+  os << indent << "Metric sampling percentage per level: " << this->m_MetricSamplingPercentagePerLevel << std::endl;
+  os << indent << "Random seed: " << this->m_RandomSeed << std::endl;
+  os << indent << "Number of levels computed: " << this->m_LevelVirtualDomainImages.size() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
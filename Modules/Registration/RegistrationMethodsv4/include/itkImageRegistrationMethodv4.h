@@ -47,18 +47,29 @@ public:
    * \class MetricSamplingStrategy
    * \ingroup ITKRegistrationMethodsv4
    * \brief enum type for metric sampling strategy
+   *
+   * \sa ImageRegistrationMetricSampler
    */
   enum class MetricSamplingStrategy : uint8_t
   {
     NONE,
     REGULAR,
-    RANDOM
+    RANDOM,
+    STRATIFIED,
+    LOW_DISCREPANCY,
+    GRADIENT_WEIGHTED
   };
 };
 // Define how to print enumeration
 extern ITKRegistrationMethodsv4_EXPORT std::ostream &
                                        operator<<(std::ostream & out, const ImageRegistrationMethodv4Enums::MetricSamplingStrategy value);
 
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+class ITK_TEMPLATE_EXPORT ImageRegistrationFixedImagePyramid;
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+class ITK_TEMPLATE_EXPORT ImageRegistrationMetricSampler;
+
 /** \class ImageRegistrationMethodv4
  * \brief Interface method for the current registration framework.
  *
@@ -199,6 +210,8 @@ public:
   using SmoothingSigmasArrayType = Array<RealType>;
   using MetricSamplingPercentageArrayType = Array<RealType>;
 
+  using FixedImagePyramidType = ImageRegistrationFixedImagePyramid<FixedImageType, VirtualImageType, RealType>;
+
   /** Transform adaptor type alias */
   using TransformParametersAdaptorType = TransformParametersAdaptorBase<InitialTransformType>;
   using TransformParametersAdaptorPointer = typename TransformParametersAdaptorType::Pointer;
@@ -303,7 +316,7 @@ public:
   itkSetObjectMacro(Metric, MetricType);
   itkGetModifiableObjectMacro(Metric, MetricType);
 
-  /** Set/Get the metric sampling strategy. */
+  /** Set/Get the metric sampling strategy, which ImageRegistrationMetricSampler describes. */
   itkSetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
   itkGetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
 
@@ -433,6 +446,21 @@ public:
   itkGetConstMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits, bool);
   itkBooleanMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits);
 
+  /**
+   * Set/Get a pyramid of the fixed image, computed beforehand and possibly shared with
+   * other registrations.  At each level, the image metrics whose fixed image is the fixed
+   * image of the pyramid use the smoothed fixed image, the gradient image and the virtual
+   * domain samples of the pyramid, and the virtual domain of the pyramid is not shrunk
+   * again.  The pyramid must have the levels, the shrink factors and the smoothing sigmas
+   * of the registration, and its virtual domain must be the one of the registration.  If
+   * the pyramid samples the virtual domain, it must use the sampling strategy, the sampling
+   * percentages, the random seed and the fixed image mask of the registration, which must
+   * not reseed its samples.  A metric whose fixed image gradient filter has been set
+   * computes its own gradient image.
+   */
+  itkSetConstObjectMacro(FixedImagePyramid, FixedImagePyramidType);
+  itkGetConstObjectMacro(FixedImagePyramid, FixedImagePyramidType);
+
   /** Make a DataObject of the correct type to be used as the specified output. */
   using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
   using Superclass::MakeOutput;
@@ -531,6 +559,11 @@ protected:
   virtual void
   SetMetricSamplePoints();
 
+  /** Check that the fixed image pyramid matches the levels, the virtual domain and the
+   * metric sampling. */
+  virtual void
+  VerifyFixedImagePyramid() const;
+
   SizeValueType m_CurrentLevel;
   SizeValueType m_NumberOfLevels;
   SizeValueType m_CurrentIteration;
@@ -560,6 +593,7 @@ protected:
   std::vector<ShrinkFactorsPerDimensionContainerType> m_ShrinkFactorsPerLevel;
   SmoothingSigmasArrayType                            m_SmoothingSigmasPerLevel;
   bool                                                m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
+  SmartPointer<const FixedImagePyramidType>           m_FixedImagePyramid;
 
   bool m_ReseedIterator;
   int  m_RandomSeed;
@@ -20,6 +20,9 @@
 
 #include "itkImageRegistrationMethodv4.h"
 
+#include "itkImageRegistrationFixedImagePyramid.h"
+#include "itkImageRegistrationMetricSampler.h"
+
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
 #include "itkGradientDescentOptimizerv4.h"
 #include "itkImageRandomConstIteratorWithIndex.h"
@@ -465,6 +468,11 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
         }
       }
     }
+
+    if (this->m_FixedImagePyramid)
+    {
+      this->VerifyFixedImagePyramid();
+    }
   }
   this->m_CompositeTransform->SetOnlyMostRecentTransformToOptimizeOn();
 
@@ -472,15 +480,19 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   //   1. subsample the reference domain (typically the fixed image) and/or
   //   2. smooth the fixed and moving images.
 
-  typename VirtualImageType::Pointer currentLevelVirtualDomainImage = nullptr;
-  if (this->m_VirtualDomainImage.IsNotNull())
+  typename VirtualImageType::ConstPointer currentLevelVirtualDomainImage = nullptr;
+  if (this->m_VirtualDomainImage.IsNotNull() && this->m_FixedImagePyramid)
+  {
+    currentLevelVirtualDomainImage = this->m_FixedImagePyramid->GetLevelVirtualDomainImage(level);
+  }
+  else if (this->m_VirtualDomainImage.IsNotNull())
   {
     typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
     shrinkFilter->SetShrinkFactors(this->m_ShrinkFactorsPerLevel[level]);
     shrinkFilter->SetInput(this->m_VirtualDomainImage);
+    shrinkFilter->Update();
 
     currentLevelVirtualDomainImage = shrinkFilter->GetOutput();
-    currentLevelVirtualDomainImage->Update();
   }
   else
   {
@@ -619,28 +631,45 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
          multiMetric->GetMetricQueue()[n]->GetMetricCategory() ==
            ObjectToObjectMetricBaseTemplateEnums::MetricCategory::IMAGE_METRIC))
     {
-      if (this->m_SmoothingSigmasPerLevel[level] > 0)
+      // The metrics of the fixed image of the pyramid use its smoothed image, and its gradient image unless
+      // their fixed image gradient filter has been set.
+      const bool usesFixedImagePyramid =
+        this->m_FixedImagePyramid && this->GetFixedImage(n) == this->m_FixedImagePyramid->GetFixedImage();
+      const typename ImageMetricType::FixedImageGradientImageType * fixedImageGradientImage = nullptr;
+      if (usesFixedImagePyramid)
       {
-        using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
-        typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter =
-          FixedImageSmoothingFilterType::New();
-        typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(
-          this->m_SmoothingSigmasPerLevel[level]);
+        fixedImageGradientImage = this->m_FixedImagePyramid->GetLevelFixedImageGradientImage(level);
+      }
 
-        if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
+      if (this->m_SmoothingSigmasPerLevel[level] > 0)
+      {
+        if (usesFixedImagePyramid)
+        {
+          this->m_FixedSmoothImages[n] = this->m_FixedImagePyramid->GetLevelFixedImage(level);
+        }
+        else
         {
-          auto & fixedSpacing = this->GetFixedImage(n)->GetSpacing();
-          for (unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i)
+          using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
+          typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter =
+            FixedImageSmoothingFilterType::New();
+          typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(
+            this->m_SmoothingSigmasPerLevel[level]);
+
+          if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
           {
-            fixedImageSigmaArray[i] *= fixedSpacing[i];
+            auto & fixedSpacing = this->GetFixedImage(n)->GetSpacing();
+            for (unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i)
+            {
+              fixedImageSigmaArray[i] *= fixedSpacing[i];
+            }
           }
-        }
-        fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
-        fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
+          fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
+          fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
 
-        this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
-        fixedImageSmoothingFilter->Update();
-        fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+          this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
+          fixedImageSmoothingFilter->Update();
+          fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+        }
 
         using MovingImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<MovingImageType, MovingImageType>;
         typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter =
@@ -680,6 +709,12 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
           ->SetFixedImageMask(this->m_FixedImageMasks[n]);
         dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer())
           ->SetMovingImageMask(this->m_MovingImageMasks[n]);
+        if (this->m_FixedImagePyramid)
+        {
+          auto * imageMetric = dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer());
+          imageMetric->SetPrecomputedFixedImageGradientImage(
+            imageMetric->GetFixedImageGradientFilterIsDefault() ? fixedImageGradientImage : nullptr);
+        }
       }
       else if (this->m_Metric->GetMetricCategory() ==
                ObjectToObjectMetricBaseTemplateEnums::MetricCategory::IMAGE_METRIC)
@@ -689,6 +724,12 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
         dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer())->SetFixedImageMask(this->m_FixedImageMasks[n]);
         dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer())->SetMovingImageMask(this->m_MovingImageMasks[n]);
+        if (this->m_FixedImagePyramid)
+        {
+          auto * imageMetric = dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer());
+          imageMetric->SetPrecomputedFixedImageGradientImage(
+            imageMetric->GetFixedImageGradientFilterIsDefault() ? fixedImageGradientImage : nullptr);
+        }
       }
       else
       {
@@ -734,6 +775,33 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
     this->SetMetricSamplePoints();
   }
 
+  // The samples of the pyramid, drawn as the ones of the registration, replace the ones of the metrics of its
+  // fixed image.
+  if (this->m_MetricSamplingStrategy != MetricSamplingStrategyEnum::NONE && this->m_FixedImagePyramid &&
+      this->m_FixedImagePyramid->GetLevelMetricSamplePointSet(level))
+  {
+    auto * samplePointSet =
+      const_cast<MetricSamplePointSetType *>(this->m_FixedImagePyramid->GetLevelMetricSamplePointSet(level));
+    for (SizeValueType n = 0; n < this->m_NumberOfMetrics; n++)
+    {
+      ImageMetricType * imageMetric = nullptr;
+      if (multiMetric)
+      {
+        imageMetric = dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer());
+      }
+      else
+      {
+        imageMetric = dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer());
+      }
+      if (imageMetric && this->GetFixedImage(n) == this->m_FixedImagePyramid->GetFixedImage())
+      {
+        imageMetric->SetVirtualSampledPointSet(samplePointSet);
+        imageMetric->UseSampledPointSetOn();
+        imageMetric->UseVirtualSampledPointSetOn();
+      }
+    }
+  }
+
   // Update the optimizer
 
   this->m_Optimizer->SetMetric(this->m_Metric);
@@ -919,7 +987,6 @@ void
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SetMetricSamplePoints()
 {
   using VirtualDomainImageType = typename ImageMetricType::VirtualImageType;
-  using VirtualDomainRegionType = typename VirtualDomainImageType::RegionType;
 
   const VirtualDomainImageType * virtualImage = nullptr;
   const FixedImageMaskType *     fixedMaskImage = nullptr;
@@ -963,101 +1030,26 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
     }
   }
 
-  const VirtualDomainRegionType &                    virtualDomainRegion = virtualImage->GetRequestedRegion();
-  const typename VirtualDomainImageType::SpacingType oneThirdVirtualSpacing = virtualImage->GetSpacing() / 3.0;
+  using SamplerType = ImageRegistrationMetricSampler<FixedImageType, VirtualDomainImageType, RealType>;
+  typename SamplerType::Pointer sampler = SamplerType::New();
+  sampler->SetVirtualImage(virtualImage);
+  sampler->SetFixedImageMask(fixedMaskImage);
+  sampler->SetMetricSamplingStrategy(this->m_MetricSamplingStrategy);
+  sampler->SetMetricSamplingPercentage(this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel]);
+  sampler->SetReseedIterator(this->m_ReseedIterator);
 
   for (SizeValueType n = 0; n < numberOfLocalMetrics; n++)
   {
-    typename MetricSamplePointSetType::Pointer samplePointSet = MetricSamplePointSetType::New();
-    samplePointSet->Initialize();
-
-    using SamplePointType = typename MetricSamplePointSetType::PointType;
-
-    using RandomizerType = Statistics::MersenneTwisterRandomVariateGenerator;
-    typename RandomizerType::Pointer randomizer = RandomizerType::New();
-    if (m_ReseedIterator)
-    {
-      randomizer->SetSeed();
-    }
-    else
-    {
-      randomizer->SetSeed(m_CurrentRandomSeed++);
-    }
-
-
-    unsigned long index = 0;
+    ImageMetricType * imageMetric = multiMetric
+                                      ? dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer())
+                                      : dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer());
 
-    switch (this->m_MetricSamplingStrategy)
-    {
-      case MetricSamplingStrategyEnum::REGULAR:
-      {
-        const auto sampleCount =
-          static_cast<unsigned long>(std::ceil(1.0 / this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel]));
-        unsigned long count =
-          sampleCount; // Start at sampleCount to keep behavior backwards identical, using first element.
-        ImageRegionConstIteratorWithIndex<VirtualDomainImageType> It(virtualImage, virtualDomainRegion);
-        for (It.GoToBegin(); !It.IsAtEnd(); ++It)
-        {
-          if (count == sampleCount)
-          {
-            count = 0; // Reset counter
-            SamplePointType point;
-            virtualImage->TransformIndexToPhysicalPoint(It.GetIndex(), point);
-
-            // randomly perturb the point within a voxel (approximately)
-            for (SizeValueType d = 0; d < ImageDimension; d++)
-            {
-              point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
-            }
-            if (!fixedMaskImage || fixedMaskImage->IsInsideInWorldSpace(point))
-            {
-              samplePointSet->SetPoint(index, point);
-              ++index;
-            }
-          }
-          ++count;
-        }
-        break;
-      }
-      case MetricSamplingStrategyEnum::RANDOM:
-      {
-        const unsigned long totalVirtualDomainVoxels = virtualDomainRegion.GetNumberOfPixels();
-        const auto          sampleCount =
-          static_cast<unsigned long>(static_cast<float>(totalVirtualDomainVoxels) *
-                                     this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel]);
-        ImageRandomConstIteratorWithIndex<VirtualDomainImageType> ItR(virtualImage, virtualDomainRegion);
-        if (m_ReseedIterator)
-        {
-          ItR.ReinitializeSeed();
-        }
-        else
-        {
-          ItR.ReinitializeSeed(m_CurrentRandomSeed++);
-        }
-        ItR.SetNumberOfSamples(sampleCount);
-        for (ItR.GoToBegin(); !ItR.IsAtEnd(); ++ItR)
-        {
-          SamplePointType point;
-          virtualImage->TransformIndexToPhysicalPoint(ItR.GetIndex(), point);
-
-          // randomly perturb the point within a voxel (approximately)
-          for (unsigned int d = 0; d < ImageDimension; d++)
-          {
-            point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
-          }
-          if (!fixedMaskImage || fixedMaskImage->IsInsideInWorldSpace(point))
-          {
-            samplePointSet->SetPoint(index, point);
-            ++index;
-          }
-        }
-        break;
-      }
-      default:
-      {
-        itkExceptionMacro("Invalid sampling strategy requested.");
-      }
-    }
+    // The gradient weighted samples are weighted by the fixed image of the metric at this level.
+    sampler->SetFixedImage(this->m_FixedSmoothImages[n]);
+    sampler->SetFixedTransform(imageMetric ? imageMetric->GetFixedTransform() : nullptr);
+    sampler->SetRandomSeed(this->m_CurrentRandomSeed);
+    typename MetricSamplePointSetType::Pointer samplePointSet = sampler->GenerateSamplePointSet();
+    this->m_CurrentRandomSeed = sampler->GetRandomSeed();
 
     if (multiMetric)
     {
@@ -1075,6 +1067,79 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   }
 }
 
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::VerifyFixedImagePyramid()
+  const
+{
+  const FixedImagePyramidType * pyramid = this->m_FixedImagePyramid;
+
+  if (pyramid->GetNumberOfLevels() != this->m_NumberOfLevels)
+  {
+    itkExceptionMacro("The fixed image pyramid has " << pyramid->GetNumberOfLevels() << " levels instead of "
+                                                     << this->m_NumberOfLevels << ".");
+  }
+  if (pyramid->GetSmoothingSigmasAreSpecifiedInPhysicalUnits() != this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
+  {
+    itkExceptionMacro("The smoothing sigmas of the fixed image pyramid are not specified in the same units.");
+  }
+  for (SizeValueType level = 0; level < this->m_NumberOfLevels; level++)
+  {
+    if (pyramid->GetShrinkFactorsPerDimension(level) != this->m_ShrinkFactorsPerLevel[level] ||
+        pyramid->GetSmoothingSigmasPerLevel()[level] != this->m_SmoothingSigmasPerLevel[level])
+    {
+      itkExceptionMacro("The shrink factors or the smoothing sigma of the level "
+                        << level << " of the fixed image pyramid differ from the ones of the registration.");
+    }
+  }
+
+  const VirtualImageBaseType * pyramidVirtualDomainImage = pyramid->GetVirtualDomainImage();
+  if (pyramidVirtualDomainImage->GetLargestPossibleRegion() !=
+        this->m_VirtualDomainImage->GetLargestPossibleRegion() ||
+      pyramidVirtualDomainImage->GetOrigin() != this->m_VirtualDomainImage->GetOrigin() ||
+      pyramidVirtualDomainImage->GetSpacing() != this->m_VirtualDomainImage->GetSpacing() ||
+      pyramidVirtualDomainImage->GetDirection() != this->m_VirtualDomainImage->GetDirection())
+  {
+    itkExceptionMacro("The virtual domain of the fixed image pyramid differs from the one of the registration.");
+  }
+
+  bool isFixedImage = false;
+  for (SizeValueType n = 0; n < this->m_NumberOfFixedObjects; n++)
+  {
+    isFixedImage = isFixedImage || this->GetFixedImage(n) == pyramid->GetFixedImage();
+  }
+  if (!isFixedImage)
+  {
+    itkExceptionMacro("The fixed image of the fixed image pyramid is not a fixed image of the registration.");
+  }
+
+  // The samples of the pyramid must be the ones the registration would draw.
+  if (pyramid->GetMetricSamplingStrategy() == MetricSamplingStrategyEnum::NONE)
+  {
+    return;
+  }
+  if (pyramid->GetMetricSamplingStrategy() != this->m_MetricSamplingStrategy ||
+      pyramid->GetMetricSamplingPercentagePerLevel() != this->m_MetricSamplingPercentagePerLevel)
+  {
+    itkExceptionMacro("The metric sampling strategy or percentages of the fixed image pyramid differ from the ones "
+                      "of the registration.");
+  }
+  if (this->m_ReseedIterator || pyramid->GetRandomSeed() != this->m_RandomSeed)
+  {
+    itkExceptionMacro("The fixed image pyramid samples with another random seed than the registration, or the "
+                      "registration reseeds its samples.");
+  }
+  for (SizeValueType n = 0; n < this->m_NumberOfMetrics; n++)
+  {
+    if (this->GetFixedImage(n) == pyramid->GetFixedImage() &&
+        this->m_FixedImageMasks[n].GetPointer() != pyramid->GetFixedImageMask())
+    {
+      itkExceptionMacro("The fixed image mask of the metric " << n
+                                                               << " differs from the one of the fixed image pyramid.");
+    }
+  }
+}
+
 template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
 void
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
@@ -1206,6 +1271,8 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   os << indent << "RandomSeed: " << m_RandomSeed << std::endl;
   os << indent << "CurrentRandomSeed: " << m_CurrentRandomSeed << std::endl;
 
+  itkPrintSelfObjectMacro(FixedImagePyramid);
+
   os << indent << "InPlace: " << (this->m_InPlace ? "On" : "Off") << std::endl;
 
   os << indent
@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegistrationMetricSampler_h
+#define itkImageRegistrationMetricSampler_h
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+namespace itk
+{
+/** \class ImageRegistrationMetricSampler
+ * \brief Draw the virtual domain samples of the image metrics of a
+ * registration.
+ *
+ * The samples are drawn in the requested region of the virtual image, inside
+ * the fixed image mask if one is set, according to the metric sampling
+ * strategy:
+ *
+ * - REGULAR: every n-th voxel, n being the inverse of the sampling
+ *   percentage.
+ * - RANDOM: voxels drawn at random.
+ * - STRATIFIED: the region is divided in blocks, as many as the samples,
+ *   and a voxel is drawn at random in each block, which spreads the samples
+ *   evenly without the aliasing of the regular grid.
+ * - LOW_DISCREPANCY: the points of a randomly shifted Halton sequence, which
+ *   cover the region more uniformly than random points.
+ * - GRADIENT_WEIGHTED: voxels drawn with a probability proportional to the
+ *   gradient magnitude of the fixed image at their point, plus a tenth of its
+ *   mean, so that the samples concentrate on the edges which drive the
+ *   registration without leaving the uniform regions out.
+ *
+ * The points of the samples are perturbed randomly within their voxel,
+ * except for LOW_DISCREPANCY, whose points are not on the voxel grid. The
+ * samples of the STRATIFIED, LOW_DISCREPANCY and GRADIENT_WEIGHTED
+ * strategies are sorted in the memory order of their voxels, so that the
+ * metrics read the images in order. The ones of REGULAR and RANDOM are kept
+ * in the order in which they have always been drawn.
+ *
+ * The seeds of the random generators are taken from RandomSeed, which is
+ * advanced past the seeds used, unless ReseedIterator is on, in which case
+ * the generators are seeded from the wall clock.
+ *
+ * \sa ImageRegistrationMethodv4
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template <typename TFixedImage, typename TVirtualImage = TFixedImage, typename TInternalComputationValueType = double>
+class ITK_TEMPLATE_EXPORT ImageRegistrationMetricSampler : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageRegistrationMetricSampler);
+
+  /** Standard class type aliases. */
+  using Self = ImageRegistrationMetricSampler;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageRegistrationMetricSampler, Object);
+
+  /** ImageDimension constants */
+  static constexpr unsigned int ImageDimension = TFixedImage::ImageDimension;
+
+  using FixedImageType = TFixedImage;
+  using VirtualImageType = TVirtualImage;
+  using RealType = TInternalComputationValueType;
+  using FixedTransformType = Transform<RealType, ImageDimension, ImageDimension>;
+  using FixedImageMaskType = SpatialObject<ImageDimension>;
+
+  using MetricSamplingStrategyEnum = ImageRegistrationMethodv4Enums::MetricSamplingStrategy;
+  using MetricSamplePointSetType = PointSet<typename FixedImageType::PixelType, ImageDimension>;
+  using MetricSamplePointSetPointer = typename MetricSamplePointSetType::Pointer;
+
+  /** Set/Get the virtual image, in whose requested region the samples are
+   * drawn. */
+  itkSetConstObjectMacro(VirtualImage, VirtualImageType);
+  itkGetConstObjectMacro(VirtualImage, VirtualImageType);
+
+  /** Set/Get the fixed image, whose gradient weights the GRADIENT_WEIGHTED
+   * samples. */
+  itkSetConstObjectMacro(FixedImage, FixedImageType);
+  itkGetConstObjectMacro(FixedImage, FixedImageType);
+
+  /** Set/Get the transform which maps the virtual domain to the fixed image,
+   * for the GRADIENT_WEIGHTED samples. The identity if none is set. */
+  itkSetConstObjectMacro(FixedTransform, FixedTransformType);
+  itkGetConstObjectMacro(FixedTransform, FixedTransformType);
+
+  /** Set/Get the mask of the fixed image, outside of which no samples are
+   * drawn. */
+  itkSetConstObjectMacro(FixedImageMask, FixedImageMaskType);
+  itkGetConstObjectMacro(FixedImageMask, FixedImageMaskType);
+
+  /** Set/Get the sampling strategy. Defaults to REGULAR. */
+  itkSetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
+  itkGetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
+
+  /** Set/Get the percentage of the virtual domain which is sampled, in
+   * (0.0, 1.0]. Defaults to 1. */
+  itkSetClampMacro(MetricSamplingPercentage, RealType, NumericTraits<RealType>::epsilon(), 1.0);
+  itkGetConstMacro(MetricSamplingPercentage, RealType);
+
+  /** Set/Get the seed of the next random generator. */
+  itkSetMacro(RandomSeed, int);
+  itkGetConstMacro(RandomSeed, int);
+
+  /** Set/Get whether the random generators are seeded from the wall clock.
+   * Defaults to false. */
+  itkSetMacro(ReseedIterator, bool);
+  itkGetConstMacro(ReseedIterator, bool);
+  itkBooleanMacro(ReseedIterator);
+
+  /** Draw the samples. */
+  MetricSamplePointSetPointer
+  GenerateSamplePointSet();
+
+protected:
+  ImageRegistrationMetricSampler() = default;
+  ~ImageRegistrationMetricSampler() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  using VirtualIndexType = typename VirtualImageType::IndexType;
+  using VirtualPointType = typename MetricSamplePointSetType::PointType;
+  using RandomizerType = Statistics::MersenneTwisterRandomVariateGenerator;
+
+  /** A sample, with the offset of its voxel in the virtual image. */
+  using SampleType = std::pair<OffsetValueType, VirtualPointType>;
+  using SamplesContainerType = std::vector<SampleType>;
+
+  /** The radical inverse of the integer in the base, the Halton sequence of
+   * the base. */
+  static double
+  RadicalInverse(SizeValueType i, unsigned int base);
+
+  /** The n-th prime, the base of the Halton sequence of the n-th dimension. */
+  static unsigned int
+  Prime(unsigned int n);
+
+  /** Add the point of the voxel, perturbed within the voxel, to the samples
+   * if it is inside the mask. */
+  void
+  AddVoxelSample(const VirtualIndexType & index, RandomizerType * randomizer, SamplesContainerType & samples) const;
+
+  void
+  SampleStratified(RandomizerType * randomizer, SamplesContainerType & samples) const;
+
+  void
+  SampleLowDiscrepancy(RandomizerType * randomizer, SamplesContainerType & samples) const;
+
+  void
+  SampleGradientWeighted(RandomizerType * randomizer, SamplesContainerType & samples) const;
+
+  typename VirtualImageType::ConstPointer   m_VirtualImage;
+  typename FixedImageType::ConstPointer     m_FixedImage;
+  typename FixedTransformType::ConstPointer m_FixedTransform;
+  typename FixedImageMaskType::ConstPointer m_FixedImageMask;
+  MetricSamplingStrategyEnum                m_MetricSamplingStrategy{ MetricSamplingStrategyEnum::REGULAR };
+  RealType                                  m_MetricSamplingPercentage{ 1.0 };
+  int                                       m_RandomSeed{ 0 };
+  bool                                      m_ReseedIterator{ false };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageRegistrationMetricSampler.hxx"
+#endif
+
+#endif // itkImageRegistrationMetricSampler_h
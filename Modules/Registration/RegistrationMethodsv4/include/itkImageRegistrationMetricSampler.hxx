@@ -0,0 +1,381 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegistrationMetricSampler_hxx
+#define itkImageRegistrationMetricSampler_hxx
+
+#include "itkImageRegistrationMetricSampler.h"
+
+#include "itkCentralDifferenceImageFunction.h"
+#include "itkImageRandomConstIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+#include <algorithm>
+
+namespace itk
+{
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+double
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::RadicalInverse(
+  SizeValueType i,
+  unsigned int  base)
+{
+  double inverse = 0.0;
+  double factor = 1.0;
+  while (i > 0)
+  {
+    factor /= base;
+    inverse += factor * static_cast<double>(i % base);
+    i /= base;
+  }
+  return inverse;
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+unsigned int
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::Prime(unsigned int n)
+{
+  unsigned int prime = 1;
+  for (unsigned int count = 0; count <= n;)
+  {
+    ++prime;
+    bool isPrime = true;
+    for (unsigned int divisor = 2; divisor * divisor <= prime && isPrime; ++divisor)
+    {
+      isPrime = prime % divisor != 0;
+    }
+    count += isPrime ? 1 : 0;
+  }
+  return prime;
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+auto
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::GenerateSamplePointSet()
+  -> MetricSamplePointSetPointer
+{
+  if (this->m_VirtualImage.IsNull())
+  {
+    itkExceptionMacro("The virtual image is not present.");
+  }
+
+  typename RandomizerType::Pointer randomizer = RandomizerType::New();
+  if (this->m_ReseedIterator)
+  {
+    randomizer->SetSeed();
+  }
+  else
+  {
+    randomizer->SetSeed(this->m_RandomSeed++);
+  }
+
+  SamplesContainerType samples;
+  bool                 sortSamples = true;
+
+  switch (this->m_MetricSamplingStrategy)
+  {
+    case MetricSamplingStrategyEnum::REGULAR:
+    {
+      const auto sampleCount = static_cast<unsigned long>(std::ceil(1.0 / this->m_MetricSamplingPercentage));
+      // Start at sampleCount to keep behavior backwards identical, using first element.
+      unsigned long count = sampleCount;
+      ImageRegionConstIteratorWithIndex<VirtualImageType> It(this->m_VirtualImage,
+                                                             this->m_VirtualImage->GetRequestedRegion());
+      for (It.GoToBegin(); !It.IsAtEnd(); ++It)
+      {
+        if (count == sampleCount)
+        {
+          count = 0; // Reset counter
+          this->AddVoxelSample(It.GetIndex(), randomizer, samples);
+        }
+        ++count;
+      }
+      sortSamples = false;
+      break;
+    }
+    case MetricSamplingStrategyEnum::RANDOM:
+    {
+      const typename VirtualImageType::RegionType & virtualDomainRegion = this->m_VirtualImage->GetRequestedRegion();
+      const auto                                    sampleCount = static_cast<unsigned long>(
+        static_cast<float>(virtualDomainRegion.GetNumberOfPixels()) * this->m_MetricSamplingPercentage);
+      ImageRandomConstIteratorWithIndex<VirtualImageType> ItR(this->m_VirtualImage, virtualDomainRegion);
+      if (this->m_ReseedIterator)
+      {
+        ItR.ReinitializeSeed();
+      }
+      else
+      {
+        ItR.ReinitializeSeed(this->m_RandomSeed++);
+      }
+      ItR.SetNumberOfSamples(sampleCount);
+      for (ItR.GoToBegin(); !ItR.IsAtEnd(); ++ItR)
+      {
+        this->AddVoxelSample(ItR.GetIndex(), randomizer, samples);
+      }
+      sortSamples = false;
+      break;
+    }
+    case MetricSamplingStrategyEnum::STRATIFIED:
+    {
+      this->SampleStratified(randomizer, samples);
+      break;
+    }
+    case MetricSamplingStrategyEnum::LOW_DISCREPANCY:
+    {
+      this->SampleLowDiscrepancy(randomizer, samples);
+      break;
+    }
+    case MetricSamplingStrategyEnum::GRADIENT_WEIGHTED:
+    {
+      this->SampleGradientWeighted(randomizer, samples);
+      break;
+    }
+    default:
+    {
+      itkExceptionMacro("Invalid sampling strategy requested.");
+    }
+  }
+
+  if (sortSamples)
+  {
+    std::stable_sort(samples.begin(), samples.end(), [](const SampleType & a, const SampleType & b) {
+      return a.first < b.first;
+    });
+  }
+
+  MetricSamplePointSetPointer samplePointSet = MetricSamplePointSetType::New();
+  samplePointSet->Initialize();
+  unsigned long index = 0;
+  for (const SampleType & sample : samples)
+  {
+    samplePointSet->SetPoint(index++, sample.second);
+  }
+  return samplePointSet;
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::AddVoxelSample(
+  const VirtualIndexType & index,
+  RandomizerType *         randomizer,
+  SamplesContainerType &   samples) const
+{
+  const typename VirtualImageType::SpacingType oneThirdVirtualSpacing = this->m_VirtualImage->GetSpacing() / 3.0;
+
+  VirtualPointType point;
+  this->m_VirtualImage->TransformIndexToPhysicalPoint(index, point);
+
+  // randomly perturb the point within a voxel (approximately)
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
+  }
+  if (!this->m_FixedImageMask || this->m_FixedImageMask->IsInsideInWorldSpace(point))
+  {
+    samples.emplace_back(this->m_VirtualImage->ComputeOffset(index), point);
+  }
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::SampleStratified(
+  RandomizerType *       randomizer,
+  SamplesContainerType & samples) const
+{
+  const typename VirtualImageType::RegionType & region = this->m_VirtualImage->GetRequestedRegion();
+  const typename VirtualImageType::SizeType &   size = region.GetSize();
+  const double                                  numberOfPixels = static_cast<double>(region.GetNumberOfPixels());
+  const double sampleCount = std::floor(numberOfPixels * this->m_MetricSamplingPercentage);
+  if (sampleCount < 1.0)
+  {
+    return;
+  }
+
+  // As many blocks along each dimension as there are samples along it, and
+  // a voxel in each block, kept with the probability which gives the number
+  // of samples when the blocks are more than the samples.
+  const double samplingRateAlongDimension = std::pow(sampleCount / numberOfPixels, 1.0 / ImageDimension);
+  typename VirtualImageType::SizeType numberOfBlocks;
+  double                              totalNumberOfBlocks = 1.0;
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    const auto blocksAlongDimension = static_cast<SizeValueType>(std::ceil(size[d] * samplingRateAlongDimension));
+    numberOfBlocks[d] = std::min(size[d], std::max<SizeValueType>(1, blocksAlongDimension));
+    totalNumberOfBlocks *= numberOfBlocks[d];
+  }
+  const double keepProbability = std::min(1.0, sampleCount / totalNumberOfBlocks);
+
+  const auto blockCount = static_cast<SizeValueType>(totalNumberOfBlocks);
+  samples.reserve(static_cast<SizeValueType>(sampleCount));
+  for (SizeValueType block = 0; block < blockCount; block++)
+  {
+    VirtualIndexType index;
+    SizeValueType    remainder = block;
+    for (unsigned int d = 0; d < ImageDimension; d++)
+    {
+      const SizeValueType blockIndex = remainder % numberOfBlocks[d];
+      remainder /= numberOfBlocks[d];
+      const SizeValueType begin = blockIndex * size[d] / numberOfBlocks[d];
+      const SizeValueType end = (blockIndex + 1) * size[d] / numberOfBlocks[d];
+      index[d] = region.GetIndex(d) + static_cast<IndexValueType>(begin) +
+                 static_cast<IndexValueType>(randomizer->GetIntegerVariate(
+                   static_cast<RandomizerType::IntegerType>(end - begin - 1)));
+    }
+    if (keepProbability < 1.0 && randomizer->GetVariateWithOpenUpperRange() >= keepProbability)
+    {
+      continue;
+    }
+    this->AddVoxelSample(index, randomizer, samples);
+  }
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::SampleLowDiscrepancy(
+  RandomizerType *       randomizer,
+  SamplesContainerType & samples) const
+{
+  using ContinuousIndexType = ContinuousIndex<typename VirtualPointType::ValueType, ImageDimension>;
+
+  const typename VirtualImageType::RegionType & region = this->m_VirtualImage->GetRequestedRegion();
+  const auto                                    sampleCount = static_cast<SizeValueType>(
+    static_cast<float>(region.GetNumberOfPixels()) * this->m_MetricSamplingPercentage);
+
+  // A random shift of the sequence, modulo 1, so that the samples depend on
+  // the seed, as for the other strategies.
+  double       shift[ImageDimension];
+  unsigned int base[ImageDimension];
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    shift[d] = randomizer->GetVariateWithOpenUpperRange();
+    base[d] = Prime(d);
+  }
+
+  samples.reserve(sampleCount);
+  for (SizeValueType i = 1; i <= sampleCount; i++)
+  {
+    ContinuousIndexType continuousIndex;
+    VirtualIndexType    index;
+    for (unsigned int d = 0; d < ImageDimension; d++)
+    {
+      double u = RadicalInverse(i, base[d]) + shift[d];
+      u -= std::floor(u);
+      continuousIndex[d] = region.GetIndex(d) - 0.5 + u * region.GetSize(d);
+      index[d] = std::min(
+        std::max(Math::RoundHalfIntegerUp<IndexValueType>(continuousIndex[d]), region.GetIndex(d)),
+        region.GetIndex(d) + static_cast<IndexValueType>(region.GetSize(d)) - 1);
+    }
+
+    VirtualPointType point;
+    this->m_VirtualImage->TransformContinuousIndexToPhysicalPoint(continuousIndex, point);
+    if (!this->m_FixedImageMask || this->m_FixedImageMask->IsInsideInWorldSpace(point))
+    {
+      samples.emplace_back(this->m_VirtualImage->ComputeOffset(index), point);
+    }
+  }
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::SampleGradientWeighted(
+  RandomizerType *       randomizer,
+  SamplesContainerType & samples) const
+{
+  if (this->m_FixedImage.IsNull())
+  {
+    itkExceptionMacro("The fixed image is required by the GRADIENT_WEIGHTED sampling strategy.");
+  }
+
+  const typename VirtualImageType::RegionType & region = this->m_VirtualImage->GetRequestedRegion();
+  const auto                                    sampleCount = static_cast<SizeValueType>(
+    static_cast<float>(region.GetNumberOfPixels()) * this->m_MetricSamplingPercentage);
+  if (sampleCount == 0)
+  {
+    return;
+  }
+
+  // The gradient magnitude of the fixed image at the point of each voxel.
+  using GradientCalculatorType = CentralDifferenceImageFunction<FixedImageType, RealType>;
+  typename GradientCalculatorType::Pointer gradientCalculator = GradientCalculatorType::New();
+  gradientCalculator->SetInputImage(this->m_FixedImage);
+
+  std::vector<float> weights;
+  weights.reserve(region.GetNumberOfPixels());
+  double                                              sumOfWeights = 0.0;
+  ImageRegionConstIteratorWithIndex<VirtualImageType> It(this->m_VirtualImage, region);
+  for (It.GoToBegin(); !It.IsAtEnd(); ++It)
+  {
+    typename FixedTransformType::InputPointType point;
+    this->m_VirtualImage->TransformIndexToPhysicalPoint(It.GetIndex(), point);
+    if (this->m_FixedTransform)
+    {
+      point = this->m_FixedTransform->TransformPoint(point);
+    }
+    typename FixedImageType::IndexType fixedIndex;
+    float                              weight = 0.0f;
+    if (this->m_FixedImage->TransformPhysicalPointToIndex(point, fixedIndex) &&
+        gradientCalculator->IsInsideBuffer(fixedIndex))
+    {
+      weight = static_cast<float>(gradientCalculator->EvaluateAtIndex(fixedIndex).GetNorm());
+    }
+    weights.push_back(weight);
+    sumOfWeights += weight;
+  }
+
+  // Systematic sampling of the cumulated weights, which draws the voxels in
+  // memory order, a voxel whose weight is larger than the step being drawn
+  // several times.
+  const double floorWeight = sumOfWeights > 0.0 ? 0.1 * sumOfWeights / weights.size() : 1.0;
+  const double step = (sumOfWeights + floorWeight * weights.size()) / sampleCount;
+  double       nextSample = randomizer->GetVariateWithOpenUpperRange() * step;
+  double       cumulatedWeight = 0.0;
+
+  samples.reserve(sampleCount);
+  SizeValueType voxel = 0;
+  for (It.GoToBegin(); !It.IsAtEnd(); ++It, ++voxel)
+  {
+    cumulatedWeight += weights[voxel] + floorWeight;
+    while (nextSample < cumulatedWeight)
+    {
+      this->AddVoxelSample(It.GetIndex(), randomizer, samples);
+      nextSample += step;
+    }
+  }
+}
+
+template <typename TFixedImage, typename TVirtualImage, typename TInternalComputationValueType>
+void
+ImageRegistrationMetricSampler<TFixedImage, TVirtualImage, TInternalComputationValueType>::PrintSelf(
+  std::ostream & os,
+  Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(VirtualImage);
+  itkPrintSelfObjectMacro(FixedImage);
+  itkPrintSelfObjectMacro(FixedTransform);
+  itkPrintSelfObjectMacro(FixedImageMask);
+
+  os << indent << "Metric sampling strategy: " << this->m_MetricSamplingStrategy << std::endl;
+  os << indent << "Metric sampling percentage: " << this->m_MetricSamplingPercentage << std::endl;
+  os << indent << "Random seed: " << this->m_RandomSeed << std::endl;
+  os << indent << "Reseed iterator: " << (this->m_ReseedIterator ? "On" : "Off") << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -32,6 +32,12 @@ operator<<(std::ostream & out, const ImageRegistrationMethodv4Enums::MetricSampl
         return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::REGULAR";
       case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::RANDOM:
         return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::RANDOM";
+      case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::STRATIFIED:
+        return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::STRATIFIED";
+      case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::LOW_DISCREPANCY:
+        return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::LOW_DISCREPANCY";
+      case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::GRADIENT_WEIGHTED:
+        return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::GRADIENT_WEIGHTED";
       default:
         return "INVALID VALUE FOR itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy";
     }
@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTestingMacros.h"
+
+#include <atomic>
+
+/* ImageRegistrationMethodv4 gives its metric a composite transform, whose
+ * only optimized transform is the output transform, added after the moving
+ * initial transform. This test checks that the metrics map the points of an
+ * output B-spline transform by blocks, with and without a linear moving
+ * initial transform, the B-spline transform mapping no point by itself. */
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+
+// A B-spline transform which counts the points it maps by blocks, and the
+// ones it maps one by one.
+class CountingBSplineTransform : public itk::BSplineTransform<double, Dimension, 3>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CountingBSplineTransform);
+
+  using Self = CountingBSplineTransform;
+  using Superclass = itk::BSplineTransform<double, Dimension, 3>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(CountingBSplineTransform, BSplineTransform);
+
+  using Superclass::TransformPoint;
+
+  OutputPointType
+  TransformPoint(const InputPointType & point) const override
+  {
+    ++m_NumberOfPointsMappedOneByOne;
+    return Superclass::TransformPoint(point);
+  }
+
+  void
+  TransformPoints(const InputPointType *    inputPoints,
+                  itk::SizeValueType        numberOfPoints,
+                  OutputPointType *         outputPoints,
+                  WeightsValueType *        weights,
+                  ParameterIndexValueType * indices,
+                  bool *                    inside) const override
+  {
+    m_NumberOfPointsMappedByBlocks += numberOfPoints;
+    Superclass::TransformPoints(inputPoints, numberOfPoints, outputPoints, weights, indices, inside);
+  }
+
+  mutable std::atomic<itk::SizeValueType> m_NumberOfPointsMappedOneByOne{ 0 };
+  mutable std::atomic<itk::SizeValueType> m_NumberOfPointsMappedByBlocks{ 0 };
+
+protected:
+  CountingBSplineTransform() = default;
+  ~CountingBSplineTransform() override = default;
+};
+
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, CountingBSplineTransform>;
+using MetricType = RegistrationType::ImageMetricType;
+
+// An image of a blob centered on the point.
+ImageType::Pointer
+MakeBlobImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(40);
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    const double dx = point[0] - centerX;
+    const double dy = point[1] - centerY;
+    it.Set(100.0 * std::exp(-(dx * dx + 2.0 * dy * dy) / 150.0));
+  }
+  return image;
+}
+
+// Registers the moving image to the fixed image with a B-spline transform,
+// after the moving initial transform if there is one, and checks that the
+// points of the B-spline transform are mapped by blocks.
+int
+Register(const std::string &                            name,
+         const ImageType *                              fixedImage,
+         const ImageType *                              movingImage,
+         MetricType *                                   metric,
+         const RegistrationType::InitialTransformType * movingInitialTransform)
+{
+  auto                                   bspline = CountingBSplineTransform::New();
+  CountingBSplineTransform::MeshSizeType meshSize;
+  meshSize.Fill(4);
+  CountingBSplineTransform::PhysicalDimensionsType dimensions;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    dimensions[d] = fixedImage->GetSpacing()[d] * (fixedImage->GetLargestPossibleRegion().GetSize()[d] - 1);
+  }
+  bspline->SetTransformDomainOrigin(fixedImage->GetOrigin());
+  bspline->SetTransformDomainDirection(fixedImage->GetDirection());
+  bspline->SetTransformDomainPhysicalDimensions(dimensions);
+  bspline->SetTransformDomainMeshSize(meshSize);
+  bspline->SetIdentity();
+
+  // without scales estimator, which would map points one by one
+  auto optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetLearningRate(0.5);
+  optimizer->SetNumberOfIterations(5);
+  optimizer->SetDoEstimateLearningRateOnce(false);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(false);
+
+  auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetInitialTransform(bspline);
+  registration->SetMovingInitialTransform(movingInitialTransform);
+  registration->SetNumberOfLevels(1);
+  RegistrationType::ShrinkFactorsArrayType shrinkFactorsPerLevel(1);
+  shrinkFactorsPerLevel[0] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmasPerLevel(1);
+  smoothingSigmasPerLevel[0] = 0.0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+
+  const itk::SizeValueType numberOfPoints = fixedImage->GetLargestPossibleRegion().GetNumberOfPixels();
+  std::cout << name << ": " << bspline->m_NumberOfPointsMappedByBlocks << " points mapped by blocks, "
+            << bspline->m_NumberOfPointsMappedOneByOne << " one by one, final metric value "
+            << optimizer->GetCurrentMetricValue() << std::endl;
+  ITK_TEST_EXPECT_TRUE(registration->GetOutput()->Get() == bspline.GetPointer());
+  const itk::SizeValueType numberOfMappedPoints = optimizer->GetCurrentIteration() * numberOfPoints;
+  ITK_TEST_EXPECT_TRUE(bspline->m_NumberOfPointsMappedByBlocks.load() >= numberOfMappedPoints);
+  ITK_TEST_EXPECT_EQUAL(bspline->m_NumberOfPointsMappedOneByOne.load(), 0u);
+
+  // the registration has moved the B-spline transform
+  const CountingBSplineTransform::ParametersType & parameters = bspline->GetParameters();
+  ITK_TEST_EXPECT_TRUE(parameters.inf_norm() > 0.0);
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkImageRegistrationBSplineBlockMappingTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeBlobImage(18.0, 20.0);
+  const ImageType::Pointer movingImage = MakeBlobImage(21.0, 19.0);
+
+  using AffineType = itk::AffineTransform<double, Dimension>;
+  auto                         affine = AffineType::New();
+  AffineType::OutputVectorType translation;
+  translation[0] = 2.0;
+  translation[1] = -0.5;
+  affine->Translate(translation);
+  affine->Rotate2D(0.05);
+
+  using MattesType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+  using MeanSquaresType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  auto mattes = MattesType::New();
+  mattes->SetNumberOfHistogramBins(20);
+
+  int result = EXIT_SUCCESS;
+  if (Register("Mattes", fixedImage, movingImage, mattes, nullptr) != EXIT_SUCCESS ||
+      Register("Mattes with affine", fixedImage, movingImage, mattes, affine) != EXIT_SUCCESS ||
+      Register("MeanSquares", fixedImage, movingImage, MeanSquaresType::New(), nullptr) != EXIT_SUCCESS ||
+      Register("MeanSquares with affine", fixedImage, movingImage, MeanSquaresType::New(), affine) != EXIT_SUCCESS)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,291 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationFixedImagePyramid.h"
+#include "itkBoxSpatialObject.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+#include <functional>
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+using PyramidType = itk::ImageRegistrationFixedImagePyramid<ImageType>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using SamplingStrategyEnum = RegistrationType::MetricSamplingStrategyEnum;
+using ConfigureType = std::function<void(RegistrationType *, MetricType *)>;
+
+constexpr int RandomSeed = 121213;
+
+// An image of a blob centered on the point.
+ImageType::Pointer
+MakeBlobImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(48);
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.5;
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    const double dx = point[0] - centerX;
+    const double dy = point[1] - centerY;
+    it.Set(100.0 * std::exp(-(dx * dx + dy * dy) / 200.0));
+  }
+  return image;
+}
+
+// Registers the moving image to the fixed image, with two levels and
+// regularly sampled metrics, using the pyramid if there is one. The settings
+// may be changed by the configure function.
+RegistrationType::Pointer
+Register(const ImageType *     fixedImage,
+         const ImageType *     movingImage,
+         const PyramidType *   pyramid,
+         const ConfigureType & configure = nullptr)
+{
+  auto metric = MetricType::New();
+  metric->SetGradientSource(MetricType::GradientSourceEnum::GRADIENT_SOURCE_BOTH);
+
+  auto optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetLearningRate(0.1);
+  optimizer->SetNumberOfIterations(20);
+  optimizer->SetDoEstimateLearningRateOnce(false);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(false);
+  optimizer->SetMinimumConvergenceValue(0.0);
+
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors(2);
+  shrinkFactors[0] = 2;
+  shrinkFactors[1] = 1;
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas(2);
+  smoothingSigmas[0] = 1.0;
+  smoothingSigmas[1] = 0.0;
+
+  auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetNumberOfLevels(2);
+  registration->SetShrinkFactorsPerLevel(shrinkFactors);
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  registration->SetMetricSamplingPercentage(0.5);
+  registration->MetricSamplingReinitializeSeed(RandomSeed);
+  registration->SetMetricSamplingStrategy(SamplingStrategyEnum::REGULAR);
+  registration->SetFixedImagePyramid(pyramid);
+  if (configure)
+  {
+    configure(registration, metric);
+  }
+  registration->Update();
+  return registration;
+}
+
+bool
+SameParameters(const RegistrationType * registration, const RegistrationType * expectedRegistration)
+{
+  const TransformType::ParametersType & parameters = registration->GetTransform()->GetParameters();
+  const TransformType::ParametersType & expected = expectedRegistration->GetTransform()->GetParameters();
+  for (unsigned int i = 0; i < expected.Size(); ++i)
+  {
+    if (std::abs(parameters[i] - expected[i]) > 1e-9)
+    {
+      std::cerr << "Registration with the pyramid: " << parameters << " instead of " << expected << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkImageRegistrationFixedImagePyramidTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeBlobImage(35.0, 36.0);
+
+  auto pyramid = PyramidType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(pyramid, ImageRegistrationFixedImagePyramid, Object);
+
+  // the levels are computed by Update()
+  pyramid->SetFixedImage(fixedImage);
+  ITK_TRY_EXPECT_EXCEPTION(pyramid->GetLevelFixedImage(0));
+
+  PyramidType::ShrinkFactorsArrayType shrinkFactors(2);
+  shrinkFactors[0] = 2;
+  shrinkFactors[1] = 1;
+  pyramid->SetShrinkFactorsPerLevel(shrinkFactors);
+  ITK_TEST_EXPECT_EQUAL(pyramid->GetNumberOfLevels(), 2);
+  PyramidType::SmoothingSigmasArrayType smoothingSigmas(2);
+  smoothingSigmas[0] = 1.0;
+  smoothingSigmas[1] = 0.0;
+  pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  ITK_TEST_SET_GET_BOOLEAN(pyramid, SmoothingSigmasAreSpecifiedInPhysicalUnits, true);
+  ITK_TEST_SET_GET_BOOLEAN(pyramid, ComputeFixedImageGradient, true);
+  pyramid->SetMetricSamplingStrategy(SamplingStrategyEnum::REGULAR);
+  PyramidType::MetricSamplingPercentageArrayType samplingPercentages(2);
+  samplingPercentages.Fill(0.5);
+  pyramid->SetMetricSamplingPercentagePerLevel(samplingPercentages);
+  pyramid->SetRandomSeed(RandomSeed);
+  ITK_TEST_SET_GET_VALUE(RandomSeed, pyramid->GetRandomSeed());
+  ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->Update());
+
+  ITK_TEST_EXPECT_EQUAL(pyramid->GetLevelVirtualDomainImage(0)->GetLargestPossibleRegion().GetSize(0), 24);
+  ITK_TEST_EXPECT_EQUAL(pyramid->GetLevelVirtualDomainImage(1)->GetLargestPossibleRegion().GetSize(0), 48);
+  ITK_TEST_EXPECT_TRUE(pyramid->GetLevelFixedImage(0) != fixedImage.GetPointer());
+  ITK_TEST_EXPECT_TRUE(pyramid->GetLevelFixedImage(1) == fixedImage.GetPointer());
+  ITK_TEST_EXPECT_TRUE(pyramid->GetLevelFixedImageGradientImage(1) != nullptr);
+  ITK_TEST_EXPECT_TRUE(pyramid->GetLevelMetricSamplePointSet(1) != nullptr);
+  ITK_TRY_EXPECT_EXCEPTION(pyramid->GetLevelFixedImage(2));
+
+  // the levels are not computed again if nothing has changed
+  const ImageType * levelFixedImage = pyramid->GetLevelFixedImage(0);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->Update());
+  ITK_TEST_EXPECT_TRUE(pyramid->GetLevelFixedImage(0) == levelFixedImage);
+
+  int result = EXIT_SUCCESS;
+
+  // the registrations of several moving images with the shared pyramid give
+  // the transforms of the registrations without it
+  const double movingCenters[][2] = { { 32.0, 38.0 }, { 37.0, 33.0 } };
+  for (const auto & movingCenter : movingCenters)
+  {
+    const ImageType::Pointer movingImage = MakeBlobImage(movingCenter[0], movingCenter[1]);
+
+    const RegistrationType::Pointer expectedRegistration = Register(fixedImage, movingImage, nullptr);
+    RegistrationType::Pointer       registration;
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration = Register(fixedImage, movingImage, pyramid));
+    if (!SameParameters(registration, expectedRegistration))
+    {
+      result = EXIT_FAILURE;
+    }
+
+    // the metric of the last level uses the gradient image of the pyramid,
+    // which is the one computed by the metric of the registration without it
+    const auto * metric = dynamic_cast<const MetricType *>(registration->GetMetric());
+    const auto * expectedMetric = dynamic_cast<const MetricType *>(expectedRegistration->GetMetric());
+    const auto * gradientImage = metric->GetFixedImageGradientImage();
+    const auto * expectedGradientImage = expectedMetric->GetFixedImageGradientImage();
+    ITK_TEST_EXPECT_TRUE(gradientImage == pyramid->GetLevelFixedImageGradientImage(1));
+    itk::ImageRegionConstIteratorWithIndex<MetricType::FixedImageGradientImageType> it(
+      expectedGradientImage, expectedGradientImage->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it)
+    {
+      if ((gradientImage->GetPixel(it.GetIndex()) - it.Get()).GetNorm() > 1e-12)
+      {
+        std::cerr << "Gradient " << gradientImage->GetPixel(it.GetIndex()) << " instead of " << it.Get() << " at "
+                  << it.GetIndex() << std::endl;
+        result = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+
+  // a metric with its own fixed image gradient filter computes its gradient
+  // image, as without the pyramid
+  const ImageType::Pointer movingImage = MakeBlobImage(32.0, 38.0);
+  const ConfigureType      setGradientFilter = [](RegistrationType *, MetricType * metric) {
+    auto gradientFilter = MetricType::DefaultFixedImageGradientFilter::New();
+    gradientFilter->SetSigma(3.0);
+    metric->SetFixedImageGradientFilter(gradientFilter);
+  };
+  {
+    const RegistrationType::Pointer expectedRegistration =
+      Register(fixedImage, movingImage, nullptr, setGradientFilter);
+    RegistrationType::Pointer registration;
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration = Register(fixedImage, movingImage, pyramid, setGradientFilter));
+    if (!SameParameters(registration, expectedRegistration))
+    {
+      result = EXIT_FAILURE;
+    }
+    const auto * metric = dynamic_cast<const MetricType *>(registration->GetMetric());
+    ITK_TEST_EXPECT_TRUE(!metric->GetFixedImageGradientFilterIsDefault());
+    ITK_TEST_EXPECT_TRUE(metric->GetPrecomputedFixedImageGradientImage() == nullptr);
+    ITK_TEST_EXPECT_TRUE(metric->GetFixedImageGradientImage() != pyramid->GetLevelFixedImageGradientImage(1));
+  }
+
+  // registrations which do not sample the virtual domain as the pyramid
+  const ConfigureType otherSamplings[] = {
+    [](RegistrationType * registration, MetricType *) {
+      registration->SetMetricSamplingStrategy(SamplingStrategyEnum::NONE);
+    },
+    [](RegistrationType * registration, MetricType *) {
+      registration->SetMetricSamplingStrategy(SamplingStrategyEnum::RANDOM);
+    },
+    [](RegistrationType * registration, MetricType *) { registration->SetMetricSamplingPercentage(0.25); },
+    [](RegistrationType * registration, MetricType *) { registration->MetricSamplingReinitializeSeed(RandomSeed + 1); },
+    [](RegistrationType * registration, MetricType *) { registration->MetricSamplingReinitializeSeed(); }
+  };
+  for (const auto & otherSampling : otherSamplings)
+  {
+    ITK_TRY_EXPECT_EXCEPTION(Register(fixedImage, movingImage, pyramid, otherSampling));
+  }
+
+  // a fixed image mask which is not the one of the pyramid
+  using MaskType = itk::BoxSpatialObject<Dimension>;
+  MaskType::SizeType maskSize;
+  maskSize.Fill(40.0);
+  auto fixedImageMask = MaskType::New();
+  fixedImageMask->SetSizeInObjectSpace(maskSize);
+  fixedImageMask->Update();
+  const ConfigureType setFixedImageMask = [&fixedImageMask](RegistrationType *, MetricType * metric) {
+    metric->SetFixedImageMask(fixedImageMask);
+  };
+  ITK_TRY_EXPECT_EXCEPTION(Register(fixedImage, movingImage, pyramid, setFixedImageMask));
+  pyramid->SetFixedImageMask(fixedImageMask);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->Update());
+  ITK_TRY_EXPECT_EXCEPTION(Register(fixedImage, movingImage, pyramid));
+  ITK_TRY_EXPECT_NO_EXCEPTION(Register(fixedImage, movingImage, pyramid, setFixedImageMask));
+  pyramid->SetFixedImageMask(nullptr);
+
+  // a pyramid whose levels are not the ones of the registration
+  smoothingSigmas[0] = 2.0;
+  pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->Update());
+  ITK_TRY_EXPECT_EXCEPTION(Register(fixedImage, movingImage, pyramid));
+
+  // a pyramid of another fixed image
+  smoothingSigmas[0] = 1.0;
+  pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  pyramid->SetFixedImage(MakeBlobImage(35.0, 36.0));
+  ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->Update());
+  ITK_TRY_EXPECT_EXCEPTION(Register(fixedImage, movingImage, pyramid));
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
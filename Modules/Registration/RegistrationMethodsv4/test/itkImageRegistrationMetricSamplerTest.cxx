@@ -0,0 +1,294 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMetricSampler.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using SamplerType = itk::ImageRegistrationMetricSampler<ImageType>;
+using SamplingStrategyEnum = SamplerType::MetricSamplingStrategyEnum;
+using PointSetType = SamplerType::MetricSamplePointSetType;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+
+constexpr int                RandomSeed = 121213;
+constexpr itk::SizeValueType SizeX = 40;
+constexpr itk::SizeValueType SizeY = 30;
+constexpr double             EdgeX = 19.5;
+
+// An image of a vertical step edge between the columns 19 and 20.
+ImageType::Pointer
+MakeStepImage()
+{
+  ImageType::SizeType size;
+  size[0] = SizeX;
+  size[1] = SizeY;
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    it.Set(it.GetIndex()[0] < 20 ? 0.0 : 100.0);
+  }
+  return image;
+}
+
+bool
+SamePoints(const PointSetType * pointSet, const PointSetType * expectedPointSet)
+{
+  if (pointSet->GetNumberOfPoints() != expectedPointSet->GetNumberOfPoints())
+  {
+    std::cerr << pointSet->GetNumberOfPoints() << " points instead of " << expectedPointSet->GetNumberOfPoints()
+              << std::endl;
+    return false;
+  }
+  for (itk::SizeValueType i = 0; i < pointSet->GetNumberOfPoints(); ++i)
+  {
+    if (pointSet->GetPoint(i) != expectedPointSet->GetPoint(i))
+    {
+      std::cerr << "Point " << i << ": " << pointSet->GetPoint(i) << " instead of " << expectedPointSet->GetPoint(i)
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The samples are in the virtual domain, up to the random perturbation
+// within their voxel, and they are in the memory order of their voxels if
+// the strategy sorts them.
+bool
+CheckPoints(const PointSetType * pointSet, double tolerance, bool sorted)
+{
+  double previousY = -1.0;
+  for (itk::SizeValueType i = 0; i < pointSet->GetNumberOfPoints(); ++i)
+  {
+    const PointSetType::PointType & point = pointSet->GetPoint(i);
+    if (point[0] < -0.5 - tolerance || point[0] > SizeX - 0.5 + tolerance || point[1] < -0.5 - tolerance ||
+        point[1] > SizeY - 0.5 + tolerance)
+    {
+      std::cerr << "Point " << i << " outside of the virtual domain: " << point << std::endl;
+      return false;
+    }
+    if (sorted && point[1] < previousY - 1.0 - 2.0 * tolerance)
+    {
+      std::cerr << "Point " << i << " out of order: " << point << std::endl;
+      return false;
+    }
+    previousY = std::max(previousY, static_cast<double>(point[1]));
+  }
+  return true;
+}
+
+double
+FractionOfPointsNearX(const PointSetType * pointSet, double x)
+{
+  itk::SizeValueType count = 0;
+  for (itk::SizeValueType i = 0; i < pointSet->GetNumberOfPoints(); ++i)
+  {
+    count += std::abs(pointSet->GetPoint(i)[0] - x) < 2.0 ? 1 : 0;
+  }
+  return static_cast<double>(count) / pointSet->GetNumberOfPoints();
+}
+} // namespace
+
+
+int
+itkImageRegistrationMetricSamplerTest(int, char *[])
+{
+  const ImageType::Pointer image = MakeStepImage();
+
+  auto sampler = SamplerType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(sampler, ImageRegistrationMetricSampler, Object);
+
+  ITK_TRY_EXPECT_EXCEPTION(sampler->GenerateSamplePointSet());
+
+  sampler->SetVirtualImage(image);
+  ITK_TEST_SET_GET_VALUE(image.GetPointer(), sampler->GetVirtualImage());
+  sampler->SetFixedImage(image);
+  ITK_TEST_SET_GET_VALUE(image.GetPointer(), sampler->GetFixedImage());
+  ITK_TEST_SET_GET_BOOLEAN(sampler, ReseedIterator, false);
+  sampler->SetMetricSamplingPercentage(0.2);
+  ITK_TEST_SET_GET_VALUE(0.2, sampler->GetMetricSamplingPercentage());
+
+  int result = EXIT_SUCCESS;
+
+  // The number of samples, the seeds used and whether the samples are
+  // sorted, for each strategy, with a fifth of the 1200 voxels sampled.
+  struct StrategyCase
+  {
+    SamplingStrategyEnum strategy;
+    itk::SizeValueType   minimumNumberOfSamples;
+    itk::SizeValueType   maximumNumberOfSamples;
+    int                  numberOfSeeds;
+    double               tolerance;
+    bool                 sorted;
+  };
+  const StrategyCase strategyCases[] = { { SamplingStrategyEnum::REGULAR, 240, 240, 1, 2.0, true },
+                                         { SamplingStrategyEnum::RANDOM, 240, 240, 2, 2.0, false },
+                                         { SamplingStrategyEnum::STRATIFIED, 200, 280, 1, 2.0, true },
+                                         { SamplingStrategyEnum::LOW_DISCREPANCY, 240, 240, 1, 0.0, true },
+                                         { SamplingStrategyEnum::GRADIENT_WEIGHTED, 239, 241, 1, 2.0, true } };
+  for (const StrategyCase & strategyCase : strategyCases)
+  {
+    std::cout << "Strategy " << strategyCase.strategy << std::endl;
+    sampler->SetMetricSamplingStrategy(strategyCase.strategy);
+    ITK_TEST_SET_GET_VALUE(strategyCase.strategy, sampler->GetMetricSamplingStrategy());
+
+    sampler->SetRandomSeed(RandomSeed);
+    PointSetType::Pointer pointSet;
+    ITK_TRY_EXPECT_NO_EXCEPTION(pointSet = sampler->GenerateSamplePointSet());
+    ITK_TEST_EXPECT_EQUAL(sampler->GetRandomSeed(), RandomSeed + strategyCase.numberOfSeeds);
+
+    const itk::SizeValueType numberOfSamples = pointSet->GetNumberOfPoints();
+    if (numberOfSamples < strategyCase.minimumNumberOfSamples || numberOfSamples > strategyCase.maximumNumberOfSamples)
+    {
+      std::cerr << numberOfSamples << " samples instead of " << strategyCase.minimumNumberOfSamples << " to "
+                << strategyCase.maximumNumberOfSamples << std::endl;
+      result = EXIT_FAILURE;
+    }
+    if (!CheckPoints(pointSet, strategyCase.tolerance, strategyCase.sorted))
+    {
+      result = EXIT_FAILURE;
+    }
+
+    // the same seed gives the same samples, another seed other samples
+    sampler->SetRandomSeed(RandomSeed);
+    if (!SamePoints(sampler->GenerateSamplePointSet(), pointSet))
+    {
+      result = EXIT_FAILURE;
+    }
+    const PointSetType::Pointer otherPointSet = sampler->GenerateSamplePointSet();
+    if (otherPointSet->GetNumberOfPoints() == numberOfSamples &&
+        otherPointSet->GetPoint(0) == pointSet->GetPoint(0) &&
+        otherPointSet->GetPoint(numberOfSamples - 1) == pointSet->GetPoint(numberOfSamples - 1))
+    {
+      std::cerr << "The samples of another seed are the same." << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+
+  // the gradient weighted samples concentrate on the edge of the fixed
+  // image, where the fixed transform maps it in the virtual domain
+  sampler->SetMetricSamplingStrategy(SamplingStrategyEnum::GRADIENT_WEIGHTED);
+  const double edgeFraction = FractionOfPointsNearX(sampler->GenerateSamplePointSet(), EdgeX);
+  std::cout << "Fraction of the gradient weighted samples on the edge: " << edgeFraction << std::endl;
+  ITK_TEST_EXPECT_TRUE(edgeFraction > 0.5);
+
+  auto                          fixedTransform = TransformType::New();
+  TransformType::OutputVectorType translation;
+  translation[0] = 10.0;
+  translation[1] = 0.0;
+  fixedTransform->Translate(translation);
+  sampler->SetFixedTransform(fixedTransform);
+  ITK_TEST_SET_GET_VALUE(fixedTransform.GetPointer(), sampler->GetFixedTransform());
+  const double translatedEdgeFraction = FractionOfPointsNearX(sampler->GenerateSamplePointSet(), EdgeX - 10.0);
+  std::cout << "Fraction of the samples on the translated edge: " << translatedEdgeFraction << std::endl;
+  ITK_TEST_EXPECT_TRUE(translatedEdgeFraction > 0.5);
+  sampler->SetFixedTransform(nullptr);
+
+  sampler->SetFixedImage(nullptr);
+  ITK_TRY_EXPECT_EXCEPTION(sampler->GenerateSamplePointSet());
+  sampler->SetFixedImage(image);
+
+  // no samples are drawn outside of the mask of the left half of the image
+  using MaskImageType = itk::Image<unsigned char, Dimension>;
+  auto maskImage = MaskImageType::New();
+  maskImage->SetRegions(image->GetLargestPossibleRegion());
+  maskImage->Allocate();
+  itk::ImageRegionIteratorWithIndex<MaskImageType> maskIt(maskImage, maskImage->GetBufferedRegion());
+  for (; !maskIt.IsAtEnd(); ++maskIt)
+  {
+    maskIt.Set(maskIt.GetIndex()[0] < 20 ? 1 : 0);
+  }
+  using MaskType = itk::ImageMaskSpatialObject<Dimension>;
+  auto mask = MaskType::New();
+  mask->SetImage(maskImage);
+  mask->Update();
+  sampler->SetFixedImageMask(mask);
+  for (const StrategyCase & strategyCase : strategyCases)
+  {
+    sampler->SetMetricSamplingStrategy(strategyCase.strategy);
+    const PointSetType::Pointer pointSet = sampler->GenerateSamplePointSet();
+    ITK_TEST_EXPECT_TRUE(pointSet->GetNumberOfPoints() > 0);
+    for (itk::SizeValueType i = 0; i < pointSet->GetNumberOfPoints(); ++i)
+    {
+      if (pointSet->GetPoint(i)[0] >= EdgeX + 0.5)
+      {
+        std::cerr << "Strategy " << strategyCase.strategy << ": point " << pointSet->GetPoint(i)
+                  << " outside of the mask" << std::endl;
+        result = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+  sampler->SetFixedImageMask(nullptr);
+
+  // the registration draws the samples of its metric with the sampler
+  using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  for (const StrategyCase & strategyCase : strategyCases)
+  {
+    auto optimizer = itk::GradientDescentOptimizerv4::New();
+    optimizer->SetNumberOfIterations(1);
+
+    RegistrationType::ShrinkFactorsArrayType shrinkFactors(1);
+    shrinkFactors[0] = 1;
+    RegistrationType::SmoothingSigmasArrayType smoothingSigmas(1);
+    smoothingSigmas[0] = 0.0;
+
+    auto registration = RegistrationType::New();
+    registration->SetFixedImage(image);
+    registration->SetMovingImage(image);
+    registration->SetMetric(MetricType::New());
+    registration->SetOptimizer(optimizer);
+    registration->SetNumberOfLevels(1);
+    registration->SetShrinkFactorsPerLevel(shrinkFactors);
+    registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+    registration->SetMetricSamplingStrategy(strategyCase.strategy);
+    registration->SetMetricSamplingPercentage(0.2);
+    registration->MetricSamplingReinitializeSeed(RandomSeed);
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+
+    sampler->SetMetricSamplingStrategy(strategyCase.strategy);
+    sampler->SetRandomSeed(RandomSeed);
+    const auto * metric = dynamic_cast<const MetricType *>(registration->GetMetric());
+    if (!SamePoints(metric->GetVirtualSampledPointSet(), sampler->GenerateSamplePointSet()))
+    {
+      std::cerr << "Registration samples of the strategy " << strategyCase.strategy << " differ." << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+
+  if (result != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
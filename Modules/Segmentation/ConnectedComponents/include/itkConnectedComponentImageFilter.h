@@ -43,6 +43,14 @@ namespace itk
  *
  * After the filter is executed, ObjectCount holds the number of connected components.
  *
+ * By default, the filter needs the whole input and produces the whole
+ * output. When NumberOfStreamDivisions is greater than one, it requests the
+ * input (and the mask) from the upstream pipeline one slab at a time, and
+ * keeps only the run length encoding of the objects, from which any
+ * requested region of the output can be written. The output can then be
+ * streamed, e.g. by an ImageFileWriter, without the whole input or output
+ * image ever being in memory. The labels are the same in both cases.
+ *
  * \sa ImageToImageFilter
  *
  * \ingroup SingleThreaded
@@ -152,6 +160,16 @@ public:
   itkSetMacro(BackgroundValue, OutputImagePixelType);
   itkGetConstMacro(BackgroundValue, OutputImagePixelType);
 
+  /**
+   * Set/Get the number of slabs, along the slowest dimension, in which the
+   * input is requested from the upstream pipeline. When it is greater than
+   * one, the labels of the whole image are computed at the first execution,
+   * and kept for the next ones, so that the output may be streamed. Default
+   * is 1, the whole input is requested at once.
+   */
+  itkSetClampMacro(NumberOfStreamDivisions, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(NumberOfStreamDivisions, unsigned int);
+
 protected:
   ConnectedComponentImageFilter();
 
@@ -168,15 +186,16 @@ protected:
   void
   ThreadedWriteOutput(const RegionType &);
 
-  /** ConnectedComponentImageFilter needs the entire input. Therefore
-   * it must provide an implementation GenerateInputRequestedRegion().
+  /** ConnectedComponentImageFilter needs the entire input, or, when it
+   * streams its input, the first slab of it. Therefore it must provide an
+   * implementation GenerateInputRequestedRegion().
    * \sa ProcessObject::GenerateInputRequestedRegion(). */
   void
   GenerateInputRequestedRegion() override;
 
-  /** ConnectedComponentImageFilter will produce all of the output.
-   * Therefore it must provide an implementation of
-   * EnlargeOutputRequestedRegion().
+  /** ConnectedComponentImageFilter will produce all of the output, or, when
+   * it streams its input, whole lines and slices of it. Therefore it must
+   * provide an implementation of EnlargeOutputRequestedRegion().
    * \sa ProcessObject::EnlargeOutputRequestedRegion() */
   void
   EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
@@ -197,8 +216,20 @@ protected:
   using WorkUnitData = typename ScanlineFunctions::WorkUnitData;
 
 private:
+  /** Labels the lines of the specified region, and resolves the
+   * equivalences between their runs. */
+  void
+  ComputeLabels(const RegionType & lineMapRegion);
+
+  /** Whether the labels of the whole image, computed by a previous execution
+   * in streaming mode, are still valid. */
+  bool
+  IsStreamedLabelingUpToDate() const;
+
   OutputPixelType m_BackgroundValue = NumericTraits<OutputPixelType>::ZeroValue();
   LabelType       m_ObjectCount = 0;
+  unsigned int    m_NumberOfStreamDivisions = 1;
+  TimeStamp       m_StreamedLabelingTime;
 
   typename TInputImage::ConstPointer m_Input;
 };
@@ -25,6 +25,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkMaskImageFilter.h"
 #include "itkConnectedComponentAlgorithm.h"
+#include "itkImageRegionSplitterDirection.h"
 #include "itkProgressTransformer.h"
 
 namespace itk
@@ -53,9 +54,33 @@ ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::GenerateIn
   {
     return;
   }
+  MaskImagePointer mask = const_cast<MaskImageType *>(this->GetMaskImage());
+
+  if (m_NumberOfStreamDivisions > 1)
+  {
+    // The input is requested piece by piece by GenerateData, so only the
+    // first piece is requested here, or nothing new when the labels of the
+    // previous execution are still valid.
+    RegionType firstPiece = input->GetLargestPossibleRegion();
+    auto       splitter = ImageRegionSplitterDirection::New();
+    splitter->SetDirection(0);
+    splitter->GetSplit(0, splitter->GetNumberOfSplits(firstPiece, m_NumberOfStreamDivisions), firstPiece);
+
+    const bool isUpToDate = this->IsStreamedLabelingUpToDate();
+    input->SetRequestedRegion(isUpToDate && input->GetBufferedRegion().GetNumberOfPixels() > 0
+                                ? input->GetBufferedRegion()
+                                : firstPiece);
+    if (mask)
+    {
+      mask->SetRequestedRegion(isUpToDate && mask->GetBufferedRegion().GetNumberOfPixels() > 0
+                                 ? mask->GetBufferedRegion()
+                                 : firstPiece);
+    }
+    return;
+  }
+
   input->SetRequestedRegion(input->GetLargestPossibleRegion());
 
-  MaskImagePointer mask = const_cast<MaskImageType *>(this->GetMaskImage());
   if (mask)
   {
     mask->SetRequestedRegion(input->GetLargestPossibleRegion());
@@ -66,7 +91,33 @@ template <typename TInputImage, typename TOutputImage, typename TMaskImage>
 void
 ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::EnlargeOutputRequestedRegion(DataObject *)
 {
-  this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+  OutputImageType *  output = this->GetOutput();
+  const RegionType & largestPossibleRegion = output->GetLargestPossibleRegion();
+
+  if (m_NumberOfStreamDivisions > 1)
+  {
+    // The output is written from the run length encoding of whole lines,
+    // which must be consecutive in the line map.
+    RegionType requestedRegion = output->GetRequestedRegion();
+    for (unsigned int i = 0; i + 1 < ImageDimension; ++i)
+    {
+      requestedRegion.SetIndex(i, largestPossibleRegion.GetIndex(i));
+      requestedRegion.SetSize(i, largestPossibleRegion.GetSize(i));
+    }
+    output->SetRequestedRegion(requestedRegion);
+  }
+  else
+  {
+    output->SetRequestedRegion(largestPossibleRegion);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+bool
+ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::IsStreamedLabelingUpToDate() const
+{
+  return m_NumberOfStreamDivisions > 1 && !this->m_LineMap.empty() &&
+         m_StreamedLabelingTime.GetMTime() > this->GetOutput()->GetPipelineMTime();
 }
 
 template <typename TInputImage, typename TOutputImage, typename TMaskImage>
@@ -74,49 +125,111 @@ void
 ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::GenerateData()
 {
   this->AllocateOutputs();
-  this->SetupLineOffsets(false);
-  typename TInputImage::ConstPointer input = this->GetInput();
-  typename TMaskImage::ConstPointer  mask = this->GetMaskImage();
 
-  using MaskFilterType = MaskImageFilter<TInputImage, TMaskImage, TInputImage>;
-  typename MaskFilterType::Pointer maskFilter = MaskFilterType::New();
-  if (mask)
+  OutputImageType *  output = this->GetOutput();
+  const RegionType & requestedRegion = output->GetRequestedRegion();
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  if (m_NumberOfStreamDivisions > 1)
   {
-    maskFilter->SetInput(input);
-    maskFilter->SetMaskImage(mask);
-    maskFilter->Update();
-    m_Input = maskFilter->GetOutput();
+    // The labels of the whole image are kept from one execution to the
+    // next, so that the output can be streamed without reading the input
+    // again.
+    if (!this->IsStreamedLabelingUpToDate())
+    {
+      this->ComputeLabels(output->GetLargestPossibleRegion());
+
+      // Only the line map and the labels are needed to write the output
+      std::deque<WorkUnitData>().swap(this->m_WorkUnitResults);
+      OffsetVectorType().swap(this->m_LineOffsets);
+      m_Input = nullptr;
+      m_StreamedLabelingTime.Modified();
+    }
   }
   else
   {
-    m_Input = input;
+    this->ComputeLabels(requestedRegion);
   }
 
-  const typename OutputImageType::RegionType & requestedRegion = this->GetOutput()->GetRequestedRegion();
-  const typename OutputImageType::SizeType &   requestedSize = requestedRegion.GetSize();
+  ProgressTransformer progress4(0.75f, 1.0f, this);
+  multiThreader->template ParallelizeImageRegionRestrictDirection<TOutputImage::ImageDimension>(
+    0,
+    requestedRegion,
+    [this](const RegionType & lambdaRegion) { this->ThreadedWriteOutput(lambdaRegion); },
+    progress4.GetProcessObject());
+
+  if (m_NumberOfStreamDivisions <= 1)
+  {
+    // clear and make sure memory is freed
+    std::deque<WorkUnitData>().swap(this->m_WorkUnitResults);
+    OffsetVectorType().swap(this->m_LineOffsets);
+    LineMapType().swap(this->m_LineMap);
+    ConsecutiveVectorType().swap(this->m_Consecutive);
+    UnionFindType().swap(this->m_UnionFind);
+    m_Input = nullptr;
+  }
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::ComputeLabels(const RegionType & lineMapRegion)
+{
+  this->SetupLineOffsets(false, lineMapRegion);
 
   // set up the vars used in the threads
-  const SizeValueType pixelcount = requestedRegion.GetNumberOfPixels();
-  const SizeValueType xsize = requestedSize[0];
+  const SizeValueType pixelcount = lineMapRegion.GetNumberOfPixels();
+  const SizeValueType xsize = lineMapRegion.GetSize(0);
   const SizeValueType linecount = pixelcount / xsize;
   this->m_LineMap.resize(linecount);
   this->m_NumberOfLabels.store(0);
 
-  ProgressTransformer progress1(0.0f, 0.5f, this);
+  // The input, masked by the mask image if there is one
+  using MaskFilterType = MaskImageFilter<TInputImage, TMaskImage, TInputImage>;
+  auto *                           maskedInput = const_cast<InputImageType *>(this->GetInput());
+  typename MaskFilterType::Pointer maskFilter;
+  if (this->GetMaskImage())
+  {
+    maskFilter = MaskFilterType::New();
+    maskFilter->SetInput(maskedInput);
+    maskFilter->SetMaskImage(this->GetMaskImage());
+    maskFilter->UpdateOutputInformation();
+    maskedInput = maskFilter->GetOutput();
+  }
 
+  // When streaming, encode the input one piece at a time, so that only the
+  // run length encoding of the whole image is kept in memory. The
+  // equivalences across the faces of the pieces are resolved with the
+  // others below.
   MultiThreaderBase * multiThreader = this->GetMultiThreader();
-  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
-  multiThreader->template ParallelizeImageRegionRestrictDirection<TOutputImage::ImageDimension>(
-    0,
-    requestedRegion,
-    [this](const RegionType & lambdaRegion) { this->DynamicThreadedGenerateData(lambdaRegion); },
-    progress1.GetProcessObject());
+  auto                splitter = ImageRegionSplitterDirection::New();
+  splitter->SetDirection(0);
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(lineMapRegion, m_NumberOfStreamDivisions);
+  for (unsigned int piece = 0; piece < numberOfPieces; ++piece)
+  {
+    RegionType pieceRegion = lineMapRegion;
+    splitter->GetSplit(piece, numberOfPieces, pieceRegion);
+
+    maskedInput->SetRequestedRegion(pieceRegion);
+    maskedInput->PropagateRequestedRegion();
+    maskedInput->UpdateOutputData();
+    m_Input = maskedInput;
+
+    ProgressTransformer progress1(0.5f * piece / numberOfPieces, 0.5f * (piece + 1) / numberOfPieces, this);
+    multiThreader->template ParallelizeImageRegionRestrictDirection<TOutputImage::ImageDimension>(
+      0,
+      pieceRegion,
+      [this](const RegionType & lambdaRegion) { this->DynamicThreadedGenerateData(lambdaRegion); },
+      progress1.GetProcessObject());
+  }
 
   SizeValueType nbOfLabels = this->m_NumberOfLabels.load();
 
   // insert all the labels into the structure -- an extra loop but
   // saves complicating the ones that come later
   this->InitUnion(nbOfLabels);
+  this->SplitLineMap(multiThreader->GetNumberOfWorkUnits());
 
   ProgressTransformer progress2(0.55f, 0.6f, this);
   multiThreader->ParallelizeArray(
@@ -145,21 +258,6 @@ ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::GenerateDa
                       << ").");
   }
   m_ObjectCount = numberOfObjects;
-
-  ProgressTransformer progress4(0.75f, 1.0f, this);
-  multiThreader->template ParallelizeImageRegionRestrictDirection<TOutputImage::ImageDimension>(
-    0,
-    requestedRegion,
-    [this](const RegionType & lambdaRegion) { this->ThreadedWriteOutput(lambdaRegion); },
-    progress4.GetProcessObject());
-
-  // clear and make sure memory is freed
-  std::deque<WorkUnitData>().swap(this->m_WorkUnitResults);
-  OffsetVectorType().swap(this->m_LineOffsets);
-  LineMapType().swap(this->m_LineMap);
-  ConsecutiveVectorType().swap(this->m_Consecutive);
-  UnionFindType().swap(this->m_UnionFind);
-  m_Input = nullptr;
 }
 
 template <typename TInputImage, typename TOutputImage, typename TMaskImage>
@@ -208,8 +306,6 @@ ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::DynamicThr
   }
 
   this->m_NumberOfLabels.fetch_add(nbOfLabels, std::memory_order_relaxed);
-  std::lock_guard<std::mutex> mutexHolder(this->m_Mutex);
-  this->m_WorkUnitResults.push_back(workUnitData);
 }
 
 template <typename TInputImage, typename TOutputImage, typename TMaskImage>
@@ -268,6 +364,7 @@ ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::PrintSelf(
   Superclass::PrintSelf(os, indent);
 
   os << indent << "ObjectCount: " << m_ObjectCount << std::endl;
+  os << indent << "NumberOfStreamDivisions: " << m_NumberOfStreamDivisions << std::endl;
 }
 } // end namespace itk
 
@@ -22,9 +22,14 @@ using itk::print_helper::operator<<;
 
 #include "itkGTest.h"
 #include "itkImage.h"
+#include "itkCastImageFilter.h"
 #include "itkConnectedComponentImageFilter.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkStreamingImageFilter.h"
 
 #include <bitset>
+#include <random>
+#include <vector>
 
 namespace
 {
@@ -50,6 +55,27 @@ CreateTestImageA()
 
   return image;
 }
+
+
+// Creates a random binary image, with enough foreground pixels for objects
+// to span many lines and slices.
+itk::Image<unsigned char, 3>::Pointer
+CreateRandomBinaryImage(const unsigned int seed, const double foregroundProbability)
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType({ { 3, -2, 5 } }, { { 37, 29, 23 } }));
+  image->Allocate();
+
+  std::mt19937                randomNumberEngine(seed);
+  std::bernoulli_distribution distribution(foregroundProbability);
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(distribution(randomNumberEngine) ? 1 : 0);
+  }
+  return image;
+}
 } // namespace
 
 
@@ -84,3 +110,71 @@ TEST(ConnectedComponentImageFilter, checkerboard_3D)
   ++it;
   EXPECT_TRUE(it.IsAtEnd());
 }
+
+
+TEST(ConnectedComponentImageFilter, StreamedInputAndOutputYieldSameLabels)
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+  using LabelImageType = itk::Image<unsigned int, 3>;
+  using FilterType = itk::ConnectedComponentImageFilter<ImageType, LabelImageType>;
+
+  const auto image = CreateRandomBinaryImage(1, 0.4);
+  const auto mask = CreateRandomBinaryImage(2, 0.9);
+
+  for (const bool fullyConnected : { false, true })
+  {
+    for (const bool useMask : { false, true })
+    {
+      const auto reference = FilterType::New();
+      reference->SetInput(image);
+      reference->SetFullyConnected(fullyConnected);
+      if (useMask)
+      {
+        reference->SetMaskImage(mask);
+      }
+      reference->Update();
+
+      // Unlike the image, the cast filter can produce any requested region.
+      const auto caster = itk::CastImageFilter<ImageType, ImageType>::New();
+      caster->SetInput(image);
+      caster->InPlaceOff();
+
+      const auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+      monitor->SetInput(caster->GetOutput());
+      monitor->ClearPipelineOnGenerateOutputInformationOff();
+
+      const auto filter = FilterType::New();
+      filter->SetInput(monitor->GetOutput());
+      filter->SetFullyConnected(fullyConnected);
+      if (useMask)
+      {
+        filter->SetMaskImage(mask);
+      }
+      filter->SetNumberOfStreamDivisions(5);
+      EXPECT_EQ(filter->GetNumberOfStreamDivisions(), 5u);
+
+      const auto streamer = itk::StreamingImageFilter<LabelImageType, LabelImageType>::New();
+      streamer->SetInput(filter->GetOutput());
+      streamer->SetNumberOfStreamDivisions(4);
+      streamer->Update();
+
+      // The input is requested once per piece, and not again for each piece
+      // of the output.
+      EXPECT_EQ(monitor->GetNumberOfUpdates(), 5u);
+      EXPECT_LT(monitor->GetOutput()->GetBufferedRegion().GetNumberOfPixels(),
+                image->GetBufferedRegion().GetNumberOfPixels());
+
+      EXPECT_EQ(filter->GetObjectCount(), reference->GetObjectCount());
+
+      const LabelImageType * const expectedImage = reference->GetOutput();
+      const LabelImageType * const actualImage = streamer->GetOutput();
+      ASSERT_EQ(actualImage->GetBufferedRegion(), expectedImage->GetBufferedRegion());
+
+      const auto                 numberOfPixels = expectedImage->GetBufferedRegion().GetNumberOfPixels();
+      const unsigned int * const actualBuffer = actualImage->GetBufferPointer();
+      const unsigned int * const expectedBuffer = expectedImage->GetBufferPointer();
+      EXPECT_EQ(std::vector<unsigned int>(actualBuffer, actualBuffer + numberOfPixels),
+                std::vector<unsigned int>(expectedBuffer, expectedBuffer + numberOfPixels));
+    }
+  }
+}
@@ -20,6 +20,9 @@
 
 #include "itkImageToImageFilter.h"
 
+#include <map>
+#include <queue>
+
 namespace itk
 {
 /**
@@ -71,6 +74,21 @@ namespace itk
  * https://hdl.handle.net/1926/202
  * http://www.insight-journal.org/browse/publication/92
  *
+ * The flooding is sequential by default. When ParallelFlooding is on, the
+ * regions of unmarked pixels that are separated from each other by marker
+ * pixels are flooded concurrently. The flooding of such a region never reads
+ * or writes the pixels of another region, and it processes its own pixels in
+ * the same order as the sequential flooding does, so the output is identical
+ * to the one of the sequential mode. The speedup depends on the number of
+ * such regions and on their sizes: it is large when the markers cover most of
+ * the image (for example, object markers plus a background marker).
+ *
+ * The work is split by region only: each region is flooded by a single
+ * thread, so the flooding takes at least as long as the sequential flooding
+ * of the largest region. There is no speedup when all the unmarked pixels are
+ * connected, as in an image of a single basin whose markers are isolated
+ * seeds: the whole image is then flooded by one thread.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  * \author Richard Beare. Department of Medicine, Monash University, Melbourne, Australia.
  *
@@ -162,6 +180,17 @@ public:
   itkGetConstReferenceMacro(MarkWatershedLine, bool);
   itkBooleanMacro(MarkWatershedLine);
 
+  /**
+   * Set/Get whether the regions of unmarked pixels that are separated by
+   * the markers are flooded concurrently, using the multi-threader of the
+   * filter. Each region is flooded by one thread, so a single connected
+   * region of unmarked pixels is not flooded faster. The output is the same
+   * either way. Default is false.
+   */
+  itkSetMacro(ParallelFlooding, bool);
+  itkGetConstReferenceMacro(ParallelFlooding, bool);
+  itkBooleanMacro(ParallelFlooding);
+
 protected:
   MorphologicalWatershedFromMarkersImageFilter();
   ~MorphologicalWatershedFromMarkersImageFilter() override = default;
@@ -180,14 +209,39 @@ protected:
   void
   EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
 
-  /** The filter is single threaded. */
+  /** The filter is single threaded, unless ParallelFlooding is on. */
   void
   GenerateData() override;
 
 private:
+  // FAH (in french: File d'Attente Hierarchique)
+  using QueueType = std::queue<IndexType>;
+  using FAHType = std::map<InputImagePixelType, QueueType>;
+
+  using StatusImageType = Image<bool, ImageDimension>;
+  using RegionImageType = Image<IdentifierType, ImageDimension>;
+
+  /** Labels the connected regions of unmarked pixels from 1, and the marker
+   * pixels with 0. Returns the number of regions. */
+  IdentifierType
+  LabelUnmarkedRegions(RegionImageType * regionImage) const;
+
+  /** Floods the pixels of the hierarchical queue and marks the watershed
+   * line (Meyer's algorithm). */
+  void
+  FloodWithWatershedLine(FAHType & fah, StatusImageType * statusImage);
+
+  /** Floods the pixels of the hierarchical queue without watershed line
+   * (Beucher's algorithm). If a region image is specified, only the pixels
+   * of the specified region are labeled. */
+  void
+  FloodWithoutWatershedLine(FAHType & fah, const RegionImageType * regionImage, IdentifierType region);
+
   bool m_FullyConnected{ false };
 
   bool m_MarkWatershedLine{ true };
+
+  bool m_ParallelFlooding{ false };
 }; // end of class
 } // end namespace itk
 
@@ -22,13 +22,14 @@
 #include <queue>
 #include <list>
 #include "itkMorphologicalWatershedFromMarkersImageFilter.h"
-#include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkConstShapedNeighborhoodIterator.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkSize.h"
 #include "itkConnectedComponentAlgorithm.h"
+#include <vector>
 
 namespace itk
 {
@@ -105,7 +106,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   // Set up the progress reporter
   // we can't found the exact number of pixel to process in the 2nd pass, so we
   // use the maximum number possible.
-  ProgressReporter progress(this, 0, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
+  TotalProgressReporter progress(this, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
 
   // mask and marker must have the same size
   if (markerImage->GetRequestedRegion().GetSize() != inputImage->GetRequestedRegion().GetSize())
@@ -113,10 +114,25 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
     itkExceptionMacro(<< "Marker and input must have the same size.");
   }
 
-  // FAH (in french: File d'Attente Hierarchique)
-  using QueueType = std::queue<IndexType>;
-  using MapType = std::map<InputImagePixelType, QueueType>;
-  MapType fah;
+  // In parallel mode, there is a FAH for each region of unmarked pixels. The
+  // regions are separated by the markers, so they can be flooded
+  // independently of each other.
+  typename RegionImageType::Pointer regionImage;
+  IdentifierType                    numberOfRegions = 1;
+  if (m_ParallelFlooding)
+  {
+    regionImage = RegionImageType::New();
+    regionImage->CopyInformation(markerImage);
+    regionImage->SetRegions(markerImage->GetRequestedRegion());
+    regionImage->Allocate();
+    numberOfRegions = std::max<IdentifierType>(this->LabelUnmarkedRegions(regionImage), 1);
+  }
+  std::vector<FAHType> fahs(numberOfRegions);
+
+  // the FAH of the region of an unmarked pixel
+  const auto getFAH = [&fahs, &regionImage](const IndexType & idx) -> FAHType & {
+    return regionImage ? fahs[regionImage->GetPixel(idx) - 1] : fahs.front();
+  };
 
   // the radius which will be used for all the shaped iterators
   Size<ImageDimension> radius;
@@ -141,13 +157,13 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   // iterator for the output image
   using OutputIteratorType = ShapedNeighborhoodIterator<LabelImageType>;
   using OffsetType = typename OutputIteratorType::OffsetType;
-  typename OutputIteratorType::Iterator noIt;
-  OutputIteratorType                    outputIt(radius, outputImage, outputImage->GetRequestedRegion());
+  OutputIteratorType outputIt(radius, outputImage, outputImage->GetRequestedRegion());
   setConnectivity(&outputIt, m_FullyConnected);
 
   //---------------------------------------------------------------------------
   // Meyer's algorithm
   //---------------------------------------------------------------------------
+  typename StatusImageType::Pointer statusImage;
   if (m_MarkWatershedLine)
   {
     // first stage:
@@ -156,16 +172,9 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
     //  - init FAH with indexes of background pixels with marker pixel(s) in
     //    their neighborhood
 
-    ConstantBoundaryCondition<LabelImageType> lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant(wsLabel);
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
     // create a temporary image to store the state of each pixel (processed or
     // not)
-    using StatusImageType = Image<bool, ImageDimension>;
-    typename StatusImageType::Pointer statusImage = StatusImageType::New();
+    statusImage = StatusImageType::New();
     statusImage->SetRegions(markerImage->GetLargestPossibleRegion());
     statusImage->Allocate();
 
@@ -215,7 +224,8 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
           {
             // this neighbor is a background pixel and is not already
             // processed; add its index to fah
-            fah[niIt.Get()].push(markerIt.GetIndex() + nmIt.GetNeighborhoodOffset());
+            const IndexType neighborIdx = markerIt.GetIndex() + nmIt.GetNeighborhoodOffset();
+            getFAH(neighborIdx)[niIt.Get()].push(neighborIdx);
             // mark it as already in the fah to avoid adding it several times
             nsIt.Set(true);
           }
@@ -230,88 +240,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
       // one more pixel done in the init stage
       progress.CompletedPixel();
     }
-    // fill the borders of the status image with "true"
-    // FillSides<StatusImageType>(statusImage, true);
-    // Now disable the boundary checks
-    // outputIt.NeedToUseBoundaryConditionOff();
-    // statusIt.NeedToUseBoundaryConditionOff();
-    // inputIt.NeedToUseBoundaryConditionOff();
     // end of init stage
-
-    // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    statusIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
-    while (!fah.empty())
-    {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase(fah.begin());
-
-      while (!currentQueue.empty())
-      {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        statusIt += shift;
-        inputIt += shift;
-
-        // iterate over the neighbors. If there is only one marker value, give
-        // that value to the pixel, else keep it as is (watershed line)
-        LabelImagePixelType marker = wsLabel;
-        bool                collision = false;
-        for (noIt = outputIt.Begin(); noIt != outputIt.End(); noIt++)
-        {
-          LabelImagePixelType o = noIt.Get();
-          if (o != wsLabel)
-          {
-            if (marker != wsLabel && o != marker)
-            {
-              collision = true;
-              break;
-            }
-            else
-            {
-              marker = o;
-            }
-          }
-        }
-        if (!collision)
-        {
-          // set the marker value
-          outputIt.SetCenterPixel(marker);
-          // and propagate to the neighbors
-          for (niIt = inputIt.Begin(), nsIt = statusIt.Begin(); niIt != inputIt.End(); niIt++, nsIt++)
-          {
-            if (!nsIt.Get())
-            {
-              // the pixel is not yet processed. add it to the fah
-              InputImagePixelType GrayVal = niIt.Get();
-              if (GrayVal <= currentValue)
-              {
-                currentQueue.push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
-              }
-              else
-              {
-                fah[GrayVal].push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
-              }
-              // mark it as already in the fah
-              nsIt.Set(true);
-            }
-          }
-        }
-        // one more pixel in the flooding stage
-        progress.CompletedPixel();
-      }
-    }
   }
 
   //---------------------------------------------------------------------------
@@ -324,11 +253,9 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
     //  - init FAH with indexes of pixels with background pixel in their
     //    neighborhood
 
-    ConstantBoundaryCondition<LabelImageType> lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant(NumericTraits<LabelImagePixelType>::max());
-    outputIt.OverrideBoundaryCondition(&lcbc2);
+    // the regions of the background pixels in the neighborhood of a marker
+    // pixel, which are the regions it is flooding into
+    std::vector<IdentifierType> neighborRegions;
 
     for (markerIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin(); !markerIt.IsAtEnd(); ++markerIt, ++outputIt)
     {
@@ -343,19 +270,30 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
         // copy it to the output image
         outputIt.SetCenterPixel(markerPixel);
         // search if it has background pixel in its neighborhood
-        bool haveBgNeighbor = false;
+        neighborRegions.clear();
         for (nmIt = markerIt.Begin(); nmIt != markerIt.End(); nmIt++)
         {
           if (nmIt.Get() == bgLabel)
           {
-            haveBgNeighbor = true;
-            break;
+            const IdentifierType region =
+              regionImage ? regionImage->GetPixel(idx + nmIt.GetNeighborhoodOffset()) - 1 : 0;
+            if (std::find(neighborRegions.cbegin(), neighborRegions.cend(), region) == neighborRegions.cend())
+            {
+              neighborRegions.push_back(region);
+            }
+            if (!regionImage)
+            {
+              break;
+            }
           }
         }
-        if (haveBgNeighbor)
+        if (!neighborRegions.empty())
         {
           // there is a background pixel in the neighborhood; add to fah
-          fah[inputIt.GetCenterPixel()].push(markerIt.GetIndex());
+          for (const IdentifierType region : neighborRegions)
+          {
+            fahs[region][inputIt.GetCenterPixel()].push(markerIt.GetIndex());
+          }
         }
         else
         {
@@ -371,52 +309,305 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
       progress.CompletedPixel();
     }
     // end of init stage
+  }
 
-    // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    inputIt.GoToBegin();
+  // flooding
+  const auto flood = [this, &fahs, &statusImage, &regionImage](SizeValueType region) {
+    if (m_MarkWatershedLine)
+    {
+      this->FloodWithWatershedLine(fahs[region], statusImage);
+    }
+    else
+    {
+      this->FloodWithoutWatershedLine(fahs[region], regionImage, static_cast<IdentifierType>(region));
+    }
+  };
+
+  if (numberOfRegions > 1)
+  {
+    MultiThreaderBase * multiThreader = this->GetMultiThreader();
+    multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    multiThreader->ParallelizeArray(0, numberOfRegions, flood, nullptr);
+  }
+  else
+  {
+    flood(0);
+  }
+}
+
+
+template <typename TInputImage, typename TLabelImage>
+IdentifierType
+MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::LabelUnmarkedRegions(
+  RegionImageType * regionImage) const
+{
+  static const LabelImagePixelType bgLabel = NumericTraits<LabelImagePixelType>::ZeroValue();
+
+  const LabelImageType * markerImage = this->GetMarkerImage();
+  const auto &           region = markerImage->GetRequestedRegion();
+
+  regionImage->FillBuffer(0);
+
+  // the offsets of the neighbors, with the same connectivity as the flooding
+  Size<ImageDimension> radius;
+  radius.Fill(1);
+  ConstShapedNeighborhoodIterator<LabelImageType> markerIt(radius, markerImage, region);
+  setConnectivity(&markerIt, m_FullyConnected);
+  const auto & activeIndexList = markerIt.GetActiveIndexList();
+
+  IdentifierType        numberOfRegions = 0;
+  std::queue<IndexType> queue;
 
-    // and start flooding
-    while (!fah.empty())
+  for (ImageRegionConstIteratorWithIndex<LabelImageType> it(markerImage, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != bgLabel || regionImage->GetPixel(it.GetIndex()) != 0)
     {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase(fah.begin());
+      continue;
+    }
+
+    // a new region: give its label to all the connected unmarked pixels
+    ++numberOfRegions;
+    regionImage->SetPixel(it.GetIndex(), numberOfRegions);
+    queue.push(it.GetIndex());
 
-      while (!currentQueue.empty())
+    while (!queue.empty())
+    {
+      const IndexType idx = queue.front();
+      queue.pop();
+
+      for (const auto neighborhoodIndex : activeIndexList)
       {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
+        const IndexType neighborIdx = idx + markerIt.GetOffset(neighborhoodIndex);
+        if (region.IsInside(neighborIdx) && markerImage->GetPixel(neighborIdx) == bgLabel &&
+            regionImage->GetPixel(neighborIdx) == 0)
+        {
+          regionImage->SetPixel(neighborIdx, numberOfRegions);
+          queue.push(neighborIdx);
+        }
+      }
+    }
+  }
+  return numberOfRegions;
+}
 
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        inputIt += shift;
 
-        LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
-        // get the current value of the pixel
-        // iterate over neighbors to propagate the marker
-        for (noIt = outputIt.Begin(), niIt = inputIt.Begin(); noIt != outputIt.End(); noIt++, niIt++)
+template <typename TInputImage, typename TLabelImage>
+void
+MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::FloodWithWatershedLine(
+  FAHType &         fah,
+  StatusImageType * statusImage)
+{
+  // the label used to mark the watershed line in the output image
+  static const LabelImagePixelType wsLabel = NumericTraits<LabelImagePixelType>::ZeroValue();
+
+  const InputImageType * inputImage = this->GetInput();
+  LabelImageType *       outputImage = this->GetOutput();
+
+  TotalProgressReporter progress(this, outputImage->GetRequestedRegion().GetNumberOfPixels() * 2);
+
+  // the radius which will be used for all the shaped iterators
+  Size<ImageDimension> radius;
+  radius.Fill(1);
+
+  // iterator for the input image
+  using InputIteratorType = ConstShapedNeighborhoodIterator<InputImageType>;
+  InputIteratorType                         inputIt(radius, inputImage, inputImage->GetRequestedRegion());
+  typename InputIteratorType::ConstIterator niIt;
+  setConnectivity(&inputIt, m_FullyConnected);
+
+  // iterator for the output image
+  using OutputIteratorType = ShapedNeighborhoodIterator<LabelImageType>;
+  using OffsetType = typename OutputIteratorType::OffsetType;
+  typename OutputIteratorType::Iterator noIt;
+  OutputIteratorType                    outputIt(radius, outputImage, outputImage->GetRequestedRegion());
+  setConnectivity(&outputIt, m_FullyConnected);
+
+  ConstantBoundaryCondition<LabelImageType> lcbc2;
+  // outside pixel are watershed so they won't be use to find real watershed
+  // pixels
+  lcbc2.SetConstant(wsLabel);
+  outputIt.OverrideBoundaryCondition(&lcbc2);
+
+  // iterator for the status image
+  using StatusIteratorType = ShapedNeighborhoodIterator<StatusImageType>;
+  typename StatusIteratorType::Iterator      nsIt;
+  StatusIteratorType                         statusIt(radius, statusImage, outputImage->GetRequestedRegion());
+  ConstantBoundaryCondition<StatusImageType> bcbc;
+  bcbc.SetConstant(true); // outside pixel are already processed
+  statusIt.OverrideBoundaryCondition(&bcbc);
+  setConnectivity(&statusIt, m_FullyConnected);
+
+  // init all the iterators
+  outputIt.GoToBegin();
+  statusIt.GoToBegin();
+  inputIt.GoToBegin();
+
+  // and start flooding
+  while (!fah.empty())
+  {
+    // store the current vars
+    InputImagePixelType currentValue = fah.begin()->first;
+    QueueType           currentQueue = fah.begin()->second;
+    // and remove them from the fah
+    fah.erase(fah.begin());
+
+    while (!currentQueue.empty())
+    {
+      IndexType idx = currentQueue.front();
+      currentQueue.pop();
+
+      // move the iterators to the right place
+      OffsetType shift = idx - outputIt.GetIndex();
+      outputIt += shift;
+      statusIt += shift;
+      inputIt += shift;
+
+      // iterate over the neighbors. If there is only one marker value, give
+      // that value to the pixel, else keep it as is (watershed line)
+      LabelImagePixelType marker = wsLabel;
+      bool                collision = false;
+      for (noIt = outputIt.Begin(); noIt != outputIt.End(); noIt++)
+      {
+        LabelImagePixelType o = noIt.Get();
+        if (o != wsLabel)
+        {
+          if (marker != wsLabel && o != marker)
+          {
+            collision = true;
+            break;
+          }
+          else
+          {
+            marker = o;
+          }
+        }
+      }
+      if (!collision)
+      {
+        // set the marker value
+        outputIt.SetCenterPixel(marker);
+        // and propagate to the neighbors
+        for (niIt = inputIt.Begin(), nsIt = statusIt.Begin(); niIt != inputIt.End(); niIt++, nsIt++)
         {
-          if (noIt.Get() == wsLabel)
+          if (!nsIt.Get())
           {
-            // the pixel is not yet processed. It can be labeled with the
-            // current label
-            noIt.Set(currentMarker);
+            // the pixel is not yet processed. add it to the fah
             InputImagePixelType GrayVal = niIt.Get();
             if (GrayVal <= currentValue)
             {
-              currentQueue.push(inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
+              currentQueue.push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
             }
             else
             {
-              fah[GrayVal].push(inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
+              fah[GrayVal].push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
             }
-            progress.CompletedPixel();
+            // mark it as already in the fah
+            nsIt.Set(true);
+          }
+        }
+      }
+      // one more pixel in the flooding stage
+      progress.CompletedPixel();
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TLabelImage>
+void
+MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::FloodWithoutWatershedLine(
+  FAHType &               fah,
+  const RegionImageType * regionImage,
+  IdentifierType          region)
+{
+  // the label used to mark the watershed line in the output image
+  static const LabelImagePixelType wsLabel = NumericTraits<LabelImagePixelType>::ZeroValue();
+
+  const InputImageType * inputImage = this->GetInput();
+  LabelImageType *       outputImage = this->GetOutput();
+
+  TotalProgressReporter progress(this, outputImage->GetRequestedRegion().GetNumberOfPixels() * 2);
+
+  // the radius which will be used for all the shaped iterators
+  Size<ImageDimension> radius;
+  radius.Fill(1);
+
+  // iterator for the input image
+  using InputIteratorType = ConstShapedNeighborhoodIterator<InputImageType>;
+  InputIteratorType                         inputIt(radius, inputImage, inputImage->GetRequestedRegion());
+  typename InputIteratorType::ConstIterator niIt;
+  setConnectivity(&inputIt, m_FullyConnected);
+
+  // iterator for the output image
+  using OutputIteratorType = ShapedNeighborhoodIterator<LabelImageType>;
+  using OffsetType = typename OutputIteratorType::OffsetType;
+  typename OutputIteratorType::Iterator noIt;
+  OutputIteratorType                    outputIt(radius, outputImage, outputImage->GetRequestedRegion());
+  setConnectivity(&outputIt, m_FullyConnected);
+
+  ConstantBoundaryCondition<LabelImageType> lcbc2;
+  // outside pixel are watershed so they won't be use to find real watershed
+  // pixels
+  lcbc2.SetConstant(NumericTraits<LabelImagePixelType>::max());
+  outputIt.OverrideBoundaryCondition(&lcbc2);
+
+  // init all the iterators
+  outputIt.GoToBegin();
+  inputIt.GoToBegin();
+
+  // and start flooding
+  while (!fah.empty())
+  {
+    // store the current vars
+    InputImagePixelType currentValue = fah.begin()->first;
+    QueueType           currentQueue = fah.begin()->second;
+    // and remove them from the fah
+    fah.erase(fah.begin());
+
+    while (!currentQueue.empty())
+    {
+      IndexType idx = currentQueue.front();
+      currentQueue.pop();
+
+      // move the iterators to the right place
+      OffsetType shift = idx - outputIt.GetIndex();
+      outputIt += shift;
+      inputIt += shift;
+
+      LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
+
+      // a marker pixel may have neighbors in several regions, which must only
+      // be flooded by the flooding of their own region
+      const bool isMarkerPixelOfSeveralRegions = regionImage && regionImage->GetPixel(idx) == 0;
+
+      // get the current value of the pixel
+      // iterate over neighbors to propagate the marker
+      for (noIt = outputIt.Begin(), niIt = inputIt.Begin(); noIt != outputIt.End(); noIt++, niIt++)
+      {
+        // the neighbors in the other regions are flooded concurrently, so
+        // they are not even read
+        const IndexType neighborIdx = inputIt.GetIndex() + noIt.GetNeighborhoodOffset();
+        if (isMarkerPixelOfSeveralRegions && (!regionImage->GetBufferedRegion().IsInside(neighborIdx) ||
+                                              regionImage->GetPixel(neighborIdx) != region + 1))
+        {
+          continue;
+        }
+
+        if (noIt.Get() == wsLabel)
+        {
+          // the pixel is not yet processed. It can be labeled with the
+          // current label
+          noIt.Set(currentMarker);
+          InputImagePixelType GrayVal = niIt.Get();
+          if (GrayVal <= currentValue)
+          {
+            currentQueue.push(neighborIdx);
           }
+          else
+          {
+            fah[GrayVal].push(neighborIdx);
+          }
+          progress.CompletedPixel();
         }
       }
     }
@@ -433,6 +624,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::PrintSel
 
   os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
   os << indent << "MarkWatershedLine: " << m_MarkWatershedLine << std::endl;
+  os << indent << "ParallelFlooding: " << m_ParallelFlooding << std::endl;
 }
 
 } // end namespace itk
@@ -105,6 +105,15 @@ public:
   itkGetConstReferenceMacro(MarkWatershedLine, bool);
   itkBooleanMacro(MarkWatershedLine);
 
+  /**
+   * Set/Get whether the regions that are separated by the regional minima are
+   * flooded concurrently. The output is the same either way. Default is
+   * false. \sa MorphologicalWatershedFromMarkersImageFilter::SetParallelFlooding
+   */
+  itkSetMacro(ParallelFlooding, bool);
+  itkGetConstReferenceMacro(ParallelFlooding, bool);
+  itkBooleanMacro(ParallelFlooding);
+
   /**
    */
   itkSetMacro(Level, InputImagePixelType);
@@ -136,6 +145,8 @@ private:
 
   bool m_MarkWatershedLine{ true };
 
+  bool m_ParallelFlooding{ false };
+
   InputImagePixelType m_Level;
 }; // end of class
 } // end namespace itk
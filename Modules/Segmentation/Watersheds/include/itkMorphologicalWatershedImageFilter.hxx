@@ -99,6 +99,7 @@ MorphologicalWatershedImageFilter<TInputImage, TOutputImage>::GenerateData()
   wshed->SetMarkerImage(label->GetOutput());
   wshed->SetFullyConnected(m_FullyConnected);
   wshed->SetMarkWatershedLine(m_MarkWatershedLine);
+  wshed->SetParallelFlooding(m_ParallelFlooding);
 
   if (m_Level != NumericTraits<InputImagePixelType>::ZeroValue())
   {
@@ -146,6 +147,7 @@ MorphologicalWatershedImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ost
 
   os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
   os << indent << "MarkWatershedLine: " << m_MarkWatershedLine << std::endl;
+  os << indent << "ParallelFlooding: " << m_ParallelFlooding << std::endl;
   os << indent << "Level: " << static_cast<typename NumericTraits<InputImagePixelType>::PrintType>(m_Level)
      << std::endl;
 }
@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+#include <random>
+
+namespace
+{
+template <typename TImage>
+bool
+CompareSequentialAndParallelFlooding(const TImage * input, const TImage * markers)
+{
+  using FilterType = itk::MorphologicalWatershedFromMarkersImageFilter<TImage, TImage>;
+
+  bool passed = true;
+  for (const bool markWatershedLine : { false, true })
+  {
+    for (const bool fullyConnected : { false, true })
+    {
+      // the sequential flooding, and the flooding of the regions by a
+      // single thread and by several threads
+      typename TImage::Pointer outputs[3];
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        auto filter = FilterType::New();
+        filter->SetInput(input);
+        filter->SetMarkerImage(markers);
+        filter->SetMarkWatershedLine(markWatershedLine);
+        filter->SetFullyConnected(fullyConnected);
+        filter->SetParallelFlooding(i > 0);
+        filter->SetNumberOfWorkUnits(i < 2 ? 1 : 8);
+        filter->Update();
+        outputs[i] = filter->GetOutput();
+        outputs[i]->DisconnectPipeline();
+      }
+
+      for (unsigned int i = 1; i < 3 && passed; ++i)
+      {
+        itk::ImageRegionConstIteratorWithIndex<TImage> sequentialIt(outputs[0], outputs[0]->GetBufferedRegion());
+        itk::ImageRegionConstIteratorWithIndex<TImage> parallelIt(outputs[i], outputs[i]->GetBufferedRegion());
+        for (; !sequentialIt.IsAtEnd(); ++sequentialIt, ++parallelIt)
+        {
+          if (sequentialIt.Get() != parallelIt.Get())
+          {
+            std::cerr << "Test failed! (MarkWatershedLine " << markWatershedLine << ", FullyConnected "
+                      << fullyConnected << ", " << (i == 1 ? "single thread" : "several threads") << ")" << std::endl;
+            std::cerr << "Output of the parallel flooding differs at " << sequentialIt.GetIndex() << ": expected "
+                      << static_cast<int>(sequentialIt.Get()) << ", actual " << static_cast<int>(parallelIt.Get())
+                      << std::endl;
+            passed = false;
+            break;
+          }
+        }
+      }
+    }
+  }
+  return passed;
+}
+
+
+// Creates an input image with few gray levels, so that it has many plateaus,
+// and a marker image made of a grid of lines (with some holes) that separate
+// the image into regions, each of which contains a few seeds.
+template <unsigned int VDimension>
+bool
+TestParallelFlooding(const typename itk::Image<unsigned char, VDimension>::SizeType & size)
+{
+  using ImageType = itk::Image<unsigned char, VDimension>;
+
+  auto input = ImageType::New();
+  input->SetRegions(size);
+  input->Allocate();
+
+  auto markers = ImageType::New();
+  markers->SetRegions(size);
+  markers->Allocate();
+
+  std::mt19937                       randomNumberEngine;
+  std::uniform_int_distribution<int> grayLevelDistribution(0, 7);
+  std::uniform_int_distribution<int> seedDistribution(0, 99);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> inputIt(input, input->GetBufferedRegion());
+  itk::ImageRegionIteratorWithIndex<ImageType> markerIt(markers, markers->GetBufferedRegion());
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++markerIt)
+  {
+    inputIt.Set(static_cast<unsigned char>(grayLevelDistribution(randomNumberEngine)));
+
+    const auto index = inputIt.GetIndex();
+    bool       isOnGrid = false;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      // the grid lines have a hole at every 17th pixel
+      isOnGrid = isOnGrid || (index[d] % 9 == 4 && index[(d + 1) % VDimension] % 17 != 3);
+    }
+
+    unsigned char marker = 0;
+    if (isOnGrid)
+    {
+      marker = 1;
+    }
+    else
+    {
+      const int seed = seedDistribution(randomNumberEngine);
+      if (seed < 3)
+      {
+        marker = static_cast<unsigned char>(2 + seed);
+      }
+    }
+    markerIt.Set(marker);
+  }
+
+  return CompareSequentialAndParallelFlooding<ImageType>(input, markers);
+}
+
+// Creates an input image of random gray levels, and a marker image of
+// columns which separate unmarked columns, so that each unmarked column is a
+// region, and each marker pixel touches two regions flooded concurrently.
+bool
+TestTouchingRegions()
+{
+  using ImageType = itk::Image<unsigned char, 2>;
+
+  const ImageType::SizeType size = { { 64, 97 } };
+  auto                      input = ImageType::New();
+  input->SetRegions(size);
+  input->Allocate();
+
+  auto markers = ImageType::New();
+  markers->SetRegions(size);
+  markers->Allocate();
+
+  std::mt19937                       randomNumberEngine;
+  std::uniform_int_distribution<int> grayLevelDistribution(0, 7);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> inputIt(input, input->GetBufferedRegion());
+  itk::ImageRegionIteratorWithIndex<ImageType> markerIt(markers, markers->GetBufferedRegion());
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++markerIt)
+  {
+    inputIt.Set(static_cast<unsigned char>(grayLevelDistribution(randomNumberEngine)));
+
+    const auto index = inputIt.GetIndex();
+    markerIt.Set(static_cast<unsigned char>(index[0] % 2 == 0 ? 1 + (index[0] / 2) % 3 : 0));
+  }
+
+  return CompareSequentialAndParallelFlooding<ImageType>(input, markers);
+}
+} // namespace
+
+
+int
+itkMorphologicalWatershedFromMarkersImageFilterParallelTest(int, char *[])
+{
+  using ImageType = itk::Image<unsigned char, 2>;
+  using FilterType = itk::MorphologicalWatershedFromMarkersImageFilter<ImageType, ImageType>;
+
+  auto filter = FilterType::New();
+
+  ITK_TEST_SET_GET_BOOLEAN(filter, ParallelFlooding, true);
+  ITK_TEST_SET_GET_BOOLEAN(filter, ParallelFlooding, false);
+
+  bool passed = true;
+
+  itk::Size<2> size2D = { { 73, 61 } };
+  passed = TestParallelFlooding<2>(size2D) && passed;
+
+  itk::Size<3> size3D = { { 29, 31, 27 } };
+  passed = TestParallelFlooding<3>(size3D) && passed;
+
+  passed = TestTouchingRegions() && passed;
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}